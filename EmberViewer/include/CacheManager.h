@@ -4,7 +4,9 @@
 #include <QObject>
 #include <QString>
 #include <QMap>
+#include <QHash>
 #include <QDateTime>
+#include "EmberPath.h"
 
 class CacheManager : public QObject
 {
@@ -18,10 +20,10 @@ public:
     };
     
     struct RootNodeInfo {
-        QString path;
+        EmberPath path;
         QString displayName;
         bool isGeneric;
-        QString identityPath;
+        EmberPath identityPath;
     };
     
     struct DeviceCache {
@@ -35,17 +37,17 @@ public:
     explicit CacheManager(QObject *parent = nullptr);
     ~CacheManager();
 
-    void cacheParameter(const QString &path, const QString &identifier, int access, int type);
-    ParameterCache getParameterCache(const QString &path) const;
-    bool hasParameterCache(const QString &path) const;
+    void cacheParameter(EmberPath path, const QString &identifier, int access, int type);
+    ParameterCache getParameterCache(EmberPath path) const;
+    bool hasParameterCache(EmberPath path) const;
     void clearParameterCache();
     
-    void setRootNode(const QString &path, const QString &displayName, bool isGeneric, const QString &identityPath = QString());
-    void updateRootNodeIdentityPath(const QString &path, const QString &identityPath);
-    void updateRootNodeDisplayName(const QString &path, const QString &displayName, bool isGeneric);
-    RootNodeInfo getRootNode(const QString &path) const;
-    bool hasRootNode(const QString &path) const;
-    bool isRootNodeGeneric(const QString &path) const;
+    void setRootNode(EmberPath path, const QString &displayName, bool isGeneric, EmberPath identityPath = EmberPath());
+    void updateRootNodeIdentityPath(EmberPath path, EmberPath identityPath);
+    void updateRootNodeDisplayName(EmberPath path, const QString &displayName, bool isGeneric);
+    RootNodeInfo getRootNode(EmberPath path) const;
+    bool hasRootNode(EmberPath path) const;
+    bool isRootNodeGeneric(EmberPath path) const;
     void clearRootNodes();
     
     static void cacheDevice(const QString &hostPort, const QString &deviceName, const QString &rootPath, const QString &identityPath);
@@ -56,8 +58,8 @@ public:
     void clear();
 
 private:
-    QMap<QString, ParameterCache> m_parameterCache;
-    QMap<QString, RootNodeInfo> m_rootNodes;
+    QHash<EmberPath, ParameterCache> m_parameterCache;
+    QHash<EmberPath, RootNodeInfo> m_rootNodes;
     
     static QMap<QString, DeviceCache> s_deviceCache;
     static constexpr int CACHE_EXPIRY_HOURS = 24;
@@ -32,6 +32,7 @@ struct ParameterData {
     QList<int> enumValues;
     bool isOnline;
     int streamIdentifier = -1;
+    int streamOffset = 0;       // Byte offset in a packed octet-string stream
     
     QJsonObject toJson() const;
     static ParameterData fromJson(const QJsonObject& json);
@@ -69,6 +70,13 @@ struct FunctionData {
 
 class DeviceSnapshot {
 public:
+    // Binary snapshots are compact and memory mappable (see MappedDeviceSnapshot),
+    // JSON remains available as a readable export
+    enum FileFormat {
+        Binary,
+        Json
+    };
+    
     DeviceSnapshot();
     
     QString deviceName;
@@ -89,9 +97,10 @@ public:
     int functionCount() const { return functions.size(); }
     
     QJsonDocument toJson() const;
-    bool saveToFile(const QString& filePath) const;
+    bool saveToFile(const QString& filePath, FileFormat format = Binary) const;
     
     static DeviceSnapshot fromJson(const QJsonDocument& doc);
+    // Reads either format, the file contents decide
     static DeviceSnapshot loadFromFile(const QString& filePath);
     
 private:
@@ -0,0 +1,65 @@
+#ifndef DEVICETREECACHE_H
+#define DEVICETREECACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include "EmberDataTypes.h"
+
+// On-disk copy of the element structure of one device, keyed by host:port.
+// Loaded on connect so the tree can be shown before the device answered, then
+// kept current from the live elements: update() reports whether an element
+// differs from the cached copy, so callers only touch what actually changed.
+// Stored as a versioned QDataStream file; files of other versions are ignored.
+class DeviceTreeCache
+{
+public:
+    enum Change {
+        Unchanged,
+        Added,
+        Modified
+    };
+
+    explicit DeviceTreeCache(const QString &hostPort = QString());
+
+    QString hostPort() const { return m_hostPort; }
+    QString filePath() const;
+    static QString cacheDirectory();
+
+    bool load();
+    bool save();
+    void clear();
+    bool isEmpty() const;
+    bool isDirty() const { return m_dirty; }
+
+    Change update(const EmberData::NodeInfo &node);
+    Change update(const EmberData::ParameterInfo &param);
+    Change update(const EmberData::MatrixInfo &matrix);
+    Change update(const EmberData::FunctionInfo &function);
+
+    // Elements ordered by path depth, so parents always come before their children
+    QVector<EmberData::NodeInfo> nodes() const;
+    QVector<EmberData::ParameterInfo> parameters() const;
+    QVector<EmberData::MatrixInfo> matrices() const;
+    QVector<EmberData::FunctionInfo> functions() const;
+    QStringList nodePaths() const;
+
+    // Drops cached elements that a full revalidation did not see again, returns their paths.
+    // Elements below a node in silentPaths (its GetDirectory got no reply) are kept
+    QStringList retainOnly(const QSet<QString> &seenPaths, const QSet<QString> &silentPaths = QSet<QString>());
+
+    static constexpr quint32 FILE_MAGIC = 0x45564443;   // "EVDC"
+    static constexpr quint16 FILE_VERSION = 2;
+
+private:
+    QString m_hostPort;
+    QHash<QString, EmberData::NodeInfo> m_nodes;
+    QHash<QString, EmberData::ParameterInfo> m_parameters;
+    QHash<QString, EmberData::MatrixInfo> m_matrices;
+    QHash<QString, EmberData::FunctionInfo> m_functions;
+    bool m_dirty;
+};
+
+#endif
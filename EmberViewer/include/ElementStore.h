@@ -0,0 +1,152 @@
+#ifndef ELEMENTSTORE_H
+#define ELEMENTSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <QHash>
+#include <vector>
+#include "EmberDataTypes.h"
+#include "EmberPath.h"
+
+
+// Deduplicates strings that repeat across a device tree (identifiers,
+// descriptions, enum lists, format strings). Id 0 is the empty string.
+class StringPool
+{
+public:
+    StringPool();
+
+    quint32 intern(const QString &string);
+    const QString& at(quint32 id) const { return m_strings[id]; }
+    int size() const { return m_strings.size(); }
+    void clear();
+
+private:
+    QVector<QString> m_strings;
+    QHash<QString, quint32> m_ids;
+};
+
+
+// Compact struct-of-arrays store of the elements of one device tree.
+// Every element is addressed by its index; the hot per-element columns are
+// plain vectors and the comparatively rare parameter and matrix details live
+// in side tables. Nothing here is presentation data, the model derives text,
+// icons and colors from these columns on demand.
+class ElementStore
+{
+public:
+    enum Kind : quint8 {
+        Placeholder,    // Created for an ancestor path before the element itself arrived
+        Node,
+        Parameter,
+        Matrix,
+        Function
+    };
+
+    enum Flag : quint8 {
+        Online = 0x01,
+        ChildrenFetched = 0x02,
+        Removed = 0x04
+    };
+
+    struct ParameterDetails {
+        int type = 0;
+        int access = 0;
+        int streamIdentifier = 0;
+        int streamOffset = 0;
+        int factor = 1;
+        QVariant minimum;
+        QVariant maximum;
+        quint32 enumOptions = 0;
+        QList<int> enumValues;
+        quint32 format = 0;
+        quint32 referenceLevel = 0;
+        quint32 formula = 0;
+    };
+
+    struct MatrixDetails {
+        int type = 0;
+        int targetCount = 0;
+        int sourceCount = 0;
+    };
+
+    static constexpr int NoElement = -1;
+
+    ElementStore();
+
+    // Includes the slots of removed elements that were not reused yet
+    int size() const { return static_cast<int>(m_kind.size()); }
+    void clear();
+
+    // Returns the element for path, creating it and any missing ancestors as placeholders
+    int findOrCreate(EmberPath path);
+    int find(EmberPath path) const { return m_index.value(path, NoElement); }
+
+    // Detaches element and its subtree. Their slots stay flagged Removed until new
+    // elements reuse them, indexes of other elements remain valid
+    void remove(int element);
+
+    void setNode(int element, const EmberData::NodeInfo &node);
+    void setParameter(int element, const EmberData::ParameterInfo &param);
+    void setMatrix(int element, const EmberData::MatrixInfo &matrix);
+    void setFunction(int element, const EmberData::FunctionInfo &function);
+    bool setValue(int element, const QString &value);
+    void setFlag(int element, Flag flag, bool on);
+
+    int parent(int element) const { return m_parent[element]; }
+    int row(int element) const { return m_row[element]; }
+    int childCount(int element) const;
+    int child(int element, int row) const;
+    int topLevelCount() const { return m_topLevel.size(); }
+    int topLevel(int row) const { return m_topLevel[row]; }
+
+    EmberPath path(int element) const { return m_path[element]; }
+    Kind kind(int element) const { return static_cast<Kind>(m_kind[element]); }
+    bool testFlag(int element, Flag flag) const { return (m_flags[element] & flag) != 0; }
+    int number(int element) const { return m_number[element]; }
+    const QString& identifier(int element) const { return m_strings.at(m_identifier[element]); }
+    const QString& description(int element) const { return m_strings.at(m_description[element]); }
+    const QString& value(int element) const { return m_value[element]; }
+    QString displayName(int element) const;
+
+    const ParameterDetails* parameter(int element) const;
+    const MatrixDetails* matrix(int element) const;
+    QStringList enumOptions(int element) const;
+    const QString& string(quint32 id) const { return m_strings.at(id); }
+
+    // Approximate heap usage of the store, excluding the path table
+    qint64 estimatedBytes() const;
+
+private:
+    int create(EmberPath path, int parent);
+    void releaseDetail(int element);
+
+    // Per-element columns
+    std::vector<int> m_parent;
+    std::vector<int> m_row;
+    std::vector<int> m_number;
+    std::vector<quint8> m_kind;
+    std::vector<quint8> m_flags;
+    std::vector<quint32> m_identifier;
+    std::vector<quint32> m_description;
+    std::vector<int> m_detail;              // Index into the side table of the element kind
+    std::vector<EmberPath> m_path;
+    std::vector<QString> m_value;
+    std::vector<QVector<int>> m_children;
+
+    std::vector<ParameterDetails> m_parameters;
+    std::vector<MatrixDetails> m_matrices;
+
+    // Slots of removed elements and details, reused before the columns grow
+    std::vector<int> m_freeElements;
+    std::vector<int> m_freeParameters;
+    std::vector<int> m_freeMatrices;
+
+    QVector<int> m_topLevel;
+    QHash<EmberPath, int> m_index;
+    StringPool m_strings;
+};
+
+#endif
@@ -10,19 +10,23 @@
 #define EMBERCONNECTION_H
 
 #include <QObject>
-#include <QTcpSocket>
+#include <QAbstractSocket>
+#include <QThread>
 #include <QByteArray>
 #include <QString>
 #include <QMap>
 #include <QTimer>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QVector>
 #include "S101Protocol.h"
-#include "GlowParser.h"
 #include "EmberDataTypes.h"
+#include "DeviceTreeCache.h"
+#include "MatrixLabelScheduler.h"
 
 
 class S101Protocol;
-class GlowParser;
+class EmberIoWorker;
 class TreeFetchService;
 class CacheManager;
 
@@ -45,16 +49,31 @@ public:
     void connectToHost(const QString &host, int port);
     void disconnect();
     bool isConnected() const;
+    // Without the cache nothing is replayed on connect and the device tree is not written to disk
+    void setDeviceTreeCacheEnabled(bool enabled);
+    // Records the raw S101 traffic of this connection to a capture file until stopped
+    void startCapture(const QString &filePath);
+    void stopCapture();
     
     void sendParameterValue(const QString &path, const QString &value, int type);
     void setMatrixConnection(const QString &matrixPath, int targetNumber, int sourceNumber, bool connect);
+    // Salvo: crosspoint changes are collected per matrix and target and sent as one root on commit
+    void addSalvoConnection(const QString &matrixPath, int targetNumber, int sourceNumber, bool connect);
+    void setSalvoTargetSources(const QString &matrixPath, int targetNumber, const QList<int> &sourceNumbers);
+    void commitMatrixSalvo();
+    void discardMatrixSalvo();
+    int pendingSalvoSize() const;
     void invokeFunction(const QString &path, const QList<QVariant> &arguments);
     void sendGetDirectoryForPath(const QString& path, bool optimizedForNameDiscovery = false);
     void sendBatchGetDirectory(const QStringList& paths, bool optimizedForNameDiscovery = false);
     void sendBatchSubscribe(const QList<SubscriptionRequest>& requests);
+    void sendBatchUnsubscribe(const QList<SubscriptionRequest>& requests);
     void fetchCompleteTree(const QStringList &initialNodePaths);
     void cancelTreeFetch();
     bool isTreeFetchActive() const;
+    // Target and source list indices on screen in a matrix view; those labels are fetched first
+    void setMatrixLabelViewport(const QString &matrixPath, int firstTarget, int lastTarget,
+                                int firstSource, int lastSource);
 
 signals:
     void connected();
@@ -64,34 +83,41 @@ signals:
     void matrixLabelProgress(const QString &matrixIdentifier, int fetchedCount, int totalCount, const QString &labelType);
     void labelFetchingComplete();
     void nodeReceived(const QString &path, const QString &identifier, const QString &description, bool isOnline);
-    void parameterReceived(const QString &path, int number, const QString &identifier, const QString &description, const QString &value, 
-                          int access, int type, const QVariant &minimum, const QVariant &maximum,
-                          const QStringList &enumOptions, const QList<int> &enumValues, bool isOnline, int streamIdentifier,
-                          const QString &format, const QString &referenceLevel, const QString &formula, int factor);
+    // Consecutive nodes and parameters of a decoded batch are delivered together
+    void nodesReceived(const QVector<EmberData::NodeInfo> &nodes);
+    void parametersReceived(const QVector<EmberData::ParameterInfo> &parameters);
     void matrixReceived(const QString &path, int number, const QString &identifier, const QString &description,
                        int type, int targetCount, int sourceCount);
-    void matrixTargetReceived(const QString &matrixPath, int targetNumber, const QString &label);
-    void matrixSourceReceived(const QString &matrixPath, int sourceNumber, const QString &label);
-    void matrixConnectionReceived(const QString &matrixPath, int targetNumber, int sourceNumber, bool connected, int disposition);
-    void matrixConnectionsCleared(const QString &matrixPath);
-    void matrixTargetConnectionsCleared(const QString &matrixPath, int targetNumber);
+    // isLabel is false for the "Target n" and "Source n" entries of a matrix's own target and source lists
+    void matrixTargetReceived(EmberPath matrixPath, int targetNumber, const QString &label, bool isLabel);
+    void matrixSourceReceived(EmberPath matrixPath, int sourceNumber, const QString &label, bool isLabel);
+    void matrixConnectionReceived(EmberPath matrixPath, int targetNumber, int sourceNumber, bool connected, int disposition);
+    void matrixConnectionsCleared(EmberPath matrixPath);
+    void matrixTargetConnectionsCleared(EmberPath matrixPath, int targetNumber);
     void functionReceived(const QString &path, const QString &identifier, const QString &description,
                          const QStringList &argNames, const QList<int> &argTypes,
                          const QStringList &resultNames, const QList<int> &resultTypes);
     void invocationResultReceived(int invocationId, bool success, const QList<QVariant> &results);
-    void streamValueReceived(int streamIdentifier, double value);
+    // Every value of one stream collection in a single emission
+    void streamValuesReceived(const QVector<EmberData::StreamValue> &values);
     void treeFetchProgress(int fetchedCount, int totalCount);
     void treeFetchCompleted(bool success, const QString &message);
+    void treeFetchResponseTime(qint64 responseTimeUs);
+    // Cached elements a completed revalidation did not find on the device anymore
+    void elementsRemoved(const QStringList &paths);
+    void captureStateChanged(bool recording, const QString &filePath);
 
 private slots:
     void onSocketConnected();
     void onSocketDisconnected();
-    void onSocketError(QAbstractSocket::SocketError error);
-    void onDataReceived();
+    void onSocketError(QAbstractSocket::SocketError error, const QString &errorString);
+    void onBatchReceived(const EmberData::Batch &batch);
     void onConnectionTimeout();
     void onProtocolTimeout();
+    void onRevalidationCompleted(bool success, const QString &message);
     void processBatchedAutoExpansion();
     void processBatchedLabelFetch();
+    void onLabelRequestTimer();
 
 private:
     struct ParameterCache {
@@ -99,18 +125,47 @@ private:
         int access = -1;
         int type = 0;
     };
-    void onS101MessageReceived(const QByteArray& emberData);
-    void onKeepAliveReceived();
+    bool sendFrame(const QByteArray& frame);
+    void flushReceivedElements();
     void onParserNodeReceived(const EmberData::NodeInfo& node);
     void onParserParameterReceived(const EmberData::ParameterInfo& param);
     void onParserMatrixReceived(const EmberData::MatrixInfo& matrix);
+    void onParserMatrixTargetReceived(const EmberData::MatrixTargetInfo& target);
+    void onParserMatrixSourceReceived(const EmberData::MatrixSourceInfo& source);
+    void onParserInvocationResultReceived(const EmberData::InvocationResult& result);
+    void onParserMatrixLabelPathsDiscovered(const EmberData::MatrixLabelPaths& labelPaths);
     void sendGetDirectory();
+    void sendTreeFetchRequest(const QStringList &paths);
+    void replayDeviceTree();
+    void trackRevalidation(const QString &path, bool isNode);
+    bool shouldForward(const QString &path, DeviceTreeCache::Change change);
     bool isGenericNodeName(const QString &name);
-
-    QTcpSocket *m_socket;
-    S101Protocol *m_s101Protocol;
-    GlowParser *m_glowParser;
+    void startLabelFetch(const QString &matrixPath);
+    void pumpLabelRequests();
+    void sendLabelRequests(const QVector<MatrixLabelScheduler::Request> &requests);
+    void fetchLabelLayers(const QString &matrixPath);
+
+    struct SalvoTarget {
+        bool absolute = false;
+        QList<int> connectSources;      // All sources when absolute
+        QList<int> disconnectSources;
+    };
+    using MatrixSalvo = QMap<QString, QMap<int, SalvoTarget>>;  // matrixPath -> targetNumber -> changes
+    bool sendMatrixSalvo(const MatrixSalvo &salvo);
+
+    QThread *m_ioThread;
+    EmberIoWorker *m_ioWorker;           // Socket, S101 decoding and Glow parsing, lives on m_ioThread
+    S101Protocol *m_s101Protocol;        // Only used for encoding outgoing frames
+    QAbstractSocket::SocketState m_socketState;  // Last state reported by the worker
+    QVector<EmberData::NodeInfo> m_pendingNodes;
+    QVector<EmberData::ParameterInfo> m_pendingParameters;
     TreeFetchService *m_treeFetchService;
+    // Persistent copy of the device tree; replayed on connect and revalidated in the background
+    DeviceTreeCache m_deviceTree;
+    bool m_deviceTreeCacheEnabled;
+    TreeFetchService *m_revalidationService;
+    QSet<QString> m_revalidatedPaths;
+    QSet<QString> m_replayedPaths;       // Shown from the cache and not yet seen again
     CacheManager *m_cacheManager;
     QString m_host;
     int m_port;
@@ -138,10 +193,18 @@ private:
         QSet<int> fetchedTargets;
         QSet<int> fetchedSources;
         QStringList labelBasePaths;  // 0=targets, 1=sources
+        QList<int> targetNumbers;    // From the matrix's own target and source lists, empty for linear matrices
+        QList<int> sourceNumbers;
         qint64 lastProgressEmitTime;  // milliseconds since epoch
     };
     QMap<QString, MatrixLabelFetchState> m_matrixLabelStates;  // matrixPath -> fetch state
     bool m_labelFetchingCompleted;  // Flag to prevent duplicate labelFetchingComplete emissions
+    // Labels are requested one by one in viewport priority order; matrices whose provider
+    // does not answer those requests fall back to fetching whole label layers
+    MatrixLabelScheduler m_labelScheduler;
+    QSet<QString> m_labelNumbersChanged;    // Matrices whose number lists the scheduler has not seen yet
+    QTimer *m_labelRequestTimer;
+    QElapsedTimer m_labelClock;
     int m_nextInvocationId;
     QMap<int, QString> m_pendingInvocations;
     struct SubscriptionState {
@@ -149,6 +212,7 @@ private:
         bool autoSubscribed;
     };
     QMap<QString, SubscriptionState> m_subscriptions;  
+    MatrixSalvo m_pendingSalvo;
     
 
 
@@ -162,6 +226,8 @@ public:
     bool isSubscribed(const QString &path) const;
     static constexpr int CONNECTION_TIMEOUT_MS = 5000;
     static constexpr int PROTOCOL_TIMEOUT_MS = 10000;
+    static constexpr int LABEL_REQUEST_TIMEOUT_MS = 3000;
+    static constexpr int LABEL_REQUEST_CHECK_MS = 500;
 };
 
 #endif 
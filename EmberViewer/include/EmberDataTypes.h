@@ -13,12 +13,17 @@
 #include <QStringList>
 #include <QList>
 #include <QVariant>
+#include <QVector>
+#include <QMetaType>
+#include <variant>
+#include "EmberPath.h"
 
 namespace EmberData {
 
 
 struct NodeInfo {
     QString path;
+    EmberPath oid;               // Interned path, set by the parser
     QString identifier;
     QString description;
     bool isOnline;
@@ -29,6 +34,7 @@ struct NodeInfo {
 
 struct ParameterInfo {
     QString path;
+    EmberPath oid;
     int number;
     QString identifier;
     QString description;         // Human-readable label for UI display
@@ -41,6 +47,7 @@ struct ParameterInfo {
     QList<int> enumValues;
     bool isOnline;
     int streamIdentifier;
+    int streamOffset = 0;        // Byte offset of the value inside a packed octet-string stream
     QString format;              // C-style format string (e.g., "%.1f dBFS")
     QString referenceLevel;      // Detected reference level (e.g., "dBFS", "dBu", "dBr")
     QString formula;             // Formula string for value conversion
@@ -50,6 +57,7 @@ struct ParameterInfo {
 
 struct MatrixInfo {
     QString path;
+    EmberPath oid;
     int number;
     QString identifier;
     QString description;
@@ -61,20 +69,25 @@ struct MatrixInfo {
 
 struct MatrixTargetInfo {
     QString matrixPath;
+    EmberPath matrixOid;
     int targetNumber;
     QString label;
+    bool isLabel = false;   // False for entries of the matrix's own target list, labelled "Target n"
 };
 
 
 struct MatrixSourceInfo {
     QString matrixPath;
+    EmberPath matrixOid;
     int sourceNumber;
     QString label;
+    bool isLabel = false;   // False for entries of the matrix's own source list, labelled "Source n"
 };
 
 
 struct MatrixConnectionInfo {
     QString matrixPath;
+    EmberPath matrixOid;
     int targetNumber;
     int sourceNumber;
     bool connected;
@@ -84,6 +97,7 @@ struct MatrixConnectionInfo {
 
 struct FunctionInfo {
     QString path;
+    EmberPath oid;
     QString identifier;
     QString description;
     QStringList argNames;
@@ -102,9 +116,67 @@ struct InvocationResult {
 
 struct StreamValue {
     int streamIdentifier;
+    int offset;                  // Channel offset within a packed stream, 0 for single value streams
     double value;
 };
 
+
+// All values decoded from one stream collection, delivered as a single update
+struct StreamValues {
+    QVector<StreamValue> values;
+};
+
+
+// Decoded elements carry their interned path; elements built elsewhere, such as
+// from the device tree cache, are interned from the string on first use
+template <typename Info>
+EmberPath elementPath(const Info &info)
+{
+    return info.oid.isEmpty() ? EmberPath::fromString(info.path) : info.oid;
+}
+
+template <typename Info>
+EmberPath matrixPathOf(const Info &info)
+{
+    return info.matrixOid.isEmpty() ? EmberPath::fromString(info.matrixPath) : info.matrixOid;
+}
+
+
+// Packed streams share an identifier; the offset tells their channels apart
+inline quint64 streamKey(int streamIdentifier, int offset)
+{
+    return (quint64(quint32(streamIdentifier)) << 32) | quint32(offset);
+}
+
+
+struct TargetConnectionsCleared {
+    QString matrixPath;
+    int targetNumber;
+    EmberPath matrixOid;
+};
+
+
+struct MatrixLabelPaths {
+    QString matrixPath;
+    QStringList basePaths;
+};
+
+
+// A single decoded record; batches keep records in the order the parser produced them
+using Record = std::variant<NodeInfo, ParameterInfo, MatrixInfo, MatrixTargetInfo, MatrixSourceInfo,
+                            MatrixConnectionInfo, TargetConnectionsCleared, FunctionInfo,
+                            InvocationResult, StreamValues, MatrixLabelPaths>;
+
+
+// Records decoded by the I/O thread from one chunk of socket data
+struct Batch {
+    QVector<Record> records;
+    int messageCount = 0;        // Number of Ember+ messages the records were decoded from
+};
+
 } 
 
+Q_DECLARE_METATYPE(EmberData::Batch)
+
+
 #endif 
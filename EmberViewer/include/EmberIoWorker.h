@@ -0,0 +1,73 @@
+#ifndef EMBERIOWORKER_H
+#define EMBERIOWORKER_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include "EmberDataTypes.h"
+#include "S101Capture.h"
+
+
+class S101Protocol;
+class GlowParser;
+
+// Owns the socket, the S101 decoder and the Glow parser of an EmberConnection.
+// Lives on a dedicated thread and hands decoded records to the GUI thread in batches.
+// At most MAX_PENDING_BATCHES batches may be unacknowledged; beyond that the worker
+// stops reading, the bounded socket buffer fills up and TCP flow control slows the device.
+class EmberIoWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EmberIoWorker(QObject *parent = nullptr);
+    ~EmberIoWorker();
+
+    // Thread-safe, called by the consumer once it has applied a batch
+    void acknowledgeBatch();
+
+    static constexpr int MAX_PENDING_BATCHES = 4;
+    static constexpr qint64 READ_CHUNK_SIZE = 64 * 1024;
+    static constexpr qint64 READ_BUFFER_SIZE = 1024 * 1024;
+
+public slots:
+    void connectToHost(const QString &host, int port);
+    void disconnectFromHost();
+    void abort();
+    void sendFrame(const QByteArray &frame);
+    // Raw socket bytes in both directions, see S101CaptureWriter
+    void startRecording(const QString &filePath);
+    void stopRecording();
+
+signals:
+    void connected();
+    void disconnected();
+    void stateChanged(QAbstractSocket::SocketState state);
+    void errorOccurred(QAbstractSocket::SocketError error, const QString &errorString);
+    void batchReady(const EmberData::Batch &batch);
+    void protocolError(const QString &error);
+    void parsingError(const QString &error);
+    void recordingStateChanged(bool recording, const QString &filePath);
+
+private slots:
+    void onReadyRead();
+    void resumeReading();
+
+private:
+    void onMessageReceived(const QByteArray &emberData);
+    void onKeepAliveReceived();
+    void appendRecord(EmberData::Record record);
+    void flushBatch();
+
+    QTcpSocket *m_socket;
+    S101Protocol *m_s101Protocol;
+    GlowParser *m_glowParser;
+    EmberData::Batch m_batch;
+    S101CaptureWriter m_capture;
+    std::atomic<int> m_pendingBatches;
+    bool m_readPaused;
+};
+
+#endif
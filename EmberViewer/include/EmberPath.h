@@ -0,0 +1,61 @@
+#ifndef EMBERPATH_H
+#define EMBERPATH_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include <QHashFunctions>
+#include <QMetaType>
+
+
+// Compact, interned identifier of an element path ("1.3.7.12").
+// Every distinct path is stored once in a process wide path table as a
+// (parent, number, depth) entry; an EmberPath is only the index into that
+// table, so copying, hashing and comparing are integer operations. The
+// dotted string form is produced on demand for display. The table is
+// append-only: creating paths takes a lock and may happen on any thread,
+// reading an entry does not lock. Interned paths are never freed, so use
+// find() for lookups of paths that may not exist.
+class EmberPath
+{
+public:
+    EmberPath() : m_id(0) {}
+
+    static EmberPath fromString(QStringView path);
+    static EmberPath fromNumbers(const QVector<int> &numbers);
+    // The path if it was interned before, an empty path otherwise
+    static EmberPath find(QStringView path);
+
+    bool isEmpty() const { return m_id == 0; }
+    quint32 id() const { return m_id; }
+
+    EmberPath child(int number) const;
+    EmberPath parent() const;
+    EmberPath ancestor(int depth) const;
+    bool isAncestorOf(EmberPath other) const;
+
+    int depth() const;
+    int number() const;
+    QVector<int> numbers() const;
+    QString toString() const;
+
+    friend bool operator==(EmberPath lhs, EmberPath rhs) { return lhs.m_id == rhs.m_id; }
+    friend bool operator!=(EmberPath lhs, EmberPath rhs) { return lhs.m_id != rhs.m_id; }
+
+    // Number of distinct paths interned so far, mainly for diagnostics
+    static int internedCount();
+
+private:
+    explicit EmberPath(quint32 id) : m_id(id) {}
+
+    quint32 m_id;
+};
+
+inline size_t qHash(EmberPath path, size_t seed = 0) noexcept
+{
+    return qHash(path.id(), seed);
+}
+
+Q_DECLARE_METATYPE(EmberPath)
+
+#endif
@@ -16,10 +16,15 @@
 #include <QString>
 #include <QMap>
 #include <QList>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <memory>
 #include <ember/dom/AsyncDomReader.hpp>
 #include <s101/StreamDecoder.hpp>
 
 class DeviceSnapshot;
+class MappedDeviceSnapshot;
 struct NodeData;
 struct ParameterData;
 struct MatrixData;
@@ -107,7 +112,11 @@ public:
     void stopListening();
     bool isListening() const { return m_server && m_server->isListening(); }
     
-    void loadDeviceTree(const DeviceSnapshot &snapshot);
+    void loadDeviceTree(const DeviceSnapshot &snapshot, std::shared_ptr<const MappedDeviceSnapshot> matrixSource = nullptr);
+    // Stream identifier to rate in Hz. Clients subscribed to a stream parameter get a generated
+    // meter value at that rate; loading a device tree stops all streams.
+    void setStreamRates(const QMap<int, int> &ratesHz);
+    int streamCount() const;
     
     
     void processRoot(libember::dom::Node* root, ClientConnection *client);
@@ -143,6 +152,9 @@ private:
     void handleUnsubscribe(const QString &path, ClientConnection *client);
     
     void sendEncodedMessage(const libember::glow::GlowContainer *container, ClientConnection *client);
+    MatrixData* findMatrix(const QString &path);
+    bool hasMatrix(const QString &path) const;
+    void sendStreamValues(int rateHz);
     
     QTcpServer *m_server;
     QList<ClientConnection*> m_clients;
@@ -153,6 +165,20 @@ private:
     QMap<QString, ParameterData> m_parameters;
     QMap<QString, MatrixData> m_matrices;
     QMap<QString, FunctionData> m_functions;
+    std::shared_ptr<const MappedDeviceSnapshot> m_matrixSource;  // Decodes matrices missing from m_matrices
+    
+    struct StreamSource {
+        int identifier = 0;
+        QStringList paths;          // Every parameter on this stream, any of them may be subscribed
+        int minimum = 0;
+        int maximum = 0;
+    };
+    QMap<int, QVector<StreamSource>> m_streamsByRate;
+    QList<QTimer*> m_streamTimers;
+    QElapsedTimer m_streamClock;
+    
+    // A client this far behind skips stream ticks instead of buffering them
+    static constexpr qint64 MAX_STREAM_BACKLOG_BYTES = 4 * 1024 * 1024;
     
     
     QStringList m_rootPaths;
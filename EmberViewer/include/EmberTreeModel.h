@@ -0,0 +1,87 @@
+#ifndef EMBERTREEMODEL_H
+#define EMBERTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QIcon>
+#include <QVector>
+#include "ElementStore.h"
+#include "EmberDataTypes.h"
+
+
+// Lazy item model over an ElementStore behind the main device tree view.
+// Text, icons, colors and tooltips are computed in data() for the rows a view
+// actually asks for, so the cost of an element is its store columns only.
+// Element data sits on the NameColumn index under Qt::UserRole based roles:
+// +0 path, +1 type, +2 access, +3 minimum, +4 maximum (isOnline for nodes),
+// +5 enum options, +6 enum values, +7 "Matrix", +8 isOnline, +9 stream
+// identifier, +10 format, +11 reference level, +12 formula, +13 factor,
+// +14 stream offset.
+class EmberTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn = 0,
+        TypeColumn,
+        ValueColumn,
+        ColumnCount
+    };
+
+    explicit EmberTreeModel(QObject *parent = nullptr);
+    ~EmberTreeModel();
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    void applyNodes(const QVector<EmberData::NodeInfo> &nodes);
+    void applyParameters(const QVector<EmberData::ParameterInfo> &parameters);
+    void applyMatrix(const EmberData::MatrixInfo &matrix);
+    void applyFunction(const EmberData::FunctionInfo &function);
+    void setParameterValue(const QString &path, const QString &value);
+    // Removes the elements and everything below them
+    void removePaths(const QStringList &paths);
+    void clear();
+
+    QModelIndex indexForPath(const QString &path, int column = NameColumn) const;
+    QString pathForIndex(const QModelIndex &index) const;
+    const ElementStore& store() const { return m_store; }
+
+    // Text of the TypeColumn, empty for placeholders
+    static QString kindName(ElementStore::Kind kind);
+
+signals:
+    // Emitted when a view expands a node or matrix whose children were never requested
+    void fetchRequested(const QString &path);
+
+private:
+    int elementOf(const QModelIndex &index) const;
+    QModelIndex indexOf(int element, int column = NameColumn) const;
+    int prepare(EmberPath key);
+    // Creates the missing elements of paths and their ancestors, one row insertion per parent
+    void insertMissing(const QVector<EmberPath> &paths);
+    // Emits one dataChanged range per parent of the elements
+    void elementsChanged(const QVector<int> &elements);
+    QVariant decoration(int element) const;
+    QVariant userData(int element, int role) const;
+
+    ElementStore m_store;
+
+    QIcon m_nodeIcon;
+    QIcon m_offlineIcon;
+    QIcon m_parameterIcon;
+    QIcon m_meterIcon;
+    QIcon m_matrixIcon;
+    QIcon m_functionIcon;
+};
+
+#endif
@@ -10,19 +10,19 @@
 
 
 
-#ifndef EMBERTREEWIDGET_H
-#define EMBERTREEWIDGET_H
+#ifndef EMBERTREEVIEW_H
+#define EMBERTREEVIEW_H
 
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QMouseEvent>
 #include <QApplication>
 
-class EmberTreeWidget : public QTreeWidget
+class EmberTreeView : public QTreeView
 {
     Q_OBJECT
 
 public:
-    explicit EmberTreeWidget(QWidget *parent = nullptr);
+    explicit EmberTreeView(QWidget *parent = nullptr);
 
 protected:
     void mousePressEvent(QMouseEvent *event) override;
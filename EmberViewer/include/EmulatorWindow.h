@@ -18,9 +18,11 @@
 #include <QSpinBox>
 #include <QLabel>
 #include <QListWidget>
+#include <memory>
 
 class EmberProvider;
 class DeviceSnapshot;
+class MappedDeviceSnapshot;
 
 class EmulatorWindow : public QMainWindow
 {
@@ -32,6 +34,7 @@ public:
 
 private slots:
     void onLoadSnapshot();
+    void onGenerateDevice();
     void onStartServer();
     void onStopServer();
     void onServerStateChanged(bool running);
@@ -43,7 +46,7 @@ private slots:
 private:
     void setupUi();
     void setupMenu();
-    void loadSnapshotData(const DeviceSnapshot &snapshot);
+    void loadSnapshotData(const DeviceSnapshot &snapshot, std::shared_ptr<const MappedDeviceSnapshot> mapped = nullptr);
     void updateServerStatus();
     void logActivity(const QString &message);
     
@@ -58,6 +61,7 @@ private:
     
     
     QPushButton *m_loadButton;
+    QPushButton *m_generateButton;
     QPushButton *m_startButton;
     QPushButton *m_stopButton;
     QSpinBox *m_portSpin;
@@ -74,6 +78,10 @@ private:
     
     
     static constexpr int DEFAULT_EMULATOR_PORT = 9099;
+    // Larger devices only list their nodes and matrices, a row per parameter would not fit
+    static constexpr int MAX_LISTED_ELEMENTS = 100000;
+    // Load tests send a request per element, the log keeps the most recent ones
+    static constexpr int MAX_ACTIVITY_LINES = 5000;
 };
 
 #endif 
@@ -12,6 +12,7 @@
 #define GLOWPARSER_H
 
 #include <QObject>
+#include <QHash>
 #include "EmberDataTypes.h"
 #include "StreamingDomReader.h"
 
@@ -50,34 +51,43 @@ signals:
     void matrixTargetReceived(const EmberData::MatrixTargetInfo& target);
     void matrixSourceReceived(const EmberData::MatrixSourceInfo& source);
     void matrixConnectionReceived(const EmberData::MatrixConnectionInfo& connection);
-    void matrixTargetConnectionsCleared(const QString& matrixPath, int targetNumber);
+    void matrixTargetConnectionsCleared(const QString& matrixPath, EmberPath matrixOid, int targetNumber);
     void functionReceived(const EmberData::FunctionInfo& function);
     void invocationResultReceived(const EmberData::InvocationResult& result);
-    void streamValueReceived(const EmberData::StreamValue& streamValue);
+    void streamValuesReceived(const QVector<EmberData::StreamValue>& values);
     void matrixLabelPathsDiscovered(const QString& matrixPath, const QStringList& basePaths);
     void parsingError(const QString& error);
 
 private:
     void processRoot(libember::dom::Node* root);
-    void processElementCollection(libember::glow::GlowContainer* container, const QString& parentPath);
+    void processElementCollection(libember::glow::GlowContainer* container, const QString& parentPath, EmberPath parentOid);
     void processQualifiedParameter(libember::glow::GlowQualifiedParameter* param);
-    void processParameter(libember::glow::GlowParameter* param, const QString& parentPath);
+    void processParameter(libember::glow::GlowParameter* param, const QString& parentPath, EmberPath parentOid);
     void processQualifiedNode(libember::glow::GlowQualifiedNode* node, bool isNew = true);
-    void processNode(libember::glow::GlowNode* node, const QString& parentPath, bool isNew = true);
+    void processNode(libember::glow::GlowNode* node, const QString& parentPath, EmberPath parentOid, bool isNew = true);
     void processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* matrix);
-    void processMatrix(libember::glow::GlowMatrix* matrix, const QString& parentPath);
+    void processMatrix(libember::glow::GlowMatrix* matrix, const QString& parentPath, EmberPath parentOid);
     void processQualifiedFunction(libember::glow::GlowQualifiedFunction* function);
-    void processFunction(libember::glow::GlowFunction* function, const QString& parentPath);
+    void processFunction(libember::glow::GlowFunction* function, const QString& parentPath, EmberPath parentOid);
     void processInvocationResult(libember::dom::Node* result);
     void processStreamCollection(libember::glow::GlowContainer* streamCollection);
+    void registerStreamChannel(int streamIdentifier, int offset, int format, int factor);
     QString detectReferenceLevel(const QString& formatString) const;
     void onItemReady(libember::dom::Node* node);
     StreamingDomReader *m_domReader;
     QMap<QString, bool> m_nodesWithIdentifier;
     QMap<QString, bool> m_parametersWithIdentifier;
     QMap<int, int> m_streamFactors;
+    // Channels of packed octet-string streams, sorted by offset
+    struct StreamChannel {
+        int offset;
+        int format;
+        int factor;
+    };
+    QHash<int, QVector<StreamChannel>> m_streamChannels;
     struct MatrixLabelPaths {
         QString matrixPath;
+        EmberPath matrixOid;
         QMap<QString, QString> labelBasePaths;
         QList<QString> labelOrder;
     };
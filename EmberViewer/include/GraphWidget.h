@@ -7,9 +7,11 @@
 #include <QLabel>
 #include <QComboBox>
 #include <QPainter>
-#include <QList>
 #include <QString>
 #include <QVBoxLayout>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "TimeSeriesBuffer.h"
 
 class GraphWidget : public QWidget
 {
@@ -25,6 +27,8 @@ public:
     void setTimeWindow(int seconds);
     void setStreamIdentifier(int id) { m_streamIdentifier = id; }
     int streamIdentifier() const { return m_streamIdentifier; }
+    void setStreamOffset(int offset) { m_streamOffset = offset; }
+    int streamOffset() const { return m_streamOffset; }
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -32,22 +36,24 @@ protected:
 
 private slots:
     void onTimeWindowChanged(int index);
+    void onRepaintTimer();
 
 private:
-    struct DataPoint {
-        qint64 timestamp;
-        double value;
-    };
-
     QString m_identifier;
     QString m_parameterPath;
     QString m_format;
     double m_minValue;
     double m_maxValue;
     int m_streamIdentifier;
+    int m_streamOffset;
     int m_timeWindowSeconds;
     
-    QList<DataPoint> m_dataPoints;
+    // Timestamps are ms on m_clock, which is monotonic so the buffer stays sorted
+    TimeSeriesBuffer m_samples;
+    QElapsedTimer m_clock;
+    double m_lastValue;
+    bool m_hasNewData;
+    QTimer *m_repaintTimer;     // Coalesces incoming samples into one repaint per display frame
     
     QLabel *m_identifierLabel;
     QLabel *m_currentValueLabel;
@@ -56,6 +62,7 @@ private:
     QLabel *m_pathLabel;
     
     void pruneOldData();
+    void scheduleRepaint();
     void drawGraph(QPainter &painter, const QRect &graphRect);
     void drawAxes(QPainter &painter, const QRect &graphRect);
     void drawGridLines(QPainter &painter, const QRect &graphRect);
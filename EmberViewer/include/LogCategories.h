@@ -0,0 +1,14 @@
+#ifndef LOGCATEGORIES_H
+#define LOGCATEGORIES_H
+
+#include <QLoggingCategory>
+
+// Per-element and per-packet logging. Debug output of these categories is off
+// by default and qCDebug skips the whole statement, formatting included, while
+// it is. Enable with e.g. QT_LOGGING_RULES="emberviewer.glow.debug=true".
+Q_DECLARE_LOGGING_CATEGORY(lcGlow)
+Q_DECLARE_LOGGING_CATEGORY(lcS101)
+Q_DECLARE_LOGGING_CATEGORY(lcIo)
+Q_DECLARE_LOGGING_CATEGORY(lcElements)
+
+#endif
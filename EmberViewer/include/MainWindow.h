@@ -10,7 +10,7 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QTextEdit>
 #include <QSplitter>
 #include <QGroupBox>
@@ -26,6 +26,7 @@
 #include <QPointer>
 
 #include "UpdateManager.h"
+#include "EmberDataTypes.h"
 
 class EmberConnection;
 class MatrixWidget;
@@ -35,7 +36,8 @@ class EmulatorWindow;
 class UpdateDialog;
 class ConnectionManager;
 class ConnectionsTreeWidget;
-class EmberTreeWidget;
+class EmberTreeView;
+class EmberTreeModel;
 class TreeViewController;
 class SubscriptionManager;
 class MatrixManager;
@@ -46,6 +48,9 @@ class TriggerWidget;
 class SliderWidget;
 class GraphWidget;
 class BusySpinner;
+class StreamDashboard;
+class PerformancePanel;
+class QDockWidget;
 
 class MainWindow : public QMainWindow
 {
@@ -66,27 +71,26 @@ private slots:
     void onDisconnectClicked();
     void onConnectionStateChanged(bool connected);
     void onNodeReceived(const QString &path, const QString &identifier, const QString &description, bool isOnline);
-    void onParameterReceived(const QString &path, int number, const QString &identifier, const QString &description, const QString &value, 
-                            int access, int type, const QVariant &minimum, const QVariant &maximum,
-                            const QStringList &enumOptions, const QList<int> &enumValues, bool isOnline, int streamIdentifier,
-                            const QString &format = QString(), const QString &referenceLevel = QString(),
-                            const QString &formula = QString(), int factor = 1);
+    void onNodesReceived(const QVector<EmberData::NodeInfo> &nodes);
+    void onParametersReceived(const QVector<EmberData::ParameterInfo> &parameters);
     void onMatrixReceived(const QString &path, int number, const QString &identifier, const QString &description,
                          int type, int targetCount, int sourceCount);
-    void onMatrixTargetReceived(const QString &matrixPath, int targetNumber, const QString &label);
-    void onMatrixSourceReceived(const QString &matrixPath, int sourceNumber, const QString &label);
-    void onMatrixConnectionReceived(const QString &matrixPath, int targetNumber, int sourceNumber, bool connected, int disposition);
-    void onMatrixConnectionsCleared(const QString &matrixPath);
-    void onMatrixTargetConnectionsCleared(const QString &matrixPath, int targetNumber);
+    void onMatrixTargetReceived(EmberPath matrixPath, int targetNumber, const QString &label, bool isLabel);
+    void onMatrixSourceReceived(EmberPath matrixPath, int sourceNumber, const QString &label, bool isLabel);
+    void onMatrixConnectionReceived(EmberPath matrixPath, int targetNumber, int sourceNumber, bool connected, int disposition);
+    void onMatrixConnectionsCleared(EmberPath matrixPath);
+    void onMatrixTargetConnectionsCleared(EmberPath matrixPath, int targetNumber);
     void onMatrixDimensionsUpdated(const QString &path, QWidget *widget);
     void onMatrixWidgetCreated(const QString &path, QWidget *widget);
     void onFunctionReceived(const QString &path, const QString &identifier, const QString &description,
                            const QStringList &argNames, const QList<int> &argTypes,
                            const QStringList &resultNames, const QList<int> &resultTypes);
-    void onStreamValueReceived(int streamIdentifier, double value);
+    void onStreamValuesReceived(const QVector<EmberData::StreamValue> &values);
     void onCrosspointClicked(const QString &matrixPath, int targetNumber, int sourceNumber);
+    void onCrosspointsClicked(const QString &matrixPath, const QList<QPair<int, int>> &crosspoints);
     void onTreeSelectionChanged();
     void onEnableCrosspointsToggled(bool enabled);
+    void onRecordCaptureTriggered(bool record);
     void onActivityTimeout();
     void onSaveEmberDevice();
     void onOpenEmulator();
@@ -115,11 +119,17 @@ private:
     void saveSettings();
     void cleanupActiveParameterWidget();
     void cleanupPropertyPanelLayout();
+    StreamDashboard* streamDashboard();
+    bool isOnStreamDashboard(const QString &path) const;
+    void addToStreamDashboard(const QModelIndex &index);
+    void removeFromStreamDashboard(const QString &path);
+    void showPerformancePanel();
     
     void logMessage(const QString &message);
     
     
-    EmberTreeWidget *m_treeWidget;
+    EmberTreeView *m_treeView;
+    EmberTreeModel *m_treeModel;
     QPointer<QWidget> m_propertyPanel;
     QTextEdit *m_consoleLog;
     QGroupBox *m_consoleGroup;
@@ -152,9 +162,17 @@ private:
     QPointer<MeterWidget> m_activeMeter;
     QString m_activeMeterPath;  
     
+    // Created on first use; meters are fed from onStreamValuesReceived by stream key
+    StreamDashboard *m_streamDashboard;
+    QDockWidget *m_streamDashboardDock;
+    
+    PerformancePanel *m_performancePanel;
+    QDockWidget *m_performanceDock;
+    
     
     QPointer<QWidget> m_activeParameterWidget;  
     QString m_activeParameterPath;     
+    QString m_activeMatrixPath;
     
     
     QMap<int, QString> m_streamIdToPath;
@@ -175,6 +193,7 @@ private:
 
     
     QAction *m_enableCrosspointsAction;
+    QAction *m_recordCaptureAction;
     QLabel *m_crosspointsStatusLabel;
     
     
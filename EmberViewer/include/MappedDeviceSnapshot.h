@@ -0,0 +1,81 @@
+#ifndef MAPPEDDEVICESNAPSHOT_H
+#define MAPPEDDEVICESNAPSHOT_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QHash>
+#include "DeviceSnapshot.h"
+
+// Binary device snapshot that is read straight from a memory mapping.
+//
+// Layout (all words little endian):
+//   header       HEADER_WORDS words: magic, version, section counts and offsets, device metadata
+//   strings      index of {offset, length} pairs followed by UTF-8 data; string 0 is empty
+//   int pool     variable length lists (children, enum values, numbers, labels), referenced by first/count
+//   records      fixed size node, parameter, matrix and function records
+//   bitsets      one row-major target x source connection bitset per matrix
+//
+// Nothing is decoded when the file is opened; records are turned into the
+// DeviceSnapshot structs one at a time, so large matrices cost nothing until
+// they are actually used.
+class MappedDeviceSnapshot
+{
+public:
+    MappedDeviceSnapshot();
+    ~MappedDeviceSnapshot();
+
+    bool open(const QString &filePath);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    QString errorString() const { return m_error; }
+
+    QString deviceName() const;
+    QString hostAddress() const;
+    int port() const;
+    QDateTime captureTime() const;
+    QStringList rootPaths() const;
+
+    int nodeCount() const { return m_nodeCount; }
+    int parameterCount() const { return m_parameterCount; }
+    int matrixCount() const { return m_matrixCount; }
+    int functionCount() const { return m_functionCount; }
+
+    NodeData node(int index) const;
+    ParameterData parameter(int index) const;
+    // Without contents only the matrix header is decoded, no labels or connections
+    MatrixData matrix(int index, bool withContents = true) const;
+    FunctionData function(int index) const;
+    int findMatrix(const QString &path) const;
+
+    DeviceSnapshot toSnapshot(bool withMatrixContents = true) const;
+
+    static bool isBinarySnapshot(const QString &filePath);
+    static bool write(const DeviceSnapshot &snapshot, const QString &filePath, QString *error = nullptr);
+
+    static constexpr quint32 FILE_MAGIC = 0x4E535645;   // "EVSN"
+    static constexpr quint32 FILE_VERSION = 2;
+
+private:
+    quint32 word(qint64 offset) const;
+    quint32 headerWord(int index) const { return word(index * 4); }
+    QString string(quint32 id) const;
+    QList<int> ints(quint32 first, quint32 count) const;
+    QStringList strings(quint32 first, quint32 count) const;
+    qint64 recordOffset(int section, int index) const;
+
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+    QString m_error;
+
+    int m_nodeCount;
+    int m_parameterCount;
+    int m_matrixCount;
+    int m_functionCount;
+
+    mutable QHash<QString, int> m_matrixIndex;  // Built on the first lookup
+};
+
+#endif
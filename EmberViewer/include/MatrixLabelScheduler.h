@@ -0,0 +1,112 @@
+#ifndef MATRIXLABELSCHEDULER_H
+#define MATRIXLABELSCHEDULER_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// Orders matrix label requests so that what is on screen loads first.
+//
+// Every target and source label of a matrix is missing, in flight or done.
+// Labels are tracked by their index in the matrix's target and source lists;
+// requests and markReceived() use the label numbers, which equal the indices
+// unless setNumbers() gave the actual lists. Requests are handed out for the
+// visible range of the focused matrix first, then one page on either side of
+// it, then the remaining labels of every matrix in ascending order, with at
+// most maxInFlight outstanding at a time.
+class MatrixLabelScheduler
+{
+public:
+    // Values are the node numbers of the target and source layers below a label base path
+    enum LabelType {
+        Target = 1,
+        Source = 2
+    };
+
+    struct Request {
+        QString matrixPath;
+        LabelType type;
+        int number;
+    };
+
+    explicit MatrixLabelScheduler(int maxInFlight = DEFAULT_MAX_IN_FLIGHT);
+
+    // Adding a known matrix again only resizes it and keeps labels already fetched
+    void addMatrix(const QString &matrixPath, int targetCount, int sourceCount);
+    void removeMatrix(const QString &matrixPath);
+    bool hasMatrix(const QString &matrixPath) const { return m_matrixIds.contains(matrixPath); }
+    void clear();
+
+    // Target or source numbers in list order, for matrices whose numbers are not 0..count-1.
+    // Requests in flight for the matrix are handed out again under the new numbers
+    void setNumbers(const QString &matrixPath, LabelType type, const QList<int> &numbers);
+
+    // Inclusive index ranges into the target and source lists of the matrix on screen;
+    // it becomes the focused matrix
+    void setVisibleRange(const QString &matrixPath, int firstTarget, int lastTarget,
+                         int firstSource, int lastSource);
+
+    // Labels are accepted whether they were requested or not
+    void markReceived(const QString &matrixPath, LabelType type, int number);
+
+    // Fills the in-flight window; now is any monotonic millisecond clock
+    QVector<Request> takeRequests(qint64 now);
+
+    // Requests outstanding for longer than timeoutMs are given up so the window keeps moving
+    QVector<Request> takeExpired(qint64 now, qint64 timeoutMs);
+
+    // True once any label of the matrix arrived while requested one by one
+    bool hasAnswers(const QString &matrixPath) const;
+
+    int inFlightCount() const { return m_inFlight.size(); }
+    int maxInFlight() const { return m_maxInFlight; }
+    bool isIdle() const;
+
+    static constexpr int DEFAULT_MAX_IN_FLIGHT = 256;
+
+private:
+    enum LabelState : quint8 {
+        Missing,
+        InFlight,
+        Done
+    };
+
+    struct MatrixState {
+        QString path;
+        QVector<quint8> states[2];      // Indexed by LabelType - 1, then by list index
+        QList<int> numbers[2];          // Label number per index, empty when they are equal
+        QHash<int, int> indexes[2];     // Label number -> index, for non-empty numbers
+        int cursors[2] = {0, 0};        // Below the cursor nothing is missing
+        int remaining = 0;              // Labels not yet done
+        bool answered = false;
+    };
+
+    struct Visible {
+        int first[2] = {0, 0};
+        int last[2] = {-1, -1};
+    };
+
+    static quint64 key(int matrixId, LabelType type, int index)
+    {
+        return (quint64(quint32(matrixId)) << 33) | (quint64(type - 1) << 32) | quint32(index);
+    }
+
+    static int numberAt(const MatrixState &matrix, LabelType type, int index);
+    static int indexOf(const MatrixState &matrix, LabelType type, int number);
+
+    void requestRange(int matrixId, LabelType type, int first, int last, qint64 now, QVector<Request> &requests);
+    bool request(int matrixId, LabelType type, int index, qint64 now, QVector<Request> &requests);
+    void setState(MatrixState &matrix, LabelType type, int index, LabelState state);
+
+    int m_maxInFlight;
+    int m_nextMatrixId;
+    QHash<int, MatrixState> m_matrices;
+    QHash<QString, int> m_matrixIds;
+    QVector<int> m_matrixOrder;         // Background order, by discovery
+    QHash<quint64, qint64> m_inFlight;  // Request key -> time requested
+
+    int m_focusedMatrix;
+    Visible m_visible;
+};
+
+#endif
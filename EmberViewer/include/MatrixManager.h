@@ -12,8 +12,9 @@
 #define MATRIXMANAGER_H
 
 #include <QObject>
-#include <QMap>
+#include <QHash>
 #include <QString>
+#include "EmberPath.h"
 
 class VirtualizedMatrixWidget;
 class EmberConnection;
@@ -35,11 +36,11 @@ public slots:
     
     void onMatrixReceived(const QString &path, int number, const QString &identifier, const QString &description,
                          int type, int targetCount, int sourceCount);
-    void onMatrixTargetReceived(const QString &matrixPath, int targetNumber, const QString &label);
-    void onMatrixSourceReceived(const QString &matrixPath, int sourceNumber, const QString &label);
-    void onMatrixConnectionReceived(const QString &matrixPath, int targetNumber, int sourceNumber, bool connected, int disposition);
-    void onMatrixConnectionsCleared(const QString &matrixPath);
-    void onMatrixTargetConnectionsCleared(const QString &matrixPath, int targetNumber);
+    void onMatrixTargetReceived(EmberPath matrixPath, int targetNumber, const QString &label, bool isLabel = true);
+    void onMatrixSourceReceived(EmberPath matrixPath, int sourceNumber, const QString &label, bool isLabel = true);
+    void onMatrixConnectionReceived(EmberPath matrixPath, int targetNumber, int sourceNumber, bool connected, int disposition);
+    void onMatrixConnectionsCleared(EmberPath matrixPath);
+    void onMatrixTargetConnectionsCleared(EmberPath matrixPath, int targetNumber);
 
 signals:
     void matrixWidgetCreated(const QString &path, QWidget *widget);
@@ -47,7 +48,7 @@ signals:
 
 private:
     EmberConnection *m_connection;
-    QMap<QString, QWidget*> m_matrixWidgets;  
+    QHash<EmberPath, QWidget*> m_matrixWidgets;  
     
     static constexpr int MATRIX_LABEL_PATH_MARKER = 666999666;
 };
@@ -8,6 +8,101 @@
 #include <QHash>
 #include <QList>
 #include <QPair>
+#include <QVector>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <vector>
+
+
+// Crosspoint state of one matrix.
+// While every crosspoint lies within targetCount x sourceCount the state is a
+// dense row-major bitset, so lookups are O(1) and clearing a target touches
+// sourceCount/64 words. Crosspoints outside those bounds (nonlinear matrices
+// with sparse numbering, or dimensions that are not known yet) switch the
+// store to sorted source lists per target. Non-zero dispositions are kept in
+// a side table in both modes.
+class ConnectionStore
+{
+public:
+    ConnectionStore();
+
+    void resize(int targetCount, int sourceCount);
+    void clear();
+
+    // Returns false if the crosspoint already had this state
+    bool set(int targetNumber, int sourceNumber, bool connected, int disposition);
+    void clearTarget(int targetNumber);
+
+    bool isConnected(int targetNumber, int sourceNumber) const;
+    int disposition(int targetNumber, int sourceNumber) const;
+    int count() const { return m_count; }
+    bool isDense() const { return m_dense; }
+    QList<QPair<int, int>> connections() const;
+
+    // Calls f(sourceNumber) for the connected sources of a target within [firstSource, lastSource],
+    // in ascending order and without looking at unconnected crosspoints
+    template <typename F>
+    void forEachSource(int targetNumber, int firstSource, int lastSource, F f) const;
+
+    // Dense storage is only used up to this many crosspoints (8 MB of bits)
+    static constexpr qint64 MAX_DENSE_CROSSPOINTS = qint64(1) << 26;
+
+private:
+    static quint64 key(int targetNumber, int sourceNumber)
+    {
+        return (quint64(quint32(targetNumber)) << 32) | quint32(sourceNumber);
+    }
+    bool inDenseRange(int targetNumber, int sourceNumber) const
+    {
+        return targetNumber >= 0 && targetNumber < m_targetCount && sourceNumber >= 0 && sourceNumber < m_sourceCount;
+    }
+    void makeSparse();
+
+    bool m_dense;
+    int m_targetCount;
+    int m_sourceCount;
+    int m_wordsPerTarget;
+    int m_count;
+    std::vector<quint64> m_bits;
+    QHash<int, QVector<int>> m_sparse;      // Target -> sorted connected sources
+    QHash<quint64, int> m_dispositions;     // Only non-zero dispositions
+};
+
+template <typename F>
+void ConnectionStore::forEachSource(int targetNumber, int firstSource, int lastSource, F f) const
+{
+    if (!m_dense) {
+        auto it = m_sparse.constFind(targetNumber);
+        if (it == m_sparse.constEnd()) {
+            return;
+        }
+        for (auto source = std::lower_bound(it->begin(), it->end(), firstSource);
+             source != it->end() && *source <= lastSource; ++source) {
+            f(*source);
+        }
+        return;
+    }
+
+    if (targetNumber < 0 || targetNumber >= m_targetCount) {
+        return;
+    }
+    firstSource = std::max(firstSource, 0);
+    lastSource = std::min(lastSource, m_sourceCount - 1);
+    const quint64 *row = m_bits.data() + size_t(targetNumber) * m_wordsPerTarget;
+    for (int i = firstSource / 64; i <= lastSource / 64 && firstSource <= lastSource; ++i) {
+        quint64 word = row[i];
+        if (i == firstSource / 64) {
+            word &= ~quint64(0) << (firstSource % 64);
+        }
+        if (i == lastSource / 64 && lastSource % 64 != 63) {
+            word &= (quint64(1) << (lastSource % 64 + 1)) - 1;
+        }
+        for (; word != 0; word &= word - 1) {
+            f(i * 64 + int(qCountTrailingZeroBits(word)));
+        }
+    }
+}
+
 
 class MatrixModel : public QObject
 {
@@ -25,8 +120,11 @@ public:
     
     void setTargetNumbers(const QList<int> &numbers);
     void setSourceNumbers(const QList<int> &numbers);
-    void setTargetLabel(int targetNumber, const QString &label);
-    void setSourceLabel(int sourceNumber, const QString &label);
+    // isLabel is false for the "Target N" stand-ins, which never replace a received label
+    void setTargetLabel(int targetNumber, const QString &label, bool isLabel = true);
+    void setSourceLabel(int sourceNumber, const QString &label, bool isLabel = true);
+    bool hasTargetLabel(int targetNumber) const { return m_receivedTargetLabels.contains(targetNumber); }
+    bool hasSourceLabel(int sourceNumber) const { return m_receivedSourceLabels.contains(sourceNumber); }
     
     // Batch update optimization - defer widget repaints during bulk operations
     void setUpdatesDeferred(bool deferred);
@@ -56,9 +154,12 @@ public:
     bool isConnected(int targetNumber, int sourceNumber) const;
     int connectionDisposition(int targetNumber, int sourceNumber) const;
     QList<QPair<int, int>> getAllConnections() const;
+    const ConnectionStore& connectionStore() const { return m_connections; }
 
 signals:
     void dataChanged();
+    // Also emitted during batch updates, so labels show up while the rest are still loading
+    void labelsChanged();
     void connectionChanged(int targetNumber, int sourceNumber, bool connected);
 
 private:
@@ -77,13 +178,11 @@ private:
     QSet<int> m_sourceNumbersSet;  // Fast O(1) lookups
     QHash<int, QString> m_targetLabels;
     QHash<int, QString> m_sourceLabels;
+    QSet<int> m_receivedTargetLabels;
+    QSet<int> m_receivedSourceLabels;
 
     
-    struct ConnectionState {
-        bool connected;
-        int disposition;
-    };
-    QHash<QPair<int, int>, ConnectionState> m_connections;
+    ConnectionStore m_connections;
     
     // Batch update optimization
     bool m_updatesDeferred;
@@ -92,12 +191,6 @@ private:
     void emitDataChangedIfNotDeferred();
 };
 
-
-inline uint qHash(const QPair<int, int> &key, uint seed = 0)
-{
-    return qHash(key.first, seed) ^ qHash(key.second, seed);
-}
-
 #endif 
 
 
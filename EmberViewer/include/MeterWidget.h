@@ -42,6 +42,8 @@ public:
     
     int streamIdentifier() const { return m_streamIdentifier; }
     void setStreamIdentifier(int id) { m_streamIdentifier = id; }
+    int streamOffset() const { return m_streamOffset; }
+    void setStreamOffset(int offset) { m_streamOffset = offset; }
     
     
     void setCustomThresholds(double greenThreshold, double yellowThreshold);
@@ -50,6 +52,9 @@ public:
     
     
     QString parameterPath() const { return m_parameterPath; }
+    
+    // Rise and fall time constants in seconds; shared with the stream dashboard
+    static void getMeterConstants(MeterType type, double &riseTime, double &fallTime);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -66,7 +71,6 @@ private:
     double normalizeValue(double value) const;
     QColor getColorForLevel(double normalizedLevel) const;
     QString formatValue(double value) const;
-    void getMeterConstants(MeterType type, double &riseTime, double &fallTime) const;
     void getColorZones(MeterType type, double &greenThreshold, double &yellowThreshold) const;
     void setMeterTypeByIndex(int comboIndex);  
     
@@ -82,6 +86,7 @@ private:
     QString m_format;           
     QString m_referenceLevel;   
     int m_streamIdentifier;
+    int m_streamOffset;
     double m_minValue;
     double m_maxValue;
     
@@ -10,7 +10,6 @@
 #define PARAMETERDELEGATE_H
 
 #include <QStyledItemDelegate>
-#include <QTreeWidget>
 
 class ParameterDelegate : public QStyledItemDelegate
 {
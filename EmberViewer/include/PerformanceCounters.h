@@ -0,0 +1,100 @@
+#ifndef PERFORMANCECOUNTERS_H
+#define PERFORMANCECOUNTERS_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+// Process wide hot-path counters, timers and gauges.
+//
+// Everything is a relaxed atomic so the I/O thread and the GUI thread can
+// record without locking; recording costs one or two atomic adds. Readers
+// take a snapshot and derive rates from the difference between two of them.
+class PerformanceCounters
+{
+public:
+    enum Counter {
+        BytesIn,
+        BytesOut,
+        FramesIn,
+        FramesOut,
+        RootsDecoded,
+        ElementsDecoded,
+        BatchesDispatched,
+        TreeUpdatesApplied,
+        TreeUpdatesCollapsed,   // Replaced by a newer update before the tree refresh
+        CounterCount
+    };
+
+    enum Timer {
+        DecodeMessage,          // Glow decode of one S101 message on the I/O thread
+        DispatchBatch,          // EmberConnection handling one batch on the GUI thread
+        ApplyTree,              // One coalesced tree refresh
+        TimerCount
+    };
+
+    enum Gauge {
+        PendingBatches,         // Batches emitted by the I/O thread and not yet applied
+        PendingTreeUpdates,     // Parameter updates waiting for the next tree refresh
+        GaugeCount
+    };
+
+    struct TimerValue {
+        quint64 count = 0;
+        quint64 totalNs = 0;
+        quint64 maxNs = 0;      // Since the previous snapshot
+    };
+
+    struct Snapshot {
+        qint64 timestampMs = 0;
+        quint64 counters[CounterCount] = {};
+        TimerValue timers[TimerCount];
+        qint64 gauges[GaugeCount] = {};
+    };
+
+    static void add(Counter counter, quint64 amount = 1)
+    {
+        s_counters[counter].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    static void record(Timer timer, qint64 nsecs);
+
+    static void set(Gauge gauge, qint64 value)
+    {
+        s_gauges[gauge].store(value, std::memory_order_relaxed);
+    }
+
+    // Also restarts the per-interval timer maxima
+    static Snapshot snapshot();
+    static void reset();
+
+    static QString name(Counter counter);
+    static QString name(Timer timer);
+    static QString name(Gauge gauge);
+
+    // Records the lifetime of the scope into a timer
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Timer timer) : m_timer(timer) { m_elapsed.start(); }
+        ~ScopedTimer() { record(m_timer, m_elapsed.nsecsElapsed()); }
+
+    private:
+        Timer m_timer;
+        QElapsedTimer m_elapsed;
+    };
+
+private:
+    struct AtomicTimer {
+        std::atomic<quint64> count{0};
+        std::atomic<quint64> totalNs{0};
+        std::atomic<quint64> maxNs{0};
+    };
+
+    static std::atomic<quint64> s_counters[CounterCount];
+    static AtomicTimer s_timers[TimerCount];
+    static std::atomic<qint64> s_gauges[GaugeCount];
+};
+
+#endif
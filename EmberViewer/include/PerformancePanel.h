@@ -0,0 +1,53 @@
+#ifndef PERFORMANCEPANEL_H
+#define PERFORMANCEPANEL_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QVector>
+#include <QStringList>
+#include "PerformanceCounters.h"
+
+class QTableWidget;
+
+// Live view of PerformanceCounters.
+//
+// Samples the counters once per SAMPLE_INTERVAL_MS and shows rates per second,
+// average and worst timings of the last interval and current queue depths.
+// Every sample is kept, up to HISTORY_LIMIT of them, for CSV export.
+class PerformancePanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PerformancePanel(QWidget *parent = nullptr);
+
+    QStringList csvHeader() const;
+    QString toCsv() const;
+    int sampleCount() const { return m_history.size(); }
+
+    static constexpr int SAMPLE_INTERVAL_MS = 1000;
+    static constexpr int HISTORY_LIMIT = 3600;
+
+public slots:
+    void reset();
+    void exportCsv();
+
+private slots:
+    void sample();
+
+private:
+    struct Sample {
+        qint64 timestampMs;
+        QVector<double> values;     // One per csvHeader() column after the timestamp
+    };
+
+    void setRow(int row, const QString &current, const QString &peak, const QString &total);
+
+    QTableWidget *m_table;
+    QTimer *m_sampleTimer;
+    PerformanceCounters::Snapshot m_previous;
+    QVector<double> m_peaks;        // Per table row
+    QVector<Sample> m_history;
+};
+
+#endif
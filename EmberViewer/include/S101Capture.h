@@ -0,0 +1,75 @@
+#ifndef S101CAPTURE_H
+#define S101CAPTURE_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+// One chunk of a recorded S101 session: raw socket bytes as read or written.
+struct S101CaptureRecord {
+    enum Direction : quint8 {
+        Inbound = 0,
+        Outbound = 1
+    };
+
+    Direction direction = Inbound;
+    qint64 timestampUs = 0;         // Since the start of the recording
+    QByteArray data;
+};
+
+// Capture file layout, QDataStream encoded:
+//   magic, version, recording start (ms since epoch)
+//   per record: direction, microseconds since the previous record, bytes
+// Records are appended as they happen, so a capture cut short by a crash
+// is still readable up to its last complete record.
+class S101CaptureWriter
+{
+public:
+    S101CaptureWriter() = default;
+    ~S101CaptureWriter();
+
+    bool open(const QString &filePath);
+    bool isOpen() const { return m_file.isOpen(); }
+    void append(S101CaptureRecord::Direction direction, const QByteArray &data);
+    void close();
+
+    QString fileName() const { return m_file.fileName(); }
+    QString errorString() const { return m_file.errorString(); }
+    qint64 recordCount() const { return m_recordCount; }
+
+    static constexpr quint32 FILE_MAGIC = 0x45564350;   // "EVCP"
+    static constexpr quint16 FILE_VERSION = 1;
+
+private:
+    QFile m_file;
+    QDataStream m_stream;
+    QElapsedTimer m_clock;
+    qint64 m_lastUs = 0;
+    qint64 m_recordCount = 0;
+};
+
+class S101CaptureReader
+{
+public:
+    bool open(const QString &filePath);
+    // False at the end of the capture or at the first truncated record
+    bool readNext(S101CaptureRecord &record);
+
+    qint64 startedAtMs() const { return m_startedAtMs; }
+    QString errorString() const { return m_error; }
+
+    // The whole capture, empty with errorString set when it cannot be read
+    static QVector<S101CaptureRecord> readAll(const QString &filePath, QString *errorString = nullptr);
+
+private:
+    QFile m_file;
+    QDataStream m_stream;
+    qint64 m_startedAtMs = 0;
+    qint64 m_timestampUs = 0;
+    QString m_error;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef S101REPLAYSERVER_H
+#define S101REPLAYSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QVector>
+#include "S101Capture.h"
+#include "S101Replayer.h"
+
+// Serves a recorded session to whoever connects: every client gets the
+// inbound side of the capture from the start, with its own replayer. What
+// clients send is ignored, so the consumer sees exactly the recorded device.
+class S101ReplayServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit S101ReplayServer(QObject *parent = nullptr);
+    ~S101ReplayServer();
+
+    bool load(const QString &filePath, QString *errorString = nullptr);
+    bool listen(quint16 port, S101Replayer::Timing timing, double speed = 1.0);
+    void close();
+
+    bool isListening() const { return m_server->isListening(); }
+    quint16 serverPort() const { return m_server->serverPort(); }
+    QString errorString() const { return m_server->errorString(); }
+    int chunkCount() const { return int(m_records.size()); }
+
+    // Replay pauses while this much is still queued on a slow client's socket
+    static constexpr qint64 MAX_PENDING_BYTES = 1024 * 1024;
+
+signals:
+    void clientConnected(const QString &address);
+    void clientFinished(const QString &address);
+
+private slots:
+    void onNewConnection();
+
+private:
+    QTcpServer *m_server;
+    QVector<S101CaptureRecord> m_records;
+    S101Replayer::Timing m_timing;
+    double m_speed;
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef S101REPLAYER_H
+#define S101REPLAYER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVector>
+#include "S101Capture.h"
+
+// Plays back the inbound side of an S101 capture.
+//
+// decode() pushes every chunk through S101Protocol and GlowParser on the
+// calling thread and measures it, for decode benchmarks. start() emits the
+// chunks as dataReady() either at their recorded pace or as fast as the event
+// loop allows, for feeding a socket or any other consumer.
+class S101Replayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Timing {
+        AsFastAsPossible,
+        OriginalTiming
+    };
+
+    struct DecodeStats {
+        qint64 bytes = 0;
+        qint64 messages = 0;
+        qint64 elements = 0;
+        qint64 streamValues = 0;
+        qint64 elapsedNs = 0;
+        int errors = 0;
+    };
+
+    explicit S101Replayer(QObject *parent = nullptr);
+
+    // Outbound records are dropped, only what the device sent is replayed
+    void setRecords(const QVector<S101CaptureRecord> &records);
+    int chunkCount() const { return int(m_records.size()); }
+    qint64 durationUs() const;
+
+    DecodeStats decode() const;
+
+    // speed scales OriginalTiming, 2.0 plays twice as fast
+    void start(Timing timing, double speed = 1.0);
+    void stop();
+    bool isRunning() const { return m_timer->isActive() || m_paused; }
+
+    // Lets a consumer apply backpressure; time spent paused is not caught up afterwards
+    void setPaused(bool paused);
+
+    static constexpr int FAST_CHUNKS_PER_SLICE = 64;
+
+signals:
+    void dataReady(const QByteArray &data);
+    void finished();
+
+private slots:
+    void emitDue();
+
+private:
+    qint64 dueUs(int index) const;
+
+    QVector<S101CaptureRecord> m_records;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    Timing m_timing;
+    double m_speed;
+    int m_next;
+    qint64 m_offsetUs;          // Subtracted from the clock to skip paused time
+    qint64 m_pausedAtUs;
+    bool m_paused;
+};
+
+#endif
@@ -13,12 +13,12 @@
 
 #include <QObject>
 #include <QProgressDialog>
-#include <QTreeWidget>
 #include <QLineEdit>
 #include <QSpinBox>
 #include <QMap>
 
 class EmberConnection;
+class EmberTreeModel;
 class DeviceSnapshot;
 class MatrixManager;
 class FunctionInvoker;
@@ -28,7 +28,7 @@ class SnapshotManager : public QObject
     Q_OBJECT
 
 public:
-    explicit SnapshotManager(QTreeWidget* treeWidget,
+    explicit SnapshotManager(EmberTreeModel* treeModel,
                             EmberConnection* connection,
                             MatrixManager* matrixManager,
                             FunctionInvoker* functionInvoker,
@@ -54,7 +54,7 @@ private:
     void proceedWithSnapshot(QLineEdit* hostEdit, QSpinBox* portSpin);
     QString generateDefaultFilename(const QString& deviceName);
     
-    QTreeWidget* m_treeWidget;
+    EmberTreeModel* m_treeModel;
     EmberConnection* m_connection;
     MatrixManager* m_matrixManager;
     FunctionInvoker* m_functionInvoker;
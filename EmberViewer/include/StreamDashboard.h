@@ -0,0 +1,95 @@
+#ifndef STREAMDASHBOARD_H
+#define STREAMDASHBOARD_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include "MeterWidget.h"
+#include "EmberDataTypes.h"
+
+// Grid of compact level meters fed straight from stream values.
+//
+// Meter state is kept as parallel arrays indexed by meter, so one shared
+// animation tick advances the ballistics of every meter in a single pass and
+// only repaints the cells whose drawn level or peak actually moved.
+class StreamDashboard : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StreamDashboard(QWidget *parent = nullptr);
+
+    // Returns the meter index; a stream already on the dashboard keeps its meter
+    int addMeter(const QString &path, const QString &label, int streamIdentifier, int streamOffset,
+                 double minValue, double maxValue);
+    bool removeMeter(const QString &path);
+    bool hasMeter(const QString &path) const;
+    void clear();
+    int meterCount() const { return m_paths.size(); }
+    QStringList meterPaths() const { return m_paths; }
+
+    void setMeterType(MeterWidget::MeterType type);
+    MeterWidget::MeterType meterType() const { return m_meterType; }
+
+    // O(1) dispatch through the stream key table; unknown streams are ignored
+    void updateStreamValues(const QVector<EmberData::StreamValue> &values);
+
+    bool hasHeightForWidth() const override { return true; }
+    int heightForWidth(int width) const override;
+    QSize sizeHint() const override;
+
+signals:
+    void meterRemoveRequested(const QString &path);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void onAnimationTick();
+
+private:
+    int columnCount() const;
+    int meterAt(const QPoint &pos) const;
+    QRect meterRect(int index) const;
+    int levelPixels(int index, double value) const;
+    void startAnimation();
+
+    // Struct of arrays, one entry per meter
+    QVector<QString> m_paths;
+    QVector<QString> m_labels;
+    QVector<quint64> m_streamKeys;      // EmberData::streamKey of identifier and offset
+    QVector<double> m_minValues;
+    QVector<double> m_ranges;           // max - min, never zero
+    QVector<double> m_targetValues;
+    QVector<double> m_displayValues;
+    QVector<double> m_peakValues;
+    QVector<qint64> m_peakExpiry;       // Animation clock ms, 0 when no peak is held
+    QVector<int> m_drawnLevels;         // Bar height in pixels at the last repaint
+    QVector<int> m_drawnPeaks;
+
+    QHash<quint64, int> m_streamToMeter;    // Stream key -> meter index
+    QHash<QString, int> m_pathToMeter;
+
+    MeterWidget::MeterType m_meterType;
+    double m_riseTime;
+    double m_fallTime;
+
+    QTimer *m_animationTimer;
+    QElapsedTimer m_clock;
+    qint64 m_lastTick;
+
+    static constexpr int CELL_WIDTH = 44;
+    static constexpr int CELL_HEIGHT = 180;
+    static constexpr int BAR_WIDTH = 14;
+    static constexpr int LABEL_HEIGHT = 16;
+    static constexpr int FRAME_INTERVAL_MS = 16;
+    static constexpr int PEAK_HOLD_MS = 2000;
+};
+
+#endif
@@ -1,27 +1,25 @@
-
-
-
-
-
-
-
-
-
-
-
 #ifndef SUBSCRIPTIONMANAGER_H
 #define SUBSCRIPTIONMANAGER_H
 
 #include <QObject>
 #include <QSet>
-#include <QMap>
+#include <QHash>
 #include <QString>
-#include <QDateTime>
-#include <QTreeWidgetItem>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QModelIndex>
+#include "EmberPath.h"
 
 class EmberConnection;
-class QTreeWidget;
-
+class QTreeView;
+
+// Reference counted device subscriptions.
+//
+// Everything that shows live values holds a reference on its path: the rows
+// visible in the tree, the open meter or graph, matrix views and the stream
+// dashboard. A path is subscribed while it has references and unsubscribed
+// UNSUBSCRIBE_DELAY_MS after the last one is released, so scrolling back and
+// forth does not churn. Both directions go out in batches.
 class SubscriptionManager : public QObject
 {
     Q_OBJECT
@@ -30,25 +28,56 @@ public:
     explicit SubscriptionManager(EmberConnection *connection, QObject *parent = nullptr);
     ~SubscriptionManager();
 
-    
+    void acquire(const QString &path, const QString &type);
+    void release(const QString &path);
+    int refCount(const QString &path) const;
+
     bool isSubscribed(const QString &path) const;
     void clear();
 
+    // Rows scrolled into view hold a reference while they stay visible
+    void setTreeView(QTreeView *treeView);
+
 public slots:
-    
-    void onItemExpanded(QTreeWidgetItem *item);
-    void onItemCollapsed(QTreeWidgetItem *item);
-    void subscribeToExpandedItems(QTreeWidget *treeWidget);
+
+    void onItemExpanded(const QModelIndex &index);
+    void onItemCollapsed(const QModelIndex &index);
+    void subscribeToExpandedItems(QTreeView *treeView);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void flushPending();
+    void updateVisibleItems();
 
 private:
-    struct SubscriptionState {
-        QDateTime subscribedAt;
-        bool autoSubscribed;
+    struct Subscription {
+        QString path;
+        QString type;
+        int refs = 0;
+        bool subscribed = false;
+        qint64 releasedAt = 0;      // m_clock ms when refs dropped to zero
     };
 
+    void acquire(EmberPath key, const QString &path, const QString &type);
+    void release(EmberPath key);
+    void scheduleVisibilityUpdate();
+    void scheduleFlush();
+
     EmberConnection *m_connection;
-    QSet<QString> m_subscribedPaths;
-    QMap<QString, SubscriptionState> m_subscriptionStates;
+    QTreeView *m_treeView;
+    QHash<EmberPath, Subscription> m_subscriptions;
+    QSet<EmberPath> m_pendingSubscribe;
+    QSet<EmberPath> m_pendingUnsubscribe;       // Zero references, waiting out the delay
+    QSet<EmberPath> m_visibleItems;             // Tree rows holding a reference
+    QTimer *m_flushTimer;
+    QTimer *m_visibilityTimer;
+    QElapsedTimer m_clock;
+
+    static constexpr int FLUSH_DELAY_MS = 20;
+    static constexpr int VISIBILITY_DELAY_MS = 100;
+    static constexpr int UNSUBSCRIBE_DELAY_MS = 5000;
 };
 
-#endif 
+#endif
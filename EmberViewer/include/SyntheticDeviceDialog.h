@@ -0,0 +1,49 @@
+#ifndef SYNTHETICDEVICEDIALOG_H
+#define SYNTHETICDEVICEDIALOG_H
+
+#include <QDialog>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSpinBox>
+#include "SyntheticDeviceGenerator.h"
+
+// Collects SyntheticDeviceGenerator options for the emulator and shows how
+// many elements they produce before anything is generated.
+class SyntheticDeviceDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SyntheticDeviceDialog(QWidget *parent = nullptr);
+
+    SyntheticDeviceGenerator::Options options() const;
+
+private:
+    void setupUi();
+    void updateElementCount();
+
+    QLineEdit *m_nameEdit;
+    QSpinBox *m_depthSpin;
+    QSpinBox *m_fanOutSpin;
+    QSpinBox *m_parametersSpin;
+    QCheckBox *m_integerCheck;
+    QCheckBox *m_realCheck;
+    QCheckBox *m_stringCheck;
+    QCheckBox *m_booleanCheck;
+    QCheckBox *m_enumCheck;
+    QSpinBox *m_enumSizeSpin;
+    QSpinBox *m_matrixCountSpin;
+    QComboBox *m_matrixTypeCombo;
+    QSpinBox *m_targetsSpin;
+    QSpinBox *m_sourcesSpin;
+    QDoubleSpinBox *m_densitySpin;
+    QSpinBox *m_streamCountSpin;
+    QLineEdit *m_streamRatesEdit;
+    QSpinBox *m_seedSpin;
+    QLabel *m_elementCountLabel;
+};
+
+#endif
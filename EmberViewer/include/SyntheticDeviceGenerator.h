@@ -0,0 +1,49 @@
+#ifndef SYNTHETICDEVICEGENERATOR_H
+#define SYNTHETICDEVICEGENERATOR_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include "DeviceSnapshot.h"
+
+// Builds devices of any size and shape for the emulator, so consumers can be
+// load tested without hardware. The same options and seed always give the
+// same device.
+//
+// Layout below the root node 1:
+//   1.1 .. 1.fanOut          node tree, depth levels deep, parameters on the leaves
+//   1.(fanOut + 1)           "routing", the matrices
+//   1.(fanOut + 2)           "meters", one Integer parameter per stream
+class SyntheticDeviceGenerator
+{
+public:
+    struct Options {
+        QString deviceName = "Synthetic Device";
+        int depth = 3;                  // Node levels below the root node
+        int fanOut = 8;                 // Child nodes per node
+        int parametersPerNode = 16;     // On every leaf node
+        QList<int> parameterTypes = {1, 2, 3, 4, 6};   // Ember+ ParameterType values, cycled through
+        int enumSize = 8;
+        int matrixCount = 0;
+        int matrixType = 0;             // Ember+ MatrixType: 0 oneToN, 1 oneToOne, 2 nToN
+        int matrixTargets = 64;
+        int matrixSources = 64;
+        double connectionDensity = 0.1; // Share of targets connected, of crosspoints for nToN
+        int streamCount = 0;
+        QList<int> streamRatesHz = {100};   // Cycled through, one rate per stream
+        quint32 seed = 1;
+    };
+
+    static DeviceSnapshot generate(const Options &options);
+
+    // Stream identifier to rate, for EmberProvider::setStreamRates
+    static QMap<int, int> streamRates(const Options &options);
+
+    // Nodes, parameters and matrices the options produce, without generating them
+    static qint64 elementCount(const Options &options);
+
+    static constexpr int STREAM_MINIMUM = -60;
+    static constexpr int STREAM_MAXIMUM = 0;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef TIMESERIESBUFFER_H
+#define TIMESERIESBUFFER_H
+
+#include <QVector>
+#include <QPointF>
+#include <deque>
+
+// Fixed-capacity ring of (timestamp, value) samples with O(1) amortized
+// min/avg/max. Timestamps must be non-decreasing; when the ring is full the
+// oldest sample is dropped to make room.
+class TimeSeriesBuffer
+{
+public:
+    explicit TimeSeriesBuffer(int capacity = DEFAULT_CAPACITY);
+
+    void append(qint64 timestamp, double value);
+    void removeOlderThan(qint64 cutoff);
+    void clear();
+
+    int size() const { return m_count; }
+    int capacity() const { return m_timestamps.size(); }
+    bool isEmpty() const { return m_count == 0; }
+
+    // Index 0 is the oldest sample
+    qint64 timestampAt(int index) const { return m_timestamps[physicalIndex(index)]; }
+    double valueAt(int index) const { return m_values[physicalIndex(index)]; }
+
+    double minimum() const;
+    double maximum() const;
+    double average() const;
+
+    // Index of the first sample at or after timestamp, size() if there is none
+    int lowerBound(qint64 timestamp) const;
+
+    // Polyline of the samples in [start, start + span) scaled to width pixel
+    // columns, keeping the first, lowest, highest and last value of each column
+    // so spikes survive decimation. x is the column, y the raw value.
+    QVector<QPointF> decimate(qint64 start, qint64 span, int width) const;
+
+    static constexpr int DEFAULT_CAPACITY = 65536;
+
+private:
+    int physicalIndex(int index) const { return (m_head + index) % m_timestamps.size(); }
+    double valueAtSequence(quint64 sequence) const;
+    void removeFirst();
+
+    QVector<qint64> m_timestamps;
+    QVector<double> m_values;
+    int m_head;
+    int m_count;
+
+    // Samples are numbered by a running sequence so the deques stay valid as the ring wraps
+    quint64 m_firstSequence;
+    std::deque<quint64> m_minQueue;     // Increasing values, front is the minimum
+    std::deque<quint64> m_maxQueue;     // Decreasing values, front is the maximum
+
+    double m_sum;
+    int m_removedSinceResync;           // Re-summed once per capacity removals to bound drift
+};
+
+#endif
@@ -14,11 +14,23 @@
 
 #include <QObject>
 #include <QSet>
+#include <QHash>
+#include <QQueue>
 #include <QString>
 #include <QStringList>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <functional>
 
+// Walks a complete device tree with GetDirectory requests.
+// Outstanding requests are pipelined in a window that grows additively while the
+// measured response time stays near its minimum and halves when responses start
+// queueing up, so the fetch runs as fast as the device and link allow. Several
+// paths share one Glow message, and the queue is advanced as soon as responses
+// arrive instead of on a fixed timer. A request that times out is sent once
+// more; a path that stays silent after that is counted as answered without
+// children, since providers do not reply to GetDirectory on empty nodes.
+// Timeouts never shrink the window, only rising response times do.
 class TreeFetchService : public QObject
 {
     Q_OBJECT
@@ -38,12 +50,18 @@ public:
     bool isActive() const { return m_active; }
     
     
-    void onNodeReceived(const QString &nodePath);
+    // Every decoded element is reported; nodes are queued for fetching and any element
+    // completes the outstanding request for itself or its parent
+    void onElementReceived(const QString &path, bool isNode);
     
     
+    // Sends one GetDirectory message for all given paths (an empty path is the root)
+    void setSendGetDirectoryCallback(std::function<void(const QStringList&)> callback);
     
-    
-    void setSendGetDirectoryCallback(std::function<void(const QString&, bool)> callback);
+    int windowSize() const { return static_cast<int>(m_window); }
+    int silentCount() const { return m_silentPaths.size(); }
+    const QSet<QString> &silentPaths() const { return m_silentPaths; }
+    double smoothedRttMs() const { return m_smoothedRttUs / 1000.0; }
 
 signals:
     
@@ -51,23 +69,51 @@ signals:
     
     
     void fetchCompleted(bool success, const QString &message);
+    
+    // Time from sending a GetDirectory to the first element answering it
+    void requestCompleted(qint64 responseTimeUs);
 
 private slots:
     void processQueue();
+    void onRequestTimeout();
 
 private:
+    void schedule();
+    void completeRequest(const QString &path);
+    void adaptWindow(qint64 rttUs);
+    void armTimeout();
+    void finish();
+
     bool m_active;
+    bool m_processScheduled;
+    QQueue<QString> m_pendingQueue;        // Breadth first order
     QSet<QString> m_pendingPaths;    
     QSet<QString> m_completedPaths;  
-    QSet<QString> m_activePaths;     
+    QSet<QString> m_retriedPaths;          // Timed out once and sent again
+    QSet<QString> m_silentPaths;           // Timed out again after the retry, counted as empty
+    QHash<QString, qint64> m_activePaths;  // Path -> send time in microseconds
     int m_totalEstimate;             
     
-    QTimer *m_timer;                 
-    
-    std::function<void(const QString&, bool)> m_sendCallback;
-    
-    static constexpr int MAX_PARALLEL_REQUESTS = 5;
-    static constexpr int QUEUE_PROCESS_INTERVAL_MS = 50;
+    double m_window;
+    bool m_slowStart;
+    qint64 m_minRttUs;
+    qint64 m_smoothedRttUs;
+    qint64 m_lastDecreaseUs;
+    int m_completedSinceReport;
+    
+    QElapsedTimer m_clock;
+    QTimer *m_timeoutTimer;                 
+    
+    std::function<void(const QStringList&)> m_sendCallback;
+    
+    static constexpr int INITIAL_WINDOW = 8;
+    static constexpr int MIN_WINDOW = 2;
+    static constexpr int MAX_WINDOW = 256;
+    static constexpr int MAX_PATHS_PER_MESSAGE = 32;
+    // Responses slower than this multiple of the fastest one indicate queueing
+    static constexpr double CONGESTION_RTT_FACTOR = 3.0;
+    static constexpr qint64 MIN_REQUEST_TIMEOUT_US = 2000000;
+    static constexpr int REQUEST_TIMEOUT_RTT_FACTOR = 8;
 };
 
 #endif 
@@ -13,36 +13,43 @@
 #define TREEVIEWCONTROLLER_H
 
 #include <QObject>
-#include <QTreeWidgetItem>
-#include <QMap>
+#include <QModelIndex>
+#include <QHash>
 #include <QSet>
 #include <QString>
 #include <QVariant>
 #include <QStringList>
 #include <QTimer>
+#include <QVector>
+#include "EmberDataTypes.h"
+#include "EmberPath.h"
+#include "ElementStore.h"
 
-class QTreeWidget;
 class EmberConnection;
+class EmberTreeModel;
 
 class TreeViewController : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit TreeViewController(QTreeWidget *treeWidget, EmberConnection *connection, QObject *parent = nullptr);
+    explicit TreeViewController(EmberTreeModel *model, EmberConnection *connection, QObject *parent = nullptr);
     ~TreeViewController();
 
     
-    QTreeWidgetItem* findTreeItem(const QString &path) const;
+    QModelIndex indexForPath(const QString &path) const;
     QStringList getAllTreeItemPaths() const;
     bool hasPathBeenFetched(const QString &path) const;
     void markPathAsFetched(const QString &path);
     void clear();
 
+    // Value updates for existing parameters are coalesced per path and applied once per frame
+    void flushPendingParameterUpdates();
+
 signals:
     
-    void matrixItemCreated(const QString &path, QTreeWidgetItem *item);
-    void functionItemCreated(const QString &path, QTreeWidgetItem *item);
+    void matrixItemCreated(const QString &path);
+    void functionItemCreated(const QString &path);
 
 public slots:
     
@@ -50,42 +57,48 @@ public slots:
     void onParameterReceived(const QString &path, int number, const QString &identifier, const QString &description, const QString &value, 
                             int access, int type, const QVariant &minimum, const QVariant &maximum,
                             const QStringList &enumOptions, const QList<int> &enumValues, bool isOnline, int streamIdentifier,
-                                const QString &format, const QString &referenceLevel, const QString &formula, int factor);
+                                const QString &format, const QString &referenceLevel, const QString &formula, int factor,
+                                int streamOffset = 0);
     void onMatrixReceived(const QString &path, int number, const QString &identifier, const QString &description,
                          int type, int targetCount, int sourceCount);
     void onFunctionReceived(const QString &path, const QString &identifier, const QString &description,
                            const QStringList &argNames, const QList<int> &argTypes,
                            const QStringList &resultNames, const QList<int> &resultTypes);
 
-    
-    void onItemExpanded(QTreeWidgetItem *item);
+    void onNodesReceived(const QVector<EmberData::NodeInfo> &nodes);
+    void onParametersReceived(const QVector<EmberData::ParameterInfo> &parameters);
+
+    // EmberTreeModel asks for the children of an expanded node or matrix
+    void onFetchRequested(const QString &path);
+
+    // Elements the device no longer has, with everything below them
+    void onElementsRemoved(const QStringList &paths);
 
 private slots:
     void processPendingMatrixDetailRequests();
+    void onParameterUpdateTimer();
 
 private:
-    QTreeWidgetItem* findOrCreateTreeItem(const QString &path);
-    void setItemDisplayName(QTreeWidgetItem *item, const QString &baseName);
+    bool isNewElement(EmberPath path) const;
+    ElementStore::Kind kindOf(EmberPath path) const;
 
-    QTreeWidget *m_treeWidget;
+    EmberTreeModel *m_model;
     EmberConnection *m_connection;
     
     
-    QMap<QString, QTreeWidgetItem*> m_pathToItem;
-    
-    
-    QSet<QString> m_fetchedPaths;
-    
-    
-    int m_itemsAddedSinceUpdate;
+    QSet<EmberPath> m_fetchedPaths;
     
     // Batching for matrix detail requests
     QStringList m_pendingMatrixDetailPaths;
     QTimer *m_matrixDetailBatchTimer;
     
-    static constexpr int UPDATE_BATCH_SIZE = 100;
+    // Latest update per path, applied on the next frame tick
+    QHash<EmberPath, EmberData::ParameterInfo> m_pendingParameterUpdates;
+    QTimer *m_parameterUpdateTimer;
+    
     static constexpr int MATRIX_LABEL_PATH_MARKER = 666999666;
     static constexpr int MATRIX_DETAIL_BATCH_DELAY_MS = 50;
+    static constexpr int PARAMETER_UPDATE_INTERVAL_MS = 16;
 };
 
 #endif 
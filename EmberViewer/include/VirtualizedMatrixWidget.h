@@ -7,6 +7,8 @@
 #include <QPoint>
 #include <QSize>
 #include <QPushButton>
+#include <QPixmap>
+#include <QHash>
 #include "MatrixModel.h"
 
 class QLabel;
@@ -29,8 +31,10 @@ public:
     void setMatrixInfo(const QString &identifier, const QString &description,
                        int type, int targetCount, int sourceCount);
     void setMatrixPath(const QString &path);
-    void setTargetLabel(int targetNumber, const QString &label);
-    void setSourceLabel(int sourceNumber, const QString &label);
+    void setTargetLabel(int targetNumber, const QString &label, bool isLabel = true);
+    void setSourceLabel(int sourceNumber, const QString &label, bool isLabel = true);
+    bool hasTargetLabel(int targetNumber) const { return m_model && m_model->hasTargetLabel(targetNumber); }
+    bool hasSourceLabel(int sourceNumber) const { return m_model && m_model->hasSourceLabel(sourceNumber); }
     void setConnection(int targetNumber, int sourceNumber, bool connected, int disposition = 0);
     void clearConnections();
     void clearTargetConnections(int targetNumber);
@@ -72,6 +76,8 @@ public:
     void setSelectedCell(int targetIndex, int sourceIndex);
     void clearSelection();
     QPoint selectedCell() const { return m_selectedCell; }
+    // Cell range between the selection anchor and the selected cell; dragging or shift-click extends it
+    QRect selectedRange() const;
 
     
     QPoint hoveredCell() const { return m_hoveredCell; }
@@ -85,8 +91,13 @@ signals:
     void selectionChanged(int targetNumber, int sourceNumber);
     
     void crosspointClicked(const QString &matrixPath, int targetNumber, int sourceNumber);
+    // Emitted instead of crosspointClicked when a multi-cell range is released; pairs are (target, source)
+    void crosspointsClicked(const QString &matrixPath, const QList<QPair<int, int>> &crosspoints);
     void enableCrosspointsRequested(bool enable);
     void crosspointToggleRequested();
+    // Inclusive indices into the target and source number lists currently on screen
+    void visibleRangeChanged(const QString &matrixPath, int firstTarget, int lastTarget,
+                             int firstSource, int lastSource);
 
 protected:
     
@@ -98,6 +109,7 @@ protected:
     void leaveEvent(QEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
+    void changeEvent(QEvent *event) override;
 
 private slots:
     void onModelDataChanged();
@@ -107,12 +119,16 @@ private:
     void updateScrollBars();
     void updateViewportSize();
     QRect visibleCellsRect() const;
-    void drawGrid(QPainter &painter, const QRect &visibleCells);
-    void drawConnections(QPainter &painter, const QRect &visibleCells);
+    void drawTiles(QPainter &painter, const QRect &visibleCells);
+    QPixmap renderTile(int tileColumn, int tileRow) const;
+    void invalidateTiles();
+    void ensureCellIndex();
     void drawSelection(QPainter &painter);
     void drawHover(QPainter &painter);
     void invalidateCellRegion(int row, int col);
     void invalidateCell(int targetNumber, int sourceNumber);
+    void emitSelectionClicked();
+    void reportVisibleRange(const QRect &visibleCells);
 
     MatrixModel *m_model;
 
@@ -123,6 +139,7 @@ private:
     
     
     QPoint m_selectedCell;      
+    QPoint m_selectionAnchor;
     QPoint m_hoveredCell;       
     bool m_isDragging;
     bool m_crosspointsEnabled;
@@ -134,6 +151,18 @@ private:
     
     
     QString m_matrixPath;
+    
+    // Grid and connections are rendered per tile of TILE_CELLS x TILE_CELLS cells and
+    // cached; a crosspoint change only drops the tile that contains it
+    QHash<quint64, QPixmap> m_tileCache;
+    QHash<int, int> m_targetColumns;    // Target number -> column
+    QHash<int, int> m_sourceRows;       // Source number -> row
+    bool m_cellIndexDirty;
+    QRect m_reportedVisibleCells;
+    
+    static constexpr int TILE_CELLS = 32;
+    static constexpr int MAX_CACHED_TILES = 256;
+    static constexpr int MAX_SELECTED_CROSSPOINTS = 4096;
 };
 
 #endif 
@@ -21,7 +21,7 @@ CacheManager::~CacheManager()
 }
 
 
-void CacheManager::cacheParameter(const QString &path, const QString &identifier, int access, int type)
+void CacheManager::cacheParameter(EmberPath path, const QString &identifier, int access, int type)
 {
     ParameterCache cache;
     cache.identifier = identifier;
@@ -30,12 +30,12 @@ void CacheManager::cacheParameter(const QString &path, const QString &identifier
     m_parameterCache[path] = cache;
 }
 
-CacheManager::ParameterCache CacheManager::getParameterCache(const QString &path) const
+CacheManager::ParameterCache CacheManager::getParameterCache(EmberPath path) const
 {
     return m_parameterCache.value(path);
 }
 
-bool CacheManager::hasParameterCache(const QString &path) const
+bool CacheManager::hasParameterCache(EmberPath path) const
 {
     return m_parameterCache.contains(path);
 }
@@ -46,7 +46,7 @@ void CacheManager::clearParameterCache()
 }
 
 
-void CacheManager::setRootNode(const QString &path, const QString &displayName, bool isGeneric, const QString &identityPath)
+void CacheManager::setRootNode(EmberPath path, const QString &displayName, bool isGeneric, EmberPath identityPath)
 {
     RootNodeInfo info;
     info.path = path;
@@ -56,34 +56,37 @@ void CacheManager::setRootNode(const QString &path, const QString &displayName,
     m_rootNodes[path] = info;
 }
 
-void CacheManager::updateRootNodeIdentityPath(const QString &path, const QString &identityPath)
+void CacheManager::updateRootNodeIdentityPath(EmberPath path, EmberPath identityPath)
 {
-    if (m_rootNodes.contains(path)) {
-        m_rootNodes[path].identityPath = identityPath;
+    auto it = m_rootNodes.find(path);
+    if (it != m_rootNodes.end()) {
+        it->identityPath = identityPath;
     }
 }
 
-void CacheManager::updateRootNodeDisplayName(const QString &path, const QString &displayName, bool isGeneric)
+void CacheManager::updateRootNodeDisplayName(EmberPath path, const QString &displayName, bool isGeneric)
 {
-    if (m_rootNodes.contains(path)) {
-        m_rootNodes[path].displayName = displayName;
-        m_rootNodes[path].isGeneric = isGeneric;
+    auto it = m_rootNodes.find(path);
+    if (it != m_rootNodes.end()) {
+        it->displayName = displayName;
+        it->isGeneric = isGeneric;
     }
 }
 
-CacheManager::RootNodeInfo CacheManager::getRootNode(const QString &path) const
+CacheManager::RootNodeInfo CacheManager::getRootNode(EmberPath path) const
 {
     return m_rootNodes.value(path);
 }
 
-bool CacheManager::hasRootNode(const QString &path) const
+bool CacheManager::hasRootNode(EmberPath path) const
 {
     return m_rootNodes.contains(path);
 }
 
-bool CacheManager::isRootNodeGeneric(const QString &path) const
+bool CacheManager::isRootNodeGeneric(EmberPath path) const
 {
-    return m_rootNodes.contains(path) && m_rootNodes[path].isGeneric;
+    auto it = m_rootNodes.constFind(path);
+    return it != m_rootNodes.constEnd() && it->isGeneric;
 }
 
 void CacheManager::clearRootNodes()
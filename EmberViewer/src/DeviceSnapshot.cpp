@@ -7,6 +7,7 @@
 
 
 #include "DeviceSnapshot.h"
+#include "MappedDeviceSnapshot.h"
 #include <QFile>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -78,6 +79,9 @@ QJsonObject ParameterData::toJson() const {
     if (streamIdentifier != -1) {
         obj["streamIdentifier"] = streamIdentifier;
     }
+    if (streamOffset != 0) {
+        obj["streamOffset"] = streamOffset;
+    }
     
     return obj;
 }
@@ -113,6 +117,7 @@ ParameterData ParameterData::fromJson(const QJsonObject& json) {
     if (json.contains("streamIdentifier")) {
         data.streamIdentifier = json["streamIdentifier"].toInt();
     }
+    data.streamOffset = json["streamOffset"].toInt(0);
     
     return data;
 }
@@ -346,7 +351,16 @@ QJsonDocument DeviceSnapshot::toJson() const {
     return QJsonDocument(root);
 }
 
-bool DeviceSnapshot::saveToFile(const QString& filePath) const {
+bool DeviceSnapshot::saveToFile(const QString& filePath, FileFormat format) const {
+    if (format == Binary) {
+        QString error;
+        if (!MappedDeviceSnapshot::write(*this, filePath, &error)) {
+            qWarning() << "Failed to write snapshot:" << filePath << error;
+            return false;
+        }
+        return true;
+    }
+    
     QFile file(filePath);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         qWarning() << "Failed to open file for writing:" << filePath;
@@ -411,6 +425,15 @@ DeviceSnapshot DeviceSnapshot::fromJson(const QJsonDocument& doc) {
 }
 
 DeviceSnapshot DeviceSnapshot::loadFromFile(const QString& filePath) {
+    if (MappedDeviceSnapshot::isBinarySnapshot(filePath)) {
+        MappedDeviceSnapshot mapped;
+        if (!mapped.open(filePath)) {
+            qWarning() << "Failed to open snapshot:" << mapped.errorString();
+            return DeviceSnapshot();
+        }
+        return mapped.toSnapshot();
+    }
+    
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         qWarning() << "Failed to open file for reading:" << filePath;
@@ -0,0 +1,354 @@
+#include "DeviceTreeCache.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QRegularExpression>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+void writeNode(QDataStream &out, const EmberData::NodeInfo &node)
+{
+    out << node.path << node.identifier << node.description << node.isOnline
+        << node.hasIdentifier << node.hasDescription;
+}
+
+void readNode(QDataStream &in, EmberData::NodeInfo &node)
+{
+    in >> node.path >> node.identifier >> node.description >> node.isOnline
+       >> node.hasIdentifier >> node.hasDescription;
+}
+
+void writeParameter(QDataStream &out, const EmberData::ParameterInfo &param)
+{
+    out << param.path << qint32(param.number) << param.identifier << param.description << param.value
+        << qint32(param.access) << qint32(param.type) << param.minimum << param.maximum
+        << param.enumOptions << param.enumValues << param.isOnline << qint32(param.streamIdentifier)
+        << param.format << param.referenceLevel << param.formula << qint32(param.factor)
+        << qint32(param.streamOffset);
+}
+
+void readParameter(QDataStream &in, EmberData::ParameterInfo &param)
+{
+    qint32 number, access, type, streamIdentifier, factor, streamOffset;
+    in >> param.path >> number >> param.identifier >> param.description >> param.value
+       >> access >> type >> param.minimum >> param.maximum
+       >> param.enumOptions >> param.enumValues >> param.isOnline >> streamIdentifier
+       >> param.format >> param.referenceLevel >> param.formula >> factor >> streamOffset;
+    param.number = number;
+    param.access = access;
+    param.type = type;
+    param.streamIdentifier = streamIdentifier;
+    param.factor = factor;
+    param.streamOffset = streamOffset;
+}
+
+void writeMatrix(QDataStream &out, const EmberData::MatrixInfo &matrix)
+{
+    out << matrix.path << qint32(matrix.number) << matrix.identifier << matrix.description
+        << qint32(matrix.type) << qint32(matrix.targetCount) << qint32(matrix.sourceCount);
+}
+
+void readMatrix(QDataStream &in, EmberData::MatrixInfo &matrix)
+{
+    qint32 number, type, targetCount, sourceCount;
+    in >> matrix.path >> number >> matrix.identifier >> matrix.description
+       >> type >> targetCount >> sourceCount;
+    matrix.number = number;
+    matrix.type = type;
+    matrix.targetCount = targetCount;
+    matrix.sourceCount = sourceCount;
+}
+
+void writeFunction(QDataStream &out, const EmberData::FunctionInfo &function)
+{
+    out << function.path << function.identifier << function.description
+        << function.argNames << function.argTypes << function.resultNames << function.resultTypes;
+}
+
+void readFunction(QDataStream &in, EmberData::FunctionInfo &function)
+{
+    in >> function.path >> function.identifier >> function.description
+       >> function.argNames >> function.argTypes >> function.resultNames >> function.resultTypes;
+}
+
+bool sameNode(const EmberData::NodeInfo &a, const EmberData::NodeInfo &b)
+{
+    return a.identifier == b.identifier && a.description == b.description && a.isOnline == b.isOnline;
+}
+
+bool sameParameter(const EmberData::ParameterInfo &a, const EmberData::ParameterInfo &b)
+{
+    return a.value == b.value && a.identifier == b.identifier && a.description == b.description
+        && a.access == b.access && a.type == b.type && a.isOnline == b.isOnline
+        && a.minimum == b.minimum && a.maximum == b.maximum
+        && a.enumOptions == b.enumOptions && a.enumValues == b.enumValues
+        && a.streamIdentifier == b.streamIdentifier && a.streamOffset == b.streamOffset && a.format == b.format
+        && a.referenceLevel == b.referenceLevel && a.formula == b.formula && a.factor == b.factor;
+}
+
+bool sameMatrix(const EmberData::MatrixInfo &a, const EmberData::MatrixInfo &b)
+{
+    return a.identifier == b.identifier && a.description == b.description && a.type == b.type
+        && a.targetCount == b.targetCount && a.sourceCount == b.sourceCount;
+}
+
+bool sameFunction(const EmberData::FunctionInfo &a, const EmberData::FunctionInfo &b)
+{
+    return a.identifier == b.identifier && a.description == b.description
+        && a.argNames == b.argNames && a.argTypes == b.argTypes
+        && a.resultNames == b.resultNames && a.resultTypes == b.resultTypes;
+}
+
+template <typename Info, typename Same>
+DeviceTreeCache::Change store(QHash<QString, Info> &elements, const Info &info, Same same, bool &dirty)
+{
+    auto it = elements.find(info.path);
+    if (it == elements.end()) {
+        elements.insert(info.path, info);
+        dirty = true;
+        return DeviceTreeCache::Added;
+    }
+    if (same(*it, info)) {
+        return DeviceTreeCache::Unchanged;
+    }
+    *it = info;
+    dirty = true;
+    return DeviceTreeCache::Modified;
+}
+
+template <typename Info>
+QVector<Info> byDepth(const QHash<QString, Info> &elements)
+{
+    QVector<Info> result;
+    result.reserve(elements.size());
+    for (const Info &info : elements) {
+        result.append(info);
+    }
+    std::stable_sort(result.begin(), result.end(), [](const Info &a, const Info &b) {
+        return a.path.count('.') < b.path.count('.');
+    });
+    return result;
+}
+
+}
+
+DeviceTreeCache::DeviceTreeCache(const QString &hostPort)
+    : m_hostPort(hostPort)
+    , m_dirty(false)
+{
+}
+
+QString DeviceTreeCache::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/EmberViewer/devices";
+}
+
+QString DeviceTreeCache::filePath() const
+{
+    QString fileName = m_hostPort;
+    fileName.replace(QRegularExpression("[^A-Za-z0-9._-]"), "_");
+    return cacheDirectory() + "/" + fileName + ".tree";
+}
+
+bool DeviceTreeCache::load()
+{
+    clear();
+
+    QFile file(filePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic;
+    quint16 version;
+    QString hostPort;
+    in >> magic >> version >> hostPort;
+    if (magic != FILE_MAGIC || version != FILE_VERSION || hostPort != m_hostPort) {
+        qDebug().noquote() << QString("Ignoring device tree cache %1 (version %2)").arg(file.fileName()).arg(version);
+        return false;
+    }
+
+    quint32 count;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        EmberData::NodeInfo node;
+        readNode(in, node);
+        m_nodes.insert(node.path, node);
+    }
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        EmberData::ParameterInfo param;
+        readParameter(in, param);
+        m_parameters.insert(param.path, param);
+    }
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        EmberData::MatrixInfo matrix;
+        readMatrix(in, matrix);
+        m_matrices.insert(matrix.path, matrix);
+    }
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        EmberData::FunctionInfo function;
+        readFunction(in, function);
+        m_functions.insert(function.path, function);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning().noquote() << QString("Device tree cache %1 is truncated, discarding it").arg(file.fileName());
+        clear();
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+bool DeviceTreeCache::save()
+{
+    if (m_hostPort.isEmpty()) {
+        return false;
+    }
+
+    QDir().mkpath(cacheDirectory());
+
+    // QSaveFile keeps the previous cache intact if writing is interrupted
+    QSaveFile file(filePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning().noquote() << QString("Cannot write device tree cache %1: %2").arg(file.fileName()).arg(file.errorString());
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << FILE_MAGIC << FILE_VERSION << m_hostPort;
+
+    out << quint32(m_nodes.size());
+    for (const EmberData::NodeInfo &node : m_nodes) {
+        writeNode(out, node);
+    }
+    out << quint32(m_parameters.size());
+    for (const EmberData::ParameterInfo &param : m_parameters) {
+        writeParameter(out, param);
+    }
+    out << quint32(m_matrices.size());
+    for (const EmberData::MatrixInfo &matrix : m_matrices) {
+        writeMatrix(out, matrix);
+    }
+    out << quint32(m_functions.size());
+    for (const EmberData::FunctionInfo &function : m_functions) {
+        writeFunction(out, function);
+    }
+
+    if (!file.commit()) {
+        qWarning().noquote() << QString("Cannot write device tree cache %1: %2").arg(filePath()).arg(file.errorString());
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+void DeviceTreeCache::clear()
+{
+    m_nodes.clear();
+    m_parameters.clear();
+    m_matrices.clear();
+    m_functions.clear();
+    m_dirty = false;
+}
+
+bool DeviceTreeCache::isEmpty() const
+{
+    return m_nodes.isEmpty() && m_parameters.isEmpty() && m_matrices.isEmpty() && m_functions.isEmpty();
+}
+
+DeviceTreeCache::Change DeviceTreeCache::update(const EmberData::NodeInfo &node)
+{
+    return store(m_nodes, node, sameNode, m_dirty);
+}
+
+DeviceTreeCache::Change DeviceTreeCache::update(const EmberData::ParameterInfo &param)
+{
+    return store(m_parameters, param, sameParameter, m_dirty);
+}
+
+DeviceTreeCache::Change DeviceTreeCache::update(const EmberData::MatrixInfo &matrix)
+{
+    return store(m_matrices, matrix, sameMatrix, m_dirty);
+}
+
+DeviceTreeCache::Change DeviceTreeCache::update(const EmberData::FunctionInfo &function)
+{
+    return store(m_functions, function, sameFunction, m_dirty);
+}
+
+QVector<EmberData::NodeInfo> DeviceTreeCache::nodes() const
+{
+    return byDepth(m_nodes);
+}
+
+QVector<EmberData::ParameterInfo> DeviceTreeCache::parameters() const
+{
+    return byDepth(m_parameters);
+}
+
+QVector<EmberData::MatrixInfo> DeviceTreeCache::matrices() const
+{
+    return byDepth(m_matrices);
+}
+
+QVector<EmberData::FunctionInfo> DeviceTreeCache::functions() const
+{
+    return byDepth(m_functions);
+}
+
+QStringList DeviceTreeCache::nodePaths() const
+{
+    QStringList paths;
+    for (const EmberData::NodeInfo &node : nodes()) {
+        paths.append(node.path);
+    }
+    return paths;
+}
+
+QStringList DeviceTreeCache::retainOnly(const QSet<QString> &seenPaths, const QSet<QString> &silentPaths)
+{
+    QStringList paths;
+    paths.reserve(m_nodes.size() + m_parameters.size() + m_matrices.size() + m_functions.size());
+    paths << m_nodes.keys() << m_parameters.keys() << m_matrices.keys() << m_functions.keys();
+    std::sort(paths.begin(), paths.end(), [](const QString &a, const QString &b) {
+        return a.count('.') < b.count('.');
+    });
+    
+    // Parents first: an unseen element is only kept while its parent stayed silent and
+    // was kept itself, a parent that answered without listing it removed it
+    QSet<QString> removedPaths;
+    QStringList removed;
+    for (const QString &path : std::as_const(paths)) {
+        int separator = path.lastIndexOf('.');
+        QString parentPath = separator < 0 ? QString() : path.left(separator);
+        if (seenPaths.contains(path)
+            || (silentPaths.contains(parentPath) && !removedPaths.contains(parentPath))) {
+            continue;
+        }
+        removedPaths.insert(path);
+        removed.append(path);
+        m_nodes.remove(path);
+        m_parameters.remove(path);
+        m_matrices.remove(path);
+        m_functions.remove(path);
+    }
+
+    if (!removed.isEmpty()) {
+        m_dirty = true;
+    }
+    return removed;
+}
@@ -0,0 +1,306 @@
+#include "ElementStore.h"
+
+namespace {
+
+template <typename Details>
+int allocate(std::vector<Details> &table, std::vector<int> &freeSlots)
+{
+    if (!freeSlots.empty()) {
+        int slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+    table.emplace_back();
+    return static_cast<int>(table.size()) - 1;
+}
+
+}
+
+StringPool::StringPool()
+{
+    clear();
+}
+
+quint32 StringPool::intern(const QString &string)
+{
+    if (string.isEmpty()) {
+        return 0;
+    }
+
+    auto it = m_ids.constFind(string);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+
+    quint32 id = static_cast<quint32>(m_strings.size());
+    m_strings.append(string);
+    m_ids.insert(string, id);
+    return id;
+}
+
+void StringPool::clear()
+{
+    m_strings.clear();
+    m_ids.clear();
+    m_strings.append(QString());
+}
+
+
+ElementStore::ElementStore()
+{
+}
+
+void ElementStore::clear()
+{
+    m_parent.clear();
+    m_row.clear();
+    m_number.clear();
+    m_kind.clear();
+    m_flags.clear();
+    m_identifier.clear();
+    m_description.clear();
+    m_detail.clear();
+    m_path.clear();
+    m_value.clear();
+    m_children.clear();
+    m_parameters.clear();
+    m_matrices.clear();
+    m_freeElements.clear();
+    m_freeParameters.clear();
+    m_freeMatrices.clear();
+    m_topLevel.clear();
+    m_index.clear();
+    m_strings.clear();
+}
+
+int ElementStore::findOrCreate(EmberPath path)
+{
+    if (path.isEmpty()) {
+        return NoElement;
+    }
+
+    int existing = find(path);
+    if (existing != NoElement) {
+        return existing;
+    }
+
+    // Missing ancestors are created first, so each parent exists before its children
+    EmberPath parentPath = path.parent();
+    int parentElement = parentPath.isEmpty() ? NoElement : findOrCreate(parentPath);
+    return create(path, parentElement);
+}
+
+int ElementStore::create(EmberPath path, int parent)
+{
+    int element;
+    if (!m_freeElements.empty()) {
+        element = m_freeElements.back();
+        m_freeElements.pop_back();
+    } else {
+        element = size();
+        m_parent.emplace_back();
+        m_row.emplace_back();
+        m_number.emplace_back();
+        m_kind.emplace_back();
+        m_flags.emplace_back();
+        m_identifier.emplace_back();
+        m_description.emplace_back();
+        m_detail.emplace_back();
+        m_path.emplace_back();
+        m_value.emplace_back();
+        m_children.emplace_back();
+    }
+
+    QVector<int> &siblings = parent == NoElement ? m_topLevel : m_children[parent];
+    m_row[element] = siblings.size();
+    siblings.append(element);
+
+    m_parent[element] = parent;
+    m_number[element] = path.number();
+    m_kind[element] = Placeholder;
+    m_flags[element] = Online;
+    m_identifier[element] = 0;
+    m_description[element] = 0;
+    m_detail[element] = NoElement;
+    m_path[element] = path;
+
+    m_index.insert(path, element);
+    return element;
+}
+
+void ElementStore::releaseDetail(int element)
+{
+    int detail = m_detail[element];
+    if (detail == NoElement) {
+        return;
+    }
+
+    if (m_kind[element] == Parameter) {
+        m_parameters[detail] = ParameterDetails();
+        m_freeParameters.push_back(detail);
+    } else if (m_kind[element] == Matrix) {
+        m_matrices[detail] = MatrixDetails();
+        m_freeMatrices.push_back(detail);
+    }
+    m_detail[element] = NoElement;
+}
+
+void ElementStore::remove(int element)
+{
+    QVector<int> &siblings = m_parent[element] == NoElement ? m_topLevel : m_children[m_parent[element]];
+    int row = m_row[element];
+    siblings.remove(row);
+    for (int i = row; i < siblings.size(); ++i) {
+        m_row[siblings[i]] = i;
+    }
+
+    QVector<int> pending{element};
+    while (!pending.isEmpty()) {
+        int current = pending.takeLast();
+        pending += m_children[current];
+        m_children[current] = QVector<int>();
+        m_index.remove(m_path[current]);
+        releaseDetail(current);
+        m_kind[current] = Placeholder;
+        m_flags[current] = Removed;
+        m_value[current] = QString();
+        m_path[current] = EmberPath();
+        m_freeElements.push_back(current);
+    }
+}
+
+void ElementStore::setNode(int element, const EmberData::NodeInfo &node)
+{
+    releaseDetail(element);
+    m_kind[element] = Node;
+    m_identifier[element] = m_strings.intern(node.identifier);
+    m_description[element] = m_strings.intern(node.description);
+    setFlag(element, Online, node.isOnline);
+}
+
+void ElementStore::setParameter(int element, const EmberData::ParameterInfo &param)
+{
+    if (m_kind[element] != Parameter || m_detail[element] == NoElement) {
+        releaseDetail(element);
+        m_detail[element] = allocate(m_parameters, m_freeParameters);
+    }
+
+    m_kind[element] = Parameter;
+    m_identifier[element] = m_strings.intern(param.identifier);
+    m_description[element] = m_strings.intern(param.description);
+    m_value[element] = param.value;
+    setFlag(element, Online, param.isOnline);
+
+    ParameterDetails &details = m_parameters[m_detail[element]];
+    details.type = param.type;
+    details.access = param.access;
+    details.streamIdentifier = param.streamIdentifier;
+    details.streamOffset = param.streamOffset;
+    details.factor = param.factor;
+    details.minimum = param.minimum;
+    details.maximum = param.maximum;
+    details.enumOptions = m_strings.intern(param.enumOptions.join(QLatin1Char('\n')));
+    details.enumValues = param.enumValues;
+    details.format = m_strings.intern(param.format);
+    details.referenceLevel = m_strings.intern(param.referenceLevel);
+    details.formula = m_strings.intern(param.formula);
+}
+
+void ElementStore::setMatrix(int element, const EmberData::MatrixInfo &matrix)
+{
+    if (m_kind[element] != Matrix || m_detail[element] == NoElement) {
+        releaseDetail(element);
+        m_detail[element] = allocate(m_matrices, m_freeMatrices);
+    }
+
+    m_kind[element] = Matrix;
+    m_identifier[element] = m_strings.intern(matrix.identifier);
+    m_description[element] = m_strings.intern(matrix.description);
+
+    MatrixDetails &details = m_matrices[m_detail[element]];
+    details.type = matrix.type;
+    details.targetCount = matrix.targetCount;
+    details.sourceCount = matrix.sourceCount;
+}
+
+void ElementStore::setFunction(int element, const EmberData::FunctionInfo &function)
+{
+    releaseDetail(element);
+    m_kind[element] = Function;
+    m_identifier[element] = m_strings.intern(function.identifier);
+    m_description[element] = m_strings.intern(function.description);
+}
+
+bool ElementStore::setValue(int element, const QString &value)
+{
+    if (m_value[element] == value) {
+        return false;
+    }
+    m_value[element] = value;
+    return true;
+}
+
+void ElementStore::setFlag(int element, Flag flag, bool on)
+{
+    if (on) {
+        m_flags[element] |= flag;
+    } else {
+        m_flags[element] &= ~flag;
+    }
+}
+
+int ElementStore::childCount(int element) const
+{
+    return element == NoElement ? m_topLevel.size() : m_children[element].size();
+}
+
+int ElementStore::child(int element, int row) const
+{
+    const QVector<int> &children = element == NoElement ? m_topLevel : m_children[element];
+    return (row >= 0 && row < children.size()) ? children[row] : NoElement;
+}
+
+QString ElementStore::displayName(int element) const
+{
+    if (m_kind[element] == Placeholder) {
+        return QString::number(m_number[element]);
+    }
+    const QString &description = m_strings.at(m_description[element]);
+    return !description.isEmpty() ? description : m_strings.at(m_identifier[element]);
+}
+
+const ElementStore::ParameterDetails* ElementStore::parameter(int element) const
+{
+    return (m_kind[element] == Parameter && m_detail[element] != NoElement) ? &m_parameters[m_detail[element]] : nullptr;
+}
+
+const ElementStore::MatrixDetails* ElementStore::matrix(int element) const
+{
+    return (m_kind[element] == Matrix && m_detail[element] != NoElement) ? &m_matrices[m_detail[element]] : nullptr;
+}
+
+QStringList ElementStore::enumOptions(int element) const
+{
+    const ParameterDetails *details = parameter(element);
+    if (!details || details->enumOptions == 0) {
+        return QStringList();
+    }
+    return m_strings.at(details->enumOptions).split(QLatin1Char('\n'));
+}
+
+qint64 ElementStore::estimatedBytes() const
+{
+    qint64 elements = size();
+    qint64 bytes = elements * (3 * sizeof(int) + 2 * sizeof(quint8) + 2 * sizeof(quint32)
+                               + sizeof(int) + sizeof(EmberPath) + sizeof(QString) + sizeof(QVector<int>));
+    bytes += elements * sizeof(int);    // Child lists
+    for (const QString &value : m_value) {
+        bytes += value.capacity() * sizeof(QChar);
+    }
+    bytes += static_cast<qint64>(m_parameters.size()) * sizeof(ParameterDetails);
+    bytes += static_cast<qint64>(m_matrices.size()) * sizeof(MatrixDetails);
+    for (int i = 0; i < m_strings.size(); ++i) {
+        bytes += sizeof(QString) + m_strings.at(static_cast<quint32>(i)).capacity() * sizeof(QChar);
+    }
+    return bytes;
+}
@@ -7,9 +7,15 @@
 
 
 #include "EmberConnection.h"
+#include "EmberIoWorker.h"
 #include "TreeFetchService.h"
 #include "CacheManager.h"
+#include "EmberPath.h"
+#include "LogCategories.h"
+#include "PerformanceCounters.h"
 #include <QDebug>
+#include <algorithm>
+#include <variant>
 #include <ember/Ember.hpp>
 #include <ember/ber/ObjectIdentifier.hpp>
 #include <ember/ber/Null.hpp>
@@ -44,14 +50,60 @@
 #include <ember/util/OctetStream.hpp>
 
 
+namespace {
+
+template<class... Ts> struct Overloaded : Ts... { using Ts::operator()...; };
+template<class... Ts> Overloaded(Ts...) -> Overloaded<Ts...>;
+
+// Resolved through the path table, which avoids a temporary QStringList per request
+libember::ber::ObjectIdentifier toObjectIdentifier(const QString &path)
+{
+    libember::ber::ObjectIdentifier oid;
+    const QVector<int> numbers = EmberPath::fromString(path).numbers();
+    for (int number : numbers) {
+        oid.push_back(number);
+    }
+    return oid;
+}
+
+template<typename Element>
+libember::glow::GlowContainer* withCommand(Element *element, libember::glow::CommandType command)
+{
+    element->children()->insert(element->children()->end(), new libember::glow::GlowCommand(command));
+    return element;
+}
+
+// Qualified element of a tree item type carrying one command, nullptr for unknown types
+libember::glow::GlowContainer* qualifiedCommand(const QString &type, const QString &path, libember::glow::CommandType command)
+{
+    libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
+    if (type == "Node") {
+        return withCommand(new libember::glow::GlowQualifiedNode(oid), command);
+    }
+    if (type == "Parameter") {
+        return withCommand(new libember::glow::GlowQualifiedParameter(oid), command);
+    }
+    if (type == "Matrix") {
+        return withCommand(new libember::glow::GlowQualifiedMatrix(oid), command);
+    }
+    if (type == "Function") {
+        return withCommand(new libember::glow::GlowQualifiedFunction(oid), command);
+    }
+    return nullptr;
+}
+
+}
 
 
 EmberConnection::EmberConnection(QObject *parent)
     : QObject(parent)
-    , m_socket(new QTcpSocket(this))
+    , m_ioThread(new QThread(this))
+    , m_ioWorker(new EmberIoWorker())
     , m_s101Protocol(new S101Protocol(this))
-    , m_glowParser(new GlowParser(this))
+    , m_socketState(QAbstractSocket::UnconnectedState)
     , m_treeFetchService(new TreeFetchService(this))
+    , m_deviceTreeCacheEnabled(true)
+    , m_revalidationService(new TreeFetchService(this))
     , m_cacheManager(new CacheManager(this))
     , m_connected(false)
     , m_emberDataReceived(false)
@@ -61,191 +113,33 @@ EmberConnection::EmberConnection(QObject *parent)
     , m_initialConnectionPhase(false)
     , m_labelBatchTimer(nullptr)
     , m_labelFetchingCompleted(false)
+    , m_labelRequestTimer(nullptr)
     , m_nextInvocationId(1)
 {
-    
-    connect(m_socket, &QTcpSocket::connected, this, &EmberConnection::onSocketConnected);
-    connect(m_socket, &QTcpSocket::disconnected, this, &EmberConnection::onSocketDisconnected);
-    
-    
-    #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-    connect(m_socket, &QAbstractSocket::errorOccurred, this, &EmberConnection::onSocketError);
-    #else
-    connect(m_socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error),
-            this, &EmberConnection::onSocketError);
-    #endif
-    
-    connect(m_socket, &QTcpSocket::readyRead, this, &EmberConnection::onDataReceived);
-    
-    
-    connect(m_s101Protocol, &S101Protocol::messageReceived, this, &EmberConnection::onS101MessageReceived);
-    connect(m_s101Protocol, &S101Protocol::keepAliveReceived, this, &EmberConnection::onKeepAliveReceived);
-    connect(m_s101Protocol, &S101Protocol::protocolError, this, [this](const QString& error) {
+    // Socket I/O, S101 deframing and Glow decoding run on a dedicated thread,
+    // only the decoded records are handed to this (GUI) thread
+    m_ioThread->setObjectName("EmberIoThread");
+    m_ioWorker->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_ioWorker, &QObject::deleteLater);
+    
+    connect(m_ioWorker, &EmberIoWorker::connected, this, &EmberConnection::onSocketConnected);
+    connect(m_ioWorker, &EmberIoWorker::disconnected, this, &EmberConnection::onSocketDisconnected);
+    connect(m_ioWorker, &EmberIoWorker::errorOccurred, this, &EmberConnection::onSocketError);
+    connect(m_ioWorker, &EmberIoWorker::stateChanged, this, [this](QAbstractSocket::SocketState state) {
+        m_socketState = state;
+    });
+    connect(m_ioWorker, &EmberIoWorker::batchReady, this, &EmberConnection::onBatchReceived);
+    connect(m_ioWorker, &EmberIoWorker::protocolError, this, [this](const QString& error) {
         qCritical().noquote() << "S101 protocol error:" << error;
         disconnect();
     });
-    
-    
-    connect(m_glowParser, &GlowParser::nodeReceived, this, &EmberConnection::onParserNodeReceived);
-    connect(m_glowParser, &GlowParser::parameterReceived, this, &EmberConnection::onParserParameterReceived);
-    connect(m_glowParser, &GlowParser::matrixReceived, this, &EmberConnection::onParserMatrixReceived);
-    
-    
-    connect(m_glowParser, &GlowParser::matrixTargetReceived, this, 
-            [this](const EmberData::MatrixTargetInfo& target) {
-                // Track that we've fetched this target label
-                if (m_matrixLabelStates.contains(target.matrixPath)) {
-                    auto& state = m_matrixLabelStates[target.matrixPath];
-                    state.fetchedTargets.insert(target.targetNumber);
-                    
-                    // Emit progress for this matrix (throttle: time-based AND count-based)
-                    int fetchedCount = state.fetchedTargets.size() + state.fetchedSources.size();
-                    int totalCount = state.targetCount + state.sourceCount;
-                    qint64 now = QDateTime::currentMSecsSinceEpoch();
-                    qint64 timeSinceLastEmit = now - state.lastProgressEmitTime;
-                    
-                    // Emit if: 100ms has passed OR we're complete OR every 100 labels (for very fast updates)
-                    if (timeSinceLastEmit >= 100 || fetchedCount == totalCount || (fetchedCount % 100 == 0)) {
-                        // Determine label type based on what we're fetching
-                        QString labelType = state.fetchedTargets.size() < state.targetCount ? "targets" : "sources";
-                        emit matrixLabelProgress(state.identifier, fetchedCount, totalCount, labelType);
-                        state.lastProgressEmitTime = now;
-                    }
-                    
-                    // Check if this was the last matrix completing - emit labelFetchingComplete (only once)
-                    if (fetchedCount == totalCount && !m_labelFetchingCompleted) {
-                        bool allComplete = true;
-                        for (const auto& otherState : m_matrixLabelStates) {
-                            int otherFetched = otherState.fetchedTargets.size() + otherState.fetchedSources.size();
-                            int otherTotal = otherState.targetCount + otherState.sourceCount;
-                            if (otherTotal > 0 && otherFetched < otherTotal) {
-                                allComplete = false;
-                                break;
-                            }
-                        }
-                        if (allComplete) {
-                            qDebug() << "All matrix labels fetched - emitting labelFetchingComplete";
-                            m_labelFetchingCompleted = true;  // Set flag to prevent duplicate emissions
-                            emit labelFetchingComplete();
-                        }
-                    }
-                }
-                emit matrixTargetReceived(target.matrixPath, target.targetNumber, target.label);
-            });
-    connect(m_glowParser, &GlowParser::matrixSourceReceived, this,
-            [this](const EmberData::MatrixSourceInfo& source) {
-                // Track that we've fetched this source label
-                if (m_matrixLabelStates.contains(source.matrixPath)) {
-                    auto& state = m_matrixLabelStates[source.matrixPath];
-                    state.fetchedSources.insert(source.sourceNumber);
-                    
-                    // Emit progress for this matrix (throttle: time-based AND count-based)
-                    int fetchedCount = state.fetchedTargets.size() + state.fetchedSources.size();
-                    int totalCount = state.targetCount + state.sourceCount;
-                    qint64 now = QDateTime::currentMSecsSinceEpoch();
-                    qint64 timeSinceLastEmit = now - state.lastProgressEmitTime;
-                    
-                    // Emit if: 100ms has passed OR we're complete OR every 100 labels (for very fast updates)
-                    if (timeSinceLastEmit >= 100 || fetchedCount == totalCount || (fetchedCount % 100 == 0)) {
-                        // Determine label type based on what we're fetching
-                        QString labelType = state.fetchedSources.size() < state.sourceCount ? "sources" : "sources";
-                        emit matrixLabelProgress(state.identifier, fetchedCount, totalCount, labelType);
-                        state.lastProgressEmitTime = now;
-                    }
-                    
-                    // Check if this was the last matrix completing - emit labelFetchingComplete (only once)
-                    if (fetchedCount == totalCount && !m_labelFetchingCompleted) {
-                        bool allComplete = true;
-                        for (const auto& otherState : m_matrixLabelStates) {
-                            int otherFetched = otherState.fetchedTargets.size() + otherState.fetchedSources.size();
-                            int otherTotal = otherState.targetCount + otherState.sourceCount;
-                            if (otherTotal > 0 && otherFetched < otherTotal) {
-                                allComplete = false;
-                                break;
-                            }
-                        }
-                        if (allComplete) {
-                            qDebug() << "All matrix labels fetched - emitting labelFetchingComplete";
-                            m_labelFetchingCompleted = true;  // Set flag to prevent duplicate emissions
-                            emit labelFetchingComplete();
-                        }
-                    }
-                }
-                emit matrixSourceReceived(source.matrixPath, source.sourceNumber, source.label);
-            });
-    connect(m_glowParser, &GlowParser::matrixConnectionReceived, this,
-            [this](const EmberData::MatrixConnectionInfo& conn) {
-                emit matrixConnectionReceived(conn.matrixPath, conn.targetNumber, 
-                                            conn.sourceNumber, conn.connected, conn.disposition);
-            });
-    connect(m_glowParser, &GlowParser::matrixTargetConnectionsCleared, this, 
-            &EmberConnection::matrixTargetConnectionsCleared);
-    connect(m_glowParser, &GlowParser::functionReceived, this,
-            [this](const EmberData::FunctionInfo& func) {
-                emit functionReceived(func.path, func.identifier, func.description,
-                                    func.argNames, func.argTypes, func.resultNames, func.resultTypes);
-            });
-    connect(m_glowParser, &GlowParser::invocationResultReceived, this,
-            [this](const EmberData::InvocationResult& result) {
-                if (m_pendingInvocations.contains(result.invocationId)) {
-                    m_pendingInvocations.remove(result.invocationId);
-                }
-                emit invocationResultReceived(result.invocationId, result.success, result.results);
-            });
-    connect(m_glowParser, &GlowParser::streamValueReceived, this,
-            [this](const EmberData::StreamValue& stream) {
-                emit streamValueReceived(stream.streamIdentifier, stream.value);
-            });
-    connect(m_glowParser, &GlowParser::parsingError, this, [this](const QString& error) {
+    connect(m_ioWorker, &EmberIoWorker::parsingError, this, [this](const QString& error) {
         qCritical().noquote() << "Parsing error:" << error;
         disconnect();
     });
+    connect(m_ioWorker, &EmberIoWorker::recordingStateChanged, this, &EmberConnection::captureStateChanged);
     
-    
-    connect(m_glowParser, &GlowParser::matrixLabelPathsDiscovered, this,
-            [this](const QString& matrixPath, const QStringList& basePaths) {
-                // Update the matrix fetch state with label base paths
-                if (!m_matrixLabelStates.contains(matrixPath)) {
-                    return;
-                }
-                
-                auto& state = m_matrixLabelStates[matrixPath];
-                state.labelBasePaths = basePaths;
-                
-                int totalCount = state.targetCount + state.sourceCount;
-                
-                // Skip 0x0 matrices - no labels to fetch
-                if (totalCount == 0) {
-                    qInfo().noquote() << QString("Matrix %1: Skipping label fetch (0×0 dimensions)")
-                        .arg(matrixPath);
-                    return;
-                }
-                
-                qInfo().noquote() << QString("Matrix %1: Prefetching ALL labels for %2 label layers")
-                    .arg(matrixPath).arg(basePaths.size());
-                
-                // Emit initial progress (0/total) to show which matrix we're starting to fetch
-                state.lastProgressEmitTime = QDateTime::currentMSecsSinceEpoch();
-                emit matrixLabelProgress(state.identifier, 0, totalCount, "targets");
-                
-                for (const QString& basePath : basePaths) {
-                    // Track this as a label base path for recursive fetching
-                    m_labelBasePaths.insert(basePath);
-                    m_labelFetchPaths.insert(basePath);
-                    m_labelPathToMatrix[basePath] = matrixPath;
-                    qDebug().noquote() << QString("  - Queueing label fetch at basePath: %1").arg(basePath);
-                    
-                    // Add to pending batch instead of sending immediately
-                    if (!m_pendingLabelPaths.contains(basePath)) {
-                        m_pendingLabelPaths.append(basePath);
-                    }
-                    
-                    // Start batch timer if not already running
-                    if (m_labelBatchTimer && !m_labelBatchTimer->isActive()) {
-                        m_labelBatchTimer->start();
-                    }
-                }
-            });
+    m_ioThread->start();
     
     
     m_connectionTimer = new QTimer(this);
@@ -270,6 +164,18 @@ EmberConnection::EmberConnection(QObject *parent)
     m_labelBatchTimer->setSingleShot(true);
     m_labelBatchTimer->setInterval(10);  // 10ms collection window for responsive label fetching
     connect(m_labelBatchTimer, &QTimer::timeout, this, &EmberConnection::processBatchedLabelFetch);
+    
+    // Expires unanswered label requests while any are in flight
+    m_labelRequestTimer = new QTimer(this);
+    m_labelRequestTimer->setInterval(LABEL_REQUEST_CHECK_MS);
+    connect(m_labelRequestTimer, &QTimer::timeout, this, &EmberConnection::onLabelRequestTimer);
+    m_labelClock.start();
+    
+    // Revalidation of a cached tree runs on its own fetcher, its completion is not a user tree fetch
+    m_revalidationService->setSendGetDirectoryCallback([this](const QStringList& paths) {
+        sendTreeFetchRequest(paths);
+    });
+    connect(m_revalidationService, &TreeFetchService::fetchCompleted, this, &EmberConnection::onRevalidationCompleted);
 }
 
 EmberConnection::~EmberConnection()
@@ -287,31 +193,26 @@ EmberConnection::~EmberConnection()
     if (m_labelBatchTimer) {
         m_labelBatchTimer->stop();
     }
+    if (m_labelRequestTimer) {
+        m_labelRequestTimer->stop();
+    }
     
-    // Disconnect all signals to prevent crashes during cleanup
-    if (m_socket) {
-        m_socket->disconnect();
-        
-        // Close the socket connection if still connected
-        if (m_socket->state() == QAbstractSocket::ConnectedState) {
-            m_socket->disconnectFromHost();
-            // Don't wait for graceful disconnect in destructor
-            // Just abort to ensure immediate cleanup
-            if (m_socket->state() != QAbstractSocket::UnconnectedState) {
-                m_socket->abort();
-            }
-        }
+    // Stop receiving from the worker; it aborts the socket and is deleted when its thread finishes
+    QObject::disconnect(m_ioWorker, nullptr, this, nullptr);
+    m_ioThread->quit();
+    m_ioThread->wait();
+    
+    if (m_deviceTreeCacheEnabled && m_deviceTree.isDirty()) {
+        m_deviceTree.save();
     }
     
-    // Now safe to delete protocol handlers
     delete m_s101Protocol;
-    delete m_glowParser;
 }
 
 void EmberConnection::connectToHost(const QString &host, int port)
 {
     
-    QAbstractSocket::SocketState state = m_socket->state();
+    QAbstractSocket::SocketState state = m_socketState;
     if (state != QAbstractSocket::UnconnectedState) {
         qWarning().noquote() << QString("Cannot connect: socket is already in state %1").arg(static_cast<int>(state));
         
@@ -319,7 +220,7 @@ void EmberConnection::connectToHost(const QString &host, int port)
         if (state == QAbstractSocket::ConnectingState || 
             state == QAbstractSocket::HostLookupState) {
             qInfo().noquote() << "Aborting previous connection attempt...";
-            m_socket->abort();
+            QMetaObject::invokeMethod(m_ioWorker, &EmberIoWorker::abort, Qt::QueuedConnection);
             m_connectionTimer->stop();
         } else if (state == QAbstractSocket::ConnectedState) {
             qInfo().noquote() << "Already connected";
@@ -336,27 +237,20 @@ void EmberConnection::connectToHost(const QString &host, int port)
     
     m_requestedPaths.clear();
     m_labelFetchingCompleted = false;  // Reset flag for new connection
-    
-    
-    
-    
-    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
-    
-    
-    m_socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
-    
-    
-    
-    
-    m_socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, 65536);
-    m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 65536);
+    m_labelScheduler.clear();
+    m_labelNumbersChanged.clear();
+    m_labelRequestTimer->stop();
     
     qInfo().noquote() << QString("Connecting to %1:%2...").arg(host).arg(port);
     
     
     m_connectionTimer->start();
     
-    m_socket->connectToHost(host, port);
+    // Socket options are applied by the worker on the I/O thread
+    m_socketState = QAbstractSocket::HostLookupState;
+    QMetaObject::invokeMethod(m_ioWorker, [worker = m_ioWorker, host, port]() {
+        worker->connectToHost(host, port);
+    }, Qt::QueuedConnection);
 }
 
 void EmberConnection::disconnect()
@@ -365,16 +259,13 @@ void EmberConnection::disconnect()
     m_connectionTimer->stop();
     m_protocolTimer->stop();
     
-    QAbstractSocket::SocketState state = m_socket->state();
+    QAbstractSocket::SocketState state = m_socketState;
     
-    if (state == QAbstractSocket::ConnectedState) {
-        m_socket->disconnectFromHost();
-    } else if (state == QAbstractSocket::ConnectingState || 
-               state == QAbstractSocket::HostLookupState) {
-        
+    if (state == QAbstractSocket::ConnectingState || 
+        state == QAbstractSocket::HostLookupState) {
         qInfo().noquote() << "Aborting pending connection...";
-        m_socket->abort();
     }
+    QMetaObject::invokeMethod(m_ioWorker, &EmberIoWorker::disconnectFromHost, Qt::QueuedConnection);
     
     
     m_requestedPaths.clear();
@@ -386,6 +277,23 @@ bool EmberConnection::isConnected() const
     return m_connected;
 }
 
+void EmberConnection::setDeviceTreeCacheEnabled(bool enabled)
+{
+    m_deviceTreeCacheEnabled = enabled;
+}
+
+void EmberConnection::startCapture(const QString &filePath)
+{
+    QMetaObject::invokeMethod(m_ioWorker, [worker = m_ioWorker, filePath]() {
+        worker->startRecording(filePath);
+    }, Qt::QueuedConnection);
+}
+
+void EmberConnection::stopCapture()
+{
+    QMetaObject::invokeMethod(m_ioWorker, &EmberIoWorker::stopRecording, Qt::QueuedConnection);
+}
+
 void EmberConnection::onSocketConnected()
 {
     
@@ -405,6 +313,11 @@ void EmberConnection::onSocketConnected()
     
     
     QString cacheKey = QString("%1:%2").arg(m_host).arg(m_port);
+    m_deviceTree = DeviceTreeCache(cacheKey);
+    if (m_deviceTreeCacheEnabled && m_deviceTree.load()) {
+        replayDeviceTree();
+    }
+    
     if (CacheManager::hasDeviceCache(cacheKey)) {
         CacheManager::DeviceCache cache = CacheManager::getDeviceCache(cacheKey);
         
@@ -418,7 +331,8 @@ void EmberConnection::onSocketConnected()
                 .arg(hoursSinceLastSeen);
             
             
-            m_cacheManager->setRootNode(cache.rootPath, cache.deviceName, false, cache.identityPath);
+            m_cacheManager->setRootNode(EmberPath::fromString(cache.rootPath), cache.deviceName, false,
+                                        EmberPath::fromString(cache.identityPath));
             
             
             emit nodeReceived(cache.rootPath, cache.deviceName, cache.deviceName, true);
@@ -444,18 +358,23 @@ void EmberConnection::onSocketDisconnected()
     
     m_connected = false;
     m_emberDataReceived = false;
+    
+    m_revalidationService->cancel();
+    m_replayedPaths.clear();
+    if (m_deviceTreeCacheEnabled && m_deviceTree.isDirty()) {
+        m_deviceTree.save();
+    }
     m_cacheManager->clear();  
     emit disconnected();
     qInfo().noquote() << "Disconnected from provider";
 }
 
-void EmberConnection::onSocketError(QAbstractSocket::SocketError error)
+void EmberConnection::onSocketError(QAbstractSocket::SocketError error, const QString &errorString)
 {
     
     m_connectionTimer->stop();
     
-    QString errorString = m_socket->errorString();
-    QAbstractSocket::SocketState state = m_socket->state();
+    QAbstractSocket::SocketState state = m_socketState;
     
     qCritical().noquote() << QString("Connection error: %1 (error code: %2, state: %3)")
         .arg(errorString).arg(error).arg(state);
@@ -481,7 +400,7 @@ void EmberConnection::onSocketError(QAbstractSocket::SocketError error)
         
         
         if (state != QAbstractSocket::UnconnectedState) {
-            m_socket->abort();
+            QMetaObject::invokeMethod(m_ioWorker, &EmberIoWorker::abort, Qt::QueuedConnection);
         }
         
         
@@ -498,11 +417,11 @@ void EmberConnection::onConnectionTimeout()
     qCritical().noquote() << QString("Connection timeout after 5 seconds");
     
     
-    QAbstractSocket::SocketState state = m_socket->state();
+    QAbstractSocket::SocketState state = m_socketState;
     if (state == QAbstractSocket::ConnectingState || 
         state == QAbstractSocket::HostLookupState) {
         qInfo().noquote() << "Aborting connection attempt...";
-        m_socket->abort();
+        QMetaObject::invokeMethod(m_ioWorker, &EmberIoWorker::abort, Qt::QueuedConnection);
         
         
         
@@ -523,26 +442,13 @@ void EmberConnection::onProtocolTimeout()
     }
 }
 
-void EmberConnection::onDataReceived()
-{
-    QByteArray data = m_socket->readAll();
-    
-    if (data.isEmpty()) {
-        return;
-    }
-    
-    
-    qDebug().noquote() << QString("Received %1 bytes from socket").arg(data.size());
-    
-    
-    m_s101Protocol->feedData(data);
-}
-
-void EmberConnection::onS101MessageReceived(const QByteArray& emberData)
+void EmberConnection::onBatchReceived(const EmberData::Batch& batch)
 {
+    PerformanceCounters::ScopedTimer dispatchTimer(PerformanceCounters::DispatchBatch);
+    PerformanceCounters::add(PerformanceCounters::BatchesDispatched);
     
     bool isFirstData = false;
-    if (!m_emberDataReceived) {
+    if (batch.messageCount > 0 && !m_emberDataReceived) {
         m_emberDataReceived = true;
         isFirstData = true;
         m_protocolTimer->stop();
@@ -550,80 +456,139 @@ void EmberConnection::onS101MessageReceived(const QByteArray& emberData)
     }
     
     
-    m_glowParser->parseEmberData(emberData);
+    for (const EmberData::Record& record : batch.records) {
+        // Keep the relative order of nodes/parameters and all other record types
+        if (!std::holds_alternative<EmberData::NodeInfo>(record) &&
+            !std::holds_alternative<EmberData::ParameterInfo>(record)) {
+            flushReceivedElements();
+        }
+        
+        std::visit(Overloaded{
+            [this](const EmberData::NodeInfo& node) { onParserNodeReceived(node); },
+            [this](const EmberData::ParameterInfo& param) { onParserParameterReceived(param); },
+            [this](const EmberData::MatrixInfo& matrix) { onParserMatrixReceived(matrix); },
+            [this](const EmberData::MatrixTargetInfo& target) { onParserMatrixTargetReceived(target); },
+            [this](const EmberData::MatrixSourceInfo& source) { onParserMatrixSourceReceived(source); },
+            [this](const EmberData::MatrixConnectionInfo& conn) {
+                emit matrixConnectionReceived(EmberData::matrixPathOf(conn), conn.targetNumber,
+                                            conn.sourceNumber, conn.connected, conn.disposition);
+            },
+            [this](const EmberData::TargetConnectionsCleared& cleared) {
+                emit matrixTargetConnectionsCleared(EmberData::matrixPathOf(cleared), cleared.targetNumber);
+            },
+            [this](const EmberData::FunctionInfo& func) {
+                if (shouldForward(func.path, m_deviceTree.update(func))) {
+                    emit functionReceived(func.path, func.identifier, func.description,
+                                        func.argNames, func.argTypes, func.resultNames, func.resultTypes);
+                }
+                if (m_treeFetchService->isActive()) {
+                    m_treeFetchService->onElementReceived(func.path, false);
+                }
+                trackRevalidation(func.path, false);
+            },
+            [this](const EmberData::InvocationResult& result) { onParserInvocationResultReceived(result); },
+            [this](const EmberData::StreamValues& streams) { emit streamValuesReceived(streams.values); },
+            [this](const EmberData::MatrixLabelPaths& labelPaths) { onParserMatrixLabelPathsDiscovered(labelPaths); }
+        }, record);
+    }
+    flushReceivedElements();
+    
+    // Refill the label window once per batch rather than once per label
+    pumpLabelRequests();
     
     
     if (isFirstData) {
         qDebug().noquote() << "Initial tree populated, emitting treePopulated signal";
         emit treePopulated();
     }
+    
+    // Frees a slot in the worker's queue; it stops reading while too many batches are pending
+    m_ioWorker->acknowledgeBatch();
+}
+
+void EmberConnection::flushReceivedElements()
+{
+    // Parents are created before their children, so nodes go first
+    if (!m_pendingNodes.isEmpty()) {
+        emit nodesReceived(m_pendingNodes);
+        m_pendingNodes.clear();
+    }
+    if (!m_pendingParameters.isEmpty()) {
+        emit parametersReceived(m_pendingParameters);
+        m_pendingParameters.clear();
+    }
 }
 
-void EmberConnection::onKeepAliveReceived()
+bool EmberConnection::sendFrame(const QByteArray& frame)
 {
+    if (m_socketState != QAbstractSocket::ConnectedState) {
+        return false;
+    }
     
-    qDebug() << "[EmberConnection] Sending KeepAlive RESPONSE to device";
-    QByteArray response = m_s101Protocol->encodeKeepAliveResponse();
-    qint64 bytesWritten = m_socket->write(response);
-    m_socket->flush();
-    qDebug() << "[EmberConnection] KeepAlive response sent:" << bytesWritten << "bytes";
+    QMetaObject::invokeMethod(m_ioWorker, [worker = m_ioWorker, frame]() {
+        worker->sendFrame(frame);
+    }, Qt::QueuedConnection);
+    return true;
 }
 
 void EmberConnection::onParserNodeReceived(const EmberData::NodeInfo& node)
 {
     
-    QStringList pathParts = node.path.split('.');
-    int pathDepth = pathParts.size();
+    EmberPath nodePath = EmberData::elementPath(node);
+    int pathDepth = nodePath.depth();
     
     if (pathDepth == 1) {
         QString displayName = !node.description.isEmpty() ? node.description : node.identifier;
         bool isGeneric = isGenericNodeName(displayName);
         
-        qDebug().noquote() << QString("ROOT Node [%1]: Identifier='%2', Description='%3', Generic=%4")
+        qCDebug(lcElements).noquote() << QString("ROOT Node [%1]: Identifier='%2', Description='%3', Generic=%4")
             .arg(node.path).arg(node.identifier)
             .arg(node.description)
             .arg(isGeneric ? "YES" : "no");
         
         
-        if (m_cacheManager->hasRootNode(node.path) && !m_cacheManager->isRootNodeGeneric(node.path)) {
+        if (m_cacheManager->hasRootNode(nodePath) && !m_cacheManager->isRootNodeGeneric(nodePath)) {
             
-            CacheManager::RootNodeInfo rootInfo = m_cacheManager->getRootNode(node.path);
-            qDebug().noquote() << QString("Preserving existing root node name: %1").arg(rootInfo.displayName);
+            CacheManager::RootNodeInfo rootInfo = m_cacheManager->getRootNode(nodePath);
+            qCDebug(lcElements).noquote() << QString("Preserving existing root node name: %1").arg(rootInfo.displayName);
         } else {
             
-            QString existingIdentityPath;
-            if (m_cacheManager->hasRootNode(node.path)) {
+            EmberPath existingIdentityPath;
+            if (m_cacheManager->hasRootNode(nodePath)) {
                 
-                existingIdentityPath = m_cacheManager->getRootNode(node.path).identityPath;
+                existingIdentityPath = m_cacheManager->getRootNode(nodePath).identityPath;
             }
-            m_cacheManager->setRootNode(node.path, displayName, isGeneric, existingIdentityPath);
+            m_cacheManager->setRootNode(nodePath, displayName, isGeneric, existingIdentityPath);
         }
     }
     
     else if (pathDepth == 2) {
-        QString parentPath = pathParts[0];
+        EmberPath parentPath = nodePath.parent();
         if (m_cacheManager->hasRootNode(parentPath)) {
             
             QString nodeName = node.identifier.toLower();
             if (nodeName == "identity" || nodeName == "_identity" || 
                 nodeName == "deviceinfo" || nodeName == "device_info") {
-                m_cacheManager->updateRootNodeIdentityPath(parentPath, node.path);
-                qDebug().noquote() << QString("Detected identity node for root %1: %2")
-                    .arg(parentPath).arg(node.path);
+                m_cacheManager->updateRootNodeIdentityPath(parentPath, nodePath);
+                qCDebug(lcElements).noquote() << QString("Detected identity node for root %1: %2")
+                    .arg(parentPath.toString()).arg(node.path);
             }
         }
     }
     
-    qDebug().noquote() << QString("Node: %1 - Online: %2")
+    qCDebug(lcElements).noquote() << QString("Node: %1 - Online: %2")
         .arg(node.path).arg(node.isOnline ? "YES" : "NO");
     
     
-    emit nodeReceived(node.path, node.identifier, node.description, node.isOnline);
+    if (shouldForward(node.path, m_deviceTree.update(node))) {
+        m_pendingNodes.append(node);
+    }
     
     
     if (m_treeFetchService->isActive()) {
-        m_treeFetchService->onNodeReceived(node.path);
+        m_treeFetchService->onElementReceived(node.path, true);
     }
+    trackRevalidation(node.path, true);
     
     
     bool shouldAutoRequest = false;
@@ -632,7 +597,7 @@ void EmberConnection::onParserNodeReceived(const EmberData::NodeInfo& node)
     // This ensures matrices are discovered immediately on connection without user interaction
     if (pathDepth <= 3) {
         shouldAutoRequest = true;
-        qDebug().noquote() << QString("Auto-expanding node at depth %1 to discover matrices: %2")
+        qCDebug(lcElements).noquote() << QString("Auto-expanding node at depth %1 to discover matrices: %2")
             .arg(pathDepth).arg(node.path);
         
         // During initial connection, batch the requests instead of sending immediately
@@ -642,22 +607,22 @@ void EmberConnection::onParserNodeReceived(const EmberData::NodeInfo& node)
                 m_batchTimer->start();
             }
             shouldAutoRequest = false;  // Handled by batch timer
-            qDebug().noquote() << QString("  -> Queued for batched request (queue size: %1)")
+            qCDebug(lcElements).noquote() << QString("  -> Queued for batched request (queue size: %1)")
                 .arg(m_pendingAutoExpansion.size());
         }
     }
     // Legacy: Also handle specific root node name discovery cases
-    else if (pathDepth == 1 && m_cacheManager->hasRootNode(node.path) && m_cacheManager->isRootNodeGeneric(node.path)) {
+    else if (pathDepth == 1 && m_cacheManager->hasRootNode(nodePath) && m_cacheManager->isRootNodeGeneric(nodePath)) {
         shouldAutoRequest = true;
-        qDebug().noquote() << QString("Auto-requesting children of root node %1 for name discovery").arg(node.path);
+        qCDebug(lcElements).noquote() << QString("Auto-requesting children of root node %1 for name discovery").arg(node.path);
     }
     else if (pathDepth == 2) {
-        QString rootPath = pathParts[0];
+        EmberPath rootPath = nodePath.parent();
         if (m_cacheManager->hasRootNode(rootPath)) {
             CacheManager::RootNodeInfo rootInfo = m_cacheManager->getRootNode(rootPath);
-            if (rootInfo.identityPath == node.path) {
+            if (rootInfo.identityPath == nodePath) {
                 shouldAutoRequest = true;
-                qDebug().noquote() << QString("Auto-requesting children of identity node %1 for name discovery").arg(node.path);
+                qCDebug(lcElements).noquote() << QString("Auto-requesting children of identity node %1 for name discovery").arg(node.path);
             }
         }
     }
@@ -679,7 +644,7 @@ void EmberConnection::onParserNodeReceived(const EmberData::NodeInfo& node)
                 // basePath.0.1 = label parameter (depth 2), no need to go deeper
                 if (depth < 2) {
                     shouldAutoRequest = true;
-                    qDebug().noquote() << QString("Recursive label fetch (depth %1): requesting children of %2")
+                    qCDebug(lcElements).noquote() << QString("Recursive label fetch (depth %1): requesting children of %2")
                         .arg(depth + 1).arg(node.path);
                 }
             }
@@ -697,13 +662,13 @@ void EmberConnection::onParserNodeReceived(const EmberData::NodeInfo& node)
 
 void EmberConnection::onParserParameterReceived(const EmberData::ParameterInfo& param)
 {
-    qDebug().noquote() << QString("Param %1 complete: '%2' = '%3' (Type=%4, Access=%5)")
+    qCDebug(lcElements).noquote() << QString("Param %1 complete: '%2' = '%3' (Type=%4, Access=%5)")
         .arg(param.path).arg(param.identifier).arg(param.value).arg(param.type).arg(param.access);
     
     
-    QStringList pathParts = param.path.split('.');
-    if (pathParts.size() >= 3) {
-        QString rootPath = pathParts[0];
+    EmberPath paramPath = EmberData::elementPath(param);
+    if (paramPath.depth() >= 3) {
+        EmberPath rootPath = paramPath.ancestor(1);
         if (m_cacheManager->hasRootNode(rootPath) && m_cacheManager->isRootNodeGeneric(rootPath)) {
             
             QString paramName = param.identifier.toLower();
@@ -713,38 +678,45 @@ void EmberConnection::onParserParameterReceived(const EmberData::ParameterInfo&
                 
                 CacheManager::RootNodeInfo rootInfo = m_cacheManager->getRootNode(rootPath);
                 if (!rootInfo.identityPath.isEmpty()) {
-                    if (param.path.startsWith(rootInfo.identityPath + ".")) {
-                        qDebug().noquote() << QString("Found device name '%1' for root node %2 (from %3)")
-                            .arg(param.value).arg(rootPath).arg(param.path);
+                    if (rootInfo.identityPath.isAncestorOf(paramPath)) {
+                        qCDebug(lcElements).noquote() << QString("Found device name '%1' for root node %2 (from %3)")
+                            .arg(param.value).arg(rootPath.toString()).arg(param.path);
                         
                         
                         m_cacheManager->updateRootNodeDisplayName(rootPath, param.value, false);
                         
                         
                         QString cacheKey = QString("%1:%2").arg(m_host).arg(m_port);
-                        CacheManager::cacheDevice(cacheKey, param.value, rootPath, rootInfo.identityPath);
+                        CacheManager::cacheDevice(cacheKey, param.value, rootPath.toString(), rootInfo.identityPath.toString());
                         
-                        qDebug().noquote() << QString("Cached device name '%1' for %2")
+                        qCDebug(lcElements).noquote() << QString("Cached device name '%1' for %2")
                             .arg(param.value).arg(cacheKey);
                         
                         
-                        emit nodeReceived(rootPath, param.value, param.value, true);
+                        // The root node may still be queued and must not overwrite the name afterwards
+                        flushReceivedElements();
+                        emit nodeReceived(rootPath.toString(), param.value, param.value, true);
                     }
                 }
             }
         }
     }
     
-    qDebug() << "[EmberConnection] Emitting parameterReceived - format:" << param.format << "referenceLevel:" << param.referenceLevel 
+    qCDebug(lcElements) << "[EmberConnection] Queueing parameter - format:" << param.format << "referenceLevel:" << param.referenceLevel 
              << "formula:" << param.formula << "factor:" << param.factor;
-    emit parameterReceived(param.path, param.number, param.identifier, param.description, param.value, param.access, param.type, 
-                          param.minimum, param.maximum, param.enumOptions, param.enumValues, param.isOnline, param.streamIdentifier,
-                          param.format, param.referenceLevel, param.formula, param.factor);
+    if (shouldForward(param.path, m_deviceTree.update(param))) {
+        m_pendingParameters.append(param);
+    }
+    
+    if (m_treeFetchService->isActive()) {
+        m_treeFetchService->onElementReceived(param.path, false);
+    }
+    trackRevalidation(param.path, false);
 }
 
 void EmberConnection::onParserMatrixReceived(const EmberData::MatrixInfo& matrix)
 {
-    qDebug().noquote() << QString("Matrix: %1 [%2] - Type:%3, %4×%5")
+    qCDebug(lcElements).noquote() << QString("Matrix: %1 [%2] - Type:%3, %4×%5")
                     .arg(matrix.identifier).arg(matrix.path).arg(matrix.type).arg(matrix.sourceCount).arg(matrix.targetCount);
     
     // Initialize or update label fetch state for this matrix
@@ -772,11 +744,297 @@ void EmberConnection::onParserMatrixReceived(const EmberData::MatrixInfo& matrix
             state.lastProgressEmitTime = QDateTime::currentMSecsSinceEpoch();
             QString labelType = state.fetchedTargets.size() < state.targetCount ? "targets" : "sources";
             emit matrixLabelProgress(state.identifier, fetchedCount, newTotalCount, labelType);
+            startLabelFetch(matrix.path);
+        } else if (m_labelScheduler.hasMatrix(matrix.path)) {
+            m_labelScheduler.addMatrix(matrix.path, matrix.targetCount, matrix.sourceCount);
         }
     }
     
-    emit matrixReceived(matrix.path, matrix.number, matrix.identifier, matrix.description, 
-                       matrix.type, matrix.targetCount, matrix.sourceCount);
+    if (shouldForward(matrix.path, m_deviceTree.update(matrix))) {
+        emit matrixReceived(matrix.path, matrix.number, matrix.identifier, matrix.description, 
+                           matrix.type, matrix.targetCount, matrix.sourceCount);
+    }
+    
+    if (m_treeFetchService->isActive()) {
+        m_treeFetchService->onElementReceived(matrix.path, false);
+    }
+    trackRevalidation(matrix.path, false);
+}
+
+void EmberConnection::onParserMatrixTargetReceived(const EmberData::MatrixTargetInfo& target)
+{
+    // Track that we've fetched this target label
+    if (m_matrixLabelStates.contains(target.matrixPath)) {
+        auto& state = m_matrixLabelStates[target.matrixPath];
+        state.fetchedTargets.insert(target.targetNumber);
+        if (target.isLabel) {
+            m_labelScheduler.markReceived(target.matrixPath, MatrixLabelScheduler::Target, target.targetNumber);
+        } else {
+            state.targetNumbers.append(target.targetNumber);
+            m_labelNumbersChanged.insert(target.matrixPath);
+        }
+        
+        // Emit progress for this matrix (throttle: time-based AND count-based)
+        int fetchedCount = state.fetchedTargets.size() + state.fetchedSources.size();
+        int totalCount = state.targetCount + state.sourceCount;
+        qint64 now = QDateTime::currentMSecsSinceEpoch();
+        qint64 timeSinceLastEmit = now - state.lastProgressEmitTime;
+        
+        // Emit if: 100ms has passed OR we're complete OR every 100 labels (for very fast updates)
+        if (timeSinceLastEmit >= 100 || fetchedCount == totalCount || (fetchedCount % 100 == 0)) {
+            // Determine label type based on what we're fetching
+            QString labelType = state.fetchedTargets.size() < state.targetCount ? "targets" : "sources";
+            emit matrixLabelProgress(state.identifier, fetchedCount, totalCount, labelType);
+            state.lastProgressEmitTime = now;
+        }
+        
+        // Check if this was the last matrix completing - emit labelFetchingComplete (only once)
+        if (fetchedCount == totalCount && !m_labelFetchingCompleted) {
+            bool allComplete = true;
+            for (const auto& otherState : m_matrixLabelStates) {
+                int otherFetched = otherState.fetchedTargets.size() + otherState.fetchedSources.size();
+                int otherTotal = otherState.targetCount + otherState.sourceCount;
+                if (otherTotal > 0 && otherFetched < otherTotal) {
+                    allComplete = false;
+                    break;
+                }
+            }
+            if (allComplete) {
+                qDebug() << "All matrix labels fetched - emitting labelFetchingComplete";
+                m_labelFetchingCompleted = true;  // Set flag to prevent duplicate emissions
+                emit labelFetchingComplete();
+            }
+        }
+    }
+    emit matrixTargetReceived(EmberData::matrixPathOf(target), target.targetNumber, target.label, target.isLabel);
+}
+
+void EmberConnection::onParserMatrixSourceReceived(const EmberData::MatrixSourceInfo& source)
+{
+    // Track that we've fetched this source label
+    if (m_matrixLabelStates.contains(source.matrixPath)) {
+        auto& state = m_matrixLabelStates[source.matrixPath];
+        state.fetchedSources.insert(source.sourceNumber);
+        if (source.isLabel) {
+            m_labelScheduler.markReceived(source.matrixPath, MatrixLabelScheduler::Source, source.sourceNumber);
+        } else {
+            state.sourceNumbers.append(source.sourceNumber);
+            m_labelNumbersChanged.insert(source.matrixPath);
+        }
+        
+        // Emit progress for this matrix (throttle: time-based AND count-based)
+        int fetchedCount = state.fetchedTargets.size() + state.fetchedSources.size();
+        int totalCount = state.targetCount + state.sourceCount;
+        qint64 now = QDateTime::currentMSecsSinceEpoch();
+        qint64 timeSinceLastEmit = now - state.lastProgressEmitTime;
+        
+        // Emit if: 100ms has passed OR we're complete OR every 100 labels (for very fast updates)
+        if (timeSinceLastEmit >= 100 || fetchedCount == totalCount || (fetchedCount % 100 == 0)) {
+            // Determine label type based on what we're fetching
+            QString labelType = state.fetchedSources.size() < state.sourceCount ? "sources" : "sources";
+            emit matrixLabelProgress(state.identifier, fetchedCount, totalCount, labelType);
+            state.lastProgressEmitTime = now;
+        }
+        
+        // Check if this was the last matrix completing - emit labelFetchingComplete (only once)
+        if (fetchedCount == totalCount && !m_labelFetchingCompleted) {
+            bool allComplete = true;
+            for (const auto& otherState : m_matrixLabelStates) {
+                int otherFetched = otherState.fetchedTargets.size() + otherState.fetchedSources.size();
+                int otherTotal = otherState.targetCount + otherState.sourceCount;
+                if (otherTotal > 0 && otherFetched < otherTotal) {
+                    allComplete = false;
+                    break;
+                }
+            }
+            if (allComplete) {
+                qDebug() << "All matrix labels fetched - emitting labelFetchingComplete";
+                m_labelFetchingCompleted = true;  // Set flag to prevent duplicate emissions
+                emit labelFetchingComplete();
+            }
+        }
+    }
+    emit matrixSourceReceived(EmberData::matrixPathOf(source), source.sourceNumber, source.label, source.isLabel);
+}
+
+void EmberConnection::onParserInvocationResultReceived(const EmberData::InvocationResult& result)
+{
+    if (m_pendingInvocations.contains(result.invocationId)) {
+        m_pendingInvocations.remove(result.invocationId);
+    }
+    emit invocationResultReceived(result.invocationId, result.success, result.results);
+}
+
+void EmberConnection::onParserMatrixLabelPathsDiscovered(const EmberData::MatrixLabelPaths& labelPaths)
+{
+    const QString& matrixPath = labelPaths.matrixPath;
+    const QStringList& basePaths = labelPaths.basePaths;
+    
+    // Update the matrix fetch state with label base paths
+    if (!m_matrixLabelStates.contains(matrixPath)) {
+        return;
+    }
+    
+    auto& state = m_matrixLabelStates[matrixPath];
+    state.labelBasePaths = basePaths;
+    
+    int totalCount = state.targetCount + state.sourceCount;
+    
+    // Skip 0x0 matrices - no labels to fetch
+    if (totalCount == 0) {
+        qInfo().noquote() << QString("Matrix %1: Skipping label fetch (0×0 dimensions)")
+            .arg(matrixPath);
+        return;
+    }
+    
+    qInfo().noquote() << QString("Matrix %1: Prefetching labels for %2 label layers")
+        .arg(matrixPath).arg(basePaths.size());
+    
+    // Emit initial progress (0/total) to show which matrix we're starting to fetch
+    state.lastProgressEmitTime = QDateTime::currentMSecsSinceEpoch();
+    emit matrixLabelProgress(state.identifier, 0, totalCount, "targets");
+    
+    for (const QString& basePath : basePaths) {
+        m_labelBasePaths.insert(basePath);
+        m_labelPathToMatrix[basePath] = matrixPath;
+    }
+    
+    startLabelFetch(matrixPath);
+}
+
+void EmberConnection::startLabelFetch(const QString& matrixPath)
+{
+    const auto& state = m_matrixLabelStates[matrixPath];
+    if (state.labelBasePaths.isEmpty() || m_labelFetchPaths.contains(state.labelBasePaths.first())) {
+        return;  // Nothing to fetch, or already fetching whole layers
+    }
+    
+    m_labelScheduler.addMatrix(matrixPath, state.targetCount, state.sourceCount);
+    m_labelNumbersChanged.insert(matrixPath);
+    
+    // The matrix's target and source lists follow its label paths in the same message
+    QMetaObject::invokeMethod(this, &EmberConnection::pumpLabelRequests, Qt::QueuedConnection);
+}
+
+void EmberConnection::setMatrixLabelViewport(const QString& matrixPath, int firstTarget, int lastTarget,
+                                             int firstSource, int lastSource)
+{
+    m_labelScheduler.setVisibleRange(matrixPath, firstTarget, lastTarget, firstSource, lastSource);
+    pumpLabelRequests();
+}
+
+void EmberConnection::pumpLabelRequests()
+{
+    for (const QString& matrixPath : std::as_const(m_labelNumbersChanged)) {
+        auto state = m_matrixLabelStates.find(matrixPath);
+        if (state == m_matrixLabelStates.end() || !m_labelScheduler.hasMatrix(matrixPath)) {
+            continue;   // Applied once the label fetch starts
+        }
+        for (QList<int> *numbers : {&state->targetNumbers, &state->sourceNumbers}) {
+            std::sort(numbers->begin(), numbers->end());
+            numbers->erase(std::unique(numbers->begin(), numbers->end()), numbers->end());
+        }
+        m_labelScheduler.setNumbers(matrixPath, MatrixLabelScheduler::Target, state->targetNumbers);
+        m_labelScheduler.setNumbers(matrixPath, MatrixLabelScheduler::Source, state->sourceNumbers);
+    }
+    m_labelNumbersChanged.clear();
+    
+    if (!m_connected || m_labelScheduler.isIdle()) {
+        return;
+    }
+    
+    QVector<MatrixLabelScheduler::Request> requests = m_labelScheduler.takeRequests(m_labelClock.elapsed());
+    if (!requests.isEmpty()) {
+        sendLabelRequests(requests);
+    }
+    if (m_labelScheduler.inFlightCount() > 0 && !m_labelRequestTimer->isActive()) {
+        m_labelRequestTimer->start();
+    }
+}
+
+void EmberConnection::sendLabelRequests(const QVector<MatrixLabelScheduler::Request>& requests)
+{
+    try {
+        libember::glow::DirFieldMask fieldMask(libember::glow::DirFieldMask::Identifier |
+                                               libember::glow::DirFieldMask::Value);
+        auto root = new libember::glow::GlowRootElementCollection();
+        
+        // Labels are parameters at <basePath>.<1 targets|2 sources>.<number>
+        for (const MatrixLabelScheduler::Request& request : requests) {
+            const QString& basePath = m_matrixLabelStates[request.matrixPath].labelBasePaths.first();
+            QString path = QString("%1.%2.%3").arg(basePath).arg(int(request.type)).arg(request.number);
+            
+            auto param = new libember::glow::GlowQualifiedParameter(toObjectIdentifier(path));
+            auto cmd = new libember::glow::GlowCommand(libember::glow::CommandType::GetDirectory, fieldMask);
+            param->children()->insert(param->children()->end(), cmd);
+            root->insert(root->end(), param);
+        }
+        
+        libember::util::OctetStream stream;
+        root->encode(stream);
+        delete root;
+        
+        sendFrame(m_s101Protocol->encodeEmberData(stream));
+        qCDebug(lcIo).noquote() << QString("Requested %1 matrix labels (%2 in flight)")
+            .arg(requests.size()).arg(m_labelScheduler.inFlightCount());
+    }
+    catch (const std::exception &ex) {
+        qCritical().noquote() << QString("Error sending label requests: %1").arg(ex.what());
+    }
+}
+
+void EmberConnection::onLabelRequestTimer()
+{
+    QVector<MatrixLabelScheduler::Request> expired =
+        m_labelScheduler.takeExpired(m_labelClock.elapsed(), LABEL_REQUEST_TIMEOUT_MS);
+    
+    QSet<QString> unanswered;
+    for (const MatrixLabelScheduler::Request& request : expired) {
+        if (!m_labelScheduler.hasAnswers(request.matrixPath)) {
+            unanswered.insert(request.matrixPath);
+        }
+    }
+    
+    // The provider never answered a single label request: fetch the layers the old way
+    for (const QString& matrixPath : unanswered) {
+        qInfo().noquote() << QString("Matrix %1: No answer to label requests, fetching whole label layers")
+            .arg(matrixPath);
+        m_labelScheduler.removeMatrix(matrixPath);
+        fetchLabelLayers(matrixPath);
+    }
+    
+    if (!expired.isEmpty()) {
+        qCDebug(lcIo).noquote() << QString("%1 matrix label requests expired").arg(expired.size());
+    }
+    
+    pumpLabelRequests();
+    if (m_labelScheduler.inFlightCount() == 0) {
+        m_labelRequestTimer->stop();
+    }
+    
+    // Labels that never arrive must not hold back the end of the label phase
+    if (m_labelScheduler.isIdle() && m_pendingLabelPaths.isEmpty() && m_labelFetchPaths.isEmpty()
+        && !m_labelFetchingCompleted && !expired.isEmpty()) {
+        m_labelFetchingCompleted = true;
+        emit labelFetchingComplete();
+    }
+}
+
+void EmberConnection::fetchLabelLayers(const QString& matrixPath)
+{
+    for (const QString& basePath : m_matrixLabelStates[matrixPath].labelBasePaths) {
+        // Track this as a label base path for recursive fetching
+        m_labelFetchPaths.insert(basePath);
+        qCDebug(lcIo).noquote() << QString("  - Queueing label fetch at basePath: %1").arg(basePath);
+        
+        if (!m_pendingLabelPaths.contains(basePath)) {
+            m_pendingLabelPaths.append(basePath);
+        }
+    }
+    
+    if (m_labelBatchTimer && !m_labelBatchTimer->isActive()) {
+        m_labelBatchTimer->start();
+    }
 }
 
 bool EmberConnection::isGenericNodeName(const QString &name)
@@ -798,23 +1056,23 @@ void EmberConnection::sendGetDirectory()
 
 void EmberConnection::sendGetDirectoryForPath(const QString& path, bool optimizedForNameDiscovery)
 {
-    qDebug().noquote() << QString("sendGetDirectoryForPath called with path='%1'").arg(path);
-    qDebug().noquote() << QString("m_requestedPaths size: %1").arg(m_requestedPaths.size());
+    qCDebug(lcIo).noquote() << QString("sendGetDirectoryForPath called with path='%1'").arg(path);
+    qCDebug(lcIo).noquote() << QString("m_requestedPaths size: %1").arg(m_requestedPaths.size());
     
     
     if (m_requestedPaths.contains(path)) {
-        qDebug().noquote() << QString("ERROR: Skipping duplicate request for %1").arg(path.isEmpty() ? "root" : path);
+        qCDebug(lcIo).noquote() << QString("ERROR: Skipping duplicate request for %1").arg(path.isEmpty() ? "root" : path);
         return;
     }
-    qDebug().noquote() << "Passed duplicate check, inserting path";
+    qCDebug(lcIo).noquote() << "Passed duplicate check, inserting path";
     m_requestedPaths.insert(path);
-    qDebug().noquote() << "Path inserted, continuing...";
+    qCDebug(lcIo).noquote() << "Path inserted, continuing...";
     
     try {
         if (path.isEmpty()) {
-            qDebug().noquote() << "Requesting root directory...";
+            qCDebug(lcIo).noquote() << "Requesting root directory...";
         } else {
-            qDebug().noquote() << QString("Requesting children of %1%2...")
+            qCDebug(lcIo).noquote() << QString("Requesting children of %1%2...")
                 .arg(path)
                 .arg(optimizedForNameDiscovery ? " (optimized for name discovery)" : "");
         }
@@ -828,29 +1086,24 @@ void EmberConnection::sendGetDirectoryForPath(const QString& path, bool optimize
                                            libember::glow::DirFieldMask::Value)
             : libember::glow::DirFieldMask::All;
         
-        qDebug().noquote() << "Creating GlowRootElementCollection...";
+        qCDebug(lcIo).noquote() << "Creating GlowRootElementCollection...";
         auto root = new libember::glow::GlowRootElementCollection();
         
         if (path.isEmpty()) {
             
-            qDebug().noquote() << "Creating bare GlowCommand for root...";
+            qCDebug(lcIo).noquote() << "Creating bare GlowCommand for root...";
             auto command = new libember::glow::GlowCommand(
                 libember::glow::CommandType::GetDirectory,
                 fieldMask
             );
-            qDebug().noquote() << "Inserting command into root...";
+            qCDebug(lcIo).noquote() << "Inserting command into root...";
             root->insert(root->end(), command);
-            qDebug().noquote() << "Command inserted successfully";
+            qCDebug(lcIo).noquote() << "Command inserted successfully";
         }
         else {
             
-            qDebug().noquote() << QString("Creating QualifiedNode for path: %1").arg(path);
-            QStringList segments = path.split('.', Qt::SkipEmptyParts);
-            libember::ber::ObjectIdentifier oid;
-            
-            for (const QString& seg : segments) {
-                oid.push_back(seg.toInt());
-            }
+            qCDebug(lcIo).noquote() << QString("Creating QualifiedNode for path: %1").arg(path);
+            libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
             
             auto node = new libember::glow::GlowQualifiedNode(oid);
             new libember::glow::GlowCommand(
@@ -859,27 +1112,26 @@ void EmberConnection::sendGetDirectoryForPath(const QString& path, bool optimize
                 fieldMask
             );
             root->insert(root->end(), node);
-            qDebug().noquote() << QString("QualifiedNode with command inserted (field mask: %1)")
+            qCDebug(lcIo).noquote() << QString("QualifiedNode with command inserted (field mask: %1)")
                 .arg(optimizedForNameDiscovery ? "Name discovery" : "All");
         }
         
         
-        qDebug().noquote() << "Encoding to EmBER...";
+        qCDebug(lcIo).noquote() << "Encoding to EmBER...";
         libember::util::OctetStream stream;
         root->encode(stream);
-        qDebug().noquote() << QString("EmBER payload size: %1 bytes").arg(stream.size());
+        qCDebug(lcIo).noquote() << QString("EmBER payload size: %1 bytes").arg(stream.size());
         
         
         QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
         
         
-        qDebug().noquote() << QString("About to write %1 bytes to socket...").arg(s101Frame.size());
-        if (m_socket->write(s101Frame) > 0) {
-            m_socket->flush();
-            qDebug().noquote() << QString("Successfully sent GetDirectory request (%1 bytes)").arg(s101Frame.size());
+        qCDebug(lcIo).noquote() << QString("About to write %1 bytes to socket...").arg(s101Frame.size());
+        if (sendFrame(s101Frame)) {
+            qCDebug(lcIo).noquote() << QString("Successfully sent GetDirectory request (%1 bytes)").arg(s101Frame.size());
         }
         else {
-            qCritical().noquote() << "Failed to send GetDirectory - socket write returned 0 or error";
+            qCritical().noquote() << "Failed to send GetDirectory - socket not connected";
         }
         
         delete root;
@@ -902,7 +1154,7 @@ void EmberConnection::sendBatchGetDirectory(const QStringList& paths, bool optim
             pathsToRequest.append(path);
             m_requestedPaths.insert(path);
         } else {
-            qDebug().noquote() << QString("Skipping duplicate request for %1").arg(path.isEmpty() ? "root" : path);
+            qCDebug(lcIo).noquote() << QString("Skipping duplicate request for %1").arg(path.isEmpty() ? "root" : path);
         }
     }
     
@@ -911,7 +1163,7 @@ void EmberConnection::sendBatchGetDirectory(const QStringList& paths, bool optim
     }
     
     try {
-        qDebug().noquote() << QString("Batch requesting %1 paths%2...")
+        qCDebug(lcIo).noquote() << QString("Batch requesting %1 paths%2...")
             .arg(pathsToRequest.size())
             .arg(optimizedForNameDiscovery ? " (optimized for name discovery)" : "");
         
@@ -937,12 +1189,7 @@ void EmberConnection::sendBatchGetDirectory(const QStringList& paths, bool optim
             }
             else {
                 
-                QStringList segments = path.split('.', Qt::SkipEmptyParts);
-                libember::ber::ObjectIdentifier oid;
-                
-                for (const QString& seg : segments) {
-                    oid.push_back(seg.toInt());
-                }
+                libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
                 
                 auto node = new libember::glow::GlowQualifiedNode(oid);
                 new libember::glow::GlowCommand(
@@ -962,8 +1209,7 @@ void EmberConnection::sendBatchGetDirectory(const QStringList& paths, bool optim
         QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
         
         
-        if (m_socket->write(s101Frame) > 0) {
-            m_socket->flush();
+        if (sendFrame(s101Frame)) {
         }
         else {
             qWarning().noquote() << "Failed to send batch GetDirectory";
@@ -979,15 +1225,10 @@ void EmberConnection::sendBatchGetDirectory(const QStringList& paths, bool optim
 void EmberConnection::sendParameterValue(const QString &path, const QString &value, int type)
 {
     try {
-        qDebug().noquote() << QString("Setting parameter %1 = %2").arg(path).arg(value);
-        
+        qCDebug(lcIo).noquote() << QString("Setting parameter %1 = %2").arg(path).arg(value);
         
-        QStringList segments = path.split('.', Qt::SkipEmptyParts);
-        libember::ber::ObjectIdentifier oid;
         
-        for (const QString& seg : segments) {
-            oid.push_back(seg.toInt());
-        }
+        libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
         
         
         auto param = new libember::glow::GlowQualifiedParameter(oid);
@@ -1038,9 +1279,8 @@ void EmberConnection::sendParameterValue(const QString &path, const QString &val
         QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
         
         
-        if (m_socket->write(s101Frame) > 0) {
-            m_socket->flush();
-            qDebug().noquote() << QString("Successfully sent value for %1").arg(path);
+        if (sendFrame(s101Frame)) {
+            qCDebug(lcIo).noquote() << QString("Successfully sent value for %1").arg(path);
         }
         else {
             qWarning().noquote() << QString("Failed to send value for %1").arg(path);
@@ -1055,73 +1295,144 @@ void EmberConnection::sendParameterValue(const QString &path, const QString &val
 
 void EmberConnection::setMatrixConnection(const QString &matrixPath, int targetNumber, int sourceNumber, bool connect)
 {
-    try {
-        QString operation = connect ? "CONNECT" : "DISCONNECT";
-        
-        qDebug().noquote() << QString(">>> Sending %1: Matrix=%2, Target=%3, Source=%4")
-                       .arg(operation).arg(matrixPath).arg(targetNumber).arg(sourceNumber);
-        
-        
-        QStringList segments = matrixPath.split('.', Qt::SkipEmptyParts);
-        libember::ber::ObjectIdentifier matrixOid;
-        
-        for (const QString& seg : segments) {
-            matrixOid.push_back(seg.toInt());
-        }
-        
-        
-        auto matrix = new libember::glow::GlowQualifiedMatrix(matrixOid);
-        
-        
-        auto connectionsSeq = matrix->connections();
-        
-        
-        auto connection = new libember::glow::GlowConnection(targetNumber);
-        
-        
+    QString operation = connect ? "CONNECT" : "DISCONNECT";
+    
+    qCDebug(lcIo).noquote() << QString(">>> Sending %1: Matrix=%2, Target=%3, Source=%4")
+                   .arg(operation).arg(matrixPath).arg(targetNumber).arg(sourceNumber);
+    
+    
+    MatrixSalvo salvo;
+    SalvoTarget &target = salvo[matrixPath][targetNumber];
+    if (connect) {
+        target.connectSources.append(sourceNumber);
+    } else {
+        target.disconnectSources.append(sourceNumber);
+    }
+    
+    if (sendMatrixSalvo(salvo)) {
+        qCDebug(lcIo).noquote() << QString("Successfully sent matrix connection command");
+    }
+    else {
+        qWarning().noquote() << QString("Failed to send matrix connection command");
+    }
+}
+
+void EmberConnection::addSalvoConnection(const QString &matrixPath, int targetNumber, int sourceNumber, bool connect)
+{
+    SalvoTarget &target = m_pendingSalvo[matrixPath][targetNumber];
+    
+    if (target.absolute) {
+        // Adjust the absolute source list instead of mixing operations on one target
+        target.connectSources.removeAll(sourceNumber);
         if (connect) {
-            connection->setOperation(libember::glow::ConnectionOperation::Connect);
-            qDebug().noquote() << QString("    Operation: Connect (1)");
-        } else {
-            connection->setOperation(libember::glow::ConnectionOperation::Disconnect);
-            qDebug().noquote() << QString("    Operation: Disconnect (2)");
+            target.connectSources.append(sourceNumber);
         }
-        
-        
-        
-        libember::ber::ObjectIdentifier sources;
-        sources.push_back(sourceNumber);
-        connection->setSources(sources);
-        qDebug().noquote() << QString("    Sources: [%1]").arg(sourceNumber);
-        
-        
-        connectionsSeq->insert(connectionsSeq->end(), connection);
-        
-        
-        auto root = new libember::glow::GlowRootElementCollection();
-        root->insert(root->end(), matrix);
-        
-        
-        libember::util::OctetStream stream;
-        root->encode(stream);
-        
-        
-        QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
-        
-        
-        if (m_socket->write(s101Frame) > 0) {
-            m_socket->flush();
-            qDebug().noquote() << QString("Successfully sent matrix connection command");
+        return;
+    }
+    
+    // The latest change to a crosspoint wins
+    target.connectSources.removeAll(sourceNumber);
+    target.disconnectSources.removeAll(sourceNumber);
+    if (connect) {
+        target.connectSources.append(sourceNumber);
+    } else {
+        target.disconnectSources.append(sourceNumber);
+    }
+}
+
+void EmberConnection::setSalvoTargetSources(const QString &matrixPath, int targetNumber, const QList<int> &sourceNumbers)
+{
+    SalvoTarget &target = m_pendingSalvo[matrixPath][targetNumber];
+    target.absolute = true;
+    target.connectSources = sourceNumbers;
+    target.disconnectSources.clear();
+}
+
+void EmberConnection::commitMatrixSalvo()
+{
+    if (m_pendingSalvo.isEmpty()) {
+        return;
+    }
+    
+    int changeCount = pendingSalvoSize();
+    int matrixCount = m_pendingSalvo.size();
+    MatrixSalvo salvo;
+    salvo.swap(m_pendingSalvo);
+    
+    if (sendMatrixSalvo(salvo)) {
+        qInfo().noquote() << QString("Sent salvo of %1 crosspoint changes on %2 matrices").arg(changeCount).arg(matrixCount);
+    }
+    else {
+        qWarning().noquote() << QString("Failed to send salvo of %1 crosspoint changes").arg(changeCount);
+    }
+}
+
+void EmberConnection::discardMatrixSalvo()
+{
+    m_pendingSalvo.clear();
+}
+
+int EmberConnection::pendingSalvoSize() const
+{
+    int count = 0;
+    for (const auto &targets : m_pendingSalvo) {
+        for (const SalvoTarget &target : targets) {
+            count += target.connectSources.size() + target.disconnectSources.size();
         }
-        else {
-            qWarning().noquote() << QString("Failed to send matrix connection command");
+    }
+    return count;
+}
+
+bool EmberConnection::sendMatrixSalvo(const MatrixSalvo &salvo)
+{
+    auto root = new libember::glow::GlowRootElementCollection();
+    bool sent = false;
+    
+    try {
+        auto appendConnection = [](libember::dom::Sequence *connections, int targetNumber,
+                                   libember::glow::ConnectionOperation operation, const QList<int> &sourceNumbers) {
+            auto connection = new libember::glow::GlowConnection(targetNumber);
+            connection->setOperation(operation);
+            
+            libember::ber::ObjectIdentifier sources;
+            for (int sourceNumber : sourceNumbers) {
+                sources.push_back(sourceNumber);
+            }
+            connection->setSources(sources);
+            connections->insert(connections->end(), connection);
+        };
+        
+        // One qualified matrix per matrix path, each target contributes at most two connections
+        for (auto matrixIt = salvo.constBegin(); matrixIt != salvo.constEnd(); ++matrixIt) {
+            auto matrix = new libember::glow::GlowQualifiedMatrix(toObjectIdentifier(matrixIt.key()));
+            root->insert(root->end(), matrix);
+            auto connections = matrix->connections();
+            
+            for (auto targetIt = matrixIt.value().constBegin(); targetIt != matrixIt.value().constEnd(); ++targetIt) {
+                const SalvoTarget &target = targetIt.value();
+                if (target.absolute) {
+                    appendConnection(connections, targetIt.key(), libember::glow::ConnectionOperation::Absolute, target.connectSources);
+                    continue;
+                }
+                if (!target.connectSources.isEmpty()) {
+                    appendConnection(connections, targetIt.key(), libember::glow::ConnectionOperation::Connect, target.connectSources);
+                }
+                if (!target.disconnectSources.isEmpty()) {
+                    appendConnection(connections, targetIt.key(), libember::glow::ConnectionOperation::Disconnect, target.disconnectSources);
+                }
+            }
         }
         
-        delete root;
+        libember::util::OctetStream stream;
+        root->encode(stream);
+        sent = sendFrame(m_s101Protocol->encodeEmberData(stream));
     }
     catch (const std::exception &ex) {
-        qCritical().noquote() << QString("Error sending matrix connection for %1: %2").arg(matrixPath).arg(ex.what());
+        qCritical().noquote() << QString("Error sending matrix connections: %1").arg(ex.what());
     }
+    
+    delete root;
+    return sent;
 }
 
 void EmberConnection::invokeFunction(const QString &path, const QList<QVariant> &arguments)
@@ -1134,11 +1445,7 @@ void EmberConnection::invokeFunction(const QString &path, const QList<QVariant>
     int invocationId = m_nextInvocationId++;
     m_pendingInvocations[invocationId] = path;
     
-    QStringList pathParts = path.split('.');
-    libember::ber::ObjectIdentifier oid;
-    for (const QString &part : pathParts) {
-        oid.push_back(part.toInt());
-    }
+    libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
     
     auto root = new libember::glow::GlowRootElementCollection();
     auto invocation = new libember::glow::GlowInvocation();
@@ -1186,32 +1493,27 @@ void EmberConnection::invokeFunction(const QString &path, const QList<QVariant>
     
     
     QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
-    m_socket->write(s101Frame);
-    m_socket->flush();
+    sendFrame(s101Frame);
     
-    qDebug().noquote() << QString("Sent function invocation for %1").arg(path);
+    qCDebug(lcIo).noquote() << QString("Sent function invocation for %1").arg(path);
     delete root;
 }
 
 
 void EmberConnection::subscribeToParameter(const QString &path, bool autoSubscribed)
 {
-    if (!m_socket || !m_connected) {
+    if (!m_connected) {
         qWarning().noquote() << "Cannot subscribe - not connected";
         return;
     }
     
     if (m_subscriptions.contains(path)) {
-        qDebug().noquote() << QString("Already subscribed to %1").arg(path);
+        qCDebug(lcIo).noquote() << QString("Already subscribed to %1").arg(path);
         return;
     }
     
     
-    QStringList segments = path.split('.', Qt::SkipEmptyParts);
-    libember::ber::ObjectIdentifier oid;
-    for (const QString& seg : segments) {
-        oid.push_back(seg.toInt());
-    }
+    libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
     
     
     auto param = new libember::glow::GlowQualifiedParameter(oid);
@@ -1229,8 +1531,7 @@ void EmberConnection::subscribeToParameter(const QString &path, bool autoSubscri
     QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
     
     
-    m_socket->write(s101Frame);
-    m_socket->flush();
+    sendFrame(s101Frame);
     
     
     SubscriptionState state;
@@ -1238,7 +1539,7 @@ void EmberConnection::subscribeToParameter(const QString &path, bool autoSubscri
     state.autoSubscribed = autoSubscribed;
     m_subscriptions[path] = state;
     
-    qDebug().noquote() << QString("Subscribed to parameter: %1 %2")
+    qCDebug(lcIo).noquote() << QString("Subscribed to parameter: %1 %2")
         .arg(path)
         .arg(autoSubscribed ? "(auto)" : "(manual)");
     
@@ -1247,22 +1548,18 @@ void EmberConnection::subscribeToParameter(const QString &path, bool autoSubscri
 
 void EmberConnection::subscribeToNode(const QString &path, bool autoSubscribed)
 {
-    if (!m_socket || !m_connected) {
+    if (!m_connected) {
         qWarning().noquote() << "Cannot subscribe - not connected";
         return;
     }
     
     if (m_subscriptions.contains(path)) {
-        qDebug().noquote() << QString("Already subscribed to %1").arg(path);
+        qCDebug(lcIo).noquote() << QString("Already subscribed to %1").arg(path);
         return;
     }
     
     
-    QStringList segments = path.split('.', Qt::SkipEmptyParts);
-    libember::ber::ObjectIdentifier oid;
-    for (const QString& seg : segments) {
-        oid.push_back(seg.toInt());
-    }
+    libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
     
     
     auto node = new libember::glow::GlowQualifiedNode(oid);
@@ -1280,8 +1577,7 @@ void EmberConnection::subscribeToNode(const QString &path, bool autoSubscribed)
     QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
     
     
-    m_socket->write(s101Frame);
-    m_socket->flush();
+    sendFrame(s101Frame);
     
     
     SubscriptionState state;
@@ -1289,7 +1585,7 @@ void EmberConnection::subscribeToNode(const QString &path, bool autoSubscribed)
     state.autoSubscribed = autoSubscribed;
     m_subscriptions[path] = state;
     
-    qDebug().noquote() << QString("Subscribed to node: %1 %2")
+    qCDebug(lcIo).noquote() << QString("Subscribed to node: %1 %2")
         .arg(path)
         .arg(autoSubscribed ? "(auto)" : "(manual)");
     
@@ -1298,22 +1594,18 @@ void EmberConnection::subscribeToNode(const QString &path, bool autoSubscribed)
 
 void EmberConnection::subscribeToMatrix(const QString &path, bool autoSubscribed)
 {
-    if (!m_socket || !m_connected) {
+    if (!m_connected) {
         qWarning().noquote() << "Cannot subscribe - not connected";
         return;
     }
     
     if (m_subscriptions.contains(path)) {
-        qDebug().noquote() << QString("Already subscribed to %1").arg(path);
+        qCDebug(lcIo).noquote() << QString("Already subscribed to %1").arg(path);
         return;
     }
     
     
-    QStringList segments = path.split('.', Qt::SkipEmptyParts);
-    libember::ber::ObjectIdentifier oid;
-    for (const QString& seg : segments) {
-        oid.push_back(seg.toInt());
-    }
+    libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
     
     
     auto matrix = new libember::glow::GlowQualifiedMatrix(oid);
@@ -1331,8 +1623,7 @@ void EmberConnection::subscribeToMatrix(const QString &path, bool autoSubscribed
     QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
     
     
-    m_socket->write(s101Frame);
-    m_socket->flush();
+    sendFrame(s101Frame);
     
     
     SubscriptionState state;
@@ -1340,7 +1631,7 @@ void EmberConnection::subscribeToMatrix(const QString &path, bool autoSubscribed
     state.autoSubscribed = autoSubscribed;
     m_subscriptions[path] = state;
     
-    qDebug().noquote() << QString("Subscribed to matrix: %1 %2")
+    qCDebug(lcIo).noquote() << QString("Subscribed to matrix: %1 %2")
         .arg(path)
         .arg(autoSubscribed ? "(auto)" : "(manual)");
     
@@ -1349,22 +1640,18 @@ void EmberConnection::subscribeToMatrix(const QString &path, bool autoSubscribed
 
 void EmberConnection::unsubscribeFromParameter(const QString &path)
 {
-    if (!m_socket || !m_connected) {
+    if (!m_connected) {
         qWarning().noquote() << "Cannot unsubscribe - not connected";
         return;
     }
     
     if (!m_subscriptions.contains(path)) {
-        qDebug().noquote() << QString("Not subscribed to %1").arg(path);
+        qCDebug(lcIo).noquote() << QString("Not subscribed to %1").arg(path);
         return;
     }
     
     
-    QStringList segments = path.split('.', Qt::SkipEmptyParts);
-    libember::ber::ObjectIdentifier oid;
-    for (const QString& seg : segments) {
-        oid.push_back(seg.toInt());
-    }
+    libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
     
     
     auto param = new libember::glow::GlowQualifiedParameter(oid);
@@ -1382,35 +1669,30 @@ void EmberConnection::unsubscribeFromParameter(const QString &path)
     QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
     
     
-    m_socket->write(s101Frame);
-    m_socket->flush();
+    sendFrame(s101Frame);
     
     
     m_subscriptions.remove(path);
     
-    qDebug().noquote() << QString("Unsubscribed from parameter: %1").arg(path);
+    qCDebug(lcIo).noquote() << QString("Unsubscribed from parameter: %1").arg(path);
     
     delete root;
 }
 
 void EmberConnection::unsubscribeFromNode(const QString &path)
 {
-    if (!m_socket || !m_connected) {
+    if (!m_connected) {
         qWarning().noquote() << "Cannot unsubscribe - not connected";
         return;
     }
     
     if (!m_subscriptions.contains(path)) {
-        qDebug().noquote() << QString("Not subscribed to %1").arg(path);
+        qCDebug(lcIo).noquote() << QString("Not subscribed to %1").arg(path);
         return;
     }
     
     
-    QStringList segments = path.split('.', Qt::SkipEmptyParts);
-    libember::ber::ObjectIdentifier oid;
-    for (const QString& seg : segments) {
-        oid.push_back(seg.toInt());
-    }
+    libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
     
     
     auto node = new libember::glow::GlowQualifiedNode(oid);
@@ -1428,35 +1710,30 @@ void EmberConnection::unsubscribeFromNode(const QString &path)
     QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
     
     
-    m_socket->write(s101Frame);
-    m_socket->flush();
+    sendFrame(s101Frame);
     
     
     m_subscriptions.remove(path);
     
-    qDebug().noquote() << QString("Unsubscribed from node: %1").arg(path);
+    qCDebug(lcIo).noquote() << QString("Unsubscribed from node: %1").arg(path);
     
     delete root;
 }
 
 void EmberConnection::unsubscribeFromMatrix(const QString &path)
 {
-    if (!m_socket || !m_connected) {
+    if (!m_connected) {
         qWarning().noquote() << "Cannot unsubscribe - not connected";
         return;
     }
     
     if (!m_subscriptions.contains(path)) {
-        qDebug().noquote() << QString("Not subscribed to %1").arg(path);
+        qCDebug(lcIo).noquote() << QString("Not subscribed to %1").arg(path);
         return;
     }
     
     
-    QStringList segments = path.split('.', Qt::SkipEmptyParts);
-    libember::ber::ObjectIdentifier oid;
-    for (const QString& seg : segments) {
-        oid.push_back(seg.toInt());
-    }
+    libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
     
     
     auto matrix = new libember::glow::GlowQualifiedMatrix(oid);
@@ -1474,13 +1751,12 @@ void EmberConnection::unsubscribeFromMatrix(const QString &path)
     QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
     
     
-    m_socket->write(s101Frame);
-    m_socket->flush();
+    sendFrame(s101Frame);
     
     
     m_subscriptions.remove(path);
     
-    qDebug().noquote() << QString("Unsubscribed from matrix: %1").arg(path);
+    qCDebug(lcIo).noquote() << QString("Unsubscribed from matrix: %1").arg(path);
     
     delete root;
 }
@@ -1491,7 +1767,7 @@ void EmberConnection::sendBatchSubscribe(const QList<SubscriptionRequest>& reque
         return;
     }
     
-    if (!m_socket || !m_connected) {
+    if (!m_connected) {
         qWarning().noquote() << "Cannot batch subscribe - not connected";
         return;
     }
@@ -1502,17 +1778,17 @@ void EmberConnection::sendBatchSubscribe(const QList<SubscriptionRequest>& reque
         if (!m_subscriptions.contains(req.path)) {
             toSubscribe.append(req);
         } else {
-            qDebug().noquote() << QString("Skipping duplicate subscription for %1").arg(req.path);
+            qCDebug(lcIo).noquote() << QString("Skipping duplicate subscription for %1").arg(req.path);
         }
     }
     
     if (toSubscribe.isEmpty()) {
-        qDebug().noquote() << "All paths already subscribed, skipping batch";
+        qCDebug(lcIo).noquote() << "All paths already subscribed, skipping batch";
         return;
     }
     
     try {
-        qDebug().noquote() << QString("Batch subscribing to %1 paths...").arg(toSubscribe.size());
+        qCDebug(lcIo).noquote() << QString("Batch subscribing to %1 paths...").arg(toSubscribe.size());
         
         
         
@@ -1520,47 +1796,14 @@ void EmberConnection::sendBatchSubscribe(const QList<SubscriptionRequest>& reque
         
         int successCount = 0;
         for (const auto& req : toSubscribe) {
-            
-            QStringList segments = req.path.split('.', Qt::SkipEmptyParts);
-            libember::ber::ObjectIdentifier oid;
-            for (const QString& seg : segments) {
-                oid.push_back(seg.toInt());
-            }
-            
-            
-            if (req.type == "Node") {
-                auto node = new libember::glow::GlowQualifiedNode(oid);
-                auto cmd = new libember::glow::GlowCommand(libember::glow::CommandType::Subscribe);
-                node->children()->insert(node->children()->end(), cmd);
-                root->insert(root->end(), node);
-                successCount++;
-            }
-            else if (req.type == "Parameter") {
-                auto param = new libember::glow::GlowQualifiedParameter(oid);
-                auto cmd = new libember::glow::GlowCommand(libember::glow::CommandType::Subscribe);
-                param->children()->insert(param->children()->end(), cmd);
-                root->insert(root->end(), param);
-                successCount++;
-            }
-            else if (req.type == "Matrix") {
-                auto matrix = new libember::glow::GlowQualifiedMatrix(oid);
-                auto cmd = new libember::glow::GlowCommand(libember::glow::CommandType::Subscribe);
-                matrix->children()->insert(matrix->children()->end(), cmd);
-                root->insert(root->end(), matrix);
-                successCount++;
-            }
-            else if (req.type == "Function") {
-                auto function = new libember::glow::GlowQualifiedFunction(oid);
-                auto cmd = new libember::glow::GlowCommand(libember::glow::CommandType::Subscribe);
-                function->children()->insert(function->children()->end(), cmd);
-                root->insert(root->end(), function);
-                successCount++;
-            }
-            else {
+            auto element = qualifiedCommand(req.type, req.path, libember::glow::CommandType::Subscribe);
+            if (!element) {
                 qWarning().noquote() << QString("Unknown subscription type '%1' for path %2")
                     .arg(req.type).arg(req.path);
                 continue;
             }
+            root->insert(root->end(), element);
+            successCount++;
             
             
             SubscriptionState state;
@@ -1583,10 +1826,9 @@ void EmberConnection::sendBatchSubscribe(const QList<SubscriptionRequest>& reque
         QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
         
         
-        m_socket->write(s101Frame);
-        m_socket->flush();
+        sendFrame(s101Frame);
         
-        qDebug().noquote() << QString("Successfully batch subscribed to %1 paths").arg(successCount);
+        qCDebug(lcIo).noquote() << QString("Successfully batch subscribed to %1 paths").arg(successCount);
         
         delete root;
     }
@@ -1595,6 +1837,43 @@ void EmberConnection::sendBatchSubscribe(const QList<SubscriptionRequest>& reque
     }
 }
 
+void EmberConnection::sendBatchUnsubscribe(const QList<SubscriptionRequest>& requests)
+{
+    if (requests.isEmpty() || !m_connected) {
+        return;
+    }
+    
+    try {
+        auto root = new libember::glow::GlowRootElementCollection();
+        
+        int unsubscribeCount = 0;
+        for (const auto& req : requests) {
+            if (!m_subscriptions.contains(req.path)) {
+                continue;
+            }
+            auto element = qualifiedCommand(req.type, req.path, libember::glow::CommandType::Unsubscribe);
+            if (!element) {
+                continue;
+            }
+            root->insert(root->end(), element);
+            m_subscriptions.remove(req.path);
+            unsubscribeCount++;
+        }
+        
+        if (unsubscribeCount > 0) {
+            libember::util::OctetStream stream;
+            root->encode(stream);
+            sendFrame(m_s101Protocol->encodeEmberData(stream));
+            qCDebug(lcIo).noquote() << QString("Batch unsubscribed from %1 paths").arg(unsubscribeCount);
+        }
+        
+        delete root;
+    }
+    catch (const std::exception &ex) {
+        qCritical().noquote() << QString("Error sending batch unsubscribe: %1").arg(ex.what());
+    }
+}
+
 bool EmberConnection::isSubscribed(const QString &path) const
 {
     return m_subscriptions.contains(path);
@@ -1611,12 +1890,29 @@ void EmberConnection::fetchCompleteTree(const QStringList &initialNodePaths)
     qDebug().noquote() << QString("Starting complete tree fetch with %1 initial nodes...").arg(initialNodePaths.size());
     
     
-    m_treeFetchService->setSendGetDirectoryCallback([this](const QString& path, bool isRoot) {
-        qDebug().noquote() << QString("Tree fetch requesting: %1").arg(path.isEmpty() ? "root" : path);
+    // Tree fetch requests bypass the m_requestedPaths de-duplication of sendBatchGetDirectory,
+    // a complete fetch has to revisit nodes that were expanded before
+    m_treeFetchService->setSendGetDirectoryCallback([this](const QStringList& paths) {
+        qCDebug(lcIo).noquote() << QString("Tree fetch requesting %1 paths (window %2)")
+            .arg(paths.size()).arg(m_treeFetchService->windowSize());
+        sendTreeFetchRequest(paths);
+    });
+    
+    
+    connect(m_treeFetchService, &TreeFetchService::progressUpdated, this, &EmberConnection::treeFetchProgress, Qt::UniqueConnection);
+    connect(m_treeFetchService, &TreeFetchService::fetchCompleted, this, &EmberConnection::treeFetchCompleted, Qt::UniqueConnection);
+    connect(m_treeFetchService, &TreeFetchService::requestCompleted, this, &EmberConnection::treeFetchResponseTime, Qt::UniqueConnection);
+    
+    
+    m_treeFetchService->startFetch(initialNodePaths);
+}
+
+void EmberConnection::sendTreeFetchRequest(const QStringList &paths)
+{
+    try {
+        auto root = new libember::glow::GlowRootElementCollection();
         
-        try {
-            auto root = new libember::glow::GlowRootElementCollection();
-            
+        for (const QString& path : paths) {
             if (path.isEmpty()) {
                 
                 auto command = new libember::glow::GlowCommand(
@@ -1627,12 +1923,7 @@ void EmberConnection::fetchCompleteTree(const QStringList &initialNodePaths)
             }
             else {
                 
-                QStringList segments = path.split('.', Qt::SkipEmptyParts);
-                libember::ber::ObjectIdentifier oid;
-                
-                for (const QString& seg : segments) {
-                    oid.push_back(seg.toInt());
-                }
+                libember::ber::ObjectIdentifier oid = toObjectIdentifier(path);
                 
                 auto node = new libember::glow::GlowQualifiedNode(oid);
                 new libember::glow::GlowCommand(
@@ -1642,32 +1933,109 @@ void EmberConnection::fetchCompleteTree(const QStringList &initialNodePaths)
                 );
                 root->insert(root->end(), node);
             }
-            
-            
-            libember::util::OctetStream stream;
-            root->encode(stream);
-            
-            
-            QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
-            
-            
-            if (m_socket->write(s101Frame) > 0) {
-                m_socket->flush();
-            }
-            
-            delete root;
         }
-        catch (const std::exception &ex) {
-            qCritical().noquote() << QString("Error sending GetDirectory for tree fetch: %1").arg(ex.what());
-        }
-    });
+        
+        
+        libember::util::OctetStream stream;
+        root->encode(stream);
+        
+        
+        QByteArray s101Frame = m_s101Protocol->encodeEmberData(stream);
+        
+        
+        sendFrame(s101Frame);
+        
+        delete root;
+    }
+    catch (const std::exception &ex) {
+        qCritical().noquote() << QString("Error sending GetDirectory for tree fetch: %1").arg(ex.what());
+    }
+}
+
+void EmberConnection::replayDeviceTree()
+{
+    qInfo().noquote() << QString("Showing cached device tree for %1 (%2 nodes, %3 parameters), revalidating...")
+        .arg(m_deviceTree.hostPort()).arg(m_deviceTree.nodes().size()).arg(m_deviceTree.parameters().size());
     
+    QVector<EmberData::NodeInfo> nodes = m_deviceTree.nodes();
+    QVector<EmberData::ParameterInfo> parameters = m_deviceTree.parameters();
+    m_replayedPaths.clear();
+    for (const EmberData::NodeInfo &node : nodes) {
+        m_replayedPaths.insert(node.path);
+    }
+    for (const EmberData::ParameterInfo &param : parameters) {
+        m_replayedPaths.insert(param.path);
+    }
     
-    connect(m_treeFetchService, &TreeFetchService::progressUpdated, this, &EmberConnection::treeFetchProgress, Qt::UniqueConnection);
-    connect(m_treeFetchService, &TreeFetchService::fetchCompleted, this, &EmberConnection::treeFetchCompleted, Qt::UniqueConnection);
+    emit nodesReceived(nodes);
+    emit parametersReceived(parameters);
+    for (const EmberData::MatrixInfo &matrix : m_deviceTree.matrices()) {
+        m_replayedPaths.insert(matrix.path);
+        emit matrixReceived(matrix.path, matrix.number, matrix.identifier, matrix.description,
+                           matrix.type, matrix.targetCount, matrix.sourceCount);
+    }
+    for (const EmberData::FunctionInfo &func : m_deviceTree.functions()) {
+        m_replayedPaths.insert(func.path);
+        emit functionReceived(func.path, func.identifier, func.description,
+                            func.argNames, func.argTypes, func.resultNames, func.resultTypes);
+    }
+    
+    // Walk every cached node again so changes and removals on the device are picked up. The
+    // root is walked too, top-level elements are only dropped once it answered without them
+    QStringList nodePaths{"|Node"};
+    for (const QString &path : m_deviceTree.nodePaths()) {
+        nodePaths.append(path + "|Node");
+    }
+    m_revalidatedPaths.clear();
+    m_revalidationService->startFetch(nodePaths);
+}
+
+void EmberConnection::trackRevalidation(const QString &path, bool isNode)
+{
+    if (m_revalidationService->isActive()) {
+        m_revalidatedPaths.insert(path);
+        m_revalidationService->onElementReceived(path, isNode);
+    }
+}
+
+bool EmberConnection::shouldForward(const QString &path, DeviceTreeCache::Change change)
+{
+    if (change != DeviceTreeCache::Unchanged || !m_revalidationService->isActive()) {
+        return true;
+    }
     
+    // Answers to our own requests always reach the tree, only the revalidation's copies of
+    // replayed elements are dropped, once each
+    int separator = path.lastIndexOf('.');
+    QString parentPath = separator < 0 ? QString() : path.left(separator);
+    if (m_requestedPaths.contains(path) || m_requestedPaths.contains(parentPath)) {
+        return true;
+    }
+    return !m_replayedPaths.remove(path);
+}
+
+void EmberConnection::onRevalidationCompleted(bool success, const QString &message)
+{
+    m_replayedPaths.clear();
     
-    m_treeFetchService->startFetch(initialNodePaths);
+    if (!success) {
+        qWarning().noquote() << QString("Device tree revalidation incomplete, keeping cached elements: %1").arg(message);
+        m_revalidatedPaths.clear();
+        return;
+    }
+    
+    // Elements whose parent answered without them are gone; below a silent parent nothing is known
+    QStringList removed = m_deviceTree.retainOnly(m_revalidatedPaths, m_revalidationService->silentPaths());
+    m_revalidatedPaths.clear();
+    qDebug().noquote() << QString("Device tree revalidated, %1 stale elements dropped").arg(removed.size());
+    
+    if (!removed.isEmpty()) {
+        emit elementsRemoved(removed);
+    }
+    
+    if (m_deviceTreeCacheEnabled && m_deviceTree.isDirty()) {
+        m_deviceTree.save();
+    }
 }
 
 void EmberConnection::cancelTreeFetch()
@@ -1683,7 +2051,7 @@ bool EmberConnection::isTreeFetchActive() const
 void EmberConnection::processBatchedAutoExpansion()
 {
     if (m_pendingAutoExpansion.isEmpty()) {
-        qDebug().noquote() << "Batch timer fired but no paths pending";
+        qCDebug(lcIo).noquote() << "Batch timer fired but no paths pending";
         return;
     }
     
@@ -1708,7 +2076,7 @@ void EmberConnection::processBatchedAutoExpansion()
 void EmberConnection::processBatchedLabelFetch()
 {
     if (m_pendingLabelPaths.isEmpty()) {
-        qDebug().noquote() << "Label batch timer fired but no paths pending";
+        qCDebug(lcIo).noquote() << "Label batch timer fired but no paths pending";
         
         // Check if all matrices are 0x0 (no labels to fetch)
         // This can happen when matrixLabelPathsDiscovered fired for 0x0 matrices
@@ -0,0 +1,224 @@
+#include "EmberIoWorker.h"
+#include "S101Protocol.h"
+#include "GlowParser.h"
+#include "LogCategories.h"
+#include "PerformanceCounters.h"
+#include <QDebug>
+#include <utility>
+
+EmberIoWorker::EmberIoWorker(QObject *parent)
+    : QObject(parent)
+    , m_socket(new QTcpSocket(this))
+    , m_s101Protocol(new S101Protocol(this))
+    , m_glowParser(new GlowParser(this))
+    , m_pendingBatches(0)
+    , m_readPaused(false)
+{
+    // Bounded buffer: once it is full Qt stops reading from the OS socket
+    m_socket->setReadBufferSize(READ_BUFFER_SIZE);
+
+    connect(m_socket, &QTcpSocket::connected, this, &EmberIoWorker::connected);
+    connect(m_socket, &QTcpSocket::disconnected, this, &EmberIoWorker::disconnected);
+    connect(m_socket, &QAbstractSocket::stateChanged, this, &EmberIoWorker::stateChanged);
+    connect(m_socket, &QAbstractSocket::errorOccurred, this, [this](QAbstractSocket::SocketError error) {
+        emit errorOccurred(error, m_socket->errorString());
+    });
+    connect(m_socket, &QTcpSocket::readyRead, this, &EmberIoWorker::onReadyRead);
+
+    connect(m_s101Protocol, &S101Protocol::messageReceived, this, &EmberIoWorker::onMessageReceived);
+    connect(m_s101Protocol, &S101Protocol::keepAliveReceived, this, &EmberIoWorker::onKeepAliveReceived);
+    connect(m_s101Protocol, &S101Protocol::protocolError, this, &EmberIoWorker::protocolError);
+
+    // Parser signals are delivered synchronously on this thread and collected into the current batch
+    connect(m_glowParser, &GlowParser::nodeReceived, this,
+            [this](const EmberData::NodeInfo& node) { appendRecord(node); });
+    connect(m_glowParser, &GlowParser::parameterReceived, this,
+            [this](const EmberData::ParameterInfo& param) { appendRecord(param); });
+    connect(m_glowParser, &GlowParser::matrixReceived, this,
+            [this](const EmberData::MatrixInfo& matrix) { appendRecord(matrix); });
+    connect(m_glowParser, &GlowParser::matrixTargetReceived, this,
+            [this](const EmberData::MatrixTargetInfo& target) { appendRecord(target); });
+    connect(m_glowParser, &GlowParser::matrixSourceReceived, this,
+            [this](const EmberData::MatrixSourceInfo& source) { appendRecord(source); });
+    connect(m_glowParser, &GlowParser::matrixConnectionReceived, this,
+            [this](const EmberData::MatrixConnectionInfo& connection) { appendRecord(connection); });
+    connect(m_glowParser, &GlowParser::matrixTargetConnectionsCleared, this,
+            [this](const QString& matrixPath, EmberPath matrixOid, int targetNumber) {
+                appendRecord(EmberData::TargetConnectionsCleared{matrixPath, targetNumber, matrixOid});
+            });
+    connect(m_glowParser, &GlowParser::functionReceived, this,
+            [this](const EmberData::FunctionInfo& function) { appendRecord(function); });
+    connect(m_glowParser, &GlowParser::invocationResultReceived, this,
+            [this](const EmberData::InvocationResult& result) { appendRecord(result); });
+    connect(m_glowParser, &GlowParser::streamValuesReceived, this,
+            [this](const QVector<EmberData::StreamValue>& values) { appendRecord(EmberData::StreamValues{values}); });
+    connect(m_glowParser, &GlowParser::matrixLabelPathsDiscovered, this,
+            [this](const QString& matrixPath, const QStringList& basePaths) {
+                appendRecord(EmberData::MatrixLabelPaths{matrixPath, basePaths});
+            });
+    connect(m_glowParser, &GlowParser::parsingError, this, &EmberIoWorker::parsingError);
+}
+
+EmberIoWorker::~EmberIoWorker()
+{
+    m_socket->disconnect();
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->abort();
+    }
+
+    delete m_s101Protocol;
+    delete m_glowParser;
+}
+
+void EmberIoWorker::acknowledgeBatch()
+{
+    // Only the acknowledgement that frees the last slot needs to wake the worker
+    int pending = m_pendingBatches.fetch_sub(1);
+    PerformanceCounters::set(PerformanceCounters::PendingBatches, pending - 1);
+    if (pending == MAX_PENDING_BATCHES) {
+        QMetaObject::invokeMethod(this, &EmberIoWorker::resumeReading, Qt::QueuedConnection);
+    }
+}
+
+void EmberIoWorker::connectToHost(const QString &host, int port)
+{
+    m_batch = EmberData::Batch();
+    m_readPaused = false;
+
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    m_socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+    m_socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, 65536);
+    m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 65536);
+
+    m_socket->connectToHost(host, port);
+}
+
+void EmberIoWorker::disconnectFromHost()
+{
+    QAbstractSocket::SocketState state = m_socket->state();
+
+    if (state == QAbstractSocket::ConnectedState) {
+        m_socket->disconnectFromHost();
+    } else if (state == QAbstractSocket::ConnectingState ||
+               state == QAbstractSocket::HostLookupState) {
+        m_socket->abort();
+    }
+}
+
+void EmberIoWorker::abort()
+{
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->abort();
+    }
+}
+
+void EmberIoWorker::sendFrame(const QByteArray &frame)
+{
+    if (m_socket->state() != QAbstractSocket::ConnectedState) {
+        qWarning().noquote() << QString("Dropping %1 byte frame - socket not connected").arg(frame.size());
+        return;
+    }
+
+    m_capture.append(S101CaptureRecord::Outbound, frame);
+    qint64 written = m_socket->write(frame);
+    if (written > 0) {
+        PerformanceCounters::add(PerformanceCounters::BytesOut, quint64(written));
+        PerformanceCounters::add(PerformanceCounters::FramesOut);
+        m_socket->flush();
+    } else {
+        qCritical().noquote() << "Socket write failed:" << m_socket->errorString();
+    }
+}
+
+void EmberIoWorker::startRecording(const QString &filePath)
+{
+    bool recording = m_capture.open(filePath);
+    emit recordingStateChanged(recording, filePath);
+}
+
+void EmberIoWorker::stopRecording()
+{
+    if (!m_capture.isOpen()) {
+        return;
+    }
+
+    QString filePath = m_capture.fileName();
+    m_capture.close();
+    emit recordingStateChanged(false, filePath);
+}
+
+void EmberIoWorker::onReadyRead()
+{
+    if (m_pendingBatches.load() >= MAX_PENDING_BATCHES) {
+        // Leave the data in the socket buffer until the consumer catches up
+        m_readPaused = true;
+        return;
+    }
+
+    QByteArray data = m_socket->read(READ_CHUNK_SIZE);
+    if (data.isEmpty()) {
+        return;
+    }
+
+    PerformanceCounters::add(PerformanceCounters::BytesIn, quint64(data.size()));
+    m_capture.append(S101CaptureRecord::Inbound, data);
+    qCDebug(lcIo).noquote() << QString("Received %1 bytes from socket").arg(data.size());
+
+    m_s101Protocol->feedData(data);
+    flushBatch();
+
+    // readyRead is not emitted again for data that is already buffered
+    if (m_socket->bytesAvailable() > 0) {
+        QMetaObject::invokeMethod(this, &EmberIoWorker::onReadyRead, Qt::QueuedConnection);
+    }
+}
+
+void EmberIoWorker::resumeReading()
+{
+    if (!m_readPaused) {
+        return;
+    }
+
+    m_readPaused = false;
+    if (m_socket->bytesAvailable() > 0) {
+        onReadyRead();
+    }
+}
+
+void EmberIoWorker::onMessageReceived(const QByteArray &emberData)
+{
+    m_batch.messageCount++;
+    PerformanceCounters::add(PerformanceCounters::FramesIn);
+
+    PerformanceCounters::ScopedTimer timer(PerformanceCounters::DecodeMessage);
+    m_glowParser->parseEmberData(emberData);
+}
+
+void EmberIoWorker::onKeepAliveReceived()
+{
+    qCDebug(lcIo) << "[EmberIoWorker] Sending KeepAlive RESPONSE to device";
+    QByteArray response = m_s101Protocol->encodeKeepAliveResponse();
+    m_capture.append(S101CaptureRecord::Outbound, response);
+    qint64 bytesWritten = m_socket->write(response);
+    m_socket->flush();
+    PerformanceCounters::add(PerformanceCounters::BytesOut, quint64(qMax<qint64>(0, bytesWritten)));
+    PerformanceCounters::add(PerformanceCounters::FramesOut);
+    qCDebug(lcIo) << "[EmberIoWorker] KeepAlive response sent:" << bytesWritten << "bytes";
+}
+
+void EmberIoWorker::appendRecord(EmberData::Record record)
+{
+    m_batch.records.append(std::move(record));
+    PerformanceCounters::add(PerformanceCounters::ElementsDecoded);
+}
+
+void EmberIoWorker::flushBatch()
+{
+    if (m_batch.records.isEmpty() && m_batch.messageCount == 0) {
+        return;
+    }
+
+    PerformanceCounters::set(PerformanceCounters::PendingBatches, m_pendingBatches.fetch_add(1) + 1);
+    emit batchReady(m_batch);
+    m_batch = EmberData::Batch();
+}
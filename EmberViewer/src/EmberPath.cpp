@@ -0,0 +1,254 @@
+#include "EmberPath.h"
+#include <QHash>
+#include <QReadWriteLock>
+#include <QVarLengthArray>
+#include <QtAlgorithms>
+#include <atomic>
+
+namespace {
+
+struct PathEntry {
+    quint32 parent;
+    int number;
+    int depth;
+};
+
+// Same segmentation as split('.', Qt::SkipEmptyParts), without the temporary strings
+void parseNumbers(QStringView path, QVarLengthArray<int, 16> &numbers)
+{
+    qsizetype start = 0;
+    for (qsizetype i = 0; i <= path.size(); ++i) {
+        if (i == path.size() || path[i] == QLatin1Char('.')) {
+            if (i > start) {
+                numbers.append(path.mid(start, i - start).toInt());
+            }
+            start = i + 1;
+        }
+    }
+}
+
+class PathTable
+{
+public:
+    static PathTable& instance()
+    {
+        static PathTable table;
+        return table;
+    }
+
+    PathTable()
+        : m_size(0)
+    {
+        for (std::atomic<PathEntry*> &chunk : m_chunks) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+        // Entry 0 is the empty path, the parent of every root element
+        append(PathEntry{0, -1, 0});
+    }
+
+    ~PathTable()
+    {
+        for (std::atomic<PathEntry*> &chunk : m_chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Resolves the children of parent one number at a time; lookups of known
+    // paths only take the read lock
+    template <typename Numbers>
+    quint32 intern(quint32 parent, const Numbers &numbers)
+    {
+        int resolved = 0;
+        {
+            QReadLocker locker(&m_lock);
+            for (; resolved < numbers.size(); ++resolved) {
+                auto it = m_children.constFind(key(parent, numbers[resolved]));
+                if (it == m_children.constEnd()) {
+                    break;
+                }
+                parent = it.value();
+            }
+        }
+
+        if (resolved == numbers.size()) {
+            return parent;
+        }
+
+        QWriteLocker locker(&m_lock);
+        for (; resolved < numbers.size(); ++resolved) {
+            int number = numbers[resolved];
+            quint64 childKey = key(parent, number);
+            auto it = m_children.constFind(childKey);
+            if (it != m_children.constEnd()) {
+                parent = it.value();
+                continue;
+            }
+
+            quint32 id = append(PathEntry{parent, number, entry(parent).depth + 1});
+            m_children.insert(childKey, id);
+            parent = id;
+        }
+        return parent;
+    }
+
+    // Like intern, but never adds a path; 0 when it is not known
+    template <typename Numbers>
+    quint32 find(quint32 parent, const Numbers &numbers) const
+    {
+        QReadLocker locker(&m_lock);
+        for (int number : numbers) {
+            auto it = m_children.constFind(key(parent, number));
+            if (it == m_children.constEnd()) {
+                return 0;
+            }
+            parent = it.value();
+        }
+        return parent;
+    }
+
+    // Entries never move once written and an id is only handed out after its
+    // entry is, so reads need no lock
+    const PathEntry& entry(quint32 id) const
+    {
+        quint64 index = quint64(id) + FIRST_CHUNK_SIZE;
+        int bit = 63 - qCountLeadingZeroBits(index);
+        PathEntry *chunk = m_chunks[bit - FIRST_CHUNK_BITS].load(std::memory_order_acquire);
+        return chunk[index - (quint64(1) << bit)];
+    }
+
+    int size() const
+    {
+        return static_cast<int>(m_size.load(std::memory_order_acquire));
+    }
+
+private:
+    static quint64 key(quint32 parent, int number)
+    {
+        return (static_cast<quint64>(parent) << 32) | static_cast<quint32>(number);
+    }
+
+    // Called with the write lock held, or from the constructor
+    quint32 append(const PathEntry &entry)
+    {
+        quint32 id = m_size.load(std::memory_order_relaxed);
+        quint64 index = quint64(id) + FIRST_CHUNK_SIZE;
+        int bit = 63 - qCountLeadingZeroBits(index);
+        std::atomic<PathEntry*> &chunk = m_chunks[bit - FIRST_CHUNK_BITS];
+        if (!chunk.load(std::memory_order_relaxed)) {
+            chunk.store(new PathEntry[quint64(1) << bit], std::memory_order_release);
+        }
+        chunk.load(std::memory_order_relaxed)[index - (quint64(1) << bit)] = entry;
+        m_size.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    // Chunk n holds FIRST_CHUNK_SIZE << n entries, so the table grows without
+    // ever moving an entry
+    static constexpr int FIRST_CHUNK_BITS = 10;
+    static constexpr quint64 FIRST_CHUNK_SIZE = quint64(1) << FIRST_CHUNK_BITS;
+    static constexpr int CHUNK_COUNT = 33 - FIRST_CHUNK_BITS;
+
+    mutable QReadWriteLock m_lock;
+    std::atomic<PathEntry*> m_chunks[CHUNK_COUNT];
+    std::atomic<quint32> m_size;
+    QHash<quint64, quint32> m_children;
+};
+
+}
+
+EmberPath EmberPath::fromString(QStringView path)
+{
+    QVarLengthArray<int, 16> numbers;
+    parseNumbers(path, numbers);
+
+    if (numbers.isEmpty()) {
+        return EmberPath();
+    }
+    return EmberPath(PathTable::instance().intern(0, numbers));
+}
+
+EmberPath EmberPath::find(QStringView path)
+{
+    QVarLengthArray<int, 16> numbers;
+    parseNumbers(path, numbers);
+    return EmberPath(PathTable::instance().find(0, numbers));
+}
+
+EmberPath EmberPath::fromNumbers(const QVector<int> &numbers)
+{
+    if (numbers.isEmpty()) {
+        return EmberPath();
+    }
+    return EmberPath(PathTable::instance().intern(0, numbers));
+}
+
+EmberPath EmberPath::child(int number) const
+{
+    QVarLengthArray<int, 1> numbers;
+    numbers.append(number);
+    return EmberPath(PathTable::instance().intern(m_id, numbers));
+}
+
+EmberPath EmberPath::parent() const
+{
+    return EmberPath(PathTable::instance().entry(m_id).parent);
+}
+
+EmberPath EmberPath::ancestor(int depth) const
+{
+    EmberPath current = *this;
+    for (int level = this->depth(); level > depth && !current.isEmpty(); --level) {
+        current = current.parent();
+    }
+    return current;
+}
+
+bool EmberPath::isAncestorOf(EmberPath other) const
+{
+    int ownDepth = depth();
+    if (other.depth() <= ownDepth) {
+        return false;
+    }
+    return other.ancestor(ownDepth) == *this;
+}
+
+int EmberPath::depth() const
+{
+    return PathTable::instance().entry(m_id).depth;
+}
+
+int EmberPath::number() const
+{
+    return PathTable::instance().entry(m_id).number;
+}
+
+QVector<int> EmberPath::numbers() const
+{
+    const PathTable &table = PathTable::instance();
+    const PathEntry *entry = &table.entry(m_id);
+    QVector<int> result(entry->depth);
+    for (int i = result.size() - 1; i >= 0; --i) {
+        result[i] = entry->number;
+        entry = &table.entry(entry->parent);
+    }
+    return result;
+}
+
+QString EmberPath::toString() const
+{
+    QString result;
+    const QVector<int> parts = numbers();
+    for (int i = 0; i < parts.size(); ++i) {
+        if (i > 0) {
+            result += QLatin1Char('.');
+        }
+        result += QString::number(parts[i]);
+    }
+    return result;
+}
+
+int EmberPath::internedCount()
+{
+    // The empty path is not counted
+    return PathTable::instance().size() - 1;
+}
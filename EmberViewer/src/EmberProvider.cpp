@@ -8,6 +8,7 @@
 
 #include "EmberProvider.h"
 #include "DeviceSnapshot.h"
+#include "MappedDeviceSnapshot.h"
 #include "S101Protocol.h"
 #include <ember/Ember.hpp>
 #include <ember/glow/GlowRootElementCollection.hpp>
@@ -21,10 +22,12 @@
 #include <ember/glow/GlowTarget.hpp>
 #include <ember/glow/GlowSource.hpp>
 #include <ember/glow/GlowTupleItemDescription.hpp>
+#include <ember/glow/GlowStreamCollection.hpp>
 #include <s101/MessageType.hpp>
 #include <s101/CommandType.hpp>
 #include <s101/PackageFlag.hpp>
 #include <QDebug>
+#include <QtMath>
 
 
 static void s101MessageDispatch(libs101::StreamDecoder<unsigned char>::const_iterator first,
@@ -196,13 +199,19 @@ void EmberProvider::stopListening()
     emit serverStateChanged(false);
 }
 
-void EmberProvider::loadDeviceTree(const DeviceSnapshot &snapshot)
+void EmberProvider::loadDeviceTree(const DeviceSnapshot &snapshot, std::shared_ptr<const MappedDeviceSnapshot> matrixSource)
 {
     m_nodes = snapshot.nodes;
     m_parameters = snapshot.parameters;
-    m_matrices = snapshot.matrices;
     m_functions = snapshot.functions;
     
+    // With a mapped snapshot, matrices are decoded on first use instead of up front
+    m_matrixSource = matrixSource;
+    m_matrices.clear();
+    if (!m_matrixSource) {
+        m_matrices = snapshot.matrices;
+    }
+    
     
     m_rootPaths = snapshot.rootPaths;
     
@@ -214,6 +223,125 @@ void EmberProvider::loadDeviceTree(const DeviceSnapshot &snapshot)
             }
         }
     }
+    
+    setStreamRates({});
+}
+
+void EmberProvider::setStreamRates(const QMap<int, int> &ratesHz)
+{
+    qDeleteAll(m_streamTimers);
+    m_streamTimers.clear();
+    m_streamsByRate.clear();
+    
+    if (ratesHz.isEmpty()) {
+        return;
+    }
+    
+    QMap<int, StreamSource> sources;
+    for (const ParameterData &param : std::as_const(m_parameters)) {
+        if (param.streamIdentifier <= 0 || !ratesHz.contains(param.streamIdentifier)) {
+            continue;
+        }
+        
+        StreamSource &source = sources[param.streamIdentifier];
+        if (source.paths.isEmpty()) {
+            source.identifier = param.streamIdentifier;
+            source.minimum = param.minimum.isNull() ? 0 : param.minimum.toInt();
+            source.maximum = param.maximum.isNull() ? 100 : param.maximum.toInt();
+        }
+        source.paths.append(param.path);
+    }
+    
+    for (const StreamSource &source : std::as_const(sources)) {
+        int rateHz = ratesHz.value(source.identifier);
+        if (rateHz > 0) {
+            m_streamsByRate[rateHz].append(source);
+        }
+    }
+    
+    // One timer per rate, every stream of that rate goes out in the same collection
+    for (auto it = m_streamsByRate.cbegin(); it != m_streamsByRate.cend(); ++it) {
+        int rateHz = it.key();
+        QTimer *timer = new QTimer(this);
+        timer->setTimerType(Qt::PreciseTimer);
+        timer->setInterval(qMax(1, 1000 / rateHz));
+        connect(timer, &QTimer::timeout, this, [this, rateHz]() { sendStreamValues(rateHz); });
+        timer->start();
+        m_streamTimers.append(timer);
+    }
+    m_streamClock.start();
+}
+
+int EmberProvider::streamCount() const
+{
+    int count = 0;
+    for (const QVector<StreamSource> &sources : m_streamsByRate) {
+        count += sources.size();
+    }
+    return count;
+}
+
+void EmberProvider::sendStreamValues(int rateHz)
+{
+    auto streams = m_streamsByRate.constFind(rateHz);
+    if (streams == m_streamsByRate.constEnd()) {
+        return;
+    }
+    
+    double seconds = m_streamClock.nsecsElapsed() / 1e9;
+    
+    for (ClientConnection *client : std::as_const(m_clients)) {
+        if (client->subscriptions.isEmpty() || client->socket()->bytesToWrite() > MAX_STREAM_BACKLOG_BYTES) {
+            continue;
+        }
+        
+        auto collection = new libember::glow::GlowStreamCollection();
+        int count = 0;
+        for (const StreamSource &source : streams.value()) {
+            bool subscribed = false;
+            for (const QString &path : source.paths) {
+                if (client->subscriptions.contains(path)) {
+                    subscribed = true;
+                    break;
+                }
+            }
+            if (!subscribed) {
+                continue;
+            }
+            
+            // Half hertz sine, phase shifted per stream so the meters do not move in lockstep
+            double level = 0.5 + 0.5 * qSin(seconds * M_PI + source.identifier * 0.7);
+            collection->insert(source.identifier, source.minimum + qRound(level * (source.maximum - source.minimum)));
+            ++count;
+        }
+        
+        if (count > 0) {
+            sendEncodedMessage(collection, client);
+        }
+        delete collection;
+    }
+}
+
+MatrixData* EmberProvider::findMatrix(const QString &path)
+{
+    auto it = m_matrices.find(path);
+    if (it != m_matrices.end()) {
+        return &it.value();
+    }
+    
+    if (m_matrixSource) {
+        int index = m_matrixSource->findMatrix(path);
+        if (index >= 0) {
+            return &m_matrices.insert(path, m_matrixSource->matrix(index)).value();
+        }
+    }
+    return nullptr;
+}
+
+bool EmberProvider::hasMatrix(const QString &path) const
+{
+    // Index lookup only, a mapped matrix is decoded when it is actually sent
+    return m_matrices.contains(path) || (m_matrixSource && m_matrixSource->findMatrix(path) >= 0);
 }
 
 void EmberProvider::onNewConnection()
@@ -301,8 +429,8 @@ void EmberProvider::processRoot(libember::dom::Node* root, ClientConnection *cli
                         int operation = connection->operation().value();
                         
                         
-                        if (m_matrices.contains(path)) {
-                            auto& matrix = m_matrices[path];
+                        if (MatrixData *found = findMatrix(path)) {
+                            auto& matrix = *found;
                             
                             if (operation == libember::glow::ConnectionOperation::Absolute) {
                                 
@@ -475,7 +603,7 @@ void EmberProvider::sendGetDirectoryResponse(const QString &path, ClientConnecti
                     sendNodeResponse(childPath, client);
                 } else if (m_parameters.contains(childPath)) {
                     sendParameterResponse(childPath, client);
-                } else if (m_matrices.contains(childPath)) {
+                } else if (hasMatrix(childPath)) {
                     sendMatrixResponse(childPath, client);
                     
                     sendMatrixLabelNode(childPath, client);
@@ -487,7 +615,7 @@ void EmberProvider::sendGetDirectoryResponse(const QString &path, ClientConnecti
         
         else if (path.endsWith(".666999666")) {
             QString matrixPath = path.left(path.length() - 10); 
-            if (m_matrices.contains(matrixPath)) {
+            if (hasMatrix(matrixPath)) {
                 
                 sendMatrixLabelTypeNode(path, "1", client); 
                 sendMatrixLabelTypeNode(path, "2", client); 
@@ -500,7 +628,7 @@ void EmberProvider::sendGetDirectoryResponse(const QString &path, ClientConnecti
                 QString labelType = parts.last();
                 QString matrixPath = parts.mid(0, parts.size() - 2).join('.');
                 
-                if (m_matrices.contains(matrixPath)) {
+                if (hasMatrix(matrixPath)) {
                     sendMatrixLabelParameters(matrixPath, labelType, client);
                 }
             }
@@ -568,12 +696,21 @@ void EmberProvider::sendParameterResponse(const QString &path, ClientConnection
         case 4:  
             qualParam->setValue(param.value == "true" || param.value == "1");
             break;
+        case 6:
+            qualParam->setValue(static_cast<long>(param.value.toLongLong()));
+            break;
         default:
             qualParam->setValue(param.value.toStdString());
             break;
     }
     
     qualParam->setAccess(static_cast<libember::glow::Access::_Domain>(param.access));
+    if (param.type > 0) {
+        qualParam->setType(static_cast<libember::glow::ParameterType::_Domain>(param.type));
+    }
+    if (param.streamIdentifier > 0) {
+        qualParam->setStreamIdentifier(param.streamIdentifier);
+    }
     
     
     if (!param.minimum.isNull()) {
@@ -604,11 +741,12 @@ void EmberProvider::sendParameterResponse(const QString &path, ClientConnection
 
 void EmberProvider::sendMatrixResponse(const QString &path, ClientConnection *client)
 {
-    if (!m_matrices.contains(path)) {
+    const MatrixData *found = findMatrix(path);
+    if (!found) {
         return;
     }
     
-    const MatrixData &matrix = m_matrices[path];
+    const MatrixData &matrix = *found;
     
     
     auto qualMatrix = new libember::glow::GlowQualifiedMatrix(pathToOid(path));
@@ -751,11 +889,12 @@ void EmberProvider::sendEncodedMessage(const libember::glow::GlowContainer *cont
 void EmberProvider::sendMatrixLabelNode(const QString &matrixPath, ClientConnection *client)
 {
     
-    if (!m_matrices.contains(matrixPath)) {
+    const MatrixData *found = findMatrix(matrixPath);
+    if (!found) {
         return;
     }
     
-    const MatrixData &matrix = m_matrices[matrixPath];
+    const MatrixData &matrix = *found;
     if (matrix.targetLabels.isEmpty() && matrix.sourceLabels.isEmpty()) {
         return; 
     }
@@ -781,11 +920,12 @@ void EmberProvider::sendMatrixLabelTypeNode(const QString &containerPath, const
     
     QString matrixPath = containerPath.left(containerPath.length() - 10);
     
-    if (!m_matrices.contains(matrixPath)) {
+    const MatrixData *found = findMatrix(matrixPath);
+    if (!found) {
         return;
     }
     
-    const MatrixData &matrix = m_matrices[matrixPath];
+    const MatrixData &matrix = *found;
     
     
     if (labelType == "1" && matrix.targetLabels.isEmpty()) {
@@ -813,11 +953,12 @@ void EmberProvider::sendMatrixLabelTypeNode(const QString &containerPath, const
 
 void EmberProvider::sendMatrixLabelParameters(const QString &matrixPath, const QString &labelType, ClientConnection *client)
 {
-    if (!m_matrices.contains(matrixPath)) {
+    const MatrixData *found = findMatrix(matrixPath);
+    if (!found) {
         return;
     }
     
-    const MatrixData &matrix = m_matrices[matrixPath];
+    const MatrixData &matrix = *found;
     const QMap<int, QString> &labels = (labelType == "1") ? matrix.targetLabels : matrix.sourceLabels;
     
     if (labels.isEmpty()) {
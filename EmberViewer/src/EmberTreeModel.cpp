@@ -0,0 +1,485 @@
+#include "EmberTreeModel.h"
+#include <QApplication>
+#include <QStyle>
+#include <QBrush>
+#include <QColor>
+#include <QHash>
+#include <QSet>
+#include <QVarLengthArray>
+
+namespace {
+
+bool isAudioMeter(const ElementStore::ParameterDetails &details)
+{
+    return details.streamIdentifier > 0 && (details.type == 1 || details.type == 2);
+}
+
+bool isWritable(const ElementStore::ParameterDetails &details)
+{
+    return details.access == 2 || details.access == 3;
+}
+
+}
+
+EmberTreeModel::EmberTreeModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+    QStyle *style = QApplication::style();
+    m_nodeIcon = style->standardIcon(QStyle::SP_DirIcon);
+    m_offlineIcon = style->standardIcon(QStyle::SP_MessageBoxWarning);
+    m_parameterIcon = style->standardIcon(QStyle::SP_FileIcon);
+    m_meterIcon = style->standardIcon(QStyle::SP_MediaVolume);
+    m_matrixIcon = style->standardIcon(QStyle::SP_FileDialogDetailedView);
+    m_functionIcon = QIcon::fromTheme("system-run", style->standardIcon(QStyle::SP_CommandLink));
+}
+
+EmberTreeModel::~EmberTreeModel()
+{
+}
+
+QModelIndex EmberTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (column < 0 || column >= ColumnCount) {
+        return QModelIndex();
+    }
+
+    int element = m_store.child(elementOf(parent), row);
+    if (element == ElementStore::NoElement) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, static_cast<quintptr>(element));
+}
+
+QModelIndex EmberTreeModel::parent(const QModelIndex &child) const
+{
+    int element = elementOf(child);
+    if (element == ElementStore::NoElement) {
+        return QModelIndex();
+    }
+    return indexOf(m_store.parent(element));
+}
+
+int EmberTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() && parent.column() != NameColumn) {
+        return 0;
+    }
+    return m_store.childCount(elementOf(parent));
+}
+
+int EmberTreeModel::columnCount(const QModelIndex &) const
+{
+    return ColumnCount;
+}
+
+bool EmberTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    int element = elementOf(parent);
+    if (element == ElementStore::NoElement) {
+        return m_store.topLevelCount() > 0;
+    }
+    if (parent.column() != NameColumn) {
+        return false;
+    }
+    if (m_store.childCount(element) > 0) {
+        return true;
+    }
+
+    // Offer expansion until the children were requested
+    ElementStore::Kind kind = m_store.kind(element);
+    return (kind == ElementStore::Node || kind == ElementStore::Matrix)
+        && !m_store.testFlag(element, ElementStore::ChildrenFetched);
+}
+
+QVariant EmberTreeModel::data(const QModelIndex &index, int role) const
+{
+    int element = elementOf(index);
+    if (element == ElementStore::NoElement) {
+        return QVariant();
+    }
+
+    ElementStore::Kind kind = m_store.kind(element);
+    const ElementStore::ParameterDetails *param = m_store.parameter(element);
+    bool online = m_store.testFlag(element, ElementStore::Online);
+
+    switch (role) {
+        case Qt::DisplayRole:
+        case Qt::EditRole:
+            switch (index.column()) {
+                case NameColumn:
+                    return m_store.displayName(element);
+                case TypeColumn:
+                    return kindName(kind);
+                case ValueColumn:
+                    if (param) {
+                        return isAudioMeter(*param) ? QString() : m_store.value(element);
+                    }
+                    if (const ElementStore::MatrixDetails *matrix = m_store.matrix(element)) {
+                        return QString("%1×%2").arg(matrix->sourceCount).arg(matrix->targetCount);
+                    }
+                    return QString();
+            }
+            return QVariant();
+
+        case Qt::DecorationRole:
+            return index.column() == NameColumn ? decoration(element) : QVariant();
+
+        case Qt::ForegroundRole:
+            if (kind == ElementStore::Node && !online) {
+                return QBrush(QColor("#888888"));
+            }
+            if (param && index.column() == ValueColumn && isWritable(*param) && !isAudioMeter(*param)) {
+                return QBrush(QColor(30, 144, 255));
+            }
+            return QVariant();
+
+        case Qt::ToolTipRole:
+            if (index.column() == NameColumn && kind == ElementStore::Node && !online) {
+                return QString("%1 - Offline").arg(m_store.displayName(element));
+            }
+            return QVariant();
+
+        default:
+            if (role >= Qt::UserRole && index.column() == NameColumn) {
+                return userData(element, role);
+            }
+            return QVariant();
+    }
+}
+
+QString EmberTreeModel::kindName(ElementStore::Kind kind)
+{
+    switch (kind) {
+        case ElementStore::Node: return QStringLiteral("Node");
+        case ElementStore::Parameter: return QStringLiteral("Parameter");
+        case ElementStore::Matrix: return QStringLiteral("Matrix");
+        case ElementStore::Function: return QStringLiteral("Function");
+        case ElementStore::Placeholder: break;
+    }
+    return QString();
+}
+
+QVariant EmberTreeModel::userData(int element, int role) const
+{
+    if (role == Qt::UserRole) {
+        return m_store.path(element).toString();
+    }
+
+    bool online = m_store.testFlag(element, ElementStore::Online);
+    switch (m_store.kind(element)) {
+        case ElementStore::Node:
+            return role == Qt::UserRole + 4 ? QVariant(online) : QVariant();
+
+        case ElementStore::Matrix:
+            return role == Qt::UserRole + 7 ? QVariant(QStringLiteral("Matrix")) : QVariant();
+
+        case ElementStore::Parameter: {
+            const ElementStore::ParameterDetails *param = m_store.parameter(element);
+            switch (role - Qt::UserRole) {
+                case 1: return param->type;
+                case 2: return param->access;
+                case 3: return param->minimum;
+                case 4: return param->maximum;
+                case 5: return m_store.enumOptions(element);
+                case 6: {
+                    QList<QVariant> enumValues;
+                    for (int value : param->enumValues) {
+                        enumValues.append(value);
+                    }
+                    return QVariant::fromValue(enumValues);
+                }
+                case 8: return online;
+                case 9: return param->streamIdentifier;
+                case 10: return m_store.string(param->format);
+                case 11: return m_store.string(param->referenceLevel);
+                case 12: return m_store.string(param->formula);
+                case 13: return param->factor;
+                case 14: return param->streamOffset;
+            }
+            return QVariant();
+        }
+
+        default:
+            return QVariant();
+    }
+}
+
+QVariant EmberTreeModel::decoration(int element) const
+{
+    switch (m_store.kind(element)) {
+        case ElementStore::Node:
+            return m_store.testFlag(element, ElementStore::Online) ? m_nodeIcon : m_offlineIcon;
+        case ElementStore::Parameter:
+            return isAudioMeter(*m_store.parameter(element)) ? m_meterIcon : m_parameterIcon;
+        case ElementStore::Matrix:
+            return m_matrixIcon;
+        case ElementStore::Function:
+            return m_functionIcon;
+        case ElementStore::Placeholder:
+            break;
+    }
+    return QVariant();
+}
+
+bool EmberTreeModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    int element = elementOf(index);
+    if (element == ElementStore::NoElement || index.column() != ValueColumn ||
+        (role != Qt::EditRole && role != Qt::DisplayRole) || !m_store.parameter(element)) {
+        return false;
+    }
+
+    if (m_store.setValue(element, value.toString())) {
+        emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
+    }
+    return true;
+}
+
+QVariant EmberTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (section) {
+        case NameColumn: return QStringLiteral("Path");
+        case TypeColumn: return QStringLiteral("Type");
+        case ValueColumn: return QStringLiteral("Value");
+    }
+    return QVariant();
+}
+
+Qt::ItemFlags EmberTreeModel::flags(const QModelIndex &index) const
+{
+    int element = elementOf(index);
+    if (element == ElementStore::NoElement) {
+        return Qt::NoItemFlags;
+    }
+
+    Qt::ItemFlags result = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    const ElementStore::ParameterDetails *param = m_store.parameter(element);
+    if (param && index.column() == ValueColumn && isWritable(*param) && !isAudioMeter(*param)) {
+        result |= Qt::ItemIsEditable;
+    }
+    return result;
+}
+
+bool EmberTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    int element = elementOf(parent);
+    if (element == ElementStore::NoElement || parent.column() != NameColumn) {
+        return false;
+    }
+
+    ElementStore::Kind kind = m_store.kind(element);
+    return (kind == ElementStore::Node || kind == ElementStore::Matrix)
+        && !m_store.testFlag(element, ElementStore::ChildrenFetched);
+}
+
+void EmberTreeModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    int element = elementOf(parent);
+    m_store.setFlag(element, ElementStore::ChildrenFetched, true);
+    emit fetchRequested(m_store.path(element).toString());
+}
+
+void EmberTreeModel::applyNodes(const QVector<EmberData::NodeInfo> &nodes)
+{
+    QVector<EmberPath> paths;
+    paths.reserve(nodes.size());
+    for (const EmberData::NodeInfo &node : nodes) {
+        paths.append(EmberData::elementPath(node));
+    }
+    insertMissing(paths);
+
+    QVector<int> changed;
+    changed.reserve(nodes.size());
+    for (int i = 0; i < nodes.size(); ++i) {
+        int element = m_store.find(paths[i]);
+        if (element == ElementStore::NoElement) {
+            continue;
+        }
+        m_store.setNode(element, nodes[i]);
+        changed.append(element);
+    }
+    elementsChanged(changed);
+}
+
+void EmberTreeModel::applyParameters(const QVector<EmberData::ParameterInfo> &parameters)
+{
+    QVector<EmberPath> paths;
+    paths.reserve(parameters.size());
+    for (const EmberData::ParameterInfo &param : parameters) {
+        paths.append(EmberData::elementPath(param));
+    }
+    insertMissing(paths);
+
+    QVector<int> changed;
+    changed.reserve(parameters.size());
+    for (int i = 0; i < parameters.size(); ++i) {
+        int element = m_store.find(paths[i]);
+        if (element == ElementStore::NoElement) {
+            continue;
+        }
+        m_store.setParameter(element, parameters[i]);
+        changed.append(element);
+    }
+    elementsChanged(changed);
+}
+
+void EmberTreeModel::applyMatrix(const EmberData::MatrixInfo &matrix)
+{
+    int element = prepare(EmberData::elementPath(matrix));
+    if (element == ElementStore::NoElement) {
+        return;
+    }
+    m_store.setMatrix(element, matrix);
+    elementsChanged({element});
+}
+
+void EmberTreeModel::applyFunction(const EmberData::FunctionInfo &function)
+{
+    int element = prepare(EmberData::elementPath(function));
+    if (element == ElementStore::NoElement) {
+        return;
+    }
+    m_store.setFunction(element, function);
+    elementsChanged({element});
+}
+
+void EmberTreeModel::setParameterValue(const QString &path, const QString &value)
+{
+    int element = m_store.find(EmberPath::find(path));
+    if (element == ElementStore::NoElement || !m_store.parameter(element)) {
+        return;
+    }
+
+    if (m_store.setValue(element, value)) {
+        QModelIndex valueIndex = indexOf(element, ValueColumn);
+        emit dataChanged(valueIndex, valueIndex, {Qt::DisplayRole});
+    }
+}
+
+void EmberTreeModel::removePaths(const QStringList &paths)
+{
+    for (const QString &path : paths) {
+        int element = m_store.find(EmberPath::find(path));
+        if (element == ElementStore::NoElement) {
+            continue;   // Unknown, or already removed with an ancestor
+        }
+
+        int row = m_store.row(element);
+        beginRemoveRows(indexOf(m_store.parent(element)), row, row);
+        m_store.remove(element);
+        endRemoveRows();
+    }
+}
+
+void EmberTreeModel::clear()
+{
+    beginResetModel();
+    m_store.clear();
+    endResetModel();
+}
+
+QModelIndex EmberTreeModel::indexForPath(const QString &path, int column) const
+{
+    return indexOf(m_store.find(EmberPath::find(path)), column);
+}
+
+QString EmberTreeModel::pathForIndex(const QModelIndex &index) const
+{
+    int element = elementOf(index);
+    return element == ElementStore::NoElement ? QString() : m_store.path(element).toString();
+}
+
+int EmberTreeModel::elementOf(const QModelIndex &index) const
+{
+    return index.isValid() ? static_cast<int>(index.internalId()) : ElementStore::NoElement;
+}
+
+QModelIndex EmberTreeModel::indexOf(int element, int column) const
+{
+    if (element == ElementStore::NoElement) {
+        return QModelIndex();
+    }
+    return createIndex(m_store.row(element), column, static_cast<quintptr>(element));
+}
+
+int EmberTreeModel::prepare(EmberPath key)
+{
+    insertMissing({key});
+    return m_store.find(key);
+}
+
+void EmberTreeModel::insertMissing(const QVector<EmberPath> &paths)
+{
+    // Collect the missing elements and their ancestors per parent first, the number
+    // of new rows has to be known before they are announced. A parent is planned
+    // before its children, so each insertion's parent exists when it runs.
+    struct Insertion {
+        EmberPath parent;
+        QVector<EmberPath> children;
+    };
+    QVector<Insertion> insertions;
+    QHash<EmberPath, int> insertionOf;
+    QSet<EmberPath> planned;
+    QVarLengthArray<EmberPath, 16> missing;
+
+    for (EmberPath path : paths) {
+        missing.clear();
+        for (EmberPath current = path; !current.isEmpty() && !planned.contains(current)
+                 && m_store.find(current) == ElementStore::NoElement; current = current.parent()) {
+            missing.append(current);
+        }
+
+        for (int i = missing.size() - 1; i >= 0; --i) {
+            EmberPath parent = missing[i].parent();
+            auto it = insertionOf.constFind(parent);
+            int insertion = it != insertionOf.constEnd() ? it.value() : -1;
+            if (insertion < 0) {
+                insertion = insertions.size();
+                insertionOf.insert(parent, insertion);
+                insertions.append(Insertion{parent, {}});
+            }
+            insertions[insertion].children.append(missing[i]);
+            planned.insert(missing[i]);
+        }
+    }
+
+    // One insertion per parent, views only track rows under expanded parents
+    for (const Insertion &insertion : std::as_const(insertions)) {
+        int parentElement = m_store.find(insertion.parent);
+        int row = m_store.childCount(parentElement);
+        beginInsertRows(indexOf(parentElement), row, row + insertion.children.size() - 1);
+        for (EmberPath child : insertion.children) {
+            m_store.findOrCreate(child);
+        }
+        endInsertRows();
+    }
+}
+
+void EmberTreeModel::elementsChanged(const QVector<int> &elements)
+{
+    // One range per parent. A placeholder turns into a typed element here, so every column may change
+    QHash<int, std::pair<int, int>> rows;
+    for (int element : elements) {
+        int row = m_store.row(element);
+        auto it = rows.find(m_store.parent(element));
+        if (it == rows.end()) {
+            rows.insert(m_store.parent(element), {row, row});
+        } else {
+            it->first = qMin(it->first, row);
+            it->second = qMax(it->second, row);
+        }
+    }
+
+    for (auto it = rows.cbegin(); it != rows.cend(); ++it) {
+        QModelIndex parent = indexOf(it.key());
+        emit dataChanged(index(it->first, NameColumn, parent), index(it->second, ValueColumn, parent));
+    }
+}
@@ -6,16 +6,16 @@
 
 
 
-#include "EmberTreeWidget.h"
+#include "EmberTreeView.h"
 #include <QDebug>
 
-EmberTreeWidget::EmberTreeWidget(QWidget *parent)
-    : QTreeWidget(parent)
+EmberTreeView::EmberTreeView(QWidget *parent)
+    : QTreeView(parent)
     , m_savedDoubleClickInterval(QApplication::doubleClickInterval())
 {
 }
 
-bool EmberTreeWidget::isClickOnExpandArrow(const QPoint &pos, const QModelIndex &index)
+bool EmberTreeView::isClickOnExpandArrow(const QPoint &pos, const QModelIndex &index)
 {
     if (!index.isValid()) {
         return false;
@@ -43,10 +43,10 @@ bool EmberTreeWidget::isClickOnExpandArrow(const QPoint &pos, const QModelIndex
     return arrowRect.contains(pos);
 }
 
-void EmberTreeWidget::mousePressEvent(QMouseEvent *event)
+void EmberTreeView::mousePressEvent(QMouseEvent *event)
 {
     if (event->button() != Qt::LeftButton) {
-        QTreeWidget::mousePressEvent(event);
+        QTreeView::mousePressEvent(event);
         return;
     }
     
@@ -59,13 +59,13 @@ void EmberTreeWidget::mousePressEvent(QMouseEvent *event)
         QApplication::setDoubleClickInterval(0);  
         
         
-        QTreeWidget::mousePressEvent(event);
+        QTreeView::mousePressEvent(event);
         
         
         QApplication::setDoubleClickInterval(originalInterval);
     } else {
         
-        QTreeWidget::mousePressEvent(event);
+        QTreeView::mousePressEvent(event);
     }
 }
 
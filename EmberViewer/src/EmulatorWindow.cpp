@@ -9,6 +9,9 @@
 #include "EmulatorWindow.h"
 #include "EmberProvider.h"
 #include "DeviceSnapshot.h"
+#include "MappedDeviceSnapshot.h"
+#include "SyntheticDeviceDialog.h"
+#include "SyntheticDeviceGenerator.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMenuBar>
@@ -17,8 +20,12 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QDateTime>
+#include <stdexcept>
 #include <QStandardPaths>
 #include <QHeaderView>
+#include <QElapsedTimer>
+#include <QApplication>
+#include <QTextDocument>
 
 EmulatorWindow::EmulatorWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -27,6 +34,7 @@ EmulatorWindow::EmulatorWindow(QWidget *parent)
     , m_clientList(nullptr)
     , m_mainSplitter(nullptr)
     , m_loadButton(nullptr)
+    , m_generateButton(nullptr)
     , m_startButton(nullptr)
     , m_stopButton(nullptr)
     , m_portSpin(nullptr)
@@ -86,6 +94,10 @@ void EmulatorWindow::setupUi()
     connect(m_loadButton, &QPushButton::clicked, this, &EmulatorWindow::onLoadSnapshot);
     deviceLayout->addWidget(m_loadButton);
     
+    m_generateButton = new QPushButton("Generate Synthetic Device...", this);
+    connect(m_generateButton, &QPushButton::clicked, this, &EmulatorWindow::onGenerateDevice);
+    deviceLayout->addWidget(m_generateButton);
+    
     m_mainSplitter->addWidget(m_deviceGroup);
     
     
@@ -134,6 +146,7 @@ void EmulatorWindow::setupUi()
     
     m_activityLog = new QTextEdit(this);
     m_activityLog->setReadOnly(true);
+    m_activityLog->document()->setMaximumBlockCount(MAX_ACTIVITY_LINES);
     activityLayout->addWidget(m_activityLog);
     
     rightLayout->addWidget(m_activityGroup);
@@ -156,6 +169,10 @@ void EmulatorWindow::setupMenu()
     loadAction->setShortcut(QKeySequence("Ctrl+O"));
     connect(loadAction, &QAction::triggered, this, &EmulatorWindow::onLoadSnapshot);
     
+    QAction *generateAction = fileMenu->addAction("&Generate Synthetic Device...");
+    generateAction->setShortcut(QKeySequence("Ctrl+G"));
+    connect(generateAction, &QAction::triggered, this, &EmulatorWindow::onGenerateDevice);
+    
     fileMenu->addSeparator();
     
     QAction *closeAction = fileMenu->addAction("&Close");
@@ -203,15 +220,26 @@ void EmulatorWindow::onLoadSnapshot()
     QString filePath = QFileDialog::getOpenFileName(this,
         "Load Device Snapshot",
         lastDir,
-        "JSON Files (*.json);;All Files (*)");
+        "Device Snapshots (*.evsnap *.json);;All Files (*)");
     
     if (filePath.isEmpty()) {
         return;
     }
     
     try {
-        DeviceSnapshot snapshot = DeviceSnapshot::loadFromFile(filePath);
-        loadSnapshotData(snapshot);
+        // Binary snapshots stay mapped; the provider decodes matrices only when a client asks for them
+        DeviceSnapshot snapshot;
+        std::shared_ptr<MappedDeviceSnapshot> mapped;
+        if (MappedDeviceSnapshot::isBinarySnapshot(filePath)) {
+            mapped = std::make_shared<MappedDeviceSnapshot>();
+            if (!mapped->open(filePath)) {
+                throw std::runtime_error(mapped->errorString().toStdString());
+            }
+            snapshot = mapped->toSnapshot(false);
+        } else {
+            snapshot = DeviceSnapshot::loadFromFile(filePath);
+        }
+        loadSnapshotData(snapshot, mapped);
         m_loadedSnapshotPath = filePath;
         logActivity(QString("Loaded snapshot: %1").arg(filePath));
         
@@ -229,18 +257,53 @@ void EmulatorWindow::onLoadSnapshot()
     }
 }
 
-void EmulatorWindow::loadSnapshotData(const DeviceSnapshot &snapshot)
+void EmulatorWindow::onGenerateDevice()
+{
+    SyntheticDeviceDialog dialog(this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    
+    SyntheticDeviceGenerator::Options options = dialog.options();
+    
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QElapsedTimer timer;
+    timer.start();
+    DeviceSnapshot snapshot = SyntheticDeviceGenerator::generate(options);
+    logActivity(QString("Generated synthetic device in %1 ms").arg(timer.elapsed()));
+    
+    loadSnapshotData(snapshot);
+    m_provider->setStreamRates(SyntheticDeviceGenerator::streamRates(options));
+    QApplication::restoreOverrideCursor();
+    
+    if (m_provider->streamCount() > 0) {
+        logActivity(QString("Streaming %1 meters to subscribed clients").arg(m_provider->streamCount()));
+    }
+    
+    m_loadedSnapshotPath.clear();
+    m_deviceName = snapshot.deviceName;
+    m_deviceNameLabel->setText(m_deviceName);
+}
+
+void EmulatorWindow::loadSnapshotData(const DeviceSnapshot &snapshot, std::shared_ptr<const MappedDeviceSnapshot> mapped)
 {
     m_deviceTree->clear();
     
     
     if (m_provider) {
-        m_provider->loadDeviceTree(snapshot);
+        m_provider->loadDeviceTree(snapshot, mapped);
     }
     
     
     QMap<QString, QTreeWidgetItem*> pathToItem;
     
+    qint64 elementCount = qint64(snapshot.nodeCount()) + snapshot.parameterCount()
+                        + snapshot.matrixCount() + snapshot.functionCount();
+    bool listParameters = elementCount <= MAX_LISTED_ELEMENTS;
+    if (!listParameters) {
+        logActivity(QString("Device has %1 elements, only nodes and matrices are listed").arg(elementCount));
+    }
+    
     
     for (const NodeData &node : snapshot.nodes) {
         QTreeWidgetItem *item = new QTreeWidgetItem();
@@ -267,6 +330,9 @@ void EmulatorWindow::loadSnapshotData(const DeviceSnapshot &snapshot)
     
     
     for (const ParameterData &param : snapshot.parameters) {
+        if (!listParameters) {
+            break;
+        }
         QTreeWidgetItem *item = new QTreeWidgetItem();
         item->setText(0, param.path);
         item->setText(1, "Parameter");
@@ -316,6 +382,9 @@ void EmulatorWindow::loadSnapshotData(const DeviceSnapshot &snapshot)
     
     
     for (const FunctionData &func : snapshot.functions) {
+        if (!listParameters) {
+            break;
+        }
         QTreeWidgetItem *item = new QTreeWidgetItem();
         item->setText(0, func.path);
         item->setText(1, "Function");
@@ -338,7 +407,9 @@ void EmulatorWindow::loadSnapshotData(const DeviceSnapshot &snapshot)
         pathToItem[func.path] = item;
     }
     
-    m_deviceTree->expandAll();
+    if (listParameters) {
+        m_deviceTree->expandAll();
+    }
     
     logActivity(QString("Loaded device tree: %1 nodes, %2 parameters, %3 matrices, %4 functions")
         .arg(snapshot.nodeCount())
@@ -349,9 +420,9 @@ void EmulatorWindow::loadSnapshotData(const DeviceSnapshot &snapshot)
 
 void EmulatorWindow::onStartServer()
 {
-    if (m_loadedSnapshotPath.isEmpty()) {
+    if (m_deviceName.isEmpty()) {
         QMessageBox::warning(this, "No Device Loaded",
-            "Please load a device snapshot before starting the server.");
+            "Please load a device snapshot or generate a device before starting the server.");
         return;
     }
     
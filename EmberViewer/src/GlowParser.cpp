@@ -7,6 +7,8 @@
 
 
 #include "GlowParser.h"
+#include "LogCategories.h"
+#include "PerformanceCounters.h"
 #include <ember/glow/GlowNodeFactory.hpp>
 #include <ember/glow/GlowRootElementCollection.hpp>
 #include <ember/glow/GlowNode.hpp>
@@ -24,8 +26,94 @@
 #include <ember/glow/GlowStreamCollection.hpp>
 #include <ember/glow/GlowStreamEntry.hpp>
 #include <ember/glow/GlowInvocationResult.hpp>
+#include <ember/glow/GlowType.hpp>
+#include <ember/glow/GlowStreamDescriptor.hpp>
+#include <ember/glow/StreamFormat.hpp>
 #include <QVariant>
 #include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Returns the glow type of a decoded node, or 0 if the node is not a glow object.
+// Every glow type maps to exactly one class in the GlowNodeFactory, so switching
+// on this value and using static_cast replaces a chain of dynamic_casts.
+unsigned int glowTypeOf(const libember::dom::Node* node)
+{
+    const libember::ber::Tag tag = node->typeTag();
+    return tag.getClass() == libember::ber::Class::Application ? tag.number() : 0;
+}
+
+// Decodes one value of a packed stream. StreamFormat encodes the byte order in bit 0,
+// the width (1 << n bytes) in bits 1-2 and unsigned/signed/float in the remaining bits.
+bool decodePackedStreamValue(const unsigned char* data, std::size_t size, int offset, int format, double& result)
+{
+    const int width = 1 << ((format >> 1) & 0x3);
+    if (offset < 0 || static_cast<std::size_t>(offset) + width > size) {
+        return false;
+    }
+
+    const bool littleEndian = (format & 0x1) != 0;
+    quint64 bits = 0;
+    for (int i = 0; i < width; ++i) {
+        int shift = (littleEndian ? i : width - 1 - i) * 8;
+        bits |= static_cast<quint64>(data[offset + i]) << shift;
+    }
+
+    switch (format >> 3) {
+        case 0:
+            result = static_cast<double>(bits);
+            return true;
+        case 1: {
+            const int unused = 64 - width * 8;
+            result = static_cast<double>(static_cast<qint64>(bits << unused) >> unused);
+            return true;
+        }
+        case 2:
+            if (width == 4) {
+                quint32 word = static_cast<quint32>(bits);
+                float value;
+                std::memcpy(&value, &word, sizeof(value));
+                result = value;
+                return true;
+            }
+            if (width == 8) {
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                result = value;
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+// Builds the dotted form of a qualified element's OID and interns it in the same pass
+EmberPath qualifiedPath(const libember::ber::ObjectIdentifier& oid, QString& path)
+{
+    QVector<int> numbers;
+    numbers.reserve(static_cast<int>(oid.size()));
+    path.clear();
+    for (auto num : oid) {
+        if (!numbers.isEmpty()) {
+            path += QLatin1Char('.');
+        }
+        path += QString::number(num);
+        numbers.append(static_cast<int>(num));
+    }
+    return EmberPath::fromNumbers(numbers);
+}
+
+QString childPath(const QString& parentPath, int number)
+{
+    return parentPath.isEmpty()
+        ? QString::number(number)
+        : parentPath + QLatin1Char('.') + QString::number(number);
+}
+
+}
 
 GlowParser::GlowParser(QObject *parent)
     : QObject(parent)
@@ -54,10 +142,11 @@ void GlowParser::parseEmberData(const QByteArray& data)
         
         if (m_domReader->isRootReady()) {
             auto root = m_domReader->detachRoot();
-            qDebug() << "[GlowParser] Processing root with" << data.size() << "bytes of EmBER data";
+            PerformanceCounters::add(PerformanceCounters::RootsDecoded);
+            qCDebug(lcGlow) << "[GlowParser] Processing root with" << data.size() << "bytes of EmBER data";
             processRoot(root);
         } else {
-            qDebug() << "[GlowParser] Root not ready after reading" << data.size() << "bytes (accumulating)";
+            qCDebug(lcGlow) << "[GlowParser] Root not ready after reading" << data.size() << "bytes (accumulating)";
         }
     } catch (const std::exception& e) {
         emit parsingError(QString("Ember+ parsing error: %1").arg(e.what()));
@@ -73,16 +162,16 @@ void GlowParser::processRoot(libember::dom::Node* root)
     try {
         auto glowRoot = dynamic_cast<libember::glow::GlowRootElementCollection*>(root);
         if (glowRoot) {
-            qDebug() << "[GlowParser] Root is GlowRootElementCollection with" << glowRoot->size() << "elements";
-            processElementCollection(glowRoot, "");
+            qCDebug(lcGlow) << "[GlowParser] Root is GlowRootElementCollection with" << glowRoot->size() << "elements";
+            processElementCollection(glowRoot, QString(), EmberPath());
         } else {
             
             auto streamColl = dynamic_cast<libember::glow::GlowStreamCollection*>(root);
             if (streamColl) {
-                qDebug() << "[GlowParser] Root is standalone GlowStreamCollection";
+                qCDebug(lcGlow) << "[GlowParser] Root is standalone GlowStreamCollection";
                 processStreamCollection(streamColl);
             } else {
-                qDebug() << "[GlowParser] WARNING: Root is unknown type!";
+                qCDebug(lcGlow) << "[GlowParser] WARNING: Root is unknown type!";
             }
         }
     } catch (const std::exception& e) {
@@ -92,44 +181,47 @@ void GlowParser::processRoot(libember::dom::Node* root)
     delete root;
 }
 
-void GlowParser::processElementCollection(libember::glow::GlowContainer* container, const QString& parentPath)
+void GlowParser::processElementCollection(libember::glow::GlowContainer* container, const QString& parentPath, EmberPath parentOid)
 {
+    using libember::glow::GlowType;
+
     for (auto it = container->begin(); it != container->end(); ++it) {
         auto element = &(*it);
-        
-        
-        if (auto qnode = dynamic_cast<libember::glow::GlowQualifiedNode*>(element)) {
-            processQualifiedNode(qnode);
-        }
-        else if (auto node = dynamic_cast<libember::glow::GlowNode*>(element)) {
-            processNode(node, parentPath);
-        }
-        else if (auto qparam = dynamic_cast<libember::glow::GlowQualifiedParameter*>(element)) {
-            processQualifiedParameter(qparam);
-        }
-        else if (auto param = dynamic_cast<libember::glow::GlowParameter*>(element)) {
-            processParameter(param, parentPath);
-        }
-        else if (auto qmatrix = dynamic_cast<libember::glow::GlowQualifiedMatrix*>(element)) {
-            processQualifiedMatrix(qmatrix);
-        }
-        else if (auto matrix = dynamic_cast<libember::glow::GlowMatrix*>(element)) {
-            processMatrix(matrix, parentPath);
-        }
-        else if (auto qfunction = dynamic_cast<libember::glow::GlowQualifiedFunction*>(element)) {
-            processQualifiedFunction(qfunction);
-        }
-        else if (auto function = dynamic_cast<libember::glow::GlowFunction*>(element)) {
-            processFunction(function, parentPath);
-        }
-        else if (auto invResult = dynamic_cast<libember::glow::GlowInvocationResult*>(element)) {
-            processInvocationResult(invResult);
-        }
-        else if (auto streamColl = dynamic_cast<libember::glow::GlowStreamCollection*>(element)) {
-            processStreamCollection(streamColl);
-        }
-        else {
-            qDebug() << "[GlowParser] WARNING: Unknown element type received, might be stream data";
+
+        switch (glowTypeOf(element)) {
+            case GlowType::QualifiedNode:
+                processQualifiedNode(static_cast<libember::glow::GlowQualifiedNode*>(element));
+                break;
+            case GlowType::Node:
+                processNode(static_cast<libember::glow::GlowNode*>(element), parentPath, parentOid);
+                break;
+            case GlowType::QualifiedParameter:
+                processQualifiedParameter(static_cast<libember::glow::GlowQualifiedParameter*>(element));
+                break;
+            case GlowType::Parameter:
+                processParameter(static_cast<libember::glow::GlowParameter*>(element), parentPath, parentOid);
+                break;
+            case GlowType::QualifiedMatrix:
+                processQualifiedMatrix(static_cast<libember::glow::GlowQualifiedMatrix*>(element));
+                break;
+            case GlowType::Matrix:
+                processMatrix(static_cast<libember::glow::GlowMatrix*>(element), parentPath, parentOid);
+                break;
+            case GlowType::QualifiedFunction:
+                processQualifiedFunction(static_cast<libember::glow::GlowQualifiedFunction*>(element));
+                break;
+            case GlowType::Function:
+                processFunction(static_cast<libember::glow::GlowFunction*>(element), parentPath, parentOid);
+                break;
+            case GlowType::InvocationResult:
+                processInvocationResult(element);
+                break;
+            case GlowType::StreamCollection:
+                processStreamCollection(static_cast<libember::glow::GlowStreamCollection*>(element));
+                break;
+            default:
+                qCDebug(lcGlow) << "[GlowParser] WARNING: Unknown element type received, might be stream data";
+                break;
         }
     }
 }
@@ -140,10 +232,7 @@ void GlowParser::processQualifiedNode(libember::glow::GlowQualifiedNode* node, b
     
     
     auto path = node->path();
-    for (auto num : path) {
-        info.path += QString::number(num) + ".";
-    }
-    info.path.chop(1);  
+    info.oid = qualifiedPath(path, info.path);
     
     
     info.hasIdentifier = node->contains(libember::glow::NodeProperty::Identifier);
@@ -166,7 +255,7 @@ void GlowParser::processQualifiedNode(libember::glow::GlowQualifiedNode* node, b
     bool shouldEmit = true;
     
     if (hadIdentifier && !info.hasIdentifier) {
-        qDebug() << "[GlowParser] SKIPPING QualifiedNode:" << info.path 
+        qCDebug(lcGlow) << "[GlowParser] SKIPPING QualifiedNode:" << info.path 
                  << "- would replace valid identifier with stub";
         shouldEmit = false;
     }
@@ -177,7 +266,7 @@ void GlowParser::processQualifiedNode(libember::glow::GlowQualifiedNode* node, b
     }
     
     if (shouldEmit) {
-        qDebug() << "[GlowParser] EMITTING QualifiedNode:" << info.path 
+        qCDebug(lcGlow) << "[GlowParser] EMITTING QualifiedNode:" << info.path 
                  << "identifier=" << info.identifier 
                  << "hasIdentifier=" << info.hasIdentifier;
         emit nodeReceived(info);
@@ -185,18 +274,17 @@ void GlowParser::processQualifiedNode(libember::glow::GlowQualifiedNode* node, b
     
     
     if (node->children()) {
-        processElementCollection(node->children(), info.path);
+        processElementCollection(node->children(), info.path, info.oid);
     }
 }
 
-void GlowParser::processNode(libember::glow::GlowNode* node, const QString& parentPath, bool)
+void GlowParser::processNode(libember::glow::GlowNode* node, const QString& parentPath, EmberPath parentOid, bool)
 {
     EmberData::NodeInfo info;
     
     int number = node->number();
-    info.path = parentPath.isEmpty() 
-        ? QString::number(number) 
-        : QString("%1.%2").arg(parentPath).arg(number);
+    info.path = childPath(parentPath, number);
+    info.oid = parentOid.child(number);
     
     info.hasIdentifier = node->contains(libember::glow::NodeProperty::Identifier);
     info.identifier = info.hasIdentifier
@@ -218,7 +306,7 @@ void GlowParser::processNode(libember::glow::GlowNode* node, const QString& pare
     bool shouldEmit = true;
     
     if (hadIdentifier && !info.hasIdentifier) {
-        qDebug() << "[GlowParser] SKIPPING Node:" << info.path 
+        qCDebug(lcGlow) << "[GlowParser] SKIPPING Node:" << info.path 
                  << "- would replace valid identifier with stub";
         shouldEmit = false;
     }
@@ -229,7 +317,7 @@ void GlowParser::processNode(libember::glow::GlowNode* node, const QString& pare
     }
     
     if (shouldEmit) {
-        qDebug() << "[GlowParser] EMITTING Node:" << info.path 
+        qCDebug(lcGlow) << "[GlowParser] EMITTING Node:" << info.path 
                  << "identifier=" << info.identifier 
                  << "hasIdentifier=" << info.hasIdentifier;
         emit nodeReceived(info);
@@ -237,7 +325,7 @@ void GlowParser::processNode(libember::glow::GlowNode* node, const QString& pare
     
     
     if (node->children()) {
-        processElementCollection(node->children(), info.path);
+        processElementCollection(node->children(), info.path, info.oid);
     }
 }
 
@@ -247,10 +335,7 @@ void GlowParser::processQualifiedParameter(libember::glow::GlowQualifiedParamete
     
     
     auto path = param->path();
-    for (auto num : path) {
-        info.path += QString::number(num) + ".";
-    }
-    info.path.chop(1);
+    info.oid = qualifiedPath(path, info.path);
     
     info.number = path.back();
     
@@ -260,7 +345,7 @@ void GlowParser::processQualifiedParameter(libember::glow::GlowQualifiedParamete
     
     static int debugCount = 0;
     if (debugCount < 5 && (info.path.contains(".1.0.1.") || info.path.contains(".1.1.1."))) {
-        qDebug().noquote() << QString("DEBUG: Parameter path=%1, m_matrixLabelPaths.size=%2")
+        qCDebug(lcGlow).noquote() << QString("DEBUG: Parameter path=%1, m_matrixLabelPaths.size=%2")
             .arg(info.path).arg(m_matrixLabelPaths.size());
         debugCount++;
     }
@@ -274,7 +359,7 @@ void GlowParser::processQualifiedParameter(libember::glow::GlowQualifiedParamete
             const QString& basePath = labelIt.key();
             
             if (info.path.startsWith(basePath + ".")) {
-                qDebug().noquote() << QString("MATCHED label path! basePath=%1, fullPath=%2")
+                qCDebug(lcGlow).noquote() << QString("MATCHED label path! basePath=%1, fullPath=%2")
                     .arg(basePath).arg(info.path);
                 
                 
@@ -299,10 +384,12 @@ void GlowParser::processQualifiedParameter(libember::glow::GlowQualifiedParamete
                                 
                                 EmberData::MatrixTargetInfo targetInfo;
                                 targetInfo.matrixPath = matrixPath;
+                                targetInfo.matrixOid = labelPaths.matrixOid;
                                 targetInfo.targetNumber = signalNumber;
                                 targetInfo.label = labelValue;
+                                targetInfo.isLabel = true;
                                 
-                                qDebug().noquote() << QString("EMBER+ TARGET LABEL: Matrix %1, target %2, label '%3'")
+                                qCDebug(lcGlow).noquote() << QString("EMBER+ TARGET LABEL: Matrix %1, target %2, label '%3'")
                                     .arg(matrixPath).arg(signalNumber).arg(labelValue);
                                 
                                 emit matrixTargetReceived(targetInfo);
@@ -310,10 +397,12 @@ void GlowParser::processQualifiedParameter(libember::glow::GlowQualifiedParamete
                                 
                                 EmberData::MatrixSourceInfo sourceInfo;
                                 sourceInfo.matrixPath = matrixPath;
+                                sourceInfo.matrixOid = labelPaths.matrixOid;
                                 sourceInfo.sourceNumber = signalNumber;
                                 sourceInfo.label = labelValue;
+                                sourceInfo.isLabel = true;
                                 
-                                qDebug().noquote() << QString("EMBER+ SOURCE LABEL: Matrix %1, source %2, label '%3'")
+                                qCDebug(lcGlow).noquote() << QString("EMBER+ SOURCE LABEL: Matrix %1, source %2, label '%3'")
                                     .arg(matrixPath).arg(signalNumber).arg(labelValue);
                                 
                                  emit matrixSourceReceived(sourceInfo);
@@ -343,7 +432,7 @@ void GlowParser::processQualifiedParameter(libember::glow::GlowQualifiedParamete
     
     
     if (hadIdentifier && !hasIdentifier) {
-        qDebug() << "[GlowParser] SKIPPING Parameter:" << info.path
+        qCDebug(lcGlow) << "[GlowParser] SKIPPING Parameter:" << info.path
                  << "- would replace valid identifier with stub";
         return;
     }
@@ -438,12 +527,21 @@ void GlowParser::processQualifiedParameter(libember::glow::GlowQualifiedParamete
     
     if (info.streamIdentifier > 0 && info.factor > 0) {
         m_streamFactors[info.streamIdentifier] = info.factor;
-        qDebug() << "[GlowParser] Stored factor" << info.factor << "for stream ID" << info.streamIdentifier;
+        qCDebug(lcGlow) << "[GlowParser] Stored factor" << info.factor << "for stream ID" << info.streamIdentifier;
+    }
+    
+    
+    info.streamOffset = 0;
+    if (auto descriptor = param->streamDescriptor()) {
+        info.streamOffset = descriptor->offset();
+        if (info.streamIdentifier > 0) {
+            registerStreamChannel(info.streamIdentifier, info.streamOffset, descriptor->format().value(), info.factor);
+        }
     }
     
     
     if (info.streamIdentifier > 0) {
-        qDebug() << "[GlowParser] PPM Parameter (qualified):" << info.path 
+        qCDebug(lcGlow) << "[GlowParser] PPM Parameter (qualified):" << info.path 
                  << "identifier=" << info.identifier 
                  << "streamId=" << info.streamIdentifier
                  << "type=" << info.type
@@ -460,18 +558,17 @@ void GlowParser::processQualifiedParameter(libember::glow::GlowQualifiedParamete
     
     
     if (param->children()) {
-        processElementCollection(param->children(), info.path);
+        processElementCollection(param->children(), info.path, info.oid);
     }
 }
 
-void GlowParser::processParameter(libember::glow::GlowParameter* param, const QString& parentPath)
+void GlowParser::processParameter(libember::glow::GlowParameter* param, const QString& parentPath, EmberPath parentOid)
 {
     EmberData::ParameterInfo info;
     
     info.number = param->number();
-    info.path = parentPath.isEmpty() 
-        ? QString::number(info.number) 
-        : QString("%1.%2").arg(parentPath).arg(info.number);
+    info.path = childPath(parentPath, info.number);
+    info.oid = parentOid.child(info.number);
     
     
     for (auto it = m_matrixLabelPaths.begin(); it != m_matrixLabelPaths.end(); ++it) {
@@ -487,7 +584,7 @@ void GlowParser::processParameter(libember::glow::GlowParameter* param, const QS
                 
                 static int debugLabelCount = 0;
                 if (debugLabelCount < 10) {
-                    qDebug().noquote() << QString("LABEL DEBUG: path=%1, basePath=%2, remaining=%3, parts=%4")
+                    qCDebug(lcGlow).noquote() << QString("LABEL DEBUG: path=%1, basePath=%2, remaining=%3, parts=%4")
                         .arg(info.path).arg(basePath).arg(remaining).arg(parts.join(","));
                     debugLabelCount++;
                 }
@@ -502,7 +599,7 @@ void GlowParser::processParameter(libember::glow::GlowParameter* param, const QS
                         
                         static int valueDebugCount = 0;
                         if (valueDebugCount < 10) {
-                            qDebug().noquote() << QString("VALUE DEBUG: paramNumber=%1, nodeNum=%2, signalNum=%3, value='%4'")
+                            qCDebug(lcGlow).noquote() << QString("VALUE DEBUG: paramNumber=%1, nodeNum=%2, signalNum=%3, value='%4'")
                                 .arg(param->number()).arg(nodeNumber).arg(signalNumber).arg(labelValue);
                             valueDebugCount++;
                         }
@@ -512,17 +609,21 @@ void GlowParser::processParameter(libember::glow::GlowParameter* param, const QS
                         if (isTargetLabel) {
                             EmberData::MatrixTargetInfo targetInfo;
                             targetInfo.matrixPath = matrixPath;
+                            targetInfo.matrixOid = labelPaths.matrixOid;
                             targetInfo.targetNumber = signalNumber;
                             targetInfo.label = labelValue;
-                            qDebug().noquote() << QString("EMBER+ TARGET LABEL: Matrix %1, target %2, label '%3'")
+                            targetInfo.isLabel = true;
+                            qCDebug(lcGlow).noquote() << QString("EMBER+ TARGET LABEL: Matrix %1, target %2, label '%3'")
                                 .arg(matrixPath).arg(signalNumber).arg(labelValue);
                             emit matrixTargetReceived(targetInfo);
                         } else {
                             EmberData::MatrixSourceInfo sourceInfo;
                             sourceInfo.matrixPath = matrixPath;
+                            sourceInfo.matrixOid = labelPaths.matrixOid;
                             sourceInfo.sourceNumber = signalNumber;
                             sourceInfo.label = labelValue;
-                            qDebug().noquote() << QString("EMBER+ SOURCE LABEL: Matrix %1, source %2, label '%3'")
+                            sourceInfo.isLabel = true;
+                            qCDebug(lcGlow).noquote() << QString("EMBER+ SOURCE LABEL: Matrix %1, source %2, label '%3'")
                                 .arg(matrixPath).arg(signalNumber).arg(labelValue);
                             emit matrixSourceReceived(sourceInfo);
                         }
@@ -547,7 +648,7 @@ void GlowParser::processParameter(libember::glow::GlowParameter* param, const QS
     }
     
     if (hadIdentifier && !hasIdentifier) {
-        qDebug() << "[GlowParser] SKIPPING Parameter:" << info.path
+        qCDebug(lcGlow) << "[GlowParser] SKIPPING Parameter:" << info.path
                  << "- would replace valid identifier with stub";
         return;
     }
@@ -641,12 +742,21 @@ void GlowParser::processParameter(libember::glow::GlowParameter* param, const QS
     
     if (info.streamIdentifier > 0 && info.factor > 0) {
         m_streamFactors[info.streamIdentifier] = info.factor;
-        qDebug() << "[GlowParser] Stored factor" << info.factor << "for stream ID" << info.streamIdentifier;
+        qCDebug(lcGlow) << "[GlowParser] Stored factor" << info.factor << "for stream ID" << info.streamIdentifier;
+    }
+    
+    
+    info.streamOffset = 0;
+    if (auto descriptor = param->streamDescriptor()) {
+        info.streamOffset = descriptor->offset();
+        if (info.streamIdentifier > 0) {
+            registerStreamChannel(info.streamIdentifier, info.streamOffset, descriptor->format().value(), info.factor);
+        }
     }
     
     
     if (info.streamIdentifier > 0) {
-        qDebug() << "[GlowParser] PPM Parameter (unqualified):" << info.path 
+        qCDebug(lcGlow) << "[GlowParser] PPM Parameter (unqualified):" << info.path 
                  << "identifier=" << info.identifier 
                  << "streamId=" << info.streamIdentifier
                  << "type=" << info.type
@@ -663,7 +773,7 @@ void GlowParser::processParameter(libember::glow::GlowParameter* param, const QS
     
     
     if (param->children()) {
-        processElementCollection(param->children(), info.path);
+        processElementCollection(param->children(), info.path, info.oid);
     }
 }
 
@@ -672,10 +782,7 @@ void GlowParser::processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* mat
     
     auto path = matrix->path();
     QString pathStr;
-    for (auto num : path) {
-        pathStr += QString::number(num) + ".";
-    }
-    pathStr.chop(1);
+    const EmberPath oid = qualifiedPath(path, pathStr);
     
     int number = path.back();
     
@@ -689,6 +796,7 @@ void GlowParser::processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* mat
     if (hasMetadata) {
         EmberData::MatrixInfo info;
         info.path = pathStr;
+        info.oid = oid;
         info.number = number;
         
         info.identifier = matrix->contains(libember::glow::MatrixProperty::Identifier)
@@ -718,6 +826,7 @@ void GlowParser::processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* mat
     if (matrix->labels()) {
         MatrixLabelPaths labelPaths;
         labelPaths.matrixPath = pathStr;
+        labelPaths.matrixOid = oid;
         
         
         std::vector<libember::glow::GlowLabel const*> labels;
@@ -741,7 +850,7 @@ void GlowParser::processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* mat
             
             
             QString labelType = (labelPaths.labelOrder.size() == 1) ? "targets" : "sources";
-            qDebug().noquote() << QString("Matrix %1: Found label layer '%2' (%3) at basePath %4")
+            qCDebug(lcGlow).noquote() << QString("Matrix %1: Found label layer '%2' (%3) at basePath %4")
                 .arg(pathStr).arg(description).arg(labelType).arg(basePathStr);
         }
         
@@ -749,11 +858,11 @@ void GlowParser::processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* mat
         if (!labelPaths.labelBasePaths.isEmpty()) {
             m_matrixLabelPaths[pathStr] = labelPaths;
             
-            qDebug().noquote() << QString("STORED %1 label basePaths for matrix %2 (total matrices: %3)")
+            qCDebug(lcGlow).noquote() << QString("STORED %1 label basePaths for matrix %2 (total matrices: %3)")
                 .arg(labelPaths.labelBasePaths.size()).arg(pathStr).arg(m_matrixLabelPaths.size());
             
             
-            qDebug().noquote() << QString("Emitting signal to request label parameters for matrix %1").arg(pathStr);
+            qCDebug(lcGlow).noquote() << QString("Emitting signal to request label parameters for matrix %1").arg(pathStr);
             emit matrixLabelPathsDiscovered(pathStr, labelPaths.labelOrder);
         }
     }
@@ -764,6 +873,7 @@ void GlowParser::processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* mat
             if (auto target = dynamic_cast<libember::glow::GlowTarget*>(&(*it))) {
                 EmberData::MatrixTargetInfo targetInfo;
                 targetInfo.matrixPath = pathStr;
+                targetInfo.matrixOid = oid;
                 targetInfo.targetNumber = target->number();
                 targetInfo.label = QString("Target %1").arg(targetInfo.targetNumber);
                 
@@ -778,6 +888,7 @@ void GlowParser::processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* mat
             if (auto source = dynamic_cast<libember::glow::GlowSource*>(&(*it))) {
                 EmberData::MatrixSourceInfo sourceInfo;
                 sourceInfo.matrixPath = pathStr;
+                sourceInfo.matrixOid = oid;
                 sourceInfo.sourceNumber = source->number();
                 sourceInfo.label = QString("Source %1").arg(sourceInfo.sourceNumber);
                 
@@ -793,7 +904,7 @@ void GlowParser::processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* mat
                 int targetNumber = connection->target();
                 
                 
-                emit matrixTargetConnectionsCleared(pathStr, targetNumber);
+                emit matrixTargetConnectionsCleared(pathStr, oid, targetNumber);
                 
                 
                 libember::ber::ObjectIdentifier sources = connection->sources();
@@ -804,6 +915,7 @@ void GlowParser::processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* mat
                     for (auto sourceIt = sources.begin(); sourceIt != sources.end(); ++sourceIt) {
                         EmberData::MatrixConnectionInfo connInfo;
                         connInfo.matrixPath = pathStr;
+                        connInfo.matrixOid = oid;
                         connInfo.targetNumber = targetNumber;
                         connInfo.sourceNumber = *sourceIt;
                         connInfo.connected = true;
@@ -818,16 +930,15 @@ void GlowParser::processQualifiedMatrix(libember::glow::GlowQualifiedMatrix* mat
     
     
     if (matrix->children()) {
-        processElementCollection(matrix->children(), pathStr);
+        processElementCollection(matrix->children(), pathStr, oid);
     }
 }
 
-void GlowParser::processMatrix(libember::glow::GlowMatrix* matrix, const QString& parentPath)
+void GlowParser::processMatrix(libember::glow::GlowMatrix* matrix, const QString& parentPath, EmberPath parentOid)
 {
     int number = matrix->number();
-    QString pathStr = parentPath.isEmpty() 
-        ? QString::number(number) 
-        : QString("%1.%2").arg(parentPath).arg(number);
+    QString pathStr = childPath(parentPath, number);
+    const EmberPath oid = parentOid.child(number);
     
     
     bool hasMetadata = matrix->contains(libember::glow::MatrixProperty::Identifier) ||
@@ -839,6 +950,7 @@ void GlowParser::processMatrix(libember::glow::GlowMatrix* matrix, const QString
     if (hasMetadata) {
         EmberData::MatrixInfo info;
         info.path = pathStr;
+        info.oid = oid;
         info.number = number;
         
         info.identifier = matrix->contains(libember::glow::MatrixProperty::Identifier)
@@ -870,6 +982,7 @@ void GlowParser::processMatrix(libember::glow::GlowMatrix* matrix, const QString
             if (auto target = dynamic_cast<libember::glow::GlowTarget*>(&(*it))) {
                 EmberData::MatrixTargetInfo targetInfo;
                 targetInfo.matrixPath = pathStr;
+                targetInfo.matrixOid = oid;
                 targetInfo.targetNumber = target->number();
                 targetInfo.label = QString("Target %1").arg(targetInfo.targetNumber);
                 
@@ -884,6 +997,7 @@ void GlowParser::processMatrix(libember::glow::GlowMatrix* matrix, const QString
             if (auto source = dynamic_cast<libember::glow::GlowSource*>(&(*it))) {
                 EmberData::MatrixSourceInfo sourceInfo;
                 sourceInfo.matrixPath = pathStr;
+                sourceInfo.matrixOid = oid;
                 sourceInfo.sourceNumber = source->number();
                 sourceInfo.label = QString("Source %1").arg(sourceInfo.sourceNumber);
                 
@@ -899,7 +1013,7 @@ void GlowParser::processMatrix(libember::glow::GlowMatrix* matrix, const QString
                 int targetNumber = connection->target();
                 
                 
-                emit matrixTargetConnectionsCleared(pathStr, targetNumber);
+                emit matrixTargetConnectionsCleared(pathStr, oid, targetNumber);
                 
                 
                 libember::ber::ObjectIdentifier sources = connection->sources();
@@ -910,6 +1024,7 @@ void GlowParser::processMatrix(libember::glow::GlowMatrix* matrix, const QString
                     for (auto sourceIt = sources.begin(); sourceIt != sources.end(); ++sourceIt) {
                         EmberData::MatrixConnectionInfo connInfo;
                         connInfo.matrixPath = pathStr;
+                        connInfo.matrixOid = oid;
                         connInfo.targetNumber = targetNumber;
                         connInfo.sourceNumber = *sourceIt;
                         connInfo.connected = true;
@@ -924,7 +1039,7 @@ void GlowParser::processMatrix(libember::glow::GlowMatrix* matrix, const QString
     
     
     if (matrix->children()) {
-        processElementCollection(matrix->children(), pathStr);
+        processElementCollection(matrix->children(), pathStr, oid);
     }
 }
 
@@ -934,10 +1049,7 @@ void GlowParser::processQualifiedFunction(libember::glow::GlowQualifiedFunction*
     
     
     auto path = function->path();
-    for (auto num : path) {
-        info.path += QString::number(num) + ".";
-    }
-    info.path.chop(1);
+    info.oid = qualifiedPath(path, info.path);
     
     info.identifier = function->contains(libember::glow::FunctionProperty::Identifier)
         ? QString::fromStdString(function->identifier())
@@ -972,18 +1084,17 @@ void GlowParser::processQualifiedFunction(libember::glow::GlowQualifiedFunction*
     
     
     if (function->children()) {
-        processElementCollection(function->children(), info.path);
+        processElementCollection(function->children(), info.path, info.oid);
     }
 }
 
-void GlowParser::processFunction(libember::glow::GlowFunction* function, const QString& parentPath)
+void GlowParser::processFunction(libember::glow::GlowFunction* function, const QString& parentPath, EmberPath parentOid)
 {
     EmberData::FunctionInfo info;
     
     int number = function->number();
-    info.path = parentPath.isEmpty() 
-        ? QString::number(number) 
-        : QString("%1.%2").arg(parentPath).arg(number);
+    info.path = childPath(parentPath, number);
+    info.oid = parentOid.child(number);
     
     info.identifier = function->contains(libember::glow::FunctionProperty::Identifier)
         ? QString::fromStdString(function->identifier())
@@ -1018,7 +1129,7 @@ void GlowParser::processFunction(libember::glow::GlowFunction* function, const Q
     
     
     if (function->children()) {
-        processElementCollection(function->children(), info.path);
+        processElementCollection(function->children(), info.path, info.oid);
     }
 }
 
@@ -1059,49 +1170,70 @@ void GlowParser::processInvocationResult(libember::dom::Node* result)
     }
 }
 
+void GlowParser::registerStreamChannel(int streamIdentifier, int offset, int format, int factor)
+{
+    QVector<StreamChannel> &channels = m_streamChannels[streamIdentifier];
+    auto it = std::lower_bound(channels.begin(), channels.end(), offset,
+                               [](const StreamChannel &channel, int value) { return channel.offset < value; });
+    if (it != channels.end() && it->offset == offset) {
+        it->format = format;
+        it->factor = factor;
+    } else {
+        channels.insert(it, StreamChannel{offset, format, factor});
+    }
+}
+
 void GlowParser::processStreamCollection(libember::glow::GlowContainer* streamCollection)
 {
-    qDebug() << "[GlowParser] Processing StreamCollection with" << streamCollection->size() << "entries";
+    QVector<EmberData::StreamValue> values;
+    values.reserve(static_cast<int>(streamCollection->size()));
     
     for (auto it = streamCollection->begin(); it != streamCollection->end(); ++it) {
         if (auto streamEntry = dynamic_cast<libember::glow::GlowStreamEntry*>(&(*it))) {
-            EmberData::StreamValue info;
-            info.streamIdentifier = streamEntry->streamIdentifier();
-            
-            
-            
-            
+            int streamIdentifier = streamEntry->streamIdentifier();
             auto value = streamEntry->value();
-            double rawValue = 0.0;
             
             switch (value.type().value()) {
                 case libember::glow::ParameterType::Integer:
-                    rawValue = static_cast<double>(value.toInteger());
+                case libember::glow::ParameterType::Real: {
+                    double rawValue = value.type().value() == libember::glow::ParameterType::Integer
+                        ? static_cast<double>(value.toInteger())
+                        : value.toReal();
+                    int factor = m_streamFactors.value(streamIdentifier, 1);
+                    values.append({streamIdentifier, 0, factor > 0 ? rawValue / factor : rawValue});
                     break;
-                case libember::glow::ParameterType::Real:
-                    rawValue = value.toReal();
+                }
+                case libember::glow::ParameterType::Octets: {
+                    // Packed stream: every known channel is extracted from the same buffer in offset order
+                    auto channels = m_streamChannels.constFind(streamIdentifier);
+                    if (channels == m_streamChannels.constEnd()) {
+                        break;
+                    }
+                    
+                    libember::ber::Octets octets = value.toOctets();
+                    if (octets.size() == 0) {
+                        break;
+                    }
+                    const unsigned char *data = &*octets.begin();
+                    
+                    for (const StreamChannel &channel : channels.value()) {
+                        double rawValue;
+                        if (decodePackedStreamValue(data, octets.size(), channel.offset, channel.format, rawValue)) {
+                            values.append({streamIdentifier, channel.offset,
+                                           channel.factor > 0 ? rawValue / channel.factor : rawValue});
+                        }
+                    }
                     break;
+                }
                 default:
-                    rawValue = 0.0;
                     break;
             }
-            
-            
-            int factor = m_streamFactors.value(info.streamIdentifier, 1);
-            
-            
-            if (factor > 0) {
-                info.value = rawValue / static_cast<double>(factor);
-            } else {
-                info.value = rawValue;  
-            }
-            
-            qDebug() << "[GlowParser] StreamEntry: streamId=" << info.streamIdentifier 
-                     << "rawValue=" << rawValue << "factor=" << factor << "dB=" << info.value;
-            
-            emit streamValueReceived(info);
         }
     }
+    
+    if (!values.isEmpty()) {
+        emit streamValuesReceived(values);
+    }
 }
 
 void GlowParser::onItemReady(libember::dom::Node* node)
@@ -1114,25 +1246,26 @@ void GlowParser::onItemReady(libember::dom::Node* node)
     }
     
     try {
-        // Check if this is a qualified parameter (label value)
-        if (auto qparam = dynamic_cast<libember::glow::GlowQualifiedParameter*>(node)) {
-            processQualifiedParameter(qparam);
-        }
-        // Check if this is a qualified node
-        else if (auto qnode = dynamic_cast<libember::glow::GlowQualifiedNode*>(node)) {
-            processQualifiedNode(qnode);
-        }
-        // Check if this is a qualified matrix
-        else if (auto qmatrix = dynamic_cast<libember::glow::GlowQualifiedMatrix*>(node)) {
-            processQualifiedMatrix(qmatrix);
-        }
-        // Check if this is a qualified function
-        else if (auto qfunction = dynamic_cast<libember::glow::GlowQualifiedFunction*>(node)) {
-            processQualifiedFunction(qfunction);
+        switch (glowTypeOf(node)) {
+            case libember::glow::GlowType::QualifiedParameter:
+                // Label values arrive as qualified parameters
+                processQualifiedParameter(static_cast<libember::glow::GlowQualifiedParameter*>(node));
+                break;
+            case libember::glow::GlowType::QualifiedNode:
+                processQualifiedNode(static_cast<libember::glow::GlowQualifiedNode*>(node));
+                break;
+            case libember::glow::GlowType::QualifiedMatrix:
+                processQualifiedMatrix(static_cast<libember::glow::GlowQualifiedMatrix*>(node));
+                break;
+            case libember::glow::GlowType::QualifiedFunction:
+                processQualifiedFunction(static_cast<libember::glow::GlowQualifiedFunction*>(node));
+                break;
+            default:
+                break;
         }
         // For other types, we'll still process them in the traditional way when root is ready
     } catch (const std::exception& e) {
-        qDebug() << "[GlowParser] Error in streaming item processing:" << e.what();
+        qCDebug(lcGlow) << "[GlowParser] Error in streaming item processing:" << e.what();
     }
 }
 
@@ -2,9 +2,9 @@
 
 #include "GraphWidget.h"
 #include <QPainter>
-#include <QDateTime>
 #include <QFont>
 #include <QHBoxLayout>
+#include <QScreen>
 #include <cmath>
 #include <algorithm>
 
@@ -13,8 +13,18 @@ GraphWidget::GraphWidget(QWidget *parent)
     , m_minValue(0.0)
     , m_maxValue(100.0)
     , m_streamIdentifier(-1)
+    , m_streamOffset(0)
     , m_timeWindowSeconds(30)
+    , m_lastValue(0.0)
+    , m_hasNewData(false)
 {
+    m_clock.start();
+
+    m_repaintTimer = new QTimer(this);
+    m_repaintTimer->setSingleShot(true);
+    m_repaintTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_repaintTimer, &QTimer::timeout, this, &GraphWidget::onRepaintTimer);
+
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     mainLayout->setContentsMargins(20, 20, 20, 20);
     mainLayout->setSpacing(10);
@@ -104,29 +114,19 @@ void GraphWidget::setParameterInfo(const QString &identifier, const QString &pat
 
 void GraphWidget::addDataPoint(double value)
 {
-    DataPoint point;
-    point.timestamp = QDateTime::currentMSecsSinceEpoch();
-    point.value = value;
-    
-    m_dataPoints.append(point);
-    
-    
-    pruneOldData();
-    
-    
-    m_currentValueLabel->setText(formatValue(value));
-    
-    
-    updateStats();
+    m_samples.append(m_clock.elapsed(), value);
+    m_lastValue = value;
+    m_hasNewData = true;
     
     
-    update();
+    scheduleRepaint();
 }
 
 void GraphWidget::setTimeWindow(int seconds)
 {
     m_timeWindowSeconds = seconds;
     pruneOldData();
+    updateStats();
     update();
 }
 
@@ -138,41 +138,46 @@ void GraphWidget::onTimeWindowChanged(int index)
 
 void GraphWidget::pruneOldData()
 {
-    if (m_dataPoints.isEmpty()) return;
-    
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
-    qint64 cutoff = now - (m_timeWindowSeconds * 1000);
+    qint64 cutoff = m_clock.elapsed() - (m_timeWindowSeconds * 1000LL);
+    m_samples.removeOlderThan(cutoff);
+}
+
+void GraphWidget::scheduleRepaint()
+{
+    if (m_repaintTimer->isActive()) return;
     
+    // One repaint per display frame, however fast samples arrive
+    qreal refreshRate = screen() ? screen()->refreshRate() : 60.0;
+    if (refreshRate <= 0.0) refreshRate = 60.0;
+    m_repaintTimer->start(qBound(4, static_cast<int>(1000.0 / refreshRate), 100));
+}
+
+void GraphWidget::onRepaintTimer()
+{
+    pruneOldData();
     
-    while (!m_dataPoints.isEmpty() && m_dataPoints.first().timestamp < cutoff) {
-        m_dataPoints.removeFirst();
+    if (m_hasNewData) {
+        m_currentValueLabel->setText(formatValue(m_lastValue));
+        m_hasNewData = false;
     }
+    
+    
+    updateStats();
+    update();
 }
 
 void GraphWidget::updateStats()
 {
-    if (m_dataPoints.isEmpty()) {
+    if (m_samples.isEmpty()) {
         m_statsLabel->setText("No data");
         return;
     }
     
-    double min = m_dataPoints.first().value;
-    double max = m_dataPoints.first().value;
-    double sum = 0.0;
-    
-    for (const DataPoint &point : m_dataPoints) {
-        min = qMin(min, point.value);
-        max = qMax(max, point.value);
-        sum += point.value;
-    }
-    
-    double avg = sum / m_dataPoints.size();
-    
     m_statsLabel->setText(QString("Min: %1  |  Avg: %2  |  Max: %3  |  Samples: %4")
-                         .arg(formatValue(min))
-                         .arg(formatValue(avg))
-                         .arg(formatValue(max))
-                         .arg(m_dataPoints.size()));
+                         .arg(formatValue(m_samples.minimum()))
+                         .arg(formatValue(m_samples.average()))
+                         .arg(formatValue(m_samples.maximum()))
+                         .arg(m_samples.size()));
 }
 
 void GraphWidget::paintEvent(QPaintEvent *event)
@@ -226,8 +231,8 @@ void GraphWidget::drawAxes(QPainter &painter, const QRect &graphRect)
     }
     
     
-    if (!m_dataPoints.isEmpty()) {
-        qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (!m_samples.isEmpty()) {
+        qint64 now = m_clock.elapsed();
         qint64 windowStart = now - (m_timeWindowSeconds * 1000);
         
         int numXLabels = 4;
@@ -267,48 +272,43 @@ void GraphWidget::drawGridLines(QPainter &painter, const QRect &graphRect)
 
 void GraphWidget::drawGraph(QPainter &painter, const QRect &graphRect)
 {
-    if (m_dataPoints.size() < 2) return;
+    qint64 span = m_timeWindowSeconds * 1000LL;
+    qint64 windowStart = m_clock.elapsed() - span;
     
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
-    qint64 windowStart = now - (m_timeWindowSeconds * 1000);
+    int firstVisible = m_samples.lowerBound(windowStart);
+    int visibleCount = m_samples.size() - firstVisible;
+    if (visibleCount < 2) return;
     
     
-    QPainterPath path;
-    bool firstPoint = true;
+    // At most four points per pixel column regardless of sample rate
+    QVector<QPointF> columns = m_samples.decimate(windowStart, span, graphRect.width());
+    double range = m_maxValue - m_minValue;
     
-    for (const DataPoint &point : m_dataPoints) {
-        
-        double timeRatio = static_cast<double>(point.timestamp - windowStart) / (m_timeWindowSeconds * 1000);
-        int x = graphRect.left() + static_cast<int>(timeRatio * graphRect.width());
-        
-        
-        double valueRatio = (point.value - m_minValue) / (m_maxValue - m_minValue);
-        valueRatio = qBound(0.0, valueRatio, 1.0);  
-        int y = graphRect.bottom() - static_cast<int>(valueRatio * graphRect.height());
-        
-        if (firstPoint) {
-            path.moveTo(x, y);
-            firstPoint = false;
-        } else {
-            path.lineTo(x, y);
-        }
+    auto toY = [&](double value) {
+        double valueRatio = range != 0.0 ? (value - m_minValue) / range : 0.0;
+        valueRatio = qBound(0.0, valueRatio, 1.0);
+        return graphRect.bottom() - valueRatio * graphRect.height();
+    };
+    
+    QPolygonF polyline;
+    polyline.reserve(columns.size());
+    for (const QPointF &column : columns) {
+        polyline.append(QPointF(graphRect.left() + column.x(), toY(column.y())));
     }
     
     
     painter.setPen(QPen(QColor(33, 150, 243), 2));  
-    painter.drawPath(path);
+    painter.drawPolyline(polyline);
+    
     
+    // Sample markers only while they are far enough apart to tell apart
+    if (visibleCount * 8 > graphRect.width()) return;
     
     painter.setBrush(QColor(33, 150, 243));
-    for (const DataPoint &point : m_dataPoints) {
-        double timeRatio = static_cast<double>(point.timestamp - windowStart) / (m_timeWindowSeconds * 1000);
-        int x = graphRect.left() + static_cast<int>(timeRatio * graphRect.width());
-        
-        double valueRatio = (point.value - m_minValue) / (m_maxValue - m_minValue);
-        valueRatio = qBound(0.0, valueRatio, 1.0);
-        int y = graphRect.bottom() - static_cast<int>(valueRatio * graphRect.height());
-        
-        painter.drawEllipse(QPoint(x, y), 3, 3);
+    for (int i = firstVisible; i < m_samples.size(); ++i) {
+        double timeRatio = static_cast<double>(m_samples.timestampAt(i) - windowStart) / span;
+        QPointF point(graphRect.left() + timeRatio * graphRect.width(), toY(m_samples.valueAt(i)));
+        painter.drawEllipse(point, 3, 3);
     }
 }
 
@@ -0,0 +1,6 @@
+#include "LogCategories.h"
+
+Q_LOGGING_CATEGORY(lcGlow, "emberviewer.glow", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcS101, "emberviewer.s101", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcIo, "emberviewer.io", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcElements, "emberviewer.elements", QtInfoMsg)
@@ -8,11 +8,14 @@
 
 #include "MainWindow.h"
 #include "EmberConnection.h"
-#include "EmberTreeWidget.h"
+#include "EmberTreeView.h"
+#include "EmberTreeModel.h"
 #include "ParameterDelegate.h"
 #include "PathColumnDelegate.h"
 #include "VirtualizedMatrixWidget.h"
 #include "MeterWidget.h"
+#include "StreamDashboard.h"
+#include "PerformancePanel.h"
 #include "TriggerWidget.h"
 #include "SliderWidget.h"
 #include "GraphWidget.h"
@@ -49,11 +52,13 @@
 #include <QMessageBox>
 #include <QProgressDialog>
 #include <QDateTime>
+#include <QSet>
 #include <QHeaderView>
 #include <QCloseEvent>
 #include <QComboBox>
 #include <QPushButton>
 #include <QScrollArea>
+#include <QDockWidget>
 #include <QApplication>
 #include <QEvent>
 #include <QKeyEvent>
@@ -65,9 +70,19 @@
 #include <QIcon>
 #include <QRegularExpression>
 
+namespace {
+
+QString columnText(const QModelIndex &index, int column)
+{
+    return index.siblingAtColumn(column).data().toString();
+}
+
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
-    , m_treeWidget(nullptr)
+    , m_treeView(nullptr)
+    , m_treeModel(nullptr)
     , m_propertyPanel(nullptr)
     , m_consoleLog(nullptr)
     , m_consoleGroup(nullptr)
@@ -83,9 +98,15 @@ MainWindow::MainWindow(QWidget *parent)
     , m_connection(nullptr)
     , m_activeMeter(nullptr)
     , m_activeMeterPath()
+    , m_streamDashboard(nullptr)
+    , m_streamDashboardDock(nullptr)
+    , m_performancePanel(nullptr)
+    , m_performanceDock(nullptr)
     , m_activeParameterWidget(nullptr)
     , m_activeParameterPath()
+    , m_activeMatrixPath()
     , m_enableCrosspointsAction(nullptr)
+    , m_recordCaptureAction(nullptr)
     , m_crosspointsStatusLabel(nullptr)
     , m_emulatorWindow(nullptr)
     , m_updateManager(nullptr)
@@ -153,6 +174,15 @@ MainWindow::MainWindow(QWidget *parent)
         qDebug() << "Label fetching complete - stopping spinner";
         onOperationCompleted();
     });
+    connect(m_connection, &EmberConnection::captureStateChanged, this,
+            [this](bool recording, const QString &filePath) {
+        m_recordCaptureAction->setChecked(recording);
+        if (recording) {
+            logMessage(QString("Recording S101 session to %1").arg(filePath));
+        } else {
+            logMessage(QString("S101 recording stopped: %1").arg(filePath));
+        }
+    });
     // Create timer for minimum status display time
     m_statusDisplayTimer = new QTimer(this);
     m_statusDisplayTimer->setSingleShot(true);
@@ -221,8 +251,9 @@ MainWindow::MainWindow(QWidget *parent)
     
     
     connect(m_connection, &EmberConnection::nodeReceived, this, &MainWindow::onNodeReceived);
-    connect(m_connection, &EmberConnection::parameterReceived, this, &MainWindow::onParameterReceived);
-    connect(m_connection, &EmberConnection::streamValueReceived, this, &MainWindow::onStreamValueReceived);
+    connect(m_connection, &EmberConnection::nodesReceived, this, &MainWindow::onNodesReceived);
+    connect(m_connection, &EmberConnection::parametersReceived, this, &MainWindow::onParametersReceived);
+    connect(m_connection, &EmberConnection::streamValuesReceived, this, &MainWindow::onStreamValuesReceived);
     
     
     connect(m_connection, &EmberConnection::matrixReceived, this, &MainWindow::onMatrixReceived);
@@ -235,12 +266,13 @@ MainWindow::MainWindow(QWidget *parent)
     
     
     
-    m_treeViewController = new TreeViewController(m_treeWidget, m_connection, this);
+    m_treeViewController = new TreeViewController(m_treeModel, m_connection, this);
+    connect(m_connection, &EmberConnection::elementsRemoved, m_treeViewController, &TreeViewController::onElementsRemoved);
     m_subscriptionManager = new SubscriptionManager(m_connection, this);
     m_matrixManager = new MatrixManager(m_connection, this);
     m_activityTracker = new CrosspointActivityTracker(m_crosspointsStatusLabel, this);
     m_functionInvoker = new FunctionInvoker(m_connection, this);
-    m_snapshotManager = new SnapshotManager(m_treeWidget, m_connection, m_matrixManager, m_functionInvoker, this);
+    m_snapshotManager = new SnapshotManager(m_treeModel, m_connection, m_matrixManager, m_functionInvoker, this);
     
     
     qApp->installEventFilter(m_activityTracker);
@@ -249,9 +281,9 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_activityTracker, &CrosspointActivityTracker::timeout, this, &MainWindow::onActivityTimeout);
     
     
-    connect(m_treeWidget, &QTreeWidget::itemExpanded, m_treeViewController, &TreeViewController::onItemExpanded);
-    connect(m_treeWidget, &QTreeWidget::itemExpanded, m_subscriptionManager, &SubscriptionManager::onItemExpanded);
-    connect(m_treeWidget, &QTreeWidget::itemCollapsed, m_subscriptionManager, &SubscriptionManager::onItemCollapsed);
+    connect(m_treeView, &QTreeView::expanded, m_subscriptionManager, &SubscriptionManager::onItemExpanded);
+    connect(m_treeView, &QTreeView::collapsed, m_subscriptionManager, &SubscriptionManager::onItemCollapsed);
+    m_subscriptionManager->setTreeView(m_treeView);
     
     
     connect(m_matrixManager, &MatrixManager::matrixDimensionsUpdated, this, &MainWindow::onMatrixDimensionsUpdated);
@@ -388,15 +420,15 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
 void MainWindow::setupUi()
 {
     
-    m_treeWidget = new EmberTreeWidget(this);
-    m_treeWidget->setHeaderLabels(QStringList() << "Path" << "Type" << "Value");
-    m_treeWidget->setColumnCount(3);
-    m_treeWidget->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);  
-    m_treeWidget->header()->setSectionResizeMode(1, QHeaderView::Fixed);  
-    m_treeWidget->setColumnWidth(1, 130);  
-    m_treeWidget->header()->setStretchLastSection(true);  
-    m_treeWidget->setAlternatingRowColors(true);
-    m_treeWidget->setContextMenuPolicy(Qt::CustomContextMenu);
+    m_treeModel = new EmberTreeModel(this);
+    m_treeView = new EmberTreeView(this);
+    m_treeView->setModel(m_treeModel);
+    m_treeView->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);  
+    m_treeView->header()->setSectionResizeMode(1, QHeaderView::Fixed);  
+    m_treeView->setColumnWidth(1, 130);  
+    m_treeView->header()->setStretchLastSection(true);  
+    m_treeView->setAlternatingRowColors(true);
+    m_treeView->setContextMenuPolicy(Qt::CustomContextMenu);
     
     
     
@@ -407,10 +439,10 @@ void MainWindow::setupUi()
     
     
     
-    m_treeWidget->setAutoExpandDelay(0);
-    m_treeWidget->setAnimated(false);
-    m_treeWidget->setUniformRowHeights(true);
-    m_treeWidget->setAllColumnsShowFocus(false);
+    m_treeView->setAutoExpandDelay(0);
+    m_treeView->setAnimated(false);
+    m_treeView->setUniformRowHeights(true);
+    m_treeView->setAllColumnsShowFocus(false);
     
     
     int doubleClickInterval = QApplication::doubleClickInterval();
@@ -420,20 +452,20 @@ void MainWindow::setupUi()
     QApplication::setDoubleClickInterval(250);  
     qDebug() << "Set double-click interval to: 250ms";
     
-    connect(m_treeWidget, &QTreeWidget::itemSelectionChanged, this, &MainWindow::onTreeSelectionChanged);
-    connect(m_treeWidget, &QTreeWidget::customContextMenuRequested, this, [this](const QPoint &pos) {
-        QTreeWidgetItem *item = m_treeWidget->itemAt(pos);
-        if (!item) return;
+    connect(m_treeView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::onTreeSelectionChanged);
+    connect(m_treeView, &QTreeView::customContextMenuRequested, this, [this](const QPoint &pos) {
+        QModelIndex index = m_treeView->indexAt(pos).siblingAtColumn(EmberTreeModel::NameColumn);
+        if (!index.isValid()) return;
         
-        QString type = item->text(1);
+        QString type = columnText(index, EmberTreeModel::TypeColumn);
         if (type == "Function") {
-            QString path = item->data(0, Qt::UserRole).toString();
+            QString path = index.data(Qt::UserRole).toString();
             if (!m_functionInvoker->hasFunction(path)) return;
             
             QMenu contextMenu;
             QAction *invokeAction = contextMenu.addAction("Invoke Function...");
             
-            QAction *selected = contextMenu.exec(m_treeWidget->mapToGlobal(pos));
+            QAction *selected = contextMenu.exec(m_treeView->mapToGlobal(pos));
             if (selected == invokeAction) {
                 FunctionInfo funcInfo = m_functionInvoker->getFunctionInfo(path);
                 
@@ -449,26 +481,42 @@ void MainWindow::setupUi()
                 }
             }
         }
+        else if (type == "Parameter" && index.data(Qt::UserRole + 9).toInt() > 0) {
+            QString path = index.data(Qt::UserRole).toString();
+            bool onDashboard = isOnStreamDashboard(path);
+            
+            QMenu contextMenu;
+            QAction *dashboardAction = contextMenu.addAction(onDashboard ? "Remove from Stream Dashboard"
+                                                                         : "Add to Stream Dashboard");
+            
+            if (contextMenu.exec(m_treeView->mapToGlobal(pos)) == dashboardAction) {
+                if (onDashboard) {
+                    removeFromStreamDashboard(path);
+                } else {
+                    addToStreamDashboard(index);
+                }
+            }
+        }
     });
     
     
     PathColumnDelegate *pathDelegate = new PathColumnDelegate(this);
-    m_treeWidget->setItemDelegateForColumn(0, pathDelegate);  
+    m_treeView->setItemDelegateForColumn(0, pathDelegate);  
     
     
     ParameterDelegate *delegate = new ParameterDelegate(this);
-    m_treeWidget->setItemDelegateForColumn(2, delegate);  
+    m_treeView->setItemDelegateForColumn(2, delegate);  
     
     
-    m_treeWidget->setEditTriggers(QAbstractItemView::DoubleClicked);
+    m_treeView->setEditTriggers(QAbstractItemView::DoubleClicked);
     
     
     connect(delegate, &ParameterDelegate::valueChanged, this, [this](const QString &path, const QString &newValue) {
         
         
-        QTreeWidgetItem *item = m_treeViewController->findTreeItem(path);
-        if (item) {
-            int type = item->data(0, Qt::UserRole + 1).toInt();
+        QModelIndex index = m_treeViewController->indexForPath(path);
+        if (index.isValid()) {
+            int type = index.data(Qt::UserRole + 1).toInt();
             m_connection->sendParameterValue(path, newValue, type);
         }
     });
@@ -518,7 +566,7 @@ void MainWindow::setupUi()
     QWidget *treeContainer = new QWidget(this);
     QVBoxLayout *treeLayout = new QVBoxLayout(treeContainer);
     treeLayout->addWidget(connectionWidget);
-    treeLayout->addWidget(m_treeWidget);
+    treeLayout->addWidget(m_treeView);
     treeLayout->setContentsMargins(0, 0, 0, 0);
     
     
@@ -578,6 +626,22 @@ void MainWindow::setupMenu()
     emulatorAction->setShortcut(QKeySequence("Ctrl+Shift+E"));
     connect(emulatorAction, &QAction::triggered, this, &MainWindow::onOpenEmulator);
     
+    QAction *dashboardAction = toolsMenu->addAction("Stream &Dashboard");
+    dashboardAction->setShortcut(QKeySequence("Ctrl+Shift+D"));
+    connect(dashboardAction, &QAction::triggered, this, [this]() {
+        streamDashboard();
+        m_streamDashboardDock->show();
+        m_streamDashboardDock->raise();
+    });
+    
+    QAction *performanceAction = toolsMenu->addAction("&Performance Monitor");
+    performanceAction->setShortcut(QKeySequence("Ctrl+Shift+P"));
+    connect(performanceAction, &QAction::triggered, this, &MainWindow::showPerformancePanel);
+    
+    m_recordCaptureAction = toolsMenu->addAction("&Record S101 Session...");
+    m_recordCaptureAction->setCheckable(true);
+    connect(m_recordCaptureAction, &QAction::triggered, this, &MainWindow::onRecordCaptureTriggered);
+    
     toolsMenu->addSeparator();
     
     QAction *openLogsAction = toolsMenu->addAction("Open &Log Directory");
@@ -765,6 +829,11 @@ void MainWindow::onConnectionStateChanged(bool connected)
         }
         m_activeMeter = nullptr;
         
+        // Stream identifiers are only valid for the session they were announced in
+        if (m_streamDashboard) {
+            m_streamDashboard->clear();
+        }
+        
         
         m_propertyPanel = new QWidget();
         QVBoxLayout *propContentLayout = new QVBoxLayout(m_propertyPanel);
@@ -776,7 +845,6 @@ void MainWindow::onConnectionStateChanged(bool connected)
         propLayout->setContentsMargins(5, 5, 5, 5);
         
         
-        m_treeWidget->clear();
         m_treeViewController->clear();
         m_subscriptionManager->clear();
         m_matrixManager->clear();
@@ -789,55 +857,65 @@ void MainWindow::onNodeReceived(const QString &path, const QString &identifier,
     m_treeViewController->onNodeReceived(path, identifier, description, isOnline);
 }
 
-void MainWindow::onParameterReceived(const QString &path, int number, const QString &identifier, const QString &description, const QString &value, 
-                                    int access, int type, const QVariant &minimum, const QVariant &maximum,
-                                    const QStringList &enumOptions, const QList<int> &enumValues, bool isOnline, int streamIdentifier,
-                                    const QString &format, const QString &referenceLevel, const QString &formula, int factor)
+void MainWindow::onNodesReceived(const QVector<EmberData::NodeInfo> &nodes)
 {
+    m_treeViewController->onNodesReceived(nodes);
+}
+
+void MainWindow::onParametersReceived(const QVector<EmberData::ParameterInfo> &parameters)
+{
+    QVector<EmberData::ParameterInfo> treeParameters;
+    treeParameters.reserve(parameters.size());
     
-    if (path.contains("matrix", Qt::CaseInsensitive) || path.contains("label", Qt::CaseInsensitive)) {
-        qDebug().noquote() << QString("PARAM_TRACE: Path='%1', Identifier='%2', Value='%3'")
-            .arg(path).arg(identifier).arg(value);
-    }
-    
-    if (streamIdentifier > 0) {
-        m_streamIdToPath[streamIdentifier] = path;
-    }
-    
-    
-    
-    QStringList pathParts = path.split('.');
-    if (pathParts.size() >= 4 && pathParts[pathParts.size() - 3] == QString::number(MATRIX_LABEL_PATH_MARKER)) {
-        qDebug().noquote() << QString("LABEL_MATCH: Detected matrix label parameter - Path: %1").arg(path);
+    for (const EmberData::ParameterInfo &param : parameters) {
+        const QString &path = param.path;
         
-        QString labelType = pathParts[pathParts.size() - 2];  
-        int labelNumber = pathParts.last().toInt();
+        if (path.contains("matrix", Qt::CaseInsensitive) || path.contains("label", Qt::CaseInsensitive)) {
+            qDebug().noquote() << QString("PARAM_TRACE: Path='%1', Identifier='%2', Value='%3'")
+                .arg(path).arg(param.identifier).arg(param.value);
+        }
         
+        if (param.streamIdentifier > 0) {
+            m_streamIdToPath[param.streamIdentifier] = path;
+        }
         
-        QStringList matrixPathParts = pathParts.mid(0, pathParts.size() - 3);
-        QString matrixPath = matrixPathParts.join('.');
         
-        qDebug().noquote() << QString("LABEL_MATCH: Matrix path: %1, Type: %2, Number: %3, Value: %4")
-            .arg(matrixPath).arg(labelType).arg(labelNumber).arg(value);
         
-        if (labelType == "1") {
+        QStringList pathParts = path.split('.');
+        if (pathParts.size() >= 4 && pathParts[pathParts.size() - 3] == QString::number(MATRIX_LABEL_PATH_MARKER)) {
+            qDebug().noquote() << QString("LABEL_MATCH: Detected matrix label parameter - Path: %1").arg(path);
+            
+            QString labelType = pathParts[pathParts.size() - 2];  
+            int labelNumber = pathParts.last().toInt();
+            
             
-            m_matrixManager->onMatrixTargetReceived(matrixPath, labelNumber, value);
-        } else if (labelType == "2") {
+            QStringList matrixPathParts = pathParts.mid(0, pathParts.size() - 3);
+            QString matrixPath = matrixPathParts.join('.');
+            EmberPath matrixOid = EmberPath::find(matrixPath);
             
-            m_matrixManager->onMatrixSourceReceived(matrixPath, labelNumber, value);
+            qDebug().noquote() << QString("LABEL_MATCH: Matrix path: %1, Type: %2, Number: %3, Value: %4")
+                .arg(matrixPath).arg(labelType).arg(labelNumber).arg(param.value);
+            
+            if (labelType == "1") {
+                
+                m_matrixManager->onMatrixTargetReceived(matrixOid, labelNumber, param.value);
+            } else if (labelType == "2") {
+                
+                m_matrixManager->onMatrixSourceReceived(matrixOid, labelNumber, param.value);
+            }
+            
+            continue; 
+        } else if (path.contains("label", Qt::CaseInsensitive)) {
+            
+            qDebug().noquote() << QString("LABEL_NO_MATCH: Path contains 'label' but doesn't match pattern. Path='%1', Parts=%2, Marker='%3'")
+                .arg(path).arg(pathParts.size()).arg(MATRIX_LABEL_PATH_MARKER);
         }
         
-        return; 
-    } else if (path.contains("label", Qt::CaseInsensitive)) {
-        
-        qDebug().noquote() << QString("LABEL_NO_MATCH: Path contains 'label' but doesn't match pattern. Path='%1', Parts=%2, Marker='%3'")
-            .arg(path).arg(pathParts.size()).arg(MATRIX_LABEL_PATH_MARKER);
+        treeParameters.append(param);
     }
     
     
-    m_treeViewController->onParameterReceived(path, number, identifier, description, value, access, type, 
-                                             minimum, maximum, enumOptions, enumValues, isOnline, streamIdentifier, format, referenceLevel, formula, factor);
+    m_treeViewController->onParametersReceived(treeParameters);
 }
 
 void MainWindow::onMatrixReceived(const QString &path, int number, const QString &identifier, 
@@ -850,27 +928,27 @@ void MainWindow::onMatrixReceived(const QString &path, int number, const QString
     m_matrixManager->onMatrixReceived(path, number, identifier, description, type, targetCount, sourceCount);
 }
 
-void MainWindow::onMatrixTargetReceived(const QString &matrixPath, int targetNumber, const QString &label)
+void MainWindow::onMatrixTargetReceived(EmberPath matrixPath, int targetNumber, const QString &label, bool isLabel)
 {
-    m_matrixManager->onMatrixTargetReceived(matrixPath, targetNumber, label);
+    m_matrixManager->onMatrixTargetReceived(matrixPath, targetNumber, label, isLabel);
 }
 
-void MainWindow::onMatrixSourceReceived(const QString &matrixPath, int sourceNumber, const QString &label)
+void MainWindow::onMatrixSourceReceived(EmberPath matrixPath, int sourceNumber, const QString &label, bool isLabel)
 {
-    m_matrixManager->onMatrixSourceReceived(matrixPath, sourceNumber, label);
+    m_matrixManager->onMatrixSourceReceived(matrixPath, sourceNumber, label, isLabel);
 }
 
-void MainWindow::onMatrixConnectionReceived(const QString &matrixPath, int targetNumber, int sourceNumber, bool connected, int disposition)
+void MainWindow::onMatrixConnectionReceived(EmberPath matrixPath, int targetNumber, int sourceNumber, bool connected, int disposition)
 {
     m_matrixManager->onMatrixConnectionReceived(matrixPath, targetNumber, sourceNumber, connected, disposition);
 }
 
-void MainWindow::onMatrixConnectionsCleared(const QString &matrixPath)
+void MainWindow::onMatrixConnectionsCleared(EmberPath matrixPath)
 {
     m_matrixManager->onMatrixConnectionsCleared(matrixPath);
 }
 
-void MainWindow::onMatrixTargetConnectionsCleared(const QString &matrixPath, int targetNumber)
+void MainWindow::onMatrixTargetConnectionsCleared(EmberPath matrixPath, int targetNumber)
 {
     m_matrixManager->onMatrixTargetConnectionsCleared(matrixPath, targetNumber);
 }
@@ -886,6 +964,11 @@ void MainWindow::onMatrixWidgetCreated(const QString &path, QWidget *widget)
         connect(matrixWidget, 
                 static_cast<void(VirtualizedMatrixWidget::*)(const QString&, int, int)>(&VirtualizedMatrixWidget::crosspointClicked),
                 this, &MainWindow::onCrosspointClicked);
+        connect(matrixWidget, &VirtualizedMatrixWidget::crosspointsClicked,
+                this, &MainWindow::onCrosspointsClicked);
+        // Queued so label requests are not sent from inside a paint event
+        connect(matrixWidget, &VirtualizedMatrixWidget::visibleRangeChanged,
+                m_connection, &EmberConnection::setMatrixLabelViewport, Qt::QueuedConnection);
         
         
         connect(matrixWidget, &VirtualizedMatrixWidget::enableCrosspointsRequested,
@@ -902,11 +985,11 @@ void MainWindow::onMatrixDimensionsUpdated(const QString &path, QWidget *widget)
     qInfo().noquote() << QString("onMatrixDimensionsUpdated called for path: %1").arg(path);
     
     
-    QList<QTreeWidgetItem*> selected = m_treeWidget->selectedItems();
+    QModelIndexList selected = m_treeView->selectionModel()->selectedRows();
     if (!selected.isEmpty()) {
-        QTreeWidgetItem *item = selected.first();
-        QString selectedPath = item->data(0, Qt::UserRole).toString();
-        QString selectedType = item->text(1);
+        QModelIndex index = selected.first();
+        QString selectedPath = index.data(Qt::UserRole).toString();
+        QString selectedType = columnText(index, EmberTreeModel::TypeColumn);
         
         qInfo().noquote() << QString("Currently selected: type=%1, path=%2").arg(selectedType).arg(selectedPath);
         
@@ -947,7 +1030,7 @@ void MainWindow::onMatrixDimensionsUpdated(const QString &path, QWidget *widget)
 
 void MainWindow::onTreeSelectionChanged()
 {
-    QList<QTreeWidgetItem*> selected = m_treeWidget->selectedItems();
+    QModelIndexList selected = m_treeView->selectionModel()->selectedRows();
     
     if (selected.isEmpty()) {
         m_pathLabel->setText("No selection");
@@ -958,9 +1041,9 @@ void MainWindow::onTreeSelectionChanged()
         return;
     }
     
-    QTreeWidgetItem *item = selected.first();
-    QString oidPath = item->data(0, Qt::UserRole).toString();
-    QString type = item->text(1);
+    QModelIndex index = selected.first();
+    QString oidPath = index.data(Qt::UserRole).toString();
+    QString type = columnText(index, EmberTreeModel::TypeColumn);
     
     
     
@@ -981,14 +1064,14 @@ void MainWindow::onTreeSelectionChanged()
     } else {
         
         QStringList breadcrumbs;
-        QTreeWidgetItem *current = item;
+        QModelIndex current = index;
         
-        while (current) {
-            QString name = current->text(0);
+        while (current.isValid()) {
+            QString name = current.data().toString();
             if (!name.isEmpty()) {
                 breadcrumbs.prepend(name);
             }
-            current = current->parent();
+            current = current.parent();
         }
         
         QString breadcrumbPath = breadcrumbs.join(" → ");
@@ -998,7 +1081,7 @@ void MainWindow::onTreeSelectionChanged()
     
     if (type == "Matrix") {
         
-        QString dimensionText = item->text(2);
+        QString dimensionText = columnText(index, EmberTreeModel::ValueColumn);
         qInfo().noquote() << QString("Matrix selected: %1, dimensions: %2").arg(oidPath).arg(dimensionText);
         
         
@@ -1035,8 +1118,8 @@ void MainWindow::onTreeSelectionChanged()
     
     if (type == "Parameter") {
         
-        int streamIdentifier = item->data(0, Qt::UserRole + 9).toInt();
-        int paramType = item->data(0, Qt::UserRole + 1).toInt();
+        int streamIdentifier = index.data(Qt::UserRole + 9).toInt();
+        int paramType = index.data(Qt::UserRole + 1).toInt();
         bool isAudioMeter = (streamIdentifier > 0) && (paramType == 1 || paramType == 2);
         
         qDebug().noquote() << QString("[MainWindow] Parameter selected - Path: %1, StreamID: %2, ParamType: %3, IsAudioMeter: %4")
@@ -1045,14 +1128,6 @@ void MainWindow::onTreeSelectionChanged()
         if (isAudioMeter) {
             
             
-            if (!m_activeMeterPath.isEmpty()) {
-                m_connection->unsubscribeFromParameter(m_activeMeterPath);
-                qDebug().noquote() << QString("Unsubscribed from previous meter: %1")
-                    .arg(m_activeMeterPath);
-                m_activeMeterPath.clear();
-            }
-            
-            
             if (m_activeMeter) {
                 m_activeMeter = nullptr;  
             }
@@ -1071,29 +1146,30 @@ void MainWindow::onTreeSelectionChanged()
             m_activeMeter = new MeterWidget();
             
             
-            QString identifier = item->text(0).replace("📊 ", "");  
-            QVariant minVar = item->data(0, Qt::UserRole + 3);
-            QVariant maxVar = item->data(0, Qt::UserRole + 4);
+            QString identifier = columnText(index, EmberTreeModel::NameColumn).replace("📊 ", "");  
+            QVariant minVar = index.data(Qt::UserRole + 3);
+            QVariant maxVar = index.data(Qt::UserRole + 4);
             
             double minValue = minVar.isValid() ? minVar.toDouble() : 0.0;
             double maxValue = maxVar.isValid() ? maxVar.toDouble() : 100.0;
             
             
             
-            QString format = item->data(0, Qt::UserRole + 10).toString();
-            QString referenceLevel = item->data(0, Qt::UserRole + 11).toString();
-            QString formula = item->data(0, Qt::UserRole + 12).toString();
-            int factor = item->data(0, Qt::UserRole + 13).toInt();
+            QString format = index.data(Qt::UserRole + 10).toString();
+            QString referenceLevel = index.data(Qt::UserRole + 11).toString();
+            QString formula = index.data(Qt::UserRole + 12).toString();
+            int factor = index.data(Qt::UserRole + 13).toInt();
             if (factor == 0) factor = 1;  
             qDebug() << "[MainWindow] Read from tree item - format:" << format << "referenceLevel:" << referenceLevel 
                      << "formula:" << formula << "factor:" << factor << "for path:" << oidPath;
             m_activeMeter->setParameterInfo(identifier, oidPath, minValue, maxValue, format, referenceLevel, factor);
             m_activeMeter->setStreamIdentifier(streamIdentifier);
+            m_activeMeter->setStreamOffset(index.data(Qt::UserRole + 14).toInt());
             
             
             
             if (!oidPath.isEmpty() && m_isConnected) {
-                m_connection->subscribeToParameter(oidPath, true);
+                m_subscriptionManager->acquire(oidPath, "Parameter");
                 m_activeMeterPath = oidPath;
                 qDebug().noquote() << QString("Subscribed to meter parameter: %1 (stream ID: %2)")
                     .arg(oidPath).arg(streamIdentifier);
@@ -1159,8 +1235,8 @@ void MainWindow::onTreeSelectionChanged()
         
         else if (paramType == 5) {
             
-            int access = item->data(0, Qt::UserRole + 2).toInt();
-            QString identifier = item->text(0);
+            int access = index.data(Qt::UserRole + 2).toInt();
+            QString identifier = columnText(index, EmberTreeModel::NameColumn);
             
             
             cleanupActiveParameterWidget();
@@ -1171,10 +1247,7 @@ void MainWindow::onTreeSelectionChanged()
             connect(triggerWidget, &TriggerWidget::triggerActivated,
                     this, [this](QString path, QString value) {
                         // Update tree view immediately (optimistic update)
-                        QTreeWidgetItem *item = m_treeViewController->findTreeItem(path);
-                        if (item) {
-                            item->setText(2, value);
-                        }
+                        m_treeModel->setParameterValue(path, value);
                         
                         // Send to provider (which will echo back to confirm)
                         m_connection->sendParameterValue(path, value, 1);  
@@ -1196,18 +1269,21 @@ void MainWindow::onTreeSelectionChanged()
             propLayout->setContentsMargins(5, 5, 5, 5);
             m_propertyPanel = triggerWidget;
             m_activeParameterWidget = triggerWidget;
-            m_activeParameterPath = oidPath;
+            if (!oidPath.isEmpty() && m_isConnected) {
+                m_subscriptionManager->acquire(oidPath, "Parameter");
+                m_activeParameterPath = oidPath;
+            }
         }
         
         else if (paramType == 1 || paramType == 2) {
-            QVariant minVar = item->data(0, Qt::UserRole + 3);
-            QVariant maxVar = item->data(0, Qt::UserRole + 4);
-            QString formula = item->data(0, Qt::UserRole + 12).toString();
-            int access = item->data(0, Qt::UserRole + 2).toInt();
-            QString identifier = item->text(0);
-            QString format = item->data(0, Qt::UserRole + 10).toString();
-            QString referenceLevel = item->data(0, Qt::UserRole + 11).toString();
-            int factor = item->data(0, Qt::UserRole + 13).toInt();
+            QVariant minVar = index.data(Qt::UserRole + 3);
+            QVariant maxVar = index.data(Qt::UserRole + 4);
+            QString formula = index.data(Qt::UserRole + 12).toString();
+            int access = index.data(Qt::UserRole + 2).toInt();
+            QString identifier = columnText(index, EmberTreeModel::NameColumn);
+            QString format = index.data(Qt::UserRole + 10).toString();
+            QString referenceLevel = index.data(Qt::UserRole + 11).toString();
+            int factor = index.data(Qt::UserRole + 13).toInt();
             
             bool hasRange = minVar.isValid() && maxVar.isValid();
             double minValue = minVar.toDouble();
@@ -1225,7 +1301,7 @@ void MainWindow::onTreeSelectionChanged()
                 sliderWidget->setParameterInfo(identifier, oidPath, minValue, maxValue, paramType, access, formula, format, referenceLevel, factor);
                 
                 
-                QString currentValue = item->text(2);
+                QString currentValue = columnText(index, EmberTreeModel::ValueColumn);
                 bool ok;
                 double val = currentValue.toDouble(&ok);
                 if (ok) {
@@ -1236,10 +1312,7 @@ void MainWindow::onTreeSelectionChanged()
                 connect(sliderWidget, &SliderWidget::valueChanged,
                         this, [this](QString path, QString newValue, int type) {
                             // Update tree view immediately (optimistic update)
-                            QTreeWidgetItem *item = m_treeViewController->findTreeItem(path);
-                            if (item) {
-                                item->setText(2, newValue);
-                            }
+                            m_treeModel->setParameterValue(path, newValue);
                             
                             // Send to provider (which will echo back to confirm)
                             m_connection->sendParameterValue(path, newValue, type);
@@ -1253,16 +1326,19 @@ void MainWindow::onTreeSelectionChanged()
                 propLayout->setContentsMargins(5, 5, 5, 5);
                 m_propertyPanel = sliderWidget;
                 m_activeParameterWidget = sliderWidget;
-                m_activeParameterPath = oidPath;
+                if (!oidPath.isEmpty() && m_isConnected) {
+                    m_subscriptionManager->acquire(oidPath, "Parameter");
+                    m_activeParameterPath = oidPath;
+                }
             }
         }
         
         else if (streamIdentifier > 0 && !isAudioMeter) {
             
-            QVariant minVar = item->data(0, Qt::UserRole + 3);
-            QVariant maxVar = item->data(0, Qt::UserRole + 4);
-            QString identifier = item->text(0);
-            QString format = item->data(0, Qt::UserRole + 10).toString();
+            QVariant minVar = index.data(Qt::UserRole + 3);
+            QVariant maxVar = index.data(Qt::UserRole + 4);
+            QString identifier = columnText(index, EmberTreeModel::NameColumn);
+            QString format = index.data(Qt::UserRole + 10).toString();
             
             double minValue = minVar.isValid() ? minVar.toDouble() : 0.0;
             double maxValue = maxVar.isValid() ? maxVar.toDouble() : 100.0;
@@ -1273,17 +1349,18 @@ void MainWindow::onTreeSelectionChanged()
             GraphWidget *graphWidget = new GraphWidget();
             graphWidget->setParameterInfo(identifier, oidPath, minValue, maxValue, format);
             graphWidget->setStreamIdentifier(streamIdentifier);
+            graphWidget->setStreamOffset(index.data(Qt::UserRole + 14).toInt());
             
             
             if (!oidPath.isEmpty() && m_isConnected) {
-                m_connection->subscribeToParameter(oidPath, true);
+                m_subscriptionManager->acquire(oidPath, "Parameter");
                 m_activeParameterPath = oidPath;
                 qDebug().noquote() << QString("Subscribed to graph parameter: %1 (stream ID: %2)")
                     .arg(oidPath).arg(streamIdentifier);
             }
             
             
-            QString currentValue = item->text(2);
+            QString currentValue = columnText(index, EmberTreeModel::ValueColumn);
             bool ok;
             double val = currentValue.toDouble(&ok);
             if (ok) {
@@ -1308,7 +1385,7 @@ void MainWindow::onTreeSelectionChanged()
             QVBoxLayout *propContentLayout = new QVBoxLayout(m_propertyPanel);
             propContentLayout->addWidget(new QLabel("Parameter properties"));
             propContentLayout->addWidget(new QLabel(QString("Path: %1").arg(oidPath)));
-            propContentLayout->addWidget(new QLabel(QString("Value: %1").arg(item->text(2))));
+            propContentLayout->addWidget(new QLabel(QString("Value: %1").arg(columnText(index, EmberTreeModel::ValueColumn))));
             propContentLayout->addStretch();
             
             QVBoxLayout *propLayout = new QVBoxLayout(m_propertyGroup);
@@ -1320,18 +1397,13 @@ void MainWindow::onTreeSelectionChanged()
     }
     else if (type == "Matrix") {
         
-        
-        if (!m_activeMeterPath.isEmpty()) {
-            m_connection->unsubscribeFromParameter(m_activeMeterPath);
-            qDebug().noquote() << QString("Unsubscribed from meter (switching to Matrix): %1")
-                .arg(m_activeMeterPath);
-            m_activeMeterPath.clear();
-        }
-        
         qInfo().noquote() << QString("Matrix selected: %1").arg(oidPath);
         
         
-        m_connection->subscribeToMatrix(oidPath, false);
+        if (!oidPath.isEmpty() && m_isConnected) {
+            m_subscriptionManager->acquire(oidPath, "Matrix");
+            m_activeMatrixPath = oidPath;
+        }
         
         VirtualizedMatrixWidget *matrixWidget = qobject_cast<VirtualizedMatrixWidget*>(m_matrixManager->getMatrix(oidPath));
         qInfo().noquote() << QString("Matrix widget pointer: %1").arg(matrixWidget ? "EXISTS" : "NULL");
@@ -1394,8 +1466,8 @@ void MainWindow::onTreeSelectionChanged()
         m_propertyPanel = new QWidget();
         QVBoxLayout *propContentLayout = new QVBoxLayout(m_propertyPanel);
         
-        QString identifier = item->text(0);
-        QString value = item->text(2);
+        QString identifier = columnText(index, EmberTreeModel::NameColumn);
+        QString value = columnText(index, EmberTreeModel::ValueColumn);
         
         propContentLayout->addWidget(new QLabel(QString("<b>Type:</b> %1").arg(type)));
         if (!identifier.isEmpty()) {
@@ -1421,11 +1493,17 @@ void MainWindow::cleanupActiveParameterWidget()
 {
     
     if (!m_activeParameterPath.isEmpty()) {
-        m_connection->unsubscribeFromParameter(m_activeParameterPath);
-        qDebug().noquote() << QString("Unsubscribed from parameter: %1")
-            .arg(m_activeParameterPath);
+        m_subscriptionManager->release(m_activeParameterPath);
         m_activeParameterPath.clear();
     }
+    if (!m_activeMeterPath.isEmpty()) {
+        m_subscriptionManager->release(m_activeMeterPath);
+        m_activeMeterPath.clear();
+    }
+    if (!m_activeMatrixPath.isEmpty()) {
+        m_subscriptionManager->release(m_activeMatrixPath);
+        m_activeMatrixPath.clear();
+    }
     
     
     m_activeParameterWidget = nullptr;
@@ -1601,6 +1679,64 @@ void MainWindow::onCrosspointClicked(const QString &matrixPath, int targetNumber
     
 }
 
+void MainWindow::onCrosspointsClicked(const QString &matrixPath, const QList<QPair<int, int>> &crosspoints)
+{
+    if (!m_activityTracker || !m_activityTracker->isEnabled()) {
+        qDebug().noquote() << "Crosspoint selection ignored - crosspoints not enabled";
+        return;
+    }
+    
+    
+    m_activityTracker->resetTimer();
+    
+    VirtualizedMatrixWidget *matrixWidget = qobject_cast<VirtualizedMatrixWidget*>(m_matrixManager->getMatrix(matrixPath));
+    if (!matrixWidget) {
+        qWarning().noquote() << "Matrix widget not found for path: " + matrixPath;
+        return;
+    }
+    
+    
+    // Connect the whole selection unless every crosspoint in it is already connected
+    bool connect = false;
+    for (const auto &crosspoint : crosspoints) {
+        if (!matrixWidget->isConnected(crosspoint.first, crosspoint.second)) {
+            connect = true;
+            break;
+        }
+    }
+    
+    
+    // 1:N and 1:1 targets take a single source, so each target is set to the first selected source
+    bool singleSource = matrixWidget->getMatrixType() != 2;
+    QSet<int> assignedTargets;
+    
+    matrixWidget->beginBatchUpdate();
+    for (const auto &crosspoint : crosspoints) {
+        int targetNumber = crosspoint.first;
+        int sourceNumber = crosspoint.second;
+        
+        if (connect && singleSource) {
+            if (assignedTargets.contains(targetNumber)) {
+                continue;
+            }
+            assignedTargets.insert(targetNumber);
+            m_connection->setSalvoTargetSources(matrixPath, targetNumber, {sourceNumber});
+        } else {
+            m_connection->addSalvoConnection(matrixPath, targetNumber, sourceNumber, connect);
+        }
+        matrixWidget->setConnection(targetNumber, sourceNumber, connect, 2);
+    }
+    matrixWidget->endBatchUpdate();
+    
+    
+    qInfo().noquote() << QString("Crosspoint salvo %1: %2 crosspoints on %3")
+                         .arg(connect ? "CONNECT" : "DISCONNECT")
+                         .arg(m_connection->pendingSalvoSize())
+                         .arg(matrixPath);
+    
+    m_connection->commitMatrixSalvo();
+}
+
 void MainWindow::onFunctionReceived(const QString &path, const QString &identifier, const QString &description,
                                    const QStringList &argNames, const QList<int> &argTypes,
                                    const QStringList &resultNames, const QList<int> &resultTypes)
@@ -1614,24 +1750,107 @@ void MainWindow::onFunctionReceived(const QString &path, const QString &identifi
 
 
 
-void MainWindow::onStreamValueReceived(int streamIdentifier, double value)
+void MainWindow::onStreamValuesReceived(const QVector<EmberData::StreamValue> &values)
 {
+    if (m_streamDashboard) {
+        m_streamDashboard->updateStreamValues(values);
+    }
     
-    if (m_activeMeter && m_activeMeter->streamIdentifier() == streamIdentifier) {
-        m_activeMeter->updateValue(value);
-        
-        
-        
+    GraphWidget *graphWidget = m_activeMeter ? nullptr : qobject_cast<GraphWidget*>(m_activeParameterWidget);
+    if (!m_activeMeter && !graphWidget) {
+        return;
     }
     
-    else if (m_activeParameterWidget) {
-        GraphWidget *graphWidget = qobject_cast<GraphWidget*>(m_activeParameterWidget);
-        if (graphWidget && graphWidget->streamIdentifier() == streamIdentifier) {
-            graphWidget->addDataPoint(value);
+    for (const EmberData::StreamValue &streamValue : values) {
+        if (m_activeMeter) {
+            if (m_activeMeter->streamIdentifier() == streamValue.streamIdentifier
+                && m_activeMeter->streamOffset() == streamValue.offset) {
+                m_activeMeter->updateValue(streamValue.value);
+            }
+        }
+        else if (graphWidget->streamIdentifier() == streamValue.streamIdentifier
+                 && graphWidget->streamOffset() == streamValue.offset) {
+            graphWidget->addDataPoint(streamValue.value);
         }
     }
 }
 
+StreamDashboard* MainWindow::streamDashboard()
+{
+    if (!m_streamDashboard) {
+        m_streamDashboard = new StreamDashboard();
+        connect(m_streamDashboard, &StreamDashboard::meterRemoveRequested,
+                this, &MainWindow::removeFromStreamDashboard);
+        
+        QScrollArea *scrollArea = new QScrollArea();
+        scrollArea->setWidgetResizable(true);
+        scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+        scrollArea->setWidget(m_streamDashboard);
+        
+        m_streamDashboardDock = new QDockWidget("Stream Dashboard", this);
+        m_streamDashboardDock->setObjectName("StreamDashboardDock");
+        m_streamDashboardDock->setWidget(scrollArea);
+        addDockWidget(Qt::BottomDockWidgetArea, m_streamDashboardDock);
+    }
+    return m_streamDashboard;
+}
+
+void MainWindow::showPerformancePanel()
+{
+    // Counters are collected from startup, the panel only samples them once it exists
+    if (!m_performancePanel) {
+        m_performancePanel = new PerformancePanel();
+        
+        m_performanceDock = new QDockWidget("Performance", this);
+        m_performanceDock->setObjectName("PerformanceDock");
+        m_performanceDock->setWidget(m_performancePanel);
+        addDockWidget(Qt::RightDockWidgetArea, m_performanceDock);
+    }
+    m_performanceDock->show();
+    m_performanceDock->raise();
+}
+
+bool MainWindow::isOnStreamDashboard(const QString &path) const
+{
+    return m_streamDashboard && m_streamDashboard->hasMeter(path);
+}
+
+void MainWindow::addToStreamDashboard(const QModelIndex &index)
+{
+    QString path = index.data(Qt::UserRole).toString();
+    if (isOnStreamDashboard(path)) {
+        return;
+    }
+    int streamIdentifier = index.data(Qt::UserRole + 9).toInt();
+    int streamOffset = index.data(Qt::UserRole + 14).toInt();
+    QVariant minVar = index.data(Qt::UserRole + 3);
+    QVariant maxVar = index.data(Qt::UserRole + 4);
+    QString identifier = columnText(index, EmberTreeModel::NameColumn).replace("📊 ", "");
+    
+    streamDashboard()->addMeter(path, identifier, streamIdentifier, streamOffset,
+                                minVar.isValid() ? minVar.toDouble() : 0.0,
+                                maxVar.isValid() ? maxVar.toDouble() : 100.0);
+    m_streamDashboardDock->show();
+    
+    if (m_isConnected) {
+        m_subscriptionManager->acquire(path, "Parameter");
+    }
+    
+    qInfo().noquote() << QString("Added %1 (stream ID: %2) to the stream dashboard, %3 meters")
+                         .arg(path).arg(streamIdentifier).arg(m_streamDashboard->meterCount());
+}
+
+void MainWindow::removeFromStreamDashboard(const QString &path)
+{
+    if (!m_streamDashboard || !m_streamDashboard->removeMeter(path)) {
+        return;
+    }
+    
+    if (m_isConnected) {
+        m_subscriptionManager->release(path);
+    }
+}
+
 void MainWindow::onSaveEmberDevice()
 {
     if (!m_isConnected) {
@@ -1752,9 +1971,8 @@ void MainWindow::onSaveCurrentConnection()
 
     
     QString deviceName;
-    if (m_treeWidget->topLevelItemCount() > 0) {
-        QTreeWidgetItem* firstRoot = m_treeWidget->topLevelItem(0);
-        deviceName = firstRoot->text(0);
+    if (m_treeModel->rowCount() > 0) {
+        deviceName = m_treeModel->index(0, EmberTreeModel::NameColumn).data().toString();
     }
 
     
@@ -1822,6 +2040,30 @@ void MainWindow::onImportConnections()
     }
 }
 
+void MainWindow::onRecordCaptureTriggered(bool record)
+{
+    if (!record) {
+        m_connection->stopCapture();
+        return;
+    }
+
+    // Stays unchecked until the I/O thread reports the capture file is open
+    m_recordCaptureAction->setChecked(false);
+
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        "Record S101 Session",
+        QString("session_%1.evcap").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")),
+        "S101 Captures (*.evcap);;All Files (*)"
+    );
+
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    m_connection->startCapture(fileName);
+}
+
 void MainWindow::onExportConnections()
 {
     QString fileName = QFileDialog::getSaveFileName(
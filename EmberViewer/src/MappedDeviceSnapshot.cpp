@@ -0,0 +1,658 @@
+#include "MappedDeviceSnapshot.h"
+#include <QSaveFile>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+enum HeaderWord {
+    Magic,
+    Version,
+    StringCount,
+    StringIndexOffset,
+    IntCount,
+    IntOffset,
+    NodeCount,
+    NodeOffset,
+    ParameterCount,
+    ParameterOffset,
+    MatrixCount,
+    MatrixOffset,
+    FunctionCount,
+    FunctionOffset,
+    BitsetOffset,
+    BitsetSize,
+    DeviceName,
+    HostAddress,
+    Port,
+    CaptureTimeLow,
+    CaptureTimeHigh,
+    RootPathsFirst,
+    RootPathsCount,
+    HEADER_WORDS = 24
+};
+
+enum Section {
+    NodeSection,
+    ParameterSection,
+    MatrixSection,
+    FunctionSection
+};
+
+// Words per record and the header words holding count and offset of each section
+const int RECORD_WORDS[] = { 6, 16, 17, 11 };
+const int SECTION_COUNT_WORD[] = { NodeCount, ParameterCount, MatrixCount, FunctionCount };
+
+enum ParameterFlag {
+    ParameterOnline = 0x01,
+    HasMinimum = 0x02,
+    HasMaximum = 0x04,
+    MinimumIsInteger = 0x08,
+    MaximumIsInteger = 0x10
+};
+
+bool isIntegerVariant(const QVariant &value)
+{
+    switch (value.typeId()) {
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Bool:
+            return true;
+        default:
+            return false;
+    }
+}
+
+quint64 encodeLimit(const QVariant &value, bool integer)
+{
+    if (integer) {
+        return static_cast<quint64>(value.toLongLong());
+    }
+    double number = value.toDouble();
+    quint64 bits;
+    std::memcpy(&bits, &number, sizeof(bits));
+    return bits;
+}
+
+QVariant decodeLimit(quint64 bits, bool integer)
+{
+    if (integer) {
+        qint64 number = static_cast<qint64>(bits);
+        if (number >= std::numeric_limits<int>::min() && number <= std::numeric_limits<int>::max()) {
+            return static_cast<int>(number);
+        }
+        return number;
+    }
+    double number;
+    std::memcpy(&number, &bits, sizeof(number));
+    return number;
+}
+
+
+// Accumulates the sections of a snapshot file before they are laid out
+class SnapshotWriter
+{
+public:
+    SnapshotWriter()
+    {
+        m_strings.append(QByteArray());
+        m_stringIds.insert(QString(), 0);
+    }
+
+    quint32 string(const QString &value)
+    {
+        auto it = m_stringIds.constFind(value);
+        if (it != m_stringIds.constEnd()) {
+            return it.value();
+        }
+        quint32 id = static_cast<quint32>(m_strings.size());
+        m_strings.append(value.toUtf8());
+        m_stringIds.insert(value, id);
+        return id;
+    }
+
+    // Appends a list to the int pool and adds its first index and count to the record
+    template <typename Container, typename Convert>
+    void list(QVector<quint32> &record, const Container &values, Convert convert)
+    {
+        record.append(static_cast<quint32>(m_ints.size()));
+        record.append(static_cast<quint32>(values.size()));
+        for (const auto &value : values) {
+            m_ints.append(convert(value));
+        }
+    }
+
+    void intList(QVector<quint32> &record, const QList<int> &values)
+    {
+        list(record, values, [](int value) { return static_cast<quint32>(value); });
+    }
+
+    void stringList(QVector<quint32> &record, const QStringList &values)
+    {
+        list(record, values, [this](const QString &value) { return string(value); });
+    }
+
+    void labels(QVector<quint32> &record, const QMap<int, QString> &labels)
+    {
+        record.append(static_cast<quint32>(m_ints.size()));
+        record.append(static_cast<quint32>(labels.size()));
+        for (auto it = labels.constBegin(); it != labels.constEnd(); ++it) {
+            m_ints.append(static_cast<quint32>(it.key()));
+            m_ints.append(string(it.value()));
+        }
+    }
+
+    void connections(QVector<quint32> &record, const MatrixData &matrix)
+    {
+        int rows = matrix.targetCount;
+        int columns = matrix.sourceCount;
+        for (auto it = matrix.connections.constBegin(); it != matrix.connections.constEnd(); ++it) {
+            if (it.value() && it.key().first >= 0 && it.key().second >= 0) {
+                rows = std::max(rows, it.key().first + 1);
+                columns = std::max(columns, it.key().second + 1);
+            }
+        }
+        if (matrix.connections.isEmpty()) {
+            rows = 0;
+            columns = 0;
+        }
+
+        int stride = (columns + 7) / 8;
+        quint32 offset = static_cast<quint32>(m_bitsets.size());
+        m_bitsets.append(QByteArray(rows * stride, '\0'));
+
+        uchar *bits = reinterpret_cast<uchar*>(m_bitsets.data()) + offset;
+        for (auto it = matrix.connections.constBegin(); it != matrix.connections.constEnd(); ++it) {
+            int target = it.key().first;
+            int source = it.key().second;
+            if (it.value() && target >= 0 && source >= 0) {
+                bits[target * stride + source / 8] |= static_cast<uchar>(1 << (source % 8));
+            }
+        }
+
+        record.append(static_cast<quint32>(rows));
+        record.append(static_cast<quint32>(columns));
+        record.append(offset);
+    }
+
+    QByteArray assemble(const QVector<quint32> (&sections)[4], const QVector<int> &counts,
+                        const DeviceSnapshot &snapshot, quint32 rootPathsFirst)
+    {
+        QVector<quint32> header(HEADER_WORDS, 0);
+        header[Magic] = MappedDeviceSnapshot::FILE_MAGIC;
+        header[Version] = MappedDeviceSnapshot::FILE_VERSION;
+        header[DeviceName] = string(snapshot.deviceName);
+        header[HostAddress] = string(snapshot.hostAddress);
+        header[Port] = static_cast<quint32>(snapshot.port);
+        quint64 captureTime = static_cast<quint64>(snapshot.captureTime.toMSecsSinceEpoch());
+        header[CaptureTimeLow] = static_cast<quint32>(captureTime);
+        header[CaptureTimeHigh] = static_cast<quint32>(captureTime >> 32);
+        header[RootPathsFirst] = rootPathsFirst;
+        header[RootPathsCount] = static_cast<quint32>(snapshot.rootPaths.size());
+
+        // String data follows its index; all later sections are word aligned
+        qint64 offset = HEADER_WORDS * 4;
+        header[StringCount] = static_cast<quint32>(m_strings.size());
+        header[StringIndexOffset] = static_cast<quint32>(offset);
+        qint64 stringData = offset + m_strings.size() * 8;
+        QVector<quint32> stringIndex;
+        stringIndex.reserve(m_strings.size() * 2);
+        qint64 dataSize = 0;
+        for (const QByteArray &utf8 : m_strings) {
+            stringIndex.append(static_cast<quint32>(stringData + dataSize));
+            stringIndex.append(static_cast<quint32>(utf8.size()));
+            dataSize += utf8.size();
+        }
+        offset = (stringData + dataSize + 3) & ~qint64(3);
+
+        header[IntCount] = static_cast<quint32>(m_ints.size());
+        header[IntOffset] = static_cast<quint32>(offset);
+        offset += m_ints.size() * 4;
+
+        for (int section = NodeSection; section <= FunctionSection; ++section) {
+            header[SECTION_COUNT_WORD[section]] = static_cast<quint32>(counts[section]);
+            header[SECTION_COUNT_WORD[section] + 1] = static_cast<quint32>(offset);
+            offset += sections[section].size() * 4;
+        }
+
+        header[BitsetOffset] = static_cast<quint32>(offset);
+        header[BitsetSize] = static_cast<quint32>(m_bitsets.size());
+
+        QByteArray file;
+        file.reserve(offset + m_bitsets.size());
+        appendWords(file, header);
+        appendWords(file, stringIndex);
+        for (const QByteArray &utf8 : m_strings) {
+            file.append(utf8);
+        }
+        file.append(QByteArray((4 - file.size() % 4) % 4, '\0'));
+        appendWords(file, m_ints);
+        for (const QVector<quint32> &records : sections) {
+            appendWords(file, records);
+        }
+        file.append(m_bitsets);
+        return file;
+    }
+
+private:
+    static void appendWords(QByteArray &out, const QVector<quint32> &words)
+    {
+        qsizetype start = out.size();
+        out.resize(start + words.size() * 4);
+        uchar *data = reinterpret_cast<uchar*>(out.data()) + start;
+        for (quint32 word : words) {
+            qToLittleEndian(word, data);
+            data += 4;
+        }
+    }
+
+    QVector<QByteArray> m_strings;
+    QHash<QString, quint32> m_stringIds;
+    QVector<quint32> m_ints;
+    QByteArray m_bitsets;
+};
+
+}
+
+
+MappedDeviceSnapshot::MappedDeviceSnapshot()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_nodeCount(0)
+    , m_parameterCount(0)
+    , m_matrixCount(0)
+    , m_functionCount(0)
+{
+}
+
+MappedDeviceSnapshot::~MappedDeviceSnapshot()
+{
+    close();
+}
+
+bool MappedDeviceSnapshot::open(const QString &filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_data = m_size >= HEADER_WORDS * 4 ? m_file.map(0, m_size) : nullptr;
+    if (!m_data) {
+        m_error = QString("Cannot map %1").arg(filePath);
+        close();
+        return false;
+    }
+
+    if (headerWord(Magic) != FILE_MAGIC || headerWord(Version) != FILE_VERSION) {
+        m_error = QString("%1 is not a version %2 device snapshot").arg(filePath).arg(FILE_VERSION);
+        close();
+        return false;
+    }
+
+    // Every section has to lie within the file, records are read without further checks
+    auto fits = [this](quint32 offset, qint64 bytes) {
+        return offset + bytes <= m_size;
+    };
+    bool valid = fits(headerWord(StringIndexOffset), qint64(headerWord(StringCount)) * 8)
+        && fits(headerWord(IntOffset), qint64(headerWord(IntCount)) * 4)
+        && fits(headerWord(BitsetOffset), headerWord(BitsetSize));
+    for (int section = NodeSection; section <= FunctionSection; ++section) {
+        int countWord = SECTION_COUNT_WORD[section];
+        valid = valid && fits(headerWord(countWord + 1), qint64(headerWord(countWord)) * RECORD_WORDS[section] * 4);
+    }
+    if (!valid) {
+        m_error = QString("%1 is truncated").arg(filePath);
+        close();
+        return false;
+    }
+
+    m_nodeCount = static_cast<int>(headerWord(NodeCount));
+    m_parameterCount = static_cast<int>(headerWord(ParameterCount));
+    m_matrixCount = static_cast<int>(headerWord(MatrixCount));
+    m_functionCount = static_cast<int>(headerWord(FunctionCount));
+    return true;
+}
+
+void MappedDeviceSnapshot::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_nodeCount = 0;
+    m_parameterCount = 0;
+    m_matrixCount = 0;
+    m_functionCount = 0;
+    m_matrixIndex.clear();
+}
+
+quint32 MappedDeviceSnapshot::word(qint64 offset) const
+{
+    if (offset < 0 || offset + 4 > m_size) {
+        return 0;
+    }
+    return qFromLittleEndian<quint32>(m_data + offset);
+}
+
+QString MappedDeviceSnapshot::string(quint32 id) const
+{
+    if (id == 0 || id >= headerWord(StringCount)) {
+        return QString();
+    }
+    qint64 entry = headerWord(StringIndexOffset) + qint64(id) * 8;
+    quint32 offset = word(entry);
+    quint32 length = word(entry + 4);
+    if (qint64(offset) + length > m_size) {
+        return QString();
+    }
+    return QString::fromUtf8(reinterpret_cast<const char*>(m_data + offset), length);
+}
+
+QList<int> MappedDeviceSnapshot::ints(quint32 first, quint32 count) const
+{
+    QList<int> values;
+    if (qint64(first) + count > headerWord(IntCount)) {
+        return values;
+    }
+    values.reserve(count);
+    qint64 offset = headerWord(IntOffset) + qint64(first) * 4;
+    for (quint32 i = 0; i < count; ++i) {
+        values.append(static_cast<int>(word(offset + i * 4)));
+    }
+    return values;
+}
+
+QStringList MappedDeviceSnapshot::strings(quint32 first, quint32 count) const
+{
+    QStringList values;
+    for (int id : ints(first, count)) {
+        values.append(string(static_cast<quint32>(id)));
+    }
+    return values;
+}
+
+qint64 MappedDeviceSnapshot::recordOffset(int section, int index) const
+{
+    return headerWord(SECTION_COUNT_WORD[section] + 1) + qint64(index) * RECORD_WORDS[section] * 4;
+}
+
+QString MappedDeviceSnapshot::deviceName() const
+{
+    return string(headerWord(DeviceName));
+}
+
+QString MappedDeviceSnapshot::hostAddress() const
+{
+    return string(headerWord(HostAddress));
+}
+
+int MappedDeviceSnapshot::port() const
+{
+    return static_cast<int>(headerWord(Port));
+}
+
+QDateTime MappedDeviceSnapshot::captureTime() const
+{
+    quint64 msecs = (quint64(headerWord(CaptureTimeHigh)) << 32) | headerWord(CaptureTimeLow);
+    return QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(msecs));
+}
+
+QStringList MappedDeviceSnapshot::rootPaths() const
+{
+    return strings(headerWord(RootPathsFirst), headerWord(RootPathsCount));
+}
+
+NodeData MappedDeviceSnapshot::node(int index) const
+{
+    qint64 record = recordOffset(NodeSection, index);
+    auto field = [&](int i) { return word(record + i * 4); };
+
+    NodeData data;
+    data.path = string(field(0));
+    data.identifier = string(field(1));
+    data.description = string(field(2));
+    data.isOnline = field(3) != 0;
+    data.childPaths = strings(field(4), field(5));
+    return data;
+}
+
+ParameterData MappedDeviceSnapshot::parameter(int index) const
+{
+    qint64 record = recordOffset(ParameterSection, index);
+    auto field = [&](int i) { return word(record + i * 4); };
+
+    ParameterData data;
+    data.path = string(field(0));
+    data.identifier = string(field(1));
+    data.value = string(field(2));
+    data.type = static_cast<int>(field(3));
+    data.access = static_cast<int>(field(4));
+    quint32 flags = field(5);
+    data.isOnline = flags & ParameterOnline;
+    data.streamIdentifier = static_cast<int>(field(6));
+    if (flags & HasMinimum) {
+        data.minimum = decodeLimit((quint64(field(8)) << 32) | field(7), flags & MinimumIsInteger);
+    }
+    if (flags & HasMaximum) {
+        data.maximum = decodeLimit((quint64(field(10)) << 32) | field(9), flags & MaximumIsInteger);
+    }
+    data.enumOptions = strings(field(11), field(12));
+    data.enumValues = ints(field(13), field(14));
+    data.streamOffset = static_cast<int>(field(15));
+    return data;
+}
+
+MatrixData MappedDeviceSnapshot::matrix(int index, bool withContents) const
+{
+    qint64 record = recordOffset(MatrixSection, index);
+    auto field = [&](int i) { return word(record + i * 4); };
+
+    MatrixData data;
+    data.path = string(field(0));
+    data.identifier = string(field(1));
+    data.description = string(field(2));
+    data.type = static_cast<int>(field(3));
+    data.targetCount = static_cast<int>(field(4));
+    data.sourceCount = static_cast<int>(field(5));
+    if (!withContents) {
+        return data;
+    }
+
+    data.targetNumbers = ints(field(6), field(7));
+    data.sourceNumbers = ints(field(8), field(9));
+
+    QList<int> targetLabels = ints(field(10), field(11) * 2);
+    for (int i = 0; i + 1 < targetLabels.size(); i += 2) {
+        data.targetLabels.insert(targetLabels[i], string(static_cast<quint32>(targetLabels[i + 1])));
+    }
+    QList<int> sourceLabels = ints(field(12), field(13) * 2);
+    for (int i = 0; i + 1 < sourceLabels.size(); i += 2) {
+        data.sourceLabels.insert(sourceLabels[i], string(static_cast<quint32>(sourceLabels[i + 1])));
+    }
+
+    quint32 rows = field(14);
+    quint32 columns = field(15);
+    quint32 stride = (columns + 7) / 8;
+    qint64 bits = headerWord(BitsetOffset) + qint64(field(16));
+    if (bits + qint64(rows) * stride > m_size) {
+        return data;
+    }
+
+    // Rows are mostly empty, so whole zero bytes are skipped
+    for (quint32 target = 0; target < rows; ++target) {
+        const uchar *row = m_data + bits + qint64(target) * stride;
+        for (quint32 byte = 0; byte < stride; ++byte) {
+            if (!row[byte]) {
+                continue;
+            }
+            for (int bit = 0; bit < 8; ++bit) {
+                if (row[byte] & (1 << bit)) {
+                    data.connections.insert({static_cast<int>(target), static_cast<int>(byte * 8 + bit)}, true);
+                }
+            }
+        }
+    }
+    return data;
+}
+
+FunctionData MappedDeviceSnapshot::function(int index) const
+{
+    qint64 record = recordOffset(FunctionSection, index);
+    auto field = [&](int i) { return word(record + i * 4); };
+
+    FunctionData data;
+    data.path = string(field(0));
+    data.identifier = string(field(1));
+    data.description = string(field(2));
+    data.argNames = strings(field(3), field(4));
+    data.argTypes = ints(field(5), field(6));
+    data.resultNames = strings(field(7), field(8));
+    data.resultTypes = ints(field(9), field(10));
+    return data;
+}
+
+int MappedDeviceSnapshot::findMatrix(const QString &path) const
+{
+    if (m_matrixIndex.isEmpty() && m_matrixCount > 0) {
+        m_matrixIndex.reserve(m_matrixCount);
+        for (int i = 0; i < m_matrixCount; ++i) {
+            m_matrixIndex.insert(string(word(recordOffset(MatrixSection, i))), i);
+        }
+    }
+    return m_matrixIndex.value(path, -1);
+}
+
+DeviceSnapshot MappedDeviceSnapshot::toSnapshot(bool withMatrixContents) const
+{
+    DeviceSnapshot snapshot;
+    snapshot.deviceName = deviceName();
+    snapshot.hostAddress = hostAddress();
+    snapshot.port = port();
+    snapshot.captureTime = captureTime();
+    snapshot.rootPaths = rootPaths();
+
+    for (int i = 0; i < m_nodeCount; ++i) {
+        NodeData data = node(i);
+        snapshot.nodes.insert(data.path, data);
+    }
+    for (int i = 0; i < m_parameterCount; ++i) {
+        ParameterData data = parameter(i);
+        snapshot.parameters.insert(data.path, data);
+    }
+    for (int i = 0; i < m_matrixCount; ++i) {
+        MatrixData data = matrix(i, withMatrixContents);
+        snapshot.matrices.insert(data.path, data);
+    }
+    for (int i = 0; i < m_functionCount; ++i) {
+        FunctionData data = function(i);
+        snapshot.functions.insert(data.path, data);
+    }
+    return snapshot;
+}
+
+bool MappedDeviceSnapshot::isBinarySnapshot(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray magic = file.read(4);
+    return magic.size() == 4 && qFromLittleEndian<quint32>(magic.constData()) == FILE_MAGIC;
+}
+
+bool MappedDeviceSnapshot::write(const DeviceSnapshot &snapshot, const QString &filePath, QString *error)
+{
+    SnapshotWriter writer;
+    QVector<quint32> sections[4];
+
+    for (const NodeData &node : snapshot.nodes) {
+        QVector<quint32> &record = sections[NodeSection];
+        record.append(writer.string(node.path));
+        record.append(writer.string(node.identifier));
+        record.append(writer.string(node.description));
+        record.append(node.isOnline ? 1 : 0);
+        writer.stringList(record, node.childPaths);
+    }
+
+    for (const ParameterData &param : snapshot.parameters) {
+        QVector<quint32> &record = sections[ParameterSection];
+        bool minimumIsInteger = isIntegerVariant(param.minimum);
+        bool maximumIsInteger = isIntegerVariant(param.maximum);
+        quint32 flags = (param.isOnline ? ParameterOnline : 0)
+            | (param.minimum.isValid() ? HasMinimum : 0)
+            | (param.maximum.isValid() ? HasMaximum : 0)
+            | (minimumIsInteger ? MinimumIsInteger : 0)
+            | (maximumIsInteger ? MaximumIsInteger : 0);
+        quint64 minimum = param.minimum.isValid() ? encodeLimit(param.minimum, minimumIsInteger) : 0;
+        quint64 maximum = param.maximum.isValid() ? encodeLimit(param.maximum, maximumIsInteger) : 0;
+
+        record.append(writer.string(param.path));
+        record.append(writer.string(param.identifier));
+        record.append(writer.string(param.value));
+        record.append(static_cast<quint32>(param.type));
+        record.append(static_cast<quint32>(param.access));
+        record.append(flags);
+        record.append(static_cast<quint32>(param.streamIdentifier));
+        record.append(static_cast<quint32>(minimum));
+        record.append(static_cast<quint32>(minimum >> 32));
+        record.append(static_cast<quint32>(maximum));
+        record.append(static_cast<quint32>(maximum >> 32));
+        writer.stringList(record, param.enumOptions);
+        writer.intList(record, param.enumValues);
+        record.append(static_cast<quint32>(param.streamOffset));
+    }
+
+    for (const MatrixData &matrix : snapshot.matrices) {
+        QVector<quint32> &record = sections[MatrixSection];
+        record.append(writer.string(matrix.path));
+        record.append(writer.string(matrix.identifier));
+        record.append(writer.string(matrix.description));
+        record.append(static_cast<quint32>(matrix.type));
+        record.append(static_cast<quint32>(matrix.targetCount));
+        record.append(static_cast<quint32>(matrix.sourceCount));
+        writer.intList(record, matrix.targetNumbers);
+        writer.intList(record, matrix.sourceNumbers);
+        writer.labels(record, matrix.targetLabels);
+        writer.labels(record, matrix.sourceLabels);
+        writer.connections(record, matrix);
+    }
+
+    for (const FunctionData &function : snapshot.functions) {
+        QVector<quint32> &record = sections[FunctionSection];
+        record.append(writer.string(function.path));
+        record.append(writer.string(function.identifier));
+        record.append(writer.string(function.description));
+        writer.stringList(record, function.argNames);
+        writer.intList(record, function.argTypes);
+        writer.stringList(record, function.resultNames);
+        writer.intList(record, function.resultTypes);
+    }
+
+    QVector<quint32> rootPaths;
+    writer.stringList(rootPaths, snapshot.rootPaths);
+
+    QVector<int> counts = { static_cast<int>(snapshot.nodes.size()), static_cast<int>(snapshot.parameters.size()),
+                            static_cast<int>(snapshot.matrices.size()), static_cast<int>(snapshot.functions.size()) };
+    QByteArray data = writer.assemble(sections, counts, snapshot, rootPaths[0]);
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,251 @@
+#include "MatrixLabelScheduler.h"
+#include <algorithm>
+
+MatrixLabelScheduler::MatrixLabelScheduler(int maxInFlight)
+    : m_maxInFlight(qMax(1, maxInFlight))
+    , m_nextMatrixId(0)
+    , m_focusedMatrix(-1)
+{
+}
+
+void MatrixLabelScheduler::addMatrix(const QString &matrixPath, int targetCount, int sourceCount)
+{
+    int id = m_matrixIds.value(matrixPath, -1);
+    if (id < 0) {
+        id = m_nextMatrixId++;
+        m_matrixIds.insert(matrixPath, id);
+        m_matrixOrder.append(id);
+        m_matrices[id].path = matrixPath;
+    }
+
+    MatrixState &matrix = m_matrices[id];
+    const int counts[2] = {qMax(0, targetCount), qMax(0, sourceCount)};
+    for (int i = 0; i < 2; ++i) {
+        QVector<quint8> &states = matrix.states[i];
+        for (int index = counts[i]; index < states.size(); ++index) {
+            m_inFlight.remove(key(id, LabelType(i + 1), index));
+        }
+        states.resize(counts[i]);
+        matrix.cursors[i] = qMin(matrix.cursors[i], counts[i]);
+    }
+
+    matrix.remaining = 0;
+    for (const QVector<quint8> &states : matrix.states) {
+        matrix.remaining += int(std::count_if(states.begin(), states.end(),
+                                              [](quint8 state) { return state != Done; }));
+    }
+}
+
+void MatrixLabelScheduler::removeMatrix(const QString &matrixPath)
+{
+    int id = m_matrixIds.take(matrixPath);
+    if (!m_matrices.contains(id)) {
+        return;
+    }
+
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();) {
+        if (int(it.key() >> 33) == id) {
+            it = m_inFlight.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    m_matrices.remove(id);
+    m_matrixOrder.removeOne(id);
+    if (m_focusedMatrix == id) {
+        m_focusedMatrix = -1;
+    }
+}
+
+void MatrixLabelScheduler::clear()
+{
+    m_matrices.clear();
+    m_matrixIds.clear();
+    m_matrixOrder.clear();
+    m_inFlight.clear();
+    m_focusedMatrix = -1;
+}
+
+void MatrixLabelScheduler::setNumbers(const QString &matrixPath, LabelType type, const QList<int> &numbers)
+{
+    int id = m_matrixIds.value(matrixPath, -1);
+    if (id < 0) {
+        return;
+    }
+
+    MatrixState &matrix = m_matrices[id];
+    int i = type - 1;
+    matrix.numbers[i] = numbers;
+    matrix.indexes[i].clear();
+    for (int index = 0; index < numbers.size(); ++index) {
+        matrix.indexes[i].insert(numbers[index], index);
+    }
+
+    // Requests sent under the old numbering asked for the wrong labels
+    QVector<quint8> &states = matrix.states[i];
+    for (int index = 0; index < states.size(); ++index) {
+        if (states[index] == InFlight && m_inFlight.remove(key(id, type, index)) > 0) {
+            states[index] = Missing;
+            matrix.cursors[i] = qMin(matrix.cursors[i], index);
+        }
+    }
+}
+
+void MatrixLabelScheduler::setVisibleRange(const QString &matrixPath, int firstTarget, int lastTarget,
+                                           int firstSource, int lastSource)
+{
+    m_focusedMatrix = m_matrixIds.value(matrixPath, -1);
+    m_visible.first[0] = firstTarget;
+    m_visible.last[0] = lastTarget;
+    m_visible.first[1] = firstSource;
+    m_visible.last[1] = lastSource;
+}
+
+void MatrixLabelScheduler::markReceived(const QString &matrixPath, LabelType type, int number)
+{
+    int id = m_matrixIds.value(matrixPath, -1);
+    if (id < 0) {
+        return;
+    }
+
+    MatrixState &matrix = m_matrices[id];
+    int index = indexOf(matrix, type, number);
+    if (index < 0) {
+        return;
+    }
+    if (m_inFlight.remove(key(id, type, index)) > 0) {
+        matrix.answered = true;
+    }
+    setState(matrix, type, index, Done);
+}
+
+QVector<MatrixLabelScheduler::Request> MatrixLabelScheduler::takeRequests(qint64 now)
+{
+    QVector<Request> requests;
+    if (m_inFlight.size() >= m_maxInFlight) {
+        return requests;
+    }
+
+    if (m_matrices.contains(m_focusedMatrix)) {
+        const LabelType types[2] = {Target, Source};
+
+        for (LabelType type : types) {
+            int i = type - 1;
+            requestRange(m_focusedMatrix, type, m_visible.first[i], m_visible.last[i], now, requests);
+        }
+
+        // Then a page on either side, the scroll direction is not known
+        for (LabelType type : types) {
+            int i = type - 1;
+            int page = m_visible.last[i] - m_visible.first[i] + 1;
+            if (page <= 0) {
+                continue;
+            }
+            requestRange(m_focusedMatrix, type, m_visible.last[i] + 1, m_visible.last[i] + page, now, requests);
+            requestRange(m_focusedMatrix, type, m_visible.first[i] - page, m_visible.first[i] - 1, now, requests);
+        }
+    }
+
+    for (int id : m_matrixOrder) {
+        MatrixState &matrix = m_matrices[id];
+        for (int i = 0; i < 2 && m_inFlight.size() < m_maxInFlight; ++i) {
+            const QVector<quint8> &states = matrix.states[i];
+            int &cursor = matrix.cursors[i];
+            for (; cursor < states.size() && m_inFlight.size() < m_maxInFlight; ++cursor) {
+                request(id, LabelType(i + 1), cursor, now, requests);
+            }
+        }
+        if (m_inFlight.size() >= m_maxInFlight) {
+            break;
+        }
+    }
+
+    return requests;
+}
+
+QVector<MatrixLabelScheduler::Request> MatrixLabelScheduler::takeExpired(qint64 now, qint64 timeoutMs)
+{
+    QVector<Request> expired;
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();) {
+        if (now - it.value() < timeoutMs) {
+            ++it;
+            continue;
+        }
+
+        int id = int(it.key() >> 33);
+        LabelType type = LabelType(((it.key() >> 32) & 1) + 1);
+        int index = int(quint32(it.key()));
+        it = m_inFlight.erase(it);
+
+        MatrixState &matrix = m_matrices[id];
+        setState(matrix, type, index, Done);
+        expired.append({matrix.path, type, numberAt(matrix, type, index)});
+    }
+    return expired;
+}
+
+bool MatrixLabelScheduler::hasAnswers(const QString &matrixPath) const
+{
+    auto it = m_matrices.constFind(m_matrixIds.value(matrixPath, -1));
+    return it != m_matrices.constEnd() && it->answered;
+}
+
+bool MatrixLabelScheduler::isIdle() const
+{
+    for (const MatrixState &matrix : m_matrices) {
+        if (matrix.remaining > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int MatrixLabelScheduler::numberAt(const MatrixState &matrix, LabelType type, int index)
+{
+    const QList<int> &numbers = matrix.numbers[type - 1];
+    return index < numbers.size() ? numbers[index] : index;
+}
+
+int MatrixLabelScheduler::indexOf(const MatrixState &matrix, LabelType type, int number)
+{
+    const QList<int> &numbers = matrix.numbers[type - 1];
+    return numbers.isEmpty() ? number : matrix.indexes[type - 1].value(number, -1);
+}
+
+void MatrixLabelScheduler::requestRange(int matrixId, LabelType type, int first, int last, qint64 now,
+                                        QVector<Request> &requests)
+{
+    const QVector<quint8> &states = m_matrices[matrixId].states[type - 1];
+    first = qMax(first, 0);
+    last = qMin(last, states.size() - 1);
+    for (int index = first; index <= last && m_inFlight.size() < m_maxInFlight; ++index) {
+        request(matrixId, type, index, now, requests);
+    }
+}
+
+bool MatrixLabelScheduler::request(int matrixId, LabelType type, int index, qint64 now, QVector<Request> &requests)
+{
+    MatrixState &matrix = m_matrices[matrixId];
+    if (matrix.states[type - 1][index] != Missing) {
+        return false;
+    }
+
+    setState(matrix, type, index, InFlight);
+    m_inFlight.insert(key(matrixId, type, index), now);
+    requests.append({matrix.path, type, numberAt(matrix, type, index)});
+    return true;
+}
+
+void MatrixLabelScheduler::setState(MatrixState &matrix, LabelType type, int index, LabelState state)
+{
+    QVector<quint8> &states = matrix.states[type - 1];
+    if (index < 0 || index >= states.size() || states[index] == state) {
+        return;
+    }
+
+    if (state == Done) {
+        --matrix.remaining;
+    }
+    states[index] = state;
+}
@@ -11,6 +11,7 @@
 #include "MatrixManager.h"
 #include "VirtualizedMatrixWidget.h"
 #include "EmberConnection.h"
+#include "LogCategories.h"
 #include <QDebug>
 
 MatrixManager::MatrixManager(EmberConnection *connection, QObject *parent)
@@ -35,7 +36,7 @@ MatrixManager::~MatrixManager()
 
 QWidget* MatrixManager::getMatrix(const QString &path) const
 {
-    return m_matrixWidgets.value(path, nullptr);
+    return m_matrixWidgets.value(EmberPath::find(path), nullptr);
 }
 
 void MatrixManager::clear()
@@ -47,7 +48,8 @@ void MatrixManager::clear()
 void MatrixManager::onMatrixReceived(const QString &path, int , const QString &identifier, 
                                      const QString &description, int type, int targetCount, int sourceCount)
 {
-    VirtualizedMatrixWidget *widget = qobject_cast<VirtualizedMatrixWidget*>(m_matrixWidgets.value(path, nullptr));
+    EmberPath key = EmberPath::fromString(path);
+    VirtualizedMatrixWidget *widget = qobject_cast<VirtualizedMatrixWidget*>(m_matrixWidgets.value(key, nullptr));
     bool isNew = false;
     bool dimensionsChanged = false;
     
@@ -58,7 +60,7 @@ void MatrixManager::onMatrixReceived(const QString &path, int , const QString &i
             .arg(identifier).arg(sourceCount).arg(targetCount).arg(totalCrosspoints);
         
         widget = new VirtualizedMatrixWidget();
-        m_matrixWidgets[path] = widget;
+        m_matrixWidgets.insert(key, widget);
         isNew = true;
     }
     
@@ -89,33 +91,33 @@ void MatrixManager::onMatrixReceived(const QString &path, int , const QString &i
     }
 }
 
-void MatrixManager::onMatrixTargetReceived(const QString &matrixPath, int targetNumber, const QString &label)
+void MatrixManager::onMatrixTargetReceived(EmberPath matrixPath, int targetNumber, const QString &label, bool isLabel)
 {
-    qDebug().noquote() << QString("MatrixManager: Received target label - Matrix: %1, Target: %2, Label: '%3'")
-        .arg(matrixPath).arg(targetNumber).arg(label);
+    qCDebug(lcElements).noquote() << QString("MatrixManager: Received target label - Matrix: %1, Target: %2, Label: '%3'")
+        .arg(matrixPath.toString()).arg(targetNumber).arg(label);
     
     VirtualizedMatrixWidget *widget = qobject_cast<VirtualizedMatrixWidget*>(m_matrixWidgets.value(matrixPath, nullptr));
     if (widget) {
-        widget->setTargetLabel(targetNumber, label);
+        widget->setTargetLabel(targetNumber, label, isLabel);
     } else {
-        qWarning().noquote() << QString("MatrixManager: No widget found for matrix path: %1").arg(matrixPath);
+        qWarning().noquote() << QString("MatrixManager: No widget found for matrix path: %1").arg(matrixPath.toString());
     }
 }
 
-void MatrixManager::onMatrixSourceReceived(const QString &matrixPath, int sourceNumber, const QString &label)
+void MatrixManager::onMatrixSourceReceived(EmberPath matrixPath, int sourceNumber, const QString &label, bool isLabel)
 {
-    qDebug().noquote() << QString("MatrixManager: Received source label - Matrix: %1, Source: %2, Label: '%3'")
-        .arg(matrixPath).arg(sourceNumber).arg(label);
+    qCDebug(lcElements).noquote() << QString("MatrixManager: Received source label - Matrix: %1, Source: %2, Label: '%3'")
+        .arg(matrixPath.toString()).arg(sourceNumber).arg(label);
     
     VirtualizedMatrixWidget *widget = qobject_cast<VirtualizedMatrixWidget*>(m_matrixWidgets.value(matrixPath, nullptr));
     if (widget) {
-        widget->setSourceLabel(sourceNumber, label);
+        widget->setSourceLabel(sourceNumber, label, isLabel);
     } else {
-        qWarning().noquote() << QString("MatrixManager: No widget found for matrix path: %1").arg(matrixPath);
+        qWarning().noquote() << QString("MatrixManager: No widget found for matrix path: %1").arg(matrixPath.toString());
     }
 }
 
-void MatrixManager::onMatrixConnectionReceived(const QString &matrixPath, int targetNumber, int sourceNumber, bool connected, int disposition)
+void MatrixManager::onMatrixConnectionReceived(EmberPath matrixPath, int targetNumber, int sourceNumber, bool connected, int disposition)
 {
     QString dispositionStr;
     switch (disposition) {
@@ -126,36 +128,36 @@ void MatrixManager::onMatrixConnectionReceived(const QString &matrixPath, int ta
         default: dispositionStr = QString("Unknown(%1)").arg(disposition); break;
     }
     
-    qDebug().noquote() << QString("Connection received - Matrix [%1], Target %2, Source %3, Connected: %4, Disposition: %5")
-               .arg(matrixPath).arg(targetNumber).arg(sourceNumber).arg(connected ? "YES" : "NO").arg(dispositionStr);
+    qCDebug(lcElements).noquote() << QString("Connection received - Matrix [%1], Target %2, Source %3, Connected: %4, Disposition: %5")
+               .arg(matrixPath.toString()).arg(targetNumber).arg(sourceNumber).arg(connected ? "YES" : "NO").arg(dispositionStr);
     
     VirtualizedMatrixWidget *widget = qobject_cast<VirtualizedMatrixWidget*>(m_matrixWidgets.value(matrixPath, nullptr));
     if (widget) {
-        qDebug().noquote() << QString("Found matrix widget, calling setConnection()");
+        qCDebug(lcElements).noquote() << QString("Found matrix widget, calling setConnection()");
         widget->setConnection(targetNumber, sourceNumber, connected, disposition);
     } else {
-        qWarning().noquote() << QString("No matrix widget found for path [%1]").arg(matrixPath);
+        qWarning().noquote() << QString("No matrix widget found for path [%1]").arg(matrixPath.toString());
     }
 }
 
-void MatrixManager::onMatrixConnectionsCleared(const QString &matrixPath)
+void MatrixManager::onMatrixConnectionsCleared(EmberPath matrixPath)
 {
-    qDebug().noquote() << QString("Clearing all connections for matrix %1").arg(matrixPath);
+    qCDebug(lcElements).noquote() << QString("Clearing all connections for matrix %1").arg(matrixPath.toString());
     
     VirtualizedMatrixWidget *widget = qobject_cast<VirtualizedMatrixWidget*>(m_matrixWidgets.value(matrixPath, nullptr));
     if (widget) {
         widget->clearConnections();
-        qDebug().noquote() << QString("Connections cleared for matrix %1").arg(matrixPath);
+        qCDebug(lcElements).noquote() << QString("Connections cleared for matrix %1").arg(matrixPath.toString());
     }
 }
 
-void MatrixManager::onMatrixTargetConnectionsCleared(const QString &matrixPath, int targetNumber)
+void MatrixManager::onMatrixTargetConnectionsCleared(EmberPath matrixPath, int targetNumber)
 {
-    qDebug().noquote() << QString("Clearing connections for target %1 in matrix %2").arg(targetNumber).arg(matrixPath);
+    qCDebug(lcElements).noquote() << QString("Clearing connections for target %1 in matrix %2").arg(targetNumber).arg(matrixPath.toString());
     
     VirtualizedMatrixWidget *widget = qobject_cast<VirtualizedMatrixWidget*>(m_matrixWidgets.value(matrixPath, nullptr));
     if (widget) {
         widget->clearTargetConnections(targetNumber);
-        qDebug().noquote() << QString("Target %1 connections cleared for matrix %2").arg(targetNumber).arg(matrixPath);
+        qCDebug(lcElements).noquote() << QString("Target %1 connections cleared for matrix %2").arg(targetNumber).arg(matrixPath.toString());
     }
 }
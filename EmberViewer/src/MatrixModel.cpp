@@ -3,6 +3,185 @@
 #include "MatrixModel.h"
 #include <QDebug>
 
+ConnectionStore::ConnectionStore()
+    : m_dense(false)
+    , m_targetCount(0)
+    , m_sourceCount(0)
+    , m_wordsPerTarget(0)
+    , m_count(0)
+{
+}
+
+void ConnectionStore::resize(int targetCount, int sourceCount)
+{
+    if (targetCount == m_targetCount && sourceCount == m_sourceCount) {
+        return;
+    }
+
+    QList<QPair<int, int>> existing = connections();
+    QHash<quint64, int> dispositions = m_dispositions;
+
+    m_targetCount = targetCount;
+    m_sourceCount = sourceCount;
+    clear();
+
+    for (const auto &connection : existing) {
+        set(connection.first, connection.second, true, dispositions.value(key(connection.first, connection.second)));
+    }
+}
+
+void ConnectionStore::clear()
+{
+    qint64 crosspoints = qint64(m_targetCount) * m_sourceCount;
+    m_dense = crosspoints > 0 && crosspoints <= MAX_DENSE_CROSSPOINTS;
+    m_wordsPerTarget = m_dense ? (m_sourceCount + 63) / 64 : 0;
+    m_bits.assign(m_dense ? size_t(m_targetCount) * m_wordsPerTarget : 0, 0);
+    m_sparse.clear();
+    m_dispositions.clear();
+    m_count = 0;
+}
+
+void ConnectionStore::makeSparse()
+{
+    QList<QPair<int, int>> existing = connections();
+    m_dense = false;
+    m_bits.clear();
+    m_bits.shrink_to_fit();
+    m_wordsPerTarget = 0;
+
+    // connections() is ordered by target and source, so every list stays sorted
+    for (const auto &connection : existing) {
+        m_sparse[connection.first].append(connection.second);
+    }
+}
+
+bool ConnectionStore::set(int targetNumber, int sourceNumber, bool connected, int disposition)
+{
+    if (m_dense && !inDenseRange(targetNumber, sourceNumber)) {
+        if (!connected) {
+            return false;
+        }
+        makeSparse();
+    }
+
+    bool wasConnected;
+    if (m_dense) {
+        quint64 &word = m_bits[size_t(targetNumber) * m_wordsPerTarget + sourceNumber / 64];
+        quint64 mask = quint64(1) << (sourceNumber % 64);
+        wasConnected = (word & mask) != 0;
+        word = connected ? (word | mask) : (word & ~mask);
+    } else {
+        auto it = m_sparse.find(targetNumber);
+        if (it == m_sparse.end()) {
+            if (!connected) {
+                return false;
+            }
+            it = m_sparse.insert(targetNumber, QVector<int>());
+        }
+        QVector<int> &sources = it.value();
+        auto position = std::lower_bound(sources.begin(), sources.end(), sourceNumber);
+        wasConnected = position != sources.end() && *position == sourceNumber;
+        if (connected && !wasConnected) {
+            sources.insert(position, sourceNumber);
+        } else if (!connected && wasConnected) {
+            sources.erase(position);
+            if (sources.isEmpty()) {
+                m_sparse.erase(it);
+            }
+        }
+    }
+
+    int previousDisposition = wasConnected ? m_dispositions.value(key(targetNumber, sourceNumber)) : 0;
+    if (connected && disposition != 0) {
+        m_dispositions.insert(key(targetNumber, sourceNumber), disposition);
+    } else if (wasConnected) {
+        m_dispositions.remove(key(targetNumber, sourceNumber));
+    }
+
+    m_count += int(connected) - int(wasConnected);
+    return connected != wasConnected || (connected && disposition != previousDisposition);
+}
+
+void ConnectionStore::clearTarget(int targetNumber)
+{
+    if (m_dense) {
+        if (targetNumber < 0 || targetNumber >= m_targetCount) {
+            return;
+        }
+        quint64 *row = m_bits.data() + size_t(targetNumber) * m_wordsPerTarget;
+        for (int i = 0; i < m_wordsPerTarget; ++i) {
+            // Only the set bits can have a disposition entry
+            for (quint64 word = row[i]; word != 0; word &= word - 1) {
+                int sourceNumber = i * 64 + qCountTrailingZeroBits(word);
+                if (!m_dispositions.isEmpty()) {
+                    m_dispositions.remove(key(targetNumber, sourceNumber));
+                }
+                m_count--;
+            }
+            row[i] = 0;
+        }
+        return;
+    }
+
+    auto it = m_sparse.find(targetNumber);
+    if (it == m_sparse.end()) {
+        return;
+    }
+    for (int sourceNumber : it.value()) {
+        m_dispositions.remove(key(targetNumber, sourceNumber));
+    }
+    m_count -= it.value().size();
+    m_sparse.erase(it);
+}
+
+bool ConnectionStore::isConnected(int targetNumber, int sourceNumber) const
+{
+    if (m_dense) {
+        if (!inDenseRange(targetNumber, sourceNumber)) {
+            return false;
+        }
+        quint64 word = m_bits[size_t(targetNumber) * m_wordsPerTarget + sourceNumber / 64];
+        return (word >> (sourceNumber % 64)) & 1;
+    }
+
+    auto it = m_sparse.constFind(targetNumber);
+    return it != m_sparse.constEnd() && std::binary_search(it->begin(), it->end(), sourceNumber);
+}
+
+int ConnectionStore::disposition(int targetNumber, int sourceNumber) const
+{
+    return m_dispositions.value(key(targetNumber, sourceNumber), 0);
+}
+
+QList<QPair<int, int>> ConnectionStore::connections() const
+{
+    QList<QPair<int, int>> result;
+    result.reserve(m_count);
+
+    if (m_dense) {
+        for (int targetNumber = 0; targetNumber < m_targetCount; ++targetNumber) {
+            const quint64 *row = m_bits.data() + size_t(targetNumber) * m_wordsPerTarget;
+            for (int i = 0; i < m_wordsPerTarget; ++i) {
+                for (quint64 word = row[i]; word != 0; word &= word - 1) {
+                    result.append(qMakePair(targetNumber, i * 64 + int(qCountTrailingZeroBits(word))));
+                }
+            }
+        }
+        return result;
+    }
+
+    QList<int> targets = m_sparse.keys();
+    std::sort(targets.begin(), targets.end());
+    for (int targetNumber : targets) {
+        for (int sourceNumber : m_sparse.value(targetNumber)) {
+            result.append(qMakePair(targetNumber, sourceNumber));
+        }
+    }
+    return result;
+}
+
+
+
 MatrixModel::MatrixModel(QObject *parent)
     : QObject(parent)
     , m_matrixType(2)  
@@ -30,6 +209,7 @@ void MatrixModel::setMatrixInfo(const QString &identifier, const QString &descri
     
     m_targetCount = targetCount;
     m_sourceCount = sourceCount;
+    m_connections.resize(targetCount, sourceCount);
     
     
     if (dimensionsChanged && wasEmpty && nowPopulated) {
@@ -80,18 +260,21 @@ void MatrixModel::setSourceNumbers(const QList<int> &numbers)
     emitDataChangedIfNotDeferred();
 }
 
-void MatrixModel::setTargetLabel(int targetNumber, const QString &label)
+void MatrixModel::setTargetLabel(int targetNumber, const QString &label, bool isLabel)
 {
     
     
     QString currentLabel = m_targetLabels.value(targetNumber);
-    bool isPlaceholder = currentLabel.isEmpty() || currentLabel.startsWith("Target ");
     
-    if (isPlaceholder) {
+    if (!m_receivedTargetLabels.contains(targetNumber)) {
         qDebug().noquote() << QString("MatrixModel: setTargetLabel - Target: %1, Label: '%2', Matrix: %3")
             .arg(targetNumber).arg(label).arg(m_matrixPath);
         
         m_targetLabels[targetNumber] = label;
+        if (isLabel) {
+            m_receivedTargetLabels.insert(targetNumber);
+        }
+        emit labelsChanged();
         
         
         // Use QSet for O(1) lookup instead of QList::contains() which is O(n)
@@ -111,18 +294,21 @@ void MatrixModel::setTargetLabel(int targetNumber, const QString &label)
     }
 }
 
-void MatrixModel::setSourceLabel(int sourceNumber, const QString &label)
+void MatrixModel::setSourceLabel(int sourceNumber, const QString &label, bool isLabel)
 {
     
     
     QString currentLabel = m_sourceLabels.value(sourceNumber);
-    bool isPlaceholder = currentLabel.isEmpty() || currentLabel.startsWith("Source ");
     
-    if (isPlaceholder) {
+    if (!m_receivedSourceLabels.contains(sourceNumber)) {
         qDebug().noquote() << QString("MatrixModel: setSourceLabel - Source: %1, Label: '%2', Matrix: %3")
             .arg(sourceNumber).arg(label).arg(m_matrixPath);
         
         m_sourceLabels[sourceNumber] = label;
+        if (isLabel) {
+            m_receivedSourceLabels.insert(sourceNumber);
+        }
+        emit labelsChanged();
         
         
         // Use QSet for O(1) lookup instead of QList::contains() which is O(n)
@@ -144,16 +330,7 @@ void MatrixModel::setSourceLabel(int sourceNumber, const QString &label)
 
 void MatrixModel::setConnection(int targetNumber, int sourceNumber, bool connected, int disposition)
 {
-    QPair<int, int> key(targetNumber, sourceNumber);
-    
-    if (connected) {
-        ConnectionState state;
-        state.connected = true;
-        state.disposition = disposition;
-        m_connections[key] = state;
-    } else {
-        m_connections.remove(key);
-    }
+    m_connections.set(targetNumber, sourceNumber, connected, disposition);
     
     emit connectionChanged(targetNumber, sourceNumber, connected);
 }
@@ -166,17 +343,7 @@ void MatrixModel::clearConnections()
 
 void MatrixModel::clearTargetConnections(int targetNumber)
 {
-    QList<QPair<int, int>> keysToRemove;
-    
-    for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
-        if (it.key().first == targetNumber) {
-            keysToRemove.append(it.key());
-        }
-    }
-    
-    for (const auto &key : keysToRemove) {
-        m_connections.remove(key);
-    }
+    m_connections.clearTarget(targetNumber);
     
     emitDataChangedIfNotDeferred();
 }
@@ -193,30 +360,17 @@ QString MatrixModel::sourceLabel(int sourceNumber) const
 
 bool MatrixModel::isConnected(int targetNumber, int sourceNumber) const
 {
-    QPair<int, int> key(targetNumber, sourceNumber);
-    return m_connections.contains(key) && m_connections[key].connected;
+    return m_connections.isConnected(targetNumber, sourceNumber);
 }
 
 int MatrixModel::connectionDisposition(int targetNumber, int sourceNumber) const
 {
-    QPair<int, int> key(targetNumber, sourceNumber);
-    if (m_connections.contains(key)) {
-        return m_connections[key].disposition;
-    }
-    return 0;
+    return m_connections.disposition(targetNumber, sourceNumber);
 }
 
 QList<QPair<int, int>> MatrixModel::getAllConnections() const
 {
-    QList<QPair<int, int>> result;
-    
-    for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
-        if (it.value().connected) {
-            result.append(it.key());
-        }
-    }
-    
-    return result;
+    return m_connections.connections();
 }
 
 void MatrixModel::setUpdatesDeferred(bool deferred)
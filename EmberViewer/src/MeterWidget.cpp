@@ -24,6 +24,7 @@
 MeterWidget::MeterWidget(QWidget *parent)
     : QWidget(parent)
     , m_streamIdentifier(-1)
+    , m_streamOffset(0)
     , m_minValue(0.0)
     , m_maxValue(100.0)
     , m_targetValue(0.0)
@@ -379,7 +380,7 @@ void MeterWidget::onMeterTypeChanged(int index)
     }
 }
 
-void MeterWidget::getMeterConstants(MeterType type, double &riseTime, double &fallTime) const
+void MeterWidget::getMeterConstants(MeterType type, double &riseTime, double &fallTime)
 {
     switch (type) {
         case MeterType::DIN_PPM:
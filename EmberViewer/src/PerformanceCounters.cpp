@@ -0,0 +1,83 @@
+#include "PerformanceCounters.h"
+#include <QDateTime>
+
+std::atomic<quint64> PerformanceCounters::s_counters[PerformanceCounters::CounterCount];
+PerformanceCounters::AtomicTimer PerformanceCounters::s_timers[PerformanceCounters::TimerCount];
+std::atomic<qint64> PerformanceCounters::s_gauges[PerformanceCounters::GaugeCount];
+
+void PerformanceCounters::record(Timer timer, qint64 nsecs)
+{
+    AtomicTimer &value = s_timers[timer];
+    quint64 ns = quint64(qMax<qint64>(0, nsecs));
+    value.count.fetch_add(1, std::memory_order_relaxed);
+    value.totalNs.fetch_add(ns, std::memory_order_relaxed);
+
+    quint64 max = value.maxNs.load(std::memory_order_relaxed);
+    while (ns > max && !value.maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+PerformanceCounters::Snapshot PerformanceCounters::snapshot()
+{
+    Snapshot snapshot;
+    snapshot.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    for (int i = 0; i < CounterCount; ++i) {
+        snapshot.counters[i] = s_counters[i].load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < TimerCount; ++i) {
+        snapshot.timers[i].count = s_timers[i].count.load(std::memory_order_relaxed);
+        snapshot.timers[i].totalNs = s_timers[i].totalNs.load(std::memory_order_relaxed);
+        snapshot.timers[i].maxNs = s_timers[i].maxNs.exchange(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < GaugeCount; ++i) {
+        snapshot.gauges[i] = s_gauges[i].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+void PerformanceCounters::reset()
+{
+    for (auto &counter : s_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto &timer : s_timers) {
+        timer.count.store(0, std::memory_order_relaxed);
+        timer.totalNs.store(0, std::memory_order_relaxed);
+        timer.maxNs.store(0, std::memory_order_relaxed);
+    }
+}
+
+QString PerformanceCounters::name(Counter counter)
+{
+    switch (counter) {
+        case BytesIn:               return "Bytes in";
+        case BytesOut:              return "Bytes out";
+        case FramesIn:              return "S101 frames in";
+        case FramesOut:             return "S101 frames out";
+        case RootsDecoded:          return "Glow roots decoded";
+        case ElementsDecoded:       return "Elements decoded";
+        case BatchesDispatched:     return "Batches dispatched";
+        case TreeUpdatesApplied:    return "Tree updates applied";
+        case TreeUpdatesCollapsed:  return "Tree updates collapsed";
+        default:                    return QString();
+    }
+}
+
+QString PerformanceCounters::name(Timer timer)
+{
+    switch (timer) {
+        case DecodeMessage:         return "Decode per message";
+        case DispatchBatch:         return "Dispatch per batch";
+        case ApplyTree:             return "Tree refresh";
+        default:                    return QString();
+    }
+}
+
+QString PerformanceCounters::name(Gauge gauge)
+{
+    switch (gauge) {
+        case PendingBatches:        return "Pending batches";
+        case PendingTreeUpdates:    return "Pending tree updates";
+        default:                    return QString();
+    }
+}
@@ -0,0 +1,204 @@
+#include "PerformancePanel.h"
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QMessageBox>
+#include <QDebug>
+
+namespace {
+
+QString formatRate(double perSecond, bool bytes)
+{
+    if (bytes && perSecond >= 1024.0 * 1024.0) {
+        return QString("%1 MB/s").arg(perSecond / (1024.0 * 1024.0), 0, 'f', 2);
+    }
+    if (bytes && perSecond >= 1024.0) {
+        return QString("%1 KB/s").arg(perSecond / 1024.0, 0, 'f', 1);
+    }
+    return QString("%1/s").arg(perSecond, 0, 'f', 0);
+}
+
+QString formatMicroseconds(double us)
+{
+    if (us >= 1000.0) {
+        return QString("%1 ms").arg(us / 1000.0, 0, 'f', 2);
+    }
+    return QString("%1 µs").arg(us, 0, 'f', 0);
+}
+
+bool isByteCounter(int counter)
+{
+    return counter == PerformanceCounters::BytesIn || counter == PerformanceCounters::BytesOut;
+}
+
+}
+
+PerformancePanel::PerformancePanel(QWidget *parent)
+    : QWidget(parent)
+    , m_table(new QTableWidget(this))
+    , m_sampleTimer(new QTimer(this))
+{
+    int rows = PerformanceCounters::CounterCount + PerformanceCounters::TimerCount + PerformanceCounters::GaugeCount;
+    m_table->setRowCount(rows);
+    m_table->setColumnCount(4);
+    m_table->setHorizontalHeaderLabels({"Metric", "Current", "Max", "Total"});
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionMode(QAbstractItemView::NoSelection);
+
+    int row = 0;
+    for (int i = 0; i < PerformanceCounters::CounterCount; ++i) {
+        m_table->setItem(row++, 0, new QTableWidgetItem(PerformanceCounters::name(PerformanceCounters::Counter(i))));
+    }
+    for (int i = 0; i < PerformanceCounters::TimerCount; ++i) {
+        m_table->setItem(row++, 0, new QTableWidgetItem(PerformanceCounters::name(PerformanceCounters::Timer(i))));
+    }
+    for (int i = 0; i < PerformanceCounters::GaugeCount; ++i) {
+        m_table->setItem(row++, 0, new QTableWidgetItem(PerformanceCounters::name(PerformanceCounters::Gauge(i))));
+    }
+    for (row = 0; row < rows; ++row) {
+        for (int column = 1; column < 4; ++column) {
+            QTableWidgetItem *item = new QTableWidgetItem();
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            m_table->setItem(row, column, item);
+        }
+    }
+    m_peaks.fill(0.0, rows);
+
+    QPushButton *resetButton = new QPushButton("Reset", this);
+    connect(resetButton, &QPushButton::clicked, this, &PerformancePanel::reset);
+    QPushButton *exportButton = new QPushButton("Export CSV...", this);
+    connect(exportButton, &QPushButton::clicked, this, &PerformancePanel::exportCsv);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(resetButton);
+    buttonLayout->addWidget(exportButton);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(5, 5, 5, 5);
+    layout->addWidget(m_table);
+    layout->addLayout(buttonLayout);
+
+    m_previous = PerformanceCounters::snapshot();
+    m_sampleTimer->setInterval(SAMPLE_INTERVAL_MS);
+    connect(m_sampleTimer, &QTimer::timeout, this, &PerformancePanel::sample);
+    m_sampleTimer->start();
+}
+
+QStringList PerformancePanel::csvHeader() const
+{
+    QStringList header{"timestamp"};
+    for (int i = 0; i < PerformanceCounters::CounterCount; ++i) {
+        header << PerformanceCounters::name(PerformanceCounters::Counter(i)) + " per second";
+    }
+    for (int i = 0; i < PerformanceCounters::TimerCount; ++i) {
+        QString name = PerformanceCounters::name(PerformanceCounters::Timer(i));
+        header << name + " avg us" << name + " max us";
+    }
+    for (int i = 0; i < PerformanceCounters::GaugeCount; ++i) {
+        header << PerformanceCounters::name(PerformanceCounters::Gauge(i));
+    }
+    return header;
+}
+
+QString PerformancePanel::toCsv() const
+{
+    QString csv;
+    QTextStream stream(&csv);
+    stream << csvHeader().join(',') << "\n";
+    for (const Sample &sample : m_history) {
+        stream << QDateTime::fromMSecsSinceEpoch(sample.timestampMs).toString(Qt::ISODateWithMs);
+        for (double value : sample.values) {
+            stream << ',' << QString::number(value, 'f', 1);
+        }
+        stream << "\n";
+    }
+    return csv;
+}
+
+void PerformancePanel::reset()
+{
+    PerformanceCounters::reset();
+    m_previous = PerformanceCounters::snapshot();
+    m_peaks.fill(0.0);
+    m_history.clear();
+    for (int row = 0; row < m_table->rowCount(); ++row) {
+        setRow(row, QString(), QString(), QString());
+    }
+}
+
+void PerformancePanel::exportCsv()
+{
+    QString defaultName = QString("emberviewer_performance_%1.csv")
+        .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss"));
+    QString fileName = QFileDialog::getSaveFileName(this, "Export Performance Counters", defaultName,
+                                                    "CSV Files (*.csv);;All Files (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::critical(this, "Export Failed", QString("Could not write %1").arg(fileName));
+        return;
+    }
+    file.write(toCsv().toUtf8());
+    qInfo().noquote() << QString("Exported %1 performance samples to %2").arg(m_history.size()).arg(fileName);
+}
+
+void PerformancePanel::sample()
+{
+    PerformanceCounters::Snapshot current = PerformanceCounters::snapshot();
+    double seconds = qMax<qint64>(1, current.timestampMs - m_previous.timestampMs) / 1000.0;
+
+    Sample sample;
+    sample.timestampMs = current.timestampMs;
+
+    int row = 0;
+    for (int i = 0; i < PerformanceCounters::CounterCount; ++i, ++row) {
+        double rate = (current.counters[i] - m_previous.counters[i]) / seconds;
+        m_peaks[row] = qMax(m_peaks[row], rate);
+        bool bytes = isByteCounter(i);
+        setRow(row, formatRate(rate, bytes), formatRate(m_peaks[row], bytes),
+               QString::number(current.counters[i]));
+        sample.values.append(rate);
+    }
+
+    for (int i = 0; i < PerformanceCounters::TimerCount; ++i, ++row) {
+        const PerformanceCounters::TimerValue &now = current.timers[i];
+        quint64 count = now.count - m_previous.timers[i].count;
+        double averageUs = count > 0 ? (now.totalNs - m_previous.timers[i].totalNs) / 1000.0 / count : 0.0;
+        double maxUs = now.maxNs / 1000.0;
+        m_peaks[row] = qMax(m_peaks[row], maxUs);
+        setRow(row, formatMicroseconds(averageUs), formatMicroseconds(m_peaks[row]), QString::number(now.count));
+        sample.values << averageUs << maxUs;
+    }
+
+    for (int i = 0; i < PerformanceCounters::GaugeCount; ++i, ++row) {
+        double value = double(current.gauges[i]);
+        m_peaks[row] = qMax(m_peaks[row], value);
+        setRow(row, QString::number(current.gauges[i]), QString::number(m_peaks[row], 'f', 0), QString());
+        sample.values.append(value);
+    }
+
+    if (m_history.size() >= HISTORY_LIMIT) {
+        m_history.removeFirst();
+    }
+    m_history.append(sample);
+    m_previous = current;
+}
+
+void PerformancePanel::setRow(int row, const QString &current, const QString &peak, const QString &total)
+{
+    m_table->item(row, 1)->setText(current);
+    m_table->item(row, 2)->setText(peak);
+    m_table->item(row, 3)->setText(total);
+}
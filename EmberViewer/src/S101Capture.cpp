@@ -0,0 +1,120 @@
+#include "S101Capture.h"
+#include <QDateTime>
+#include <QDebug>
+#include <limits>
+
+S101CaptureWriter::~S101CaptureWriter()
+{
+    close();
+}
+
+bool S101CaptureWriter::open(const QString &filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning().noquote() << QString("Cannot write S101 capture %1: %2").arg(filePath).arg(m_file.errorString());
+        return false;
+    }
+
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_6_0);
+    m_stream << FILE_MAGIC << FILE_VERSION << qint64(QDateTime::currentMSecsSinceEpoch());
+
+    m_clock.start();
+    m_lastUs = 0;
+    m_recordCount = 0;
+    return true;
+}
+
+void S101CaptureWriter::append(S101CaptureRecord::Direction direction, const QByteArray &data)
+{
+    if (!m_file.isOpen() || data.isEmpty()) {
+        return;
+    }
+
+    qint64 nowUs = m_clock.nsecsElapsed() / 1000;
+    qint64 deltaUs = qBound<qint64>(0, nowUs - m_lastUs, std::numeric_limits<quint32>::max());
+    m_lastUs += deltaUs;
+
+    m_stream << quint8(direction) << quint32(deltaUs) << data;
+    ++m_recordCount;
+}
+
+void S101CaptureWriter::close()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    m_stream.setDevice(nullptr);
+    m_file.close();
+    qInfo().noquote() << QString("S101 capture %1 closed, %2 records").arg(m_file.fileName()).arg(m_recordCount);
+}
+
+bool S101CaptureReader::open(const QString &filePath)
+{
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic;
+    quint16 version;
+    m_stream >> magic >> version >> m_startedAtMs;
+    if (m_stream.status() != QDataStream::Ok || magic != S101CaptureWriter::FILE_MAGIC) {
+        m_error = "Not an S101 capture";
+        return false;
+    }
+    if (version != S101CaptureWriter::FILE_VERSION) {
+        m_error = QString("Unsupported capture version %1").arg(version);
+        return false;
+    }
+
+    m_timestampUs = 0;
+    m_error.clear();
+    return true;
+}
+
+bool S101CaptureReader::readNext(S101CaptureRecord &record)
+{
+    if (!m_file.isOpen() || m_stream.atEnd()) {
+        return false;
+    }
+
+    quint8 direction;
+    quint32 deltaUs;
+    m_stream >> direction >> deltaUs >> record.data;
+    if (m_stream.status() != QDataStream::Ok) {
+        m_error = "Capture is truncated";
+        return false;
+    }
+
+    m_timestampUs += deltaUs;
+    record.direction = direction == S101CaptureRecord::Outbound ? S101CaptureRecord::Outbound : S101CaptureRecord::Inbound;
+    record.timestampUs = m_timestampUs;
+    return true;
+}
+
+QVector<S101CaptureRecord> S101CaptureReader::readAll(const QString &filePath, QString *errorString)
+{
+    QVector<S101CaptureRecord> records;
+    S101CaptureReader reader;
+    if (reader.open(filePath)) {
+        S101CaptureRecord record;
+        while (reader.readNext(record)) {
+            records.append(record);
+        }
+    }
+
+    // A truncated tail is reported but everything before it is still usable
+    if (errorString) {
+        *errorString = reader.errorString();
+    }
+    return records;
+}
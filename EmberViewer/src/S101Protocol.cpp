@@ -7,6 +7,7 @@
 
 
 #include "S101Protocol.h"
+#include "LogCategories.h"
 #include <s101/MessageType.hpp>
 #include <s101/CommandType.hpp>
 #include <s101/PackageFlag.hpp>
@@ -91,16 +92,16 @@ void S101Protocol::feedData(const QByteArray& data)
                 }
                 else if (command == libs101::CommandType::KeepAliveRequest) {
                     
-                    qDebug() << "[S101] KeepAlive REQUEST received from device";
+                    qCDebug(lcS101) << "[S101] KeepAlive REQUEST received from device";
                     emit self->keepAliveReceived();
                 }
                 else if (command == libs101::CommandType::KeepAliveResponse) {
                     
-                    qDebug() << "[S101] KeepAlive RESPONSE received (unexpected)";
+                    qCDebug(lcS101) << "[S101] KeepAlive RESPONSE received (unexpected)";
                 }
                 else {
                     
-                    qDebug() << "[S101] Unknown command type:" << static_cast<int>(command);
+                    qCDebug(lcS101) << "[S101] Unknown command type:" << static_cast<int>(command);
                 }
             }
             
@@ -0,0 +1,83 @@
+#include "S101ReplayServer.h"
+#include <QDebug>
+#include <QHostAddress>
+
+S101ReplayServer::S101ReplayServer(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_timing(S101Replayer::OriginalTiming)
+    , m_speed(1.0)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &S101ReplayServer::onNewConnection);
+}
+
+S101ReplayServer::~S101ReplayServer()
+{
+    close();
+}
+
+bool S101ReplayServer::load(const QString &filePath, QString *errorString)
+{
+    QString error;
+    m_records = S101CaptureReader::readAll(filePath, &error);
+    if (errorString) {
+        *errorString = error;
+    }
+    return !m_records.isEmpty();
+}
+
+bool S101ReplayServer::listen(quint16 port, S101Replayer::Timing timing, double speed)
+{
+    m_timing = timing;
+    m_speed = speed;
+    return m_server->listen(QHostAddress::Any, port);
+}
+
+void S101ReplayServer::close()
+{
+    m_server->close();
+
+    const QList<QTcpSocket*> sockets = m_server->findChildren<QTcpSocket*>();
+    for (QTcpSocket *socket : sockets) {
+        socket->abort();
+    }
+}
+
+void S101ReplayServer::onNewConnection()
+{
+    while (m_server->hasPendingConnections()) {
+        QTcpSocket *socket = m_server->nextPendingConnection();
+        QString address = QString("%1:%2").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+
+        // Parented to the socket so it goes away with the connection
+        S101Replayer *replayer = new S101Replayer(socket);
+        replayer->setRecords(m_records);
+
+        connect(replayer, &S101Replayer::dataReady, socket, [socket, replayer](const QByteArray &data) {
+            socket->write(data);
+            if (socket->bytesToWrite() > MAX_PENDING_BYTES) {
+                replayer->setPaused(true);
+            }
+        });
+        connect(socket, &QTcpSocket::bytesWritten, replayer, [socket, replayer]() {
+            if (socket->bytesToWrite() <= MAX_PENDING_BYTES / 2) {
+                replayer->setPaused(false);
+            }
+        });
+        connect(replayer, &S101Replayer::finished, this, [this, address]() {
+            qInfo().noquote() << QString("Replay to %1 complete").arg(address);
+            emit clientFinished(address);
+        });
+
+        connect(socket, &QTcpSocket::readyRead, socket, [socket]() {
+            socket->readAll();
+        });
+        connect(socket, &QTcpSocket::disconnected, socket, [replayer, socket]() {
+            replayer->stop();
+            socket->deleteLater();
+        });
+
+        emit clientConnected(address);
+        replayer->start(m_timing, m_speed);
+    }
+}
@@ -0,0 +1,156 @@
+#include "S101Replayer.h"
+#include "S101Protocol.h"
+#include "GlowParser.h"
+#include <cmath>
+
+S101Replayer::S101Replayer(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_timing(AsFastAsPossible)
+    , m_speed(1.0)
+    , m_next(0)
+    , m_offsetUs(0)
+    , m_pausedAtUs(0)
+    , m_paused(false)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &S101Replayer::emitDue);
+}
+
+void S101Replayer::setRecords(const QVector<S101CaptureRecord> &records)
+{
+    stop();
+
+    m_records.clear();
+    for (const S101CaptureRecord &record : records) {
+        if (record.direction == S101CaptureRecord::Inbound) {
+            m_records.append(record);
+        }
+    }
+    m_next = m_records.size();
+}
+
+qint64 S101Replayer::durationUs() const
+{
+    if (m_records.isEmpty()) {
+        return 0;
+    }
+    return m_records.last().timestampUs - m_records.first().timestampUs;
+}
+
+S101Replayer::DecodeStats S101Replayer::decode() const
+{
+    DecodeStats stats;
+    S101Protocol protocol;
+    GlowParser parser;
+
+    connect(&protocol, &S101Protocol::messageReceived, &parser, [&](const QByteArray &emberData) {
+        ++stats.messages;
+        parser.parseEmberData(emberData);
+    });
+    connect(&protocol, &S101Protocol::protocolError, &parser, [&]() { ++stats.errors; });
+    connect(&parser, &GlowParser::parsingError, &parser, [&]() { ++stats.errors; });
+
+    auto countElement = [&]() { ++stats.elements; };
+    connect(&parser, &GlowParser::nodeReceived, &parser, countElement);
+    connect(&parser, &GlowParser::parameterReceived, &parser, countElement);
+    connect(&parser, &GlowParser::matrixReceived, &parser, countElement);
+    connect(&parser, &GlowParser::matrixTargetReceived, &parser, countElement);
+    connect(&parser, &GlowParser::matrixSourceReceived, &parser, countElement);
+    connect(&parser, &GlowParser::matrixConnectionReceived, &parser, countElement);
+    connect(&parser, &GlowParser::functionReceived, &parser, countElement);
+    connect(&parser, &GlowParser::streamValuesReceived, &parser,
+            [&](const QVector<EmberData::StreamValue> &values) {
+        stats.streamValues += values.size();
+    });
+
+    QElapsedTimer clock;
+    clock.start();
+    for (const S101CaptureRecord &record : m_records) {
+        stats.bytes += record.data.size();
+        protocol.feedData(record.data);
+    }
+    stats.elapsedNs = clock.nsecsElapsed();
+
+    return stats;
+}
+
+void S101Replayer::start(Timing timing, double speed)
+{
+    stop();
+
+    m_timing = timing;
+    m_speed = speed > 0.0 ? speed : 1.0;
+    m_next = 0;
+    m_offsetUs = 0;
+    m_clock.start();
+
+    if (m_records.isEmpty()) {
+        emit finished();
+        return;
+    }
+    m_timer->start(0);
+}
+
+void S101Replayer::stop()
+{
+    m_timer->stop();
+    m_paused = false;
+    m_next = m_records.size();
+}
+
+void S101Replayer::setPaused(bool paused)
+{
+    if (paused == m_paused || m_next >= m_records.size()) {
+        return;
+    }
+
+    qint64 nowUs = m_clock.nsecsElapsed() / 1000;
+    if (paused) {
+        m_timer->stop();
+        m_pausedAtUs = nowUs;
+        m_paused = true;
+    } else {
+        m_offsetUs += nowUs - m_pausedAtUs;
+        m_paused = false;
+        m_timer->start(0);
+    }
+}
+
+qint64 S101Replayer::dueUs(int index) const
+{
+    qint64 recordedUs = m_records[index].timestampUs - m_records.first().timestampUs;
+    return qint64(std::llround(recordedUs / m_speed));
+}
+
+void S101Replayer::emitDue()
+{
+    if (m_timing == AsFastAsPossible) {
+        // Sliced so a socket consumer still gets event loop turns to flush
+        int end = qMin(m_next + FAST_CHUNKS_PER_SLICE, int(m_records.size()));
+        while (m_next < end && !m_paused) {
+            emit dataReady(m_records[m_next++].data);
+        }
+    } else {
+        qint64 nowUs = m_clock.nsecsElapsed() / 1000 - m_offsetUs;
+        while (m_next < m_records.size() && !m_paused && dueUs(m_next) <= nowUs) {
+            emit dataReady(m_records[m_next++].data);
+        }
+    }
+
+    if (m_paused) {
+        return;
+    }
+    if (m_next >= m_records.size()) {
+        emit finished();
+        return;
+    }
+
+    if (m_timing == AsFastAsPossible) {
+        m_timer->start(0);
+    } else {
+        qint64 waitUs = dueUs(m_next) - (m_clock.nsecsElapsed() / 1000 - m_offsetUs);
+        m_timer->start(int(qMax<qint64>(0, waitUs / 1000)));
+    }
+}
@@ -13,19 +13,46 @@
 #include "VirtualizedMatrixWidget.h"
 #include "EmberDataTypes.h"
 #include "FunctionInvoker.h"
+#include "EmberTreeModel.h"
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QDateTime>
 #include <QRegularExpression>
-#include <QTreeWidgetItemIterator>
 
-SnapshotManager::SnapshotManager(QTreeWidget* treeWidget,
+namespace {
+
+// Every row of the model, parents before their children
+QModelIndexList allIndexes(const QAbstractItemModel* model)
+{
+    QModelIndexList indexes;
+    QModelIndexList pending;
+    for (int row = model->rowCount() - 1; row >= 0; --row) {
+        pending.append(model->index(row, 0));
+    }
+    while (!pending.isEmpty()) {
+        QModelIndex index = pending.takeLast();
+        indexes.append(index);
+        for (int row = model->rowCount(index) - 1; row >= 0; --row) {
+            pending.append(model->index(row, 0, index));
+        }
+    }
+    return indexes;
+}
+
+QString columnText(const QModelIndex& index, int column)
+{
+    return index.siblingAtColumn(column).data().toString();
+}
+
+}
+
+SnapshotManager::SnapshotManager(EmberTreeModel* treeModel,
                                  EmberConnection* connection,
                                  MatrixManager* matrixManager,
                                  FunctionInvoker* functionInvoker,
                                  QWidget* parent)
     : QObject(parent)
-    , m_treeWidget(treeWidget)
+    , m_treeModel(treeModel)
     , m_connection(connection)
     , m_matrixManager(matrixManager)
     , m_functionInvoker(functionInvoker)
@@ -66,13 +93,11 @@ void SnapshotManager::saveSnapshot(QLineEdit* hostEdit, QSpinBox* portSpin)
     if (reply == QMessageBox::Yes) {
         
         QStringList allPaths;
-        QTreeWidgetItemIterator it(m_treeWidget);
-        while (*it) {
-            QString path = (*it)->data(0, Qt::UserRole).toString();
+        for (const QModelIndex& index : allIndexes(m_treeModel)) {
+            QString path = index.data(Qt::UserRole).toString();
             if (!path.isEmpty()) {
                 allPaths.append(path);
             }
-            ++it;
         }
         
         if (allPaths.isEmpty()) {
@@ -120,7 +145,7 @@ QString SnapshotManager::generateDefaultFilename(const QString& deviceName)
     }
     
     QString timestamp = QDateTime::currentDateTime().toString("ddMMyyyy");
-    return QString("%1_%2.json").arg(sanitized).arg(timestamp);
+    return QString("%1_%2.evsnap").arg(sanitized).arg(timestamp);
 }
 
 void SnapshotManager::proceedWithSnapshot(QLineEdit* hostEdit, QSpinBox* portSpin)
@@ -129,9 +154,8 @@ void SnapshotManager::proceedWithSnapshot(QLineEdit* hostEdit, QSpinBox* portSpi
     QString deviceName;
     
     
-    if (m_treeWidget->topLevelItemCount() > 0) {
-        QTreeWidgetItem* firstRoot = m_treeWidget->topLevelItem(0);
-        deviceName = firstRoot->text(0);
+    if (m_treeModel->rowCount() > 0) {
+        deviceName = m_treeModel->index(0, EmberTreeModel::NameColumn).data().toString();
     }
     
     
@@ -141,11 +165,13 @@ void SnapshotManager::proceedWithSnapshot(QLineEdit* hostEdit, QSpinBox* portSpi
     
     QString defaultName = generateDefaultFilename(deviceName);
     
+    QString selectedFilter;
     QString fileName = QFileDialog::getSaveFileName(
         qobject_cast<QWidget*>(parent()),
         "Save Ember Device",
         defaultName,
-        "Ember Device Files (*.json);;All Files (*)"
+        "Ember Device Snapshots (*.evsnap);;JSON Export (*.json);;All Files (*)",
+        &selectedFilter
     );
     
     if (fileName.isEmpty()) {
@@ -156,7 +182,13 @@ void SnapshotManager::proceedWithSnapshot(QLineEdit* hostEdit, QSpinBox* portSpi
     DeviceSnapshot snapshot = captureSnapshot(hostEdit, portSpin);
     
     
-    if (snapshot.saveToFile(fileName)) {
+    // JSON is an export format, everything else is written as a binary snapshot
+    DeviceSnapshot::FileFormat format = DeviceSnapshot::Binary;
+    if (selectedFilter.startsWith("JSON") || fileName.endsWith(".json", Qt::CaseInsensitive)) {
+        format = DeviceSnapshot::Json;
+    }
+    
+    if (snapshot.saveToFile(fileName, format)) {
         QString successMsg = QString("Device saved successfully!\n\n"
             "%1 nodes\n%2 parameters\n%3 matrices\n%4 functions")
             .arg(snapshot.nodeCount())
@@ -181,9 +213,8 @@ DeviceSnapshot SnapshotManager::captureSnapshot(QLineEdit* hostEdit, QSpinBox* p
     
     
     
-    if (m_treeWidget->topLevelItemCount() > 0) {
-        QTreeWidgetItem* firstRoot = m_treeWidget->topLevelItem(0);
-        snapshot.deviceName = firstRoot->text(0);
+    if (m_treeModel->rowCount() > 0) {
+        snapshot.deviceName = m_treeModel->index(0, EmberTreeModel::NameColumn).data().toString();
     }
     
     if (snapshot.deviceName.isEmpty()) {
@@ -195,26 +226,24 @@ DeviceSnapshot SnapshotManager::captureSnapshot(QLineEdit* hostEdit, QSpinBox* p
     snapshot.captureTime = QDateTime::currentDateTime();
     
     
-    QTreeWidgetItemIterator it(m_treeWidget);
-    while (*it) {
-        QString path = (*it)->data(0, Qt::UserRole).toString();
-        QString type = (*it)->text(1);
+    for (const QModelIndex& index : allIndexes(m_treeModel)) {
+        QString path = index.data(Qt::UserRole).toString();
+        QString type = columnText(index, EmberTreeModel::TypeColumn);
         
         if (path.isEmpty()) {
-            ++it;
             continue;
         }
         
         if (type == "Node") {
             NodeData nodeData;
             nodeData.path = path;
-            nodeData.identifier = (*it)->text(0);
+            nodeData.identifier = columnText(index, EmberTreeModel::NameColumn);
             nodeData.description = "";  
-            nodeData.isOnline = (*it)->data(0, Qt::UserRole + 4).toBool();
+            nodeData.isOnline = index.data(Qt::UserRole + 4).toBool();
             
             
-            for (int i = 0; i < (*it)->childCount(); ++i) {
-                QString childPath = (*it)->child(i)->data(0, Qt::UserRole).toString();
+            for (int i = 0; i < m_treeModel->rowCount(index); ++i) {
+                QString childPath = m_treeModel->index(i, EmberTreeModel::NameColumn, index).data(Qt::UserRole).toString();
                 if (!childPath.isEmpty()) {
                     nodeData.childPaths.append(childPath);
                 }
@@ -225,22 +254,23 @@ DeviceSnapshot SnapshotManager::captureSnapshot(QLineEdit* hostEdit, QSpinBox* p
         } else if (type == "Parameter") {
             ParameterData paramData;
             paramData.path = path;
-            paramData.identifier = (*it)->text(0);
-            paramData.value = (*it)->text(2);
-            paramData.type = (*it)->data(0, Qt::UserRole + 1).toInt();
-            paramData.access = (*it)->data(0, Qt::UserRole + 2).toInt();
-            paramData.minimum = (*it)->data(0, Qt::UserRole + 3);
-            paramData.maximum = (*it)->data(0, Qt::UserRole + 4);
-            paramData.enumOptions = (*it)->data(0, Qt::UserRole + 5).toStringList();
+            paramData.identifier = columnText(index, EmberTreeModel::NameColumn);
+            paramData.value = columnText(index, EmberTreeModel::ValueColumn);
+            paramData.type = index.data(Qt::UserRole + 1).toInt();
+            paramData.access = index.data(Qt::UserRole + 2).toInt();
+            paramData.minimum = index.data(Qt::UserRole + 3);
+            paramData.maximum = index.data(Qt::UserRole + 4);
+            paramData.enumOptions = index.data(Qt::UserRole + 5).toStringList();
             
             
-            QList<QVariant> enumVarList = (*it)->data(0, Qt::UserRole + 6).toList();
+            QList<QVariant> enumVarList = index.data(Qt::UserRole + 6).toList();
             for (const QVariant& var : enumVarList) {
                 paramData.enumValues.append(var.toInt());
             }
             
-            paramData.isOnline = (*it)->data(0, Qt::UserRole + 8).toBool();
-            paramData.streamIdentifier = (*it)->data(0, Qt::UserRole + 9).toInt();
+            paramData.isOnline = index.data(Qt::UserRole + 8).toBool();
+            paramData.streamIdentifier = index.data(Qt::UserRole + 9).toInt();
+            paramData.streamOffset = index.data(Qt::UserRole + 14).toInt();
             
             snapshot.parameters[path] = paramData;
             
@@ -251,11 +281,11 @@ DeviceSnapshot SnapshotManager::captureSnapshot(QLineEdit* hostEdit, QSpinBox* p
             if (matrixWidget) {
                 MatrixData matrixData;
                 matrixData.path = path;
-                matrixData.identifier = (*it)->text(0);
+                matrixData.identifier = columnText(index, EmberTreeModel::NameColumn);
                 matrixData.description = "";
                 
                 
-                QString sizeText = (*it)->text(2);
+                QString sizeText = columnText(index, EmberTreeModel::ValueColumn);
                 QStringList sizeParts = sizeText.split(QChar(0x00D7));  
                 if (sizeParts.size() == 2) {
                     matrixData.sourceCount = sizeParts[0].toInt();
@@ -270,18 +300,14 @@ DeviceSnapshot SnapshotManager::captureSnapshot(QLineEdit* hostEdit, QSpinBox* p
                 
                 
                 for (int targetIdx : matrixData.targetNumbers) {
-                    QString label = matrixWidget->getTargetLabel(targetIdx);
-                    
-                    if (!label.isEmpty() && label != QString("Target %1").arg(targetIdx)) {
-                        matrixData.targetLabels[targetIdx] = label;
+                    if (matrixWidget->hasTargetLabel(targetIdx)) {
+                        matrixData.targetLabels[targetIdx] = matrixWidget->getTargetLabel(targetIdx);
                     }
                 }
                 
                 for (int sourceIdx : matrixData.sourceNumbers) {
-                    QString srcLabel = matrixWidget->getSourceLabel(sourceIdx);
-                    
-                    if (!srcLabel.isEmpty() && srcLabel != QString("Source %1").arg(sourceIdx)) {
-                        matrixData.sourceLabels[sourceIdx] = srcLabel;
+                    if (matrixWidget->hasSourceLabel(sourceIdx)) {
+                        matrixData.sourceLabels[sourceIdx] = matrixWidget->getSourceLabel(sourceIdx);
                     }
                 }
                 
@@ -312,14 +338,11 @@ DeviceSnapshot SnapshotManager::captureSnapshot(QLineEdit* hostEdit, QSpinBox* p
                 snapshot.functions[path] = funcData;
             }
         }
-        
-        ++it;
     }
     
     
-    for (int i = 0; i < m_treeWidget->topLevelItemCount(); ++i) {
-        QTreeWidgetItem* item = m_treeWidget->topLevelItem(i);
-        QString path = item->data(0, Qt::UserRole).toString();
+    for (int i = 0; i < m_treeModel->rowCount(); ++i) {
+        QString path = m_treeModel->index(i, EmberTreeModel::NameColumn).data(Qt::UserRole).toString();
         if (!path.isEmpty()) {
             snapshot.rootPaths.append(path);
         }
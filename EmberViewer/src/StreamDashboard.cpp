@@ -0,0 +1,380 @@
+#include "StreamDashboard.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QContextMenuEvent>
+#include <QMenu>
+#include <QActionGroup>
+#include <QDebug>
+#include <cmath>
+
+StreamDashboard::StreamDashboard(QWidget *parent)
+    : QWidget(parent)
+    , m_meterType(MeterWidget::MeterType::VU_METER)
+    , m_riseTime(0.3)
+    , m_fallTime(0.3)
+    , m_animationTimer(new QTimer(this))
+    , m_lastTick(0)
+{
+    MeterWidget::getMeterConstants(m_meterType, m_riseTime, m_fallTime);
+
+    m_animationTimer->setTimerType(Qt::PreciseTimer);
+    m_animationTimer->setInterval(FRAME_INTERVAL_MS);
+    connect(m_animationTimer, &QTimer::timeout, this, &StreamDashboard::onAnimationTick);
+    m_clock.start();
+
+    QSizePolicy policy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+    policy.setHeightForWidth(true);
+    setSizePolicy(policy);
+    setMinimumWidth(CELL_WIDTH);
+}
+
+int StreamDashboard::addMeter(const QString &path, const QString &label, int streamIdentifier, int streamOffset,
+                              double minValue, double maxValue)
+{
+    auto existing = m_pathToMeter.constFind(path);
+    if (existing != m_pathToMeter.constEnd()) {
+        return existing.value();
+    }
+    quint64 key = EmberData::streamKey(streamIdentifier, streamOffset);
+    auto existingStream = m_streamToMeter.constFind(key);
+    if (existingStream != m_streamToMeter.constEnd()) {
+        qDebug().noquote() << QString("Stream %1/%2 of %3 is already shown by %4")
+                              .arg(streamIdentifier).arg(streamOffset).arg(path, m_paths[existingStream.value()]);
+        return existingStream.value();
+    }
+
+    int index = m_paths.size();
+    m_paths.append(path);
+    m_labels.append(label);
+    m_streamKeys.append(key);
+    m_minValues.append(minValue);
+    m_ranges.append(maxValue > minValue ? maxValue - minValue : 1.0);
+    m_targetValues.append(minValue);
+    m_displayValues.append(minValue);
+    m_peakValues.append(minValue);
+    m_peakExpiry.append(0);
+    m_drawnLevels.append(0);
+    m_drawnPeaks.append(-1);
+
+    m_streamToMeter.insert(key, index);
+    m_pathToMeter.insert(path, index);
+
+    updateGeometry();
+    update();
+    return index;
+}
+
+bool StreamDashboard::removeMeter(const QString &path)
+{
+    int index = m_pathToMeter.value(path, -1);
+    if (index < 0) {
+        return false;
+    }
+
+    m_streamToMeter.remove(m_streamKeys[index]);
+    m_pathToMeter.remove(path);
+
+    // Move the last meter into the freed slot so the arrays stay dense
+    int last = m_paths.size() - 1;
+    if (index != last) {
+        m_paths[index] = m_paths[last];
+        m_labels[index] = m_labels[last];
+        m_streamKeys[index] = m_streamKeys[last];
+        m_minValues[index] = m_minValues[last];
+        m_ranges[index] = m_ranges[last];
+        m_targetValues[index] = m_targetValues[last];
+        m_displayValues[index] = m_displayValues[last];
+        m_peakValues[index] = m_peakValues[last];
+        m_peakExpiry[index] = m_peakExpiry[last];
+        m_drawnLevels[index] = m_drawnLevels[last];
+        m_drawnPeaks[index] = m_drawnPeaks[last];
+        m_streamToMeter.insert(m_streamKeys[index], index);
+        m_pathToMeter.insert(m_paths[index], index);
+    }
+
+    m_paths.removeLast();
+    m_labels.removeLast();
+    m_streamKeys.removeLast();
+    m_minValues.removeLast();
+    m_ranges.removeLast();
+    m_targetValues.removeLast();
+    m_displayValues.removeLast();
+    m_peakValues.removeLast();
+    m_peakExpiry.removeLast();
+    m_drawnLevels.removeLast();
+    m_drawnPeaks.removeLast();
+
+    updateGeometry();
+    update();
+    return true;
+}
+
+bool StreamDashboard::hasMeter(const QString &path) const
+{
+    return m_pathToMeter.contains(path);
+}
+
+void StreamDashboard::clear()
+{
+    m_paths.clear();
+    m_labels.clear();
+    m_streamKeys.clear();
+    m_minValues.clear();
+    m_ranges.clear();
+    m_targetValues.clear();
+    m_displayValues.clear();
+    m_peakValues.clear();
+    m_peakExpiry.clear();
+    m_drawnLevels.clear();
+    m_drawnPeaks.clear();
+    m_streamToMeter.clear();
+    m_pathToMeter.clear();
+
+    m_animationTimer->stop();
+    updateGeometry();
+    update();
+}
+
+void StreamDashboard::setMeterType(MeterWidget::MeterType type)
+{
+    m_meterType = type;
+    MeterWidget::getMeterConstants(type, m_riseTime, m_fallTime);
+    startAnimation();
+}
+
+void StreamDashboard::updateStreamValues(const QVector<EmberData::StreamValue> &values)
+{
+    bool updated = false;
+    qint64 now = m_clock.elapsed();
+
+    for (const EmberData::StreamValue &streamValue : values) {
+        int index = m_streamToMeter.value(EmberData::streamKey(streamValue.streamIdentifier, streamValue.offset), -1);
+        if (index < 0) {
+            continue;
+        }
+
+        m_targetValues[index] = streamValue.value;
+        if (streamValue.value > m_peakValues[index] || m_peakExpiry[index] == 0) {
+            m_peakValues[index] = streamValue.value;
+            m_peakExpiry[index] = now + PEAK_HOLD_MS;
+        }
+        updated = true;
+    }
+
+    if (updated) {
+        startAnimation();
+    }
+}
+
+void StreamDashboard::startAnimation()
+{
+    if (!m_animationTimer->isActive() && isVisible() && !m_paths.isEmpty()) {
+        m_lastTick = m_clock.elapsed();
+        m_animationTimer->start();
+    }
+}
+
+void StreamDashboard::onAnimationTick()
+{
+    qint64 now = m_clock.elapsed();
+    double dt = (now - m_lastTick) / 1000.0;
+    m_lastTick = now;
+
+    if (dt < 0.001) dt = 0.001;
+    if (dt > 1.0) dt = 1.0;
+
+    // Rise and fall coefficients are the same for every meter on this tick
+    const double riseAlpha = 1.0 - std::exp(-dt / m_riseTime);
+    const double fallAlpha = 1.0 - std::exp(-dt / m_fallTime);
+
+    const int count = m_paths.size();
+    const double *targets = m_targetValues.constData();
+    double *displays = m_displayValues.data();
+    for (int i = 0; i < count; ++i) {
+        double delta = targets[i] - displays[i];
+        displays[i] += (delta > 0.0 ? riseAlpha : fallAlpha) * delta;
+    }
+
+    qint64 *peakExpiry = m_peakExpiry.data();
+    for (int i = 0; i < count; ++i) {
+        if (peakExpiry[i] != 0 && now >= peakExpiry[i]) {
+            peakExpiry[i] = 0;
+        }
+    }
+
+    // Repaint only the cells whose bar or peak marker moved by at least a pixel
+    bool animating = false;
+    for (int i = 0; i < count; ++i) {
+        int level = levelPixels(i, displays[i]);
+        int peak = peakExpiry[i] != 0 ? levelPixels(i, m_peakValues[i]) : -1;
+        if (level != m_drawnLevels[i] || peak != m_drawnPeaks[i]) {
+            m_drawnLevels[i] = level;
+            m_drawnPeaks[i] = peak;
+            update(meterRect(i));
+        }
+        if (peak >= 0 || level != levelPixels(i, targets[i])) {
+            animating = true;
+        }
+    }
+
+    if (!animating) {
+        m_animationTimer->stop();
+    }
+}
+
+int StreamDashboard::levelPixels(int index, double value) const
+{
+    int barHeight = CELL_HEIGHT - LABEL_HEIGHT - 12;
+    double normalized = qBound(0.0, (value - m_minValues[index]) / m_ranges[index], 1.0);
+    return static_cast<int>(normalized * barHeight);
+}
+
+int StreamDashboard::columnCount() const
+{
+    return qMax(1, width() / CELL_WIDTH);
+}
+
+QRect StreamDashboard::meterRect(int index) const
+{
+    int columns = columnCount();
+    return QRect((index % columns) * CELL_WIDTH, (index / columns) * CELL_HEIGHT, CELL_WIDTH, CELL_HEIGHT);
+}
+
+int StreamDashboard::meterAt(const QPoint &pos) const
+{
+    if (pos.x() < 0 || pos.y() < 0) {
+        return -1;
+    }
+    int column = pos.x() / CELL_WIDTH;
+    int columns = columnCount();
+    if (column >= columns) {
+        return -1;
+    }
+    int index = (pos.y() / CELL_HEIGHT) * columns + column;
+    return index < m_paths.size() ? index : -1;
+}
+
+int StreamDashboard::heightForWidth(int width) const
+{
+    int columns = qMax(1, width / CELL_WIDTH);
+    int rows = (m_paths.size() + columns - 1) / columns;
+    return qMax(1, rows) * CELL_HEIGHT;
+}
+
+QSize StreamDashboard::sizeHint() const
+{
+    int width = CELL_WIDTH * 8;
+    return QSize(width, heightForWidth(width));
+}
+
+void StreamDashboard::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.fillRect(event->rect(), QColor(30, 30, 30));
+
+    if (m_paths.isEmpty()) {
+        painter.setPen(QColor(150, 150, 150));
+        painter.drawText(rect(), Qt::AlignCenter | Qt::TextWordWrap,
+                         "Right-click a stream parameter in the tree to add it to the dashboard");
+        return;
+    }
+
+    // Only the rows intersecting the exposed region are visited
+    int columns = columnCount();
+    int firstRow = event->rect().top() / CELL_HEIGHT;
+    int lastRow = event->rect().bottom() / CELL_HEIGHT;
+    int first = qMax(0, firstRow * columns);
+    int last = qMin(m_paths.size() - 1, (lastRow + 1) * columns - 1);
+
+    int barHeight = CELL_HEIGHT - LABEL_HEIGHT - 12;
+    int greenHeight = static_cast<int>(0.7 * barHeight);
+    int yellowHeight = static_cast<int>(0.9 * barHeight);
+
+    QFont labelFont = font();
+    labelFont.setPointSizeF(labelFont.pointSizeF() * 0.8);
+    painter.setFont(labelFont);
+
+    for (int i = first; i <= last; ++i) {
+        QRect cell = meterRect(i);
+        if (!cell.intersects(event->rect())) {
+            continue;
+        }
+
+        QRect bar(cell.left() + (CELL_WIDTH - BAR_WIDTH) / 2, cell.top() + 6, BAR_WIDTH, barHeight);
+        painter.fillRect(bar, QColor(40, 40, 40));
+
+        int level = m_drawnLevels[i];
+        int bottom = bar.bottom() + 1;
+        if (level > 0) {
+            int greenPart = qMin(level, greenHeight);
+            painter.fillRect(QRect(bar.left(), bottom - greenPart, BAR_WIDTH, greenPart), QColor(0, 200, 0));
+        }
+        if (level > greenHeight) {
+            int yellowPart = qMin(level, yellowHeight) - greenHeight;
+            painter.fillRect(QRect(bar.left(), bottom - greenHeight - yellowPart, BAR_WIDTH, yellowPart), QColor(255, 200, 0));
+        }
+        if (level > yellowHeight) {
+            int redPart = level - yellowHeight;
+            painter.fillRect(QRect(bar.left(), bottom - yellowHeight - redPart, BAR_WIDTH, redPart), QColor(255, 0, 0));
+        }
+
+        if (m_drawnPeaks[i] >= 0) {
+            int peakY = bottom - m_drawnPeaks[i];
+            painter.setPen(QPen(Qt::white, 2));
+            painter.drawLine(bar.left(), peakY, bar.right(), peakY);
+        }
+
+        painter.setPen(QColor(100, 100, 100));
+        painter.drawRect(bar);
+
+        QRect labelRect(cell.left() + 1, cell.bottom() - LABEL_HEIGHT, CELL_WIDTH - 2, LABEL_HEIGHT);
+        painter.setPen(QColor(200, 200, 200));
+        painter.drawText(labelRect, Qt::AlignCenter,
+                         painter.fontMetrics().elidedText(m_labels[i], Qt::ElideRight, labelRect.width()));
+    }
+}
+
+void StreamDashboard::contextMenuEvent(QContextMenuEvent *event)
+{
+    QMenu menu(this);
+
+    int index = meterAt(event->pos());
+    QAction *removeAction = nullptr;
+    if (index >= 0) {
+        removeAction = menu.addAction(QString("Remove %1").arg(m_labels[index]));
+        menu.addSeparator();
+    }
+
+    QMenu *typeMenu = menu.addMenu("Meter Type");
+    QActionGroup *typeGroup = new QActionGroup(typeMenu);
+    const QList<QPair<QString, MeterWidget::MeterType>> types = {
+        {"VU Meter (300ms)", MeterWidget::MeterType::VU_METER},
+        {"Digital Peak (Instant)", MeterWidget::MeterType::DIGITAL_PEAK},
+        {"DIN PPM (10ms/1.5s)", MeterWidget::MeterType::DIN_PPM},
+        {"BBC PPM (4ms/2.8s)", MeterWidget::MeterType::BBC_PPM}
+    };
+    for (const auto &type : types) {
+        QAction *action = typeMenu->addAction(type.first);
+        action->setCheckable(true);
+        action->setChecked(type.second == m_meterType);
+        action->setActionGroup(typeGroup);
+        connect(action, &QAction::triggered, this, [this, type]() { setMeterType(type.second); });
+    }
+
+    QAction *selected = menu.exec(event->globalPos());
+    if (selected && selected == removeAction) {
+        emit meterRemoveRequested(m_paths[index]);
+    }
+}
+
+void StreamDashboard::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    startAnimation();
+}
+
+void StreamDashboard::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_animationTimer->stop();
+}
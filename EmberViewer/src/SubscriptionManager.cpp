@@ -11,148 +11,243 @@
 
 #include "SubscriptionManager.h"
 #include "EmberConnection.h"
-#include <QTreeWidget>
-#include <QTreeWidgetItemIterator>
+#include <QTreeView>
+#include <QScrollBar>
+#include <QEvent>
 #include <QDebug>
 
 SubscriptionManager::SubscriptionManager(EmberConnection *connection, QObject *parent)
     : QObject(parent)
     , m_connection(connection)
+    , m_treeView(nullptr)
 {
+    m_clock.start();
+
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    connect(m_flushTimer, &QTimer::timeout, this, &SubscriptionManager::flushPending);
+
+    // Scrolling fires many times per second, the visible rows are only looked at once it settles
+    m_visibilityTimer = new QTimer(this);
+    m_visibilityTimer->setSingleShot(true);
+    m_visibilityTimer->setInterval(VISIBILITY_DELAY_MS);
+    connect(m_visibilityTimer, &QTimer::timeout, this, &SubscriptionManager::updateVisibleItems);
 }
 
 SubscriptionManager::~SubscriptionManager()
 {
 }
 
+void SubscriptionManager::acquire(const QString &path, const QString &type)
+{
+    acquire(EmberPath::fromString(path), path, type);
+}
+
+void SubscriptionManager::acquire(EmberPath key, const QString &path, const QString &type)
+{
+    if (key.isEmpty() || type.isEmpty()) {
+        return;
+    }
+
+    Subscription &subscription = m_subscriptions[key];
+    subscription.path = path;
+    subscription.type = type;
+    if (++subscription.refs > 1) {
+        return;
+    }
+
+    // Released earlier but still subscribed on the device, keep it
+    if (m_pendingUnsubscribe.remove(key)) {
+        return;
+    }
+
+    if (!subscription.subscribed) {
+        m_pendingSubscribe.insert(key);
+        scheduleFlush();
+    }
+}
+
+void SubscriptionManager::release(const QString &path)
+{
+    release(EmberPath::find(path));
+}
+
+void SubscriptionManager::release(EmberPath key)
+{
+    auto it = m_subscriptions.find(key);
+    if (it == m_subscriptions.end() || it->refs == 0) {
+        return;
+    }
+
+    if (--it->refs > 0) {
+        return;
+    }
+
+    // Never sent, nothing to undo on the device
+    if (m_pendingSubscribe.remove(key)) {
+        m_subscriptions.erase(it);
+        return;
+    }
+
+    it->releasedAt = m_clock.elapsed();
+    m_pendingUnsubscribe.insert(key);
+    scheduleFlush();
+}
+
+int SubscriptionManager::refCount(const QString &path) const
+{
+    auto it = m_subscriptions.constFind(EmberPath::find(path));
+    return it != m_subscriptions.constEnd() ? it->refs : 0;
+}
+
 bool SubscriptionManager::isSubscribed(const QString &path) const
 {
-    return m_subscribedPaths.contains(path);
+    return m_subscriptions.contains(EmberPath::find(path));
 }
 
 void SubscriptionManager::clear()
 {
-    m_subscribedPaths.clear();
-    m_subscriptionStates.clear();
+    m_flushTimer->stop();
+    m_visibilityTimer->stop();
+    m_subscriptions.clear();
+    m_pendingSubscribe.clear();
+    m_pendingUnsubscribe.clear();
+    m_visibleItems.clear();
 }
 
-void SubscriptionManager::onItemExpanded(QTreeWidgetItem *item)
+void SubscriptionManager::setTreeView(QTreeView *treeView)
 {
-    QString path = item->data(0, Qt::UserRole).toString();
-    QString type = item->text(1);
-    
-    if (path.isEmpty()) {
+    m_treeView = treeView;
+
+    connect(treeView->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &SubscriptionManager::scheduleVisibilityUpdate);
+    connect(treeView->model(), &QAbstractItemModel::rowsInserted,
+            this, &SubscriptionManager::scheduleVisibilityUpdate);
+    connect(treeView->model(), &QAbstractItemModel::rowsRemoved,
+            this, &SubscriptionManager::scheduleVisibilityUpdate);
+    connect(treeView->model(), &QAbstractItemModel::modelReset,
+            this, &SubscriptionManager::scheduleVisibilityUpdate);
+    treeView->viewport()->installEventFilter(this);
+}
+
+void SubscriptionManager::onItemExpanded(const QModelIndex &index)
+{
+    Q_UNUSED(index);
+    scheduleVisibilityUpdate();
+}
+
+void SubscriptionManager::onItemCollapsed(const QModelIndex &index)
+{
+    Q_UNUSED(index);
+    scheduleVisibilityUpdate();
+}
+
+void SubscriptionManager::subscribeToExpandedItems(QTreeView *treeView)
+{
+    if (!m_treeView) {
+        setTreeView(treeView);
+    }
+    updateVisibleItems();
+}
+
+bool SubscriptionManager::eventFilter(QObject *watched, QEvent *event)
+{
+    if (m_treeView && watched == m_treeView->viewport() &&
+        (event->type() == QEvent::Resize || event->type() == QEvent::Show)) {
+        scheduleVisibilityUpdate();
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void SubscriptionManager::scheduleVisibilityUpdate()
+{
+    if (!m_visibilityTimer->isActive()) {
+        m_visibilityTimer->start();
+    }
+}
+
+void SubscriptionManager::updateVisibleItems()
+{
+    if (!m_treeView) {
         return;
     }
-    
-    
-    
-    QList<EmberConnection::SubscriptionRequest> subscriptions;
-    
-    
-    if (!m_subscribedPaths.contains(path) && !type.isEmpty()) {
-        subscriptions.append({path, type});
-        m_subscribedPaths.insert(path);
-        SubscriptionState state;
-        state.subscribedAt = QDateTime::currentDateTime();
-        state.autoSubscribed = true;
-        m_subscriptionStates[path] = state;
-    }
-    
-    
-    for (int i = 0; i < item->childCount(); i++) {
-        QTreeWidgetItem *child = item->child(i);
-        QString childPath = child->data(0, Qt::UserRole).toString();
-        QString childType = child->text(1);
-        
-        if (!childPath.isEmpty() && !childType.isEmpty() && 
-            !m_subscribedPaths.contains(childPath) &&
-            childType != "Loading...") {  
-            
-            subscriptions.append({childPath, childType});
-            m_subscribedPaths.insert(childPath);
-            SubscriptionState state;
-            state.subscribedAt = QDateTime::currentDateTime();
-            state.autoSubscribed = true;
-            m_subscriptionStates[childPath] = state;
+
+    QSet<EmberPath> visible;
+    int bottom = m_treeView->viewport()->height();
+
+    for (QModelIndex index = m_treeView->indexAt(QPoint(1, 1)); index.isValid(); index = m_treeView->indexBelow(index)) {
+        if (m_treeView->visualRect(index).top() >= bottom) {
+            break;
+        }
+
+        QString path = index.data(Qt::UserRole).toString();
+        QString type = index.siblingAtColumn(1).data().toString();
+        // Nodes and functions have no values to stream, subscribing them only costs traffic
+        if (path.isEmpty() || (type != "Parameter" && type != "Matrix")) {
+            continue;
+        }
+
+        EmberPath key = EmberPath::fromString(path);
+        visible.insert(key);
+        if (!m_visibleItems.contains(key)) {
+            acquire(key, path, type);
         }
     }
-    
-    
-    if (!subscriptions.isEmpty()) {
-        if (subscriptions.size() == 1) {
-            
-            const auto& req = subscriptions.first();
-            if (req.type == "Node") {
-                m_connection->subscribeToNode(req.path, true);
-            } else if (req.type == "Parameter") {
-                m_connection->subscribeToParameter(req.path, true);
-            } else if (req.type == "Matrix") {
-                m_connection->subscribeToMatrix(req.path, true);
-            }
-        } else {
-            
-            qDebug().noquote() << QString("Batch subscribing to %1 paths (expanded: %2)")
-                .arg(subscriptions.size()).arg(path);
-            m_connection->sendBatchSubscribe(subscriptions);
+
+    for (const EmberPath &key : std::as_const(m_visibleItems)) {
+        if (!visible.contains(key)) {
+            release(key);
         }
     }
+
+    m_visibleItems = visible;
 }
 
-void SubscriptionManager::onItemCollapsed(QTreeWidgetItem *item)
+void SubscriptionManager::scheduleFlush()
 {
-    QString path = item->data(0, Qt::UserRole).toString();
-    QString type = item->text(1);
-    
-    if (path.isEmpty() || !m_subscribedPaths.contains(path)) {
-        return;  
+    if (!m_flushTimer->isActive() || m_flushTimer->remainingTime() > FLUSH_DELAY_MS) {
+        m_flushTimer->start(FLUSH_DELAY_MS);
     }
-    
-    
-    if (m_subscriptionStates.contains(path) && m_subscriptionStates[path].autoSubscribed) {
-        if (type == "Node") {
-            m_connection->unsubscribeFromNode(path);
-        } else if (type == "Parameter") {
-            m_connection->unsubscribeFromParameter(path);
-        } else if (type == "Matrix") {
-            m_connection->unsubscribeFromMatrix(path);
-        }
-        
-        m_subscribedPaths.remove(path);
-        m_subscriptionStates.remove(path);
-    }
-}
-
-void SubscriptionManager::subscribeToExpandedItems(QTreeWidget *treeWidget)
-{
-    
-    
-    
-    
-    QList<EmberConnection::SubscriptionRequest> subscriptions;
-    
-    QTreeWidgetItemIterator it(treeWidget);
-    while (*it) {
-        if ((*it)->isExpanded()) {
-            QString path = (*it)->data(0, Qt::UserRole).toString();
-            QString type = (*it)->text(1);
-            
-            if (!path.isEmpty() && !type.isEmpty() && !m_subscribedPaths.contains(path)) {
-                subscriptions.append({path, type});
-                m_subscribedPaths.insert(path);
-                
-                SubscriptionState state;
-                state.subscribedAt = QDateTime::currentDateTime();
-                state.autoSubscribed = true;
-                m_subscriptionStates[path] = state;
-            }
+}
+
+void SubscriptionManager::flushPending()
+{
+    QList<EmberConnection::SubscriptionRequest> subscribe;
+    for (const EmberPath &key : std::as_const(m_pendingSubscribe)) {
+        Subscription &subscription = m_subscriptions[key];
+        subscription.subscribed = true;
+        subscribe.append({subscription.path, subscription.type});
+    }
+    m_pendingSubscribe.clear();
+
+    QList<EmberConnection::SubscriptionRequest> unsubscribe;
+    qint64 now = m_clock.elapsed();
+    qint64 nextDue = -1;
+    for (auto it = m_pendingUnsubscribe.begin(); it != m_pendingUnsubscribe.end();) {
+        auto subscription = m_subscriptions.find(*it);
+        qint64 due = subscription->releasedAt + UNSUBSCRIBE_DELAY_MS;
+        if (due > now) {
+            nextDue = nextDue < 0 ? due : qMin(nextDue, due);
+            ++it;
+            continue;
         }
-        ++it;
+
+        unsubscribe.append({subscription->path, subscription->type});
+        m_subscriptions.erase(subscription);
+        it = m_pendingUnsubscribe.erase(it);
     }
-    
-    if (!subscriptions.isEmpty()) {
-        qDebug().noquote() << QString("Batch subscribing to %1 expanded items after tree population")
-            .arg(subscriptions.size());
-        m_connection->sendBatchSubscribe(subscriptions);
+
+    if (!subscribe.isEmpty()) {
+        qDebug().noquote() << QString("Subscribing to %1 paths (%2 referenced)")
+            .arg(subscribe.size()).arg(m_subscriptions.size());
+        m_connection->sendBatchSubscribe(subscribe);
+    }
+    if (!unsubscribe.isEmpty()) {
+        qDebug().noquote() << QString("Unsubscribing from %1 paths no longer shown").arg(unsubscribe.size());
+        m_connection->sendBatchUnsubscribe(unsubscribe);
+    }
+
+    if (nextDue >= 0) {
+        m_flushTimer->start(int(nextDue - now));
     }
 }
@@ -0,0 +1,124 @@
+#include "SyntheticDeviceDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QDialogButtonBox>
+#include <QLocale>
+
+SyntheticDeviceDialog::SyntheticDeviceDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setupUi();
+    setWindowTitle("Generate Synthetic Device");
+    updateElementCount();
+}
+
+void SyntheticDeviceDialog::setupUi()
+{
+    SyntheticDeviceGenerator::Options defaults;
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    QFormLayout *formLayout = new QFormLayout();
+
+    auto addSpin = [&](const QString &label, int minimum, int maximum, int value) {
+        QSpinBox *spin = new QSpinBox(this);
+        spin->setRange(minimum, maximum);
+        spin->setValue(value);
+        formLayout->addRow(label, spin);
+        connect(spin, &QSpinBox::valueChanged, this, &SyntheticDeviceDialog::updateElementCount);
+        return spin;
+    };
+
+    m_nameEdit = new QLineEdit(defaults.deviceName, this);
+    formLayout->addRow("Device name:", m_nameEdit);
+
+    m_depthSpin = addSpin("Depth:", 0, 10, defaults.depth);
+    m_fanOutSpin = addSpin("Child nodes per node:", 1, 1000, defaults.fanOut);
+    m_parametersSpin = addSpin("Parameters per leaf node:", 0, 100000, defaults.parametersPerNode);
+
+    QHBoxLayout *typeLayout = new QHBoxLayout();
+    m_integerCheck = new QCheckBox("Integer", this);
+    m_realCheck = new QCheckBox("Real", this);
+    m_stringCheck = new QCheckBox("String", this);
+    m_booleanCheck = new QCheckBox("Boolean", this);
+    m_enumCheck = new QCheckBox("Enum", this);
+    for (QCheckBox *check : {m_integerCheck, m_realCheck, m_stringCheck, m_booleanCheck, m_enumCheck}) {
+        check->setChecked(true);
+        typeLayout->addWidget(check);
+    }
+    formLayout->addRow("Parameter types:", typeLayout);
+
+    m_enumSizeSpin = addSpin("Enum entries:", 1, 10000, defaults.enumSize);
+
+    m_matrixCountSpin = addSpin("Matrices:", 0, 1000, defaults.matrixCount);
+    m_matrixTypeCombo = new QComboBox(this);
+    m_matrixTypeCombo->addItems({"One to N", "One to One", "N to N"});
+    formLayout->addRow("Matrix type:", m_matrixTypeCombo);
+    m_targetsSpin = addSpin("Targets:", 1, 65535, defaults.matrixTargets);
+    m_sourcesSpin = addSpin("Sources:", 1, 65535, defaults.matrixSources);
+
+    m_densitySpin = new QDoubleSpinBox(this);
+    m_densitySpin->setRange(0.0, 1.0);
+    m_densitySpin->setSingleStep(0.05);
+    m_densitySpin->setValue(defaults.connectionDensity);
+    formLayout->addRow("Connection density:", m_densitySpin);
+
+    m_streamCountSpin = addSpin("Streams:", 0, 100000, defaults.streamCount);
+    m_streamRatesEdit = new QLineEdit("100", this);
+    m_streamRatesEdit->setPlaceholderText("Hz, comma separated, e.g. 100, 25");
+    formLayout->addRow("Stream rates (Hz):", m_streamRatesEdit);
+
+    m_seedSpin = addSpin("Seed:", 0, 999999, int(defaults.seed));
+
+    m_elementCountLabel = new QLabel(this);
+    formLayout->addRow("Elements:", m_elementCountLabel);
+
+    mainLayout->addLayout(formLayout);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    mainLayout->addWidget(buttonBox);
+}
+
+SyntheticDeviceGenerator::Options SyntheticDeviceDialog::options() const
+{
+    SyntheticDeviceGenerator::Options options;
+    options.deviceName = m_nameEdit->text().trimmed().isEmpty() ? options.deviceName : m_nameEdit->text().trimmed();
+    options.depth = m_depthSpin->value();
+    options.fanOut = m_fanOutSpin->value();
+    options.parametersPerNode = m_parametersSpin->value();
+
+    options.parameterTypes.clear();
+    if (m_integerCheck->isChecked()) options.parameterTypes.append(1);
+    if (m_realCheck->isChecked()) options.parameterTypes.append(2);
+    if (m_stringCheck->isChecked()) options.parameterTypes.append(3);
+    if (m_booleanCheck->isChecked()) options.parameterTypes.append(4);
+    if (m_enumCheck->isChecked()) options.parameterTypes.append(6);
+
+    options.enumSize = m_enumSizeSpin->value();
+    options.matrixCount = m_matrixCountSpin->value();
+    options.matrixType = m_matrixTypeCombo->currentIndex();
+    options.matrixTargets = m_targetsSpin->value();
+    options.matrixSources = m_sourcesSpin->value();
+    options.connectionDensity = m_densitySpin->value();
+    options.streamCount = m_streamCountSpin->value();
+
+    QList<int> rates;
+    for (const QString &rate : m_streamRatesEdit->text().split(',', Qt::SkipEmptyParts)) {
+        int hz = rate.trimmed().toInt();
+        if (hz > 0) {
+            rates.append(hz);
+        }
+    }
+    if (!rates.isEmpty()) {
+        options.streamRatesHz = rates;
+    }
+
+    options.seed = quint32(m_seedSpin->value());
+    return options;
+}
+
+void SyntheticDeviceDialog::updateElementCount()
+{
+    m_elementCountLabel->setText(QLocale().toString(SyntheticDeviceGenerator::elementCount(options())));
+}
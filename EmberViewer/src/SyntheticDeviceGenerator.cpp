@@ -0,0 +1,228 @@
+#include "SyntheticDeviceGenerator.h"
+#include <QDateTime>
+#include <QRandomGenerator>
+
+namespace {
+
+constexpr int ACCESS_READ = 1;
+constexpr int ACCESS_READ_WRITE = 3;
+
+NodeData makeNode(const QString &path, const QString &identifier)
+{
+    NodeData node;
+    node.path = path;
+    node.identifier = identifier;
+    node.isOnline = true;
+    return node;
+}
+
+ParameterData makeParameter(const QString &path, int number, int type, int enumSize, QRandomGenerator &random)
+{
+    ParameterData param;
+    param.path = path;
+    param.type = type;
+    param.access = ACCESS_READ_WRITE;
+    param.isOnline = true;
+
+    switch (type) {
+        case 1:
+            param.identifier = QString("integer%1").arg(number);
+            param.minimum = 0;
+            param.maximum = 1000;
+            param.value = QString::number(random.bounded(1001));
+            break;
+        case 2:
+            param.identifier = QString("real%1").arg(number);
+            param.minimum = -100;
+            param.maximum = 100;
+            param.value = QString::number(random.generateDouble() * 200.0 - 100.0, 'f', 2);
+            break;
+        case 4:
+            param.identifier = QString("boolean%1").arg(number);
+            param.value = random.bounded(2) ? "true" : "false";
+            break;
+        case 5:
+            param.identifier = QString("trigger%1").arg(number);
+            break;
+        case 6:
+            param.identifier = QString("enum%1").arg(number);
+            for (int i = 0; i < enumSize; ++i) {
+                param.enumOptions.append(QString("Option %1").arg(i + 1));
+                param.enumValues.append(i);
+            }
+            param.minimum = 0;
+            param.maximum = qMax(0, enumSize - 1);
+            param.value = QString::number(enumSize > 0 ? random.bounded(enumSize) : 0);
+            break;
+        default:
+            param.type = 3;
+            param.identifier = QString("string%1").arg(number);
+            param.value = QString("Text %1").arg(number);
+            break;
+    }
+    return param;
+}
+
+void addChild(DeviceSnapshot &snapshot, const QString &parentPath, const QString &childPath)
+{
+    snapshot.nodes[parentPath].childPaths.append(childPath);
+}
+
+void generateNodes(DeviceSnapshot &snapshot, const QString &path, int level,
+                   const SyntheticDeviceGenerator::Options &options, QRandomGenerator &random)
+{
+    if (level == options.depth) {
+        for (int i = 1; i <= options.parametersPerNode; ++i) {
+            QString paramPath = path + '.' + QString::number(i);
+            int type = options.parameterTypes.isEmpty()
+                ? 1 : options.parameterTypes[(i - 1) % options.parameterTypes.size()];
+            snapshot.parameters.insert(paramPath, makeParameter(paramPath, i, type, options.enumSize, random));
+            addChild(snapshot, path, paramPath);
+        }
+        return;
+    }
+
+    for (int i = 1; i <= options.fanOut; ++i) {
+        QString childPath = path + '.' + QString::number(i);
+        snapshot.nodes.insert(childPath, makeNode(childPath, QString("node%1").arg(i)));
+        addChild(snapshot, path, childPath);
+        generateNodes(snapshot, childPath, level + 1, options, random);
+    }
+}
+
+MatrixData makeMatrix(const QString &path, int number, const SyntheticDeviceGenerator::Options &options,
+                      QRandomGenerator &random)
+{
+    MatrixData matrix;
+    matrix.path = path;
+    matrix.identifier = QString("matrix%1").arg(number);
+    matrix.description = QString("%1x%2").arg(options.matrixTargets).arg(options.matrixSources);
+    matrix.type = options.matrixType;
+    matrix.targetCount = options.matrixTargets;
+    matrix.sourceCount = options.matrixSources;
+
+    for (int t = 0; t < options.matrixTargets; ++t) {
+        matrix.targetLabels.insert(t, QString("T%1").arg(t + 1));
+    }
+    for (int s = 0; s < options.matrixSources; ++s) {
+        matrix.sourceLabels.insert(s, QString("S%1").arg(s + 1));
+    }
+
+    if (options.matrixSources <= 0) {
+        return matrix;
+    }
+
+    if (options.matrixType == 2) {
+        for (int t = 0; t < options.matrixTargets; ++t) {
+            for (int s = 0; s < options.matrixSources; ++s) {
+                if (random.generateDouble() < options.connectionDensity) {
+                    matrix.connections.insert({t, s}, true);
+                }
+            }
+        }
+        return matrix;
+    }
+
+    // oneToN and oneToOne: at most one source per target, oneToOne uses every source once
+    QList<int> unusedSources;
+    for (int s = 0; s < options.matrixSources; ++s) {
+        unusedSources.append(s);
+    }
+    for (int t = 0; t < options.matrixTargets; ++t) {
+        if (random.generateDouble() >= options.connectionDensity) {
+            continue;
+        }
+        if (options.matrixType == 1) {
+            if (unusedSources.isEmpty()) {
+                break;
+            }
+            matrix.connections.insert({t, unusedSources.takeAt(random.bounded(int(unusedSources.size())))}, true);
+        } else {
+            matrix.connections.insert({t, int(random.bounded(options.matrixSources))}, true);
+        }
+    }
+    return matrix;
+}
+
+}
+
+DeviceSnapshot SyntheticDeviceGenerator::generate(const Options &options)
+{
+    QRandomGenerator random(options.seed);
+
+    DeviceSnapshot snapshot;
+    snapshot.deviceName = options.deviceName;
+    snapshot.captureTime = QDateTime::currentDateTime();
+    snapshot.hostAddress = "synthetic";
+    snapshot.port = 0;
+
+    const QString rootPath = "1";
+    snapshot.nodes.insert(rootPath, makeNode(rootPath, options.deviceName));
+    snapshot.rootPaths.append(rootPath);
+    generateNodes(snapshot, rootPath, 0, options, random);
+
+    if (options.matrixCount > 0) {
+        QString routingPath = rootPath + '.' + QString::number(options.fanOut + 1);
+        snapshot.nodes.insert(routingPath, makeNode(routingPath, "routing"));
+        addChild(snapshot, rootPath, routingPath);
+
+        for (int i = 1; i <= options.matrixCount; ++i) {
+            QString matrixPath = routingPath + '.' + QString::number(i);
+            snapshot.matrices.insert(matrixPath, makeMatrix(matrixPath, i, options, random));
+            addChild(snapshot, routingPath, matrixPath);
+        }
+    }
+
+    if (options.streamCount > 0) {
+        QString metersPath = rootPath + '.' + QString::number(options.fanOut + 2);
+        snapshot.nodes.insert(metersPath, makeNode(metersPath, "meters"));
+        addChild(snapshot, rootPath, metersPath);
+
+        for (int i = 1; i <= options.streamCount; ++i) {
+            ParameterData meter;
+            meter.path = metersPath + '.' + QString::number(i);
+            meter.identifier = QString("meter%1").arg(i);
+            meter.type = 1;
+            meter.access = ACCESS_READ;
+            meter.minimum = STREAM_MINIMUM;
+            meter.maximum = STREAM_MAXIMUM;
+            meter.value = QString::number(STREAM_MINIMUM);
+            meter.isOnline = true;
+            meter.streamIdentifier = i;
+            snapshot.parameters.insert(meter.path, meter);
+            addChild(snapshot, metersPath, meter.path);
+        }
+    }
+
+    return snapshot;
+}
+
+QMap<int, int> SyntheticDeviceGenerator::streamRates(const Options &options)
+{
+    QMap<int, int> rates;
+    for (int i = 1; i <= options.streamCount; ++i) {
+        int rate = options.streamRatesHz.isEmpty()
+            ? 100 : options.streamRatesHz[(i - 1) % options.streamRatesHz.size()];
+        rates.insert(i, rate);
+    }
+    return rates;
+}
+
+qint64 SyntheticDeviceGenerator::elementCount(const Options &options)
+{
+    qint64 nodes = 1;
+    qint64 levelNodes = 1;
+    for (int level = 0; level < options.depth; ++level) {
+        levelNodes *= options.fanOut;
+        nodes += levelNodes;
+    }
+
+    qint64 count = nodes + levelNodes * options.parametersPerNode;
+    if (options.matrixCount > 0) {
+        count += 1 + options.matrixCount;
+    }
+    if (options.streamCount > 0) {
+        count += 1 + options.streamCount;
+    }
+    return count;
+}
@@ -0,0 +1,190 @@
+#include "TimeSeriesBuffer.h"
+#include <algorithm>
+
+TimeSeriesBuffer::TimeSeriesBuffer(int capacity)
+    : m_timestamps(qMax(1, capacity))
+    , m_values(qMax(1, capacity))
+    , m_head(0)
+    , m_count(0)
+    , m_firstSequence(0)
+    , m_sum(0.0)
+    , m_removedSinceResync(0)
+{
+}
+
+void TimeSeriesBuffer::append(qint64 timestamp, double value)
+{
+    if (m_count == capacity()) {
+        removeFirst();
+    }
+
+    int slot = physicalIndex(m_count);
+    m_timestamps[slot] = timestamp;
+    m_values[slot] = value;
+    quint64 sequence = m_firstSequence + m_count;
+    ++m_count;
+
+    m_sum += value;
+
+    while (!m_minQueue.empty() && valueAtSequence(m_minQueue.back()) >= value) {
+        m_minQueue.pop_back();
+    }
+    m_minQueue.push_back(sequence);
+
+    while (!m_maxQueue.empty() && valueAtSequence(m_maxQueue.back()) <= value) {
+        m_maxQueue.pop_back();
+    }
+    m_maxQueue.push_back(sequence);
+}
+
+void TimeSeriesBuffer::removeOlderThan(qint64 cutoff)
+{
+    while (m_count > 0 && m_timestamps[m_head] < cutoff) {
+        removeFirst();
+    }
+}
+
+void TimeSeriesBuffer::clear()
+{
+    m_firstSequence += m_count;
+    m_head = 0;
+    m_count = 0;
+    m_minQueue.clear();
+    m_maxQueue.clear();
+    m_sum = 0.0;
+    m_removedSinceResync = 0;
+}
+
+double TimeSeriesBuffer::minimum() const
+{
+    return m_minQueue.empty() ? 0.0 : valueAtSequence(m_minQueue.front());
+}
+
+double TimeSeriesBuffer::maximum() const
+{
+    return m_maxQueue.empty() ? 0.0 : valueAtSequence(m_maxQueue.front());
+}
+
+double TimeSeriesBuffer::average() const
+{
+    return m_count == 0 ? 0.0 : m_sum / m_count;
+}
+
+int TimeSeriesBuffer::lowerBound(qint64 timestamp) const
+{
+    int low = 0;
+    int high = m_count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (timestampAt(mid) < timestamp) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+QVector<QPointF> TimeSeriesBuffer::decimate(qint64 start, qint64 span, int width) const
+{
+    QVector<QPointF> points;
+    if (m_count == 0 || span <= 0 || width <= 0) {
+        return points;
+    }
+
+    int index = lowerBound(start);
+    qint64 end = start + span;
+
+    int column = -1;
+    double first = 0.0, low = 0.0, high = 0.0, last = 0.0;
+    bool lowBeforeHigh = true;
+
+    auto flush = [&]() {
+        points.append(QPointF(column, first));
+        // Keep the extremes in the order they occurred so the line does not zig-zag
+        double inner1 = lowBeforeHigh ? low : high;
+        double inner2 = lowBeforeHigh ? high : low;
+        if (inner1 != first) {
+            points.append(QPointF(column, inner1));
+        }
+        if (inner2 != inner1) {
+            points.append(QPointF(column, inner2));
+        }
+        if (last != inner2) {
+            points.append(QPointF(column, last));
+        }
+    };
+
+    points.reserve(qMin(m_count - index, width * 4));
+
+    for (; index < m_count; ++index) {
+        qint64 timestamp = timestampAt(index);
+        if (timestamp >= end) {
+            break;
+        }
+
+        int sampleColumn = static_cast<int>((timestamp - start) * width / span);
+        double value = valueAt(index);
+
+        if (sampleColumn != column) {
+            if (column >= 0) {
+                flush();
+            }
+            column = sampleColumn;
+            first = low = high = last = value;
+            lowBeforeHigh = true;
+            continue;
+        }
+
+        if (value < low) {
+            low = value;
+            lowBeforeHigh = false;
+        }
+        if (value > high) {
+            high = value;
+            lowBeforeHigh = true;
+        }
+        last = value;
+    }
+
+    if (column >= 0) {
+        flush();
+    }
+
+    return points;
+}
+
+double TimeSeriesBuffer::valueAtSequence(quint64 sequence) const
+{
+    return valueAt(static_cast<int>(sequence - m_firstSequence));
+}
+
+void TimeSeriesBuffer::removeFirst()
+{
+    if (!m_minQueue.empty() && m_minQueue.front() == m_firstSequence) {
+        m_minQueue.pop_front();
+    }
+    if (!m_maxQueue.empty() && m_maxQueue.front() == m_firstSequence) {
+        m_maxQueue.pop_front();
+    }
+
+    m_sum -= m_values[m_head];
+    m_head = (m_head + 1) % capacity();
+    ++m_firstSequence;
+    --m_count;
+
+    if (m_count == 0) {
+        m_head = 0;
+        m_sum = 0.0;
+        m_removedSinceResync = 0;
+        return;
+    }
+
+    if (++m_removedSinceResync >= capacity()) {
+        m_sum = 0.0;
+        for (int i = 0; i < m_count; ++i) {
+            m_sum += valueAt(i);
+        }
+        m_removedSinceResync = 0;
+    }
+}
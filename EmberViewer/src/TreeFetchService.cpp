@@ -7,16 +7,24 @@
 
 
 #include "TreeFetchService.h"
+#include <QDebug>
+#include <algorithm>
 
 TreeFetchService::TreeFetchService(QObject *parent)
     : QObject(parent)
     , m_active(false)
+    , m_processScheduled(false)
     , m_totalEstimate(0)
-    , m_timer(new QTimer(this))
+    , m_window(INITIAL_WINDOW)
+    , m_slowStart(true)
+    , m_minRttUs(0)
+    , m_smoothedRttUs(0)
+    , m_lastDecreaseUs(0)
+    , m_completedSinceReport(0)
+    , m_timeoutTimer(new QTimer(this))
 {
-    m_timer->setSingleShot(false);
-    m_timer->setInterval(QUEUE_PROCESS_INTERVAL_MS);
-    connect(m_timer, &QTimer::timeout, this, &TreeFetchService::processQueue);
+    m_timeoutTimer->setSingleShot(true);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &TreeFetchService::onRequestTimeout);
 }
 
 TreeFetchService::~TreeFetchService()
@@ -31,19 +39,31 @@ void TreeFetchService::startFetch(const QStringList &initialNodePaths)
     }
     
     m_active = true;
+    m_pendingQueue.clear();
     m_pendingPaths.clear();
     m_completedPaths.clear();
+    m_retriedPaths.clear();
+    m_silentPaths.clear();
     m_activePaths.clear();
     m_totalEstimate = initialNodePaths.size();
     
+    m_window = INITIAL_WINDOW;
+    m_slowStart = true;
+    m_minRttUs = 0;
+    m_smoothedRttUs = 0;
+    m_lastDecreaseUs = 0;
+    m_completedSinceReport = 0;
+    m_clock.start();
+    
     
     for (const QString &path : initialNodePaths) {
-        QString type = path.split('|').value(1);  
-        QString nodePath = path.split('|').value(0);
+        QString type = path.section('|', 1, 1);
+        QString nodePath = path.section('|', 0, 0);
         
         
-        if (type == "Node") {
+        if (type == "Node" && !m_pendingPaths.contains(nodePath)) {
             m_pendingPaths.insert(nodePath);
+            m_pendingQueue.enqueue(nodePath);
         }
     }
     
@@ -54,7 +74,6 @@ void TreeFetchService::startFetch(const QStringList &initialNodePaths)
     }
     
     
-    m_timer->start();
     processQueue();
 }
 
@@ -65,88 +84,219 @@ void TreeFetchService::cancel()
     }
     
     m_active = false;
-    m_timer->stop();
+    m_timeoutTimer->stop();
+    m_pendingQueue.clear();
     m_pendingPaths.clear();
     m_activePaths.clear();
     m_completedPaths.clear();
+    m_retriedPaths.clear();
+    m_silentPaths.clear();
     
     emit fetchCompleted(false, "Cancelled by user");
 }
 
-void TreeFetchService::onNodeReceived(const QString &nodePath)
+void TreeFetchService::onElementReceived(const QString &path, bool isNode)
 {
     if (!m_active) {
         return;
     }
     
     
-    if (!m_completedPaths.contains(nodePath) && 
-        !m_activePaths.contains(nodePath) &&
-        !m_pendingPaths.contains(nodePath)) {
-        m_pendingPaths.insert(nodePath);
+    if (isNode && !m_completedPaths.contains(path) && 
+        !m_activePaths.contains(path) &&
+        !m_pendingPaths.contains(path)) {
+        m_pendingPaths.insert(path);
+        m_pendingQueue.enqueue(path);
         m_totalEstimate++;
     }
     
     
+    // A qualified reply carries the requested node itself, a plain one only its children
+    if (m_activePaths.contains(path)) {
+        completeRequest(path);
+    }
     
-    if (!nodePath.isEmpty()) {
-        QStringList parts = nodePath.split('.');
-        if (parts.size() > 1) {
-            parts.removeLast();
-            QString parentPath = parts.join('.');
-            if (m_activePaths.contains(parentPath)) {
-                m_activePaths.remove(parentPath);
-                m_completedPaths.insert(parentPath);
-            }
-        } else {
-            
-            if (m_activePaths.contains("")) {
-                m_activePaths.remove("");
-                m_completedPaths.insert("");
-            }
-        }
+    int separator = path.lastIndexOf('.');
+    QString parentPath = separator < 0 ? QString() : path.left(separator);
+    if (m_activePaths.contains(parentPath)) {
+        completeRequest(parentPath);
     }
+    
+    // Answered after all, just too late
+    m_silentPaths.remove(path);
+    m_silentPaths.remove(parentPath);
+    
+    schedule();
 }
 
-void TreeFetchService::setSendGetDirectoryCallback(std::function<void(const QString&, bool)> callback)
+void TreeFetchService::setSendGetDirectoryCallback(std::function<void(const QStringList&)> callback)
 {
     m_sendCallback = callback;
 }
 
+void TreeFetchService::schedule()
+{
+    // Elements of one decoded batch arrive back to back; advance the queue once afterwards
+    if (!m_processScheduled) {
+        m_processScheduled = true;
+        QMetaObject::invokeMethod(this, &TreeFetchService::processQueue, Qt::QueuedConnection);
+    }
+}
+
+void TreeFetchService::completeRequest(const QString &path)
+{
+    qint64 sentAt = m_activePaths.take(path);
+    m_completedPaths.insert(path);
+    m_completedSinceReport++;
+    
+    qint64 rttUs = m_clock.nsecsElapsed() / 1000 - sentAt;
+    adaptWindow(rttUs);
+    emit requestCompleted(rttUs);
+}
+
+void TreeFetchService::adaptWindow(qint64 rttUs)
+{
+    rttUs = std::max<qint64>(rttUs, 1);
+    m_minRttUs = m_minRttUs == 0 ? rttUs : std::min(m_minRttUs, rttUs);
+    m_smoothedRttUs = m_smoothedRttUs == 0 ? rttUs : (7 * m_smoothedRttUs + rttUs) / 8;
+    
+    qint64 now = m_clock.nsecsElapsed() / 1000;
+    if (rttUs > m_minRttUs * CONGESTION_RTT_FACTOR) {
+        // Decrease at most once per round trip, all late responses of one burst share the cause
+        if (now - m_lastDecreaseUs > m_smoothedRttUs) {
+            m_window = std::max<double>(MIN_WINDOW, m_window / 2);
+            m_slowStart = false;
+            m_lastDecreaseUs = now;
+        }
+    } else if (m_slowStart) {
+        m_window = std::min<double>(MAX_WINDOW, m_window + 1);
+    } else {
+        m_window = std::min<double>(MAX_WINDOW, m_window + 1.0 / m_window);
+    }
+}
+
 void TreeFetchService::processQueue()
 {
+    m_processScheduled = false;
     if (!m_active) {
-        m_timer->stop();
         return;
     }
     
     
-    while (m_activePaths.size() < MAX_PARALLEL_REQUESTS && !m_pendingPaths.isEmpty()) {
-        
-        QString path = *m_pendingPaths.begin();
-        m_pendingPaths.remove(path);
-        m_activePaths.insert(path);
+    int capacity = static_cast<int>(m_window) - static_cast<int>(m_activePaths.size());
+    if (capacity > 0 && !m_pendingQueue.isEmpty()) {
+        qint64 now = m_clock.nsecsElapsed() / 1000;
+        QStringList message;
         
+        while (capacity > 0 && !m_pendingQueue.isEmpty()) {
+            QString path = m_pendingQueue.dequeue();
+            m_pendingPaths.remove(path);
+            m_activePaths.insert(path, now);
+            message.append(path);
+            capacity--;
+            
+            if (message.size() == MAX_PATHS_PER_MESSAGE) {
+                if (m_sendCallback) {
+                    m_sendCallback(message);
+                }
+                message.clear();
+            }
+        }
         
-        if (m_sendCallback) {
-            bool isRoot = path.isEmpty();
-            m_sendCallback(path, isRoot);
+        if (!message.isEmpty() && m_sendCallback) {
+            m_sendCallback(message);
         }
+        
+        armTimeout();
     }
     
     
     if (m_pendingPaths.isEmpty() && m_activePaths.isEmpty()) {
-        int fetchedCount = m_completedPaths.size();
-        
-        m_active = false;
-        m_timer->stop();
-        m_completedPaths.clear();
+        finish();
+    }
+    else if (m_completedSinceReport > 0) {
+        m_completedSinceReport = 0;
         
-        emit fetchCompleted(true, QString("Fetched %1 nodes").arg(fetchedCount));
+        int done = m_completedPaths.size();
+        int total = done + m_activePaths.size() + m_pendingPaths.size();
+        emit progressUpdated(done, total);
     }
-    else {
+}
+
+void TreeFetchService::armTimeout()
+{
+    if (m_activePaths.isEmpty()) {
+        m_timeoutTimer->stop();
+        return;
+    }
+    
+    if (!m_timeoutTimer->isActive()) {
+        qint64 timeoutUs = std::max(MIN_REQUEST_TIMEOUT_US, REQUEST_TIMEOUT_RTT_FACTOR * m_smoothedRttUs);
+        m_timeoutTimer->start(static_cast<int>(timeoutUs / 1000));
+    }
+}
+
+void TreeFetchService::onRequestTimeout()
+{
+    if (!m_active) {
+        return;
+    }
+    
+    
+    // Overdue requests are sent once more. Providers stay silent on GetDirectory for a node
+    // without children, so a second timeout completes the path as empty; congestion shows
+    // up as rising response times and is handled by adaptWindow
+    qint64 now = m_clock.nsecsElapsed() / 1000;
+    qint64 timeoutUs = std::max(MIN_REQUEST_TIMEOUT_US, REQUEST_TIMEOUT_RTT_FACTOR * m_smoothedRttUs);
+    
+    QStringList overdue;
+    for (auto it = m_activePaths.constBegin(); it != m_activePaths.constEnd(); ++it) {
+        if (now - it.value() >= timeoutUs) {
+            overdue.append(it.key());
+        }
+    }
+    
+    if (!overdue.isEmpty()) {
+        qDebug().noquote() << QString("TreeFetchService: %1 requests timed out").arg(overdue.size());
         
-        int total = m_completedPaths.size() + m_activePaths.size() + m_pendingPaths.size();
-        emit progressUpdated(m_completedPaths.size(), total);
+        for (const QString &path : overdue) {
+            m_activePaths.remove(path);
+            if (!m_retriedPaths.contains(path)) {
+                m_retriedPaths.insert(path);
+                m_pendingPaths.insert(path);
+                m_pendingQueue.enqueue(path);
+            } else {
+                qDebug().noquote() << QString("TreeFetchService: No response for %1, treating it as empty").arg(path);
+                m_silentPaths.insert(path);
+                m_completedPaths.insert(path);
+                m_completedSinceReport++;
+            }
+        }
+    }
+    
+    armTimeout();
+    processQueue();
+}
+
+void TreeFetchService::finish()
+{
+    int fetchedCount = m_completedPaths.size();
+    int silentCount = m_silentPaths.size();
+    double seconds = m_clock.elapsed() / 1000.0;
+    
+    qDebug().noquote() << QString("TreeFetchService: %1 nodes in %2 s, %3 without a reply (final window %4, smoothed RTT %5 ms)")
+        .arg(fetchedCount).arg(seconds, 0, 'f', 2).arg(silentCount)
+        .arg(static_cast<int>(m_window)).arg(smoothedRttMs(), 0, 'f', 1);
+    
+    m_active = false;
+    m_timeoutTimer->stop();
+    m_completedPaths.clear();
+    m_retriedPaths.clear();
+    
+    if (silentCount > 0) {
+        emit fetchCompleted(true, QString("Fetched %1 nodes, %2 without a reply")
+            .arg(fetchedCount).arg(silentCount));
+        return;
     }
+    emit fetchCompleted(true, QString("Fetched %1 nodes").arg(fetchedCount));
 }
@@ -11,52 +11,58 @@
 
 #include "TreeViewController.h"
 #include "EmberConnection.h"
-#include <QTreeWidget>
-#include <QApplication>
-#include <QStyle>
-#include <QBrush>
-#include <QColor>
+#include "EmberTreeModel.h"
+#include "LogCategories.h"
+#include "PerformanceCounters.h"
 #include <QDebug>
 
-TreeViewController::TreeViewController(QTreeWidget *treeWidget, EmberConnection *connection, QObject *parent)
+TreeViewController::TreeViewController(EmberTreeModel *model, EmberConnection *connection, QObject *parent)
     : QObject(parent)
-    , m_treeWidget(treeWidget)
+    , m_model(model)
     , m_connection(connection)
-    , m_itemsAddedSinceUpdate(0)
     , m_matrixDetailBatchTimer(nullptr)
+    , m_parameterUpdateTimer(nullptr)
 {
     // Setup batch timer for matrix detail requests
     m_matrixDetailBatchTimer = new QTimer(this);
     m_matrixDetailBatchTimer->setSingleShot(true);
     m_matrixDetailBatchTimer->setInterval(MATRIX_DETAIL_BATCH_DELAY_MS);
     connect(m_matrixDetailBatchTimer, &QTimer::timeout, this, &TreeViewController::processPendingMatrixDetailRequests);
+    
+    // Fixed cadence rather than a debounce, so a continuous stream of changes still shows up every frame
+    m_parameterUpdateTimer = new QTimer(this);
+    m_parameterUpdateTimer->setSingleShot(true);
+    m_parameterUpdateTimer->setTimerType(Qt::PreciseTimer);
+    m_parameterUpdateTimer->setInterval(PARAMETER_UPDATE_INTERVAL_MS);
+    connect(m_parameterUpdateTimer, &QTimer::timeout, this, &TreeViewController::onParameterUpdateTimer);
+    
+    // Queued, the view asks from inside its layout pass
+    connect(m_model, &EmberTreeModel::fetchRequested, this, &TreeViewController::onFetchRequested, Qt::QueuedConnection);
 }
 
 TreeViewController::~TreeViewController()
 {
 }
 
-QTreeWidgetItem* TreeViewController::findTreeItem(const QString &path) const
+QModelIndex TreeViewController::indexForPath(const QString &path) const
 {
-    return m_pathToItem.value(path, nullptr);
+    return m_model->indexForPath(path);
 }
 
 QStringList TreeViewController::getAllTreeItemPaths() const
 {
     QStringList paths;
     
-    
-    QTreeWidgetItemIterator it(m_treeWidget);
-    while (*it) {
-        QString path = (*it)->data(0, Qt::UserRole).toString();
-        QString type = (*it)->text(1);
-        
-        if (!path.isEmpty() && !type.isEmpty()) {
-            
-            paths.append(QString("%1|%2").arg(path).arg(type));
+    const ElementStore &store = m_model->store();
+    for (int element = 0; element < store.size(); ++element) {
+        if (store.testFlag(element, ElementStore::Removed)) {
+            continue;
         }
+        QString type = EmberTreeModel::kindName(store.kind(element));
         
-        ++it;
+        if (!type.isEmpty()) {
+            paths.append(QString("%1|%2").arg(store.path(element).toString()).arg(type));
+        }
     }
     
     return paths;
@@ -64,238 +70,193 @@ QStringList TreeViewController::getAllTreeItemPaths() const
 
 bool TreeViewController::hasPathBeenFetched(const QString &path) const
 {
-    return m_fetchedPaths.contains(path);
+    return m_fetchedPaths.contains(EmberPath::find(path));
 }
 
 void TreeViewController::markPathAsFetched(const QString &path)
 {
-    m_fetchedPaths.insert(path);
+    m_fetchedPaths.insert(EmberPath::fromString(path));
 }
 
 void TreeViewController::clear()
 {
-    m_pathToItem.clear();
+    m_model->clear();
     m_fetchedPaths.clear();
-    m_itemsAddedSinceUpdate = 0;
+    m_pendingMatrixDetailPaths.clear();
+    m_pendingParameterUpdates.clear();
+    m_parameterUpdateTimer->stop();
+    PerformanceCounters::set(PerformanceCounters::PendingTreeUpdates, 0);
 }
 
 void TreeViewController::onNodeReceived(const QString &path, const QString &identifier, const QString &description, bool isOnline)
 {
-    QTreeWidgetItem *item = findOrCreateTreeItem(path);
-    if (item) {
-        
-        bool isNew = item->text(1).isEmpty();
-        
-        
-        
-        QString displayName = !description.isEmpty() ? description : identifier;
-        
-        setItemDisplayName(item, displayName);
-        item->setText(1, "Node");
-        item->setText(2, "");  
-        
-        
-        
-        item->setData(0, Qt::UserRole + 4, isOnline);
-        
-        
-        if (!isOnline) {
-            item->setIcon(0, m_treeWidget->style()->standardIcon(QStyle::SP_MessageBoxWarning));
-            item->setForeground(0, QBrush(QColor("#888888")));
-            item->setForeground(1, QBrush(QColor("#888888")));
-            item->setForeground(2, QBrush(QColor("#888888")));
-            item->setToolTip(0, QString("%1 - Offline").arg(displayName));
-        } else {
-            item->setIcon(0, m_treeWidget->style()->standardIcon(QStyle::SP_DirIcon));
-            
-            item->setForeground(0, QBrush());
-            item->setForeground(1, QBrush());
-            item->setForeground(2, QBrush());
-            item->setToolTip(0, "");
-        }
-        
-        if (isNew) {
-            qDebug().noquote() << QString("Node: %1 [%2] - %3")
-                .arg(displayName).arg(path).arg(isOnline ? "Online" : "Offline");
-            
-            
-            
-            item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
-        }
-        
-        
-        if (item->parent()) {
-            QTreeWidgetItem *parent = item->parent();
-            
-            for (int i = 0; i < parent->childCount(); i++) {
-                QTreeWidgetItem *child = parent->child(i);
-                if (child->text(0) == "Loading..." && child->text(1).isEmpty()) {
-                    delete child;
-                    break;  
-                }
-            }
-        }
-        
-        
-        m_itemsAddedSinceUpdate++;
-        if (m_itemsAddedSinceUpdate >= UPDATE_BATCH_SIZE) {
-            
-            
-            QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-            m_itemsAddedSinceUpdate = 0;
-        }
-    }
+    EmberData::NodeInfo node;
+    node.path = path;
+    node.identifier = identifier;
+    node.description = description;
+    node.isOnline = isOnline;
+    node.hasIdentifier = !identifier.isEmpty();
+    node.hasDescription = !description.isEmpty();
+    onNodesReceived({node});
 }
 
-void TreeViewController::onParameterReceived(const QString &path, int , const QString &identifier, const QString &description, const QString &value, 
+void TreeViewController::onParameterReceived(const QString &path, int number, const QString &identifier, const QString &description, const QString &value, 
                                     int access, int type, const QVariant &minimum, const QVariant &maximum,
                                     const QStringList &enumOptions, const QList<int> &enumValues, bool isOnline, int streamIdentifier,
-                                    const QString &format, const QString &referenceLevel, const QString &formula, int factor)
+                                    const QString &format, const QString &referenceLevel, const QString &formula, int factor,
+                                    int streamOffset)
 {
-    QTreeWidgetItem *item = findOrCreateTreeItem(path);
-    if (item) {
-        
-        bool isNew = item->text(1).isEmpty();
-        
-        QString displayName = !description.isEmpty() ? description : identifier;
-        setItemDisplayName(item, displayName);
-        item->setText(1, "Parameter");
-        
-        
-        
-        item->setData(0, Qt::UserRole, path);          
-        item->setData(0, Qt::UserRole + 1, type);       
-        item->setData(0, Qt::UserRole + 2, access);     
-        item->setData(0, Qt::UserRole + 3, minimum);    
-        item->setData(0, Qt::UserRole + 4, maximum);    
-        item->setData(0, Qt::UserRole + 5, enumOptions); 
-        item->setData(0, Qt::UserRole + 9, streamIdentifier);  
-        item->setData(0, Qt::UserRole + 10, format);  
-        item->setData(0, Qt::UserRole + 11, referenceLevel);  
-        item->setData(0, Qt::UserRole + 12, formula);  
-        item->setData(0, Qt::UserRole + 13, factor);  
-    qDebug() << "[TreeViewController] Storing format:" << format << "referenceLevel:" << referenceLevel 
-             << "formula:" << formula << "factor:" << factor;
-        
-        
-        QList<QVariant> enumValuesVar;
-        for (int val : enumValues) {
-            enumValuesVar.append(val);
-        }
-        item->setData(0, Qt::UserRole + 6, QVariant::fromValue(enumValuesVar)); 
-        item->setData(0, Qt::UserRole + 8, isOnline);   
-        
-        
-        
-        bool isAudioMeter = (streamIdentifier > 0) && (type == 1 || type == 2);
-        if (isAudioMeter) {
-            item->setIcon(0, m_treeWidget->style()->standardIcon(QStyle::SP_MediaVolume));
-        } else {
-            item->setIcon(0, m_treeWidget->style()->standardIcon(QStyle::SP_FileIcon));
-        }
-        
-        
-        
-        
-        
-        if (item->parent()) {
-            QTreeWidgetItem *parent = item->parent();
-            for (int i = 0; i < parent->childCount(); i++) {
-                QTreeWidgetItem *child = parent->child(i);
-                if (child->text(0) == "Loading..." && child->text(1).isEmpty()) {
-                    delete child;
-                    break;
-                }
+    EmberData::ParameterInfo param;
+    param.path = path;
+    param.number = number;
+    param.identifier = identifier;
+    param.description = description;
+    param.value = value;
+    param.access = access;
+    param.type = type;
+    param.minimum = minimum;
+    param.maximum = maximum;
+    param.enumOptions = enumOptions;
+    param.enumValues = enumValues;
+    param.isOnline = isOnline;
+    param.streamIdentifier = streamIdentifier;
+    param.streamOffset = streamOffset;
+    param.format = format;
+    param.referenceLevel = referenceLevel;
+    param.formula = formula;
+    param.factor = factor;
+    onParametersReceived({param});
+}
+
+void TreeViewController::onNodesReceived(const QVector<EmberData::NodeInfo> &nodes)
+{
+    if (nodes.isEmpty()) {
+        return;
+    }
+    
+    if (lcElements().isDebugEnabled()) {
+        for (const EmberData::NodeInfo &node : nodes) {
+            if (isNewElement(EmberData::elementPath(node))) {
+                qCDebug(lcElements).noquote() << QString("Node: %1 [%2] - %3")
+                    .arg(!node.description.isEmpty() ? node.description : node.identifier)
+                    .arg(node.path).arg(node.isOnline ? "Online" : "Offline");
             }
         }
-        
-        
-        
-        if (!isAudioMeter) {
-            item->setText(2, value);
-        } else {
-            item->setText(2, "");  
+    }
+    
+    m_model->applyNodes(nodes);
+}
+
+void TreeViewController::onParametersReceived(const QVector<EmberData::ParameterInfo> &parameters)
+{
+    if (parameters.isEmpty()) {
+        return;
+    }
+    
+    QVector<EmberData::ParameterInfo> newParameters;
+    
+    for (const EmberData::ParameterInfo &param : parameters) {
+        EmberPath path = EmberData::elementPath(param);
+        
+        // New elements are added right away so children and lazy loading see them
+        if (kindOf(path) != ElementStore::Parameter) {
+            // A value queued before the element was rebuilt is older than this one
+            m_pendingParameterUpdates.remove(path);
+            newParameters.append(param);
+            continue;
         }
         
-        
-        bool canWrite = (access == 2 || access == 3);
-        if (canWrite && !isAudioMeter) {
-            item->setForeground(2, QBrush(QColor(30, 144, 255)));
-            item->setFlags(item->flags() | Qt::ItemIsEditable);
+        auto pending = m_pendingParameterUpdates.find(path);
+        if (pending != m_pendingParameterUpdates.end()) {
+            *pending = param;
+            PerformanceCounters::add(PerformanceCounters::TreeUpdatesCollapsed);
         } else {
-            item->setForeground(2, QBrush());
-            item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+            m_pendingParameterUpdates.insert(path, param);
         }
-        
-        if (isNew) {
-            qDebug().noquote() << QString("Parameter: %1 = %2 [%3] (Type: %4, Access: %5)").arg(identifier).arg(value).arg(path).arg(type).arg(access);
-        }
-        
-        
-        m_itemsAddedSinceUpdate++;
-        if (m_itemsAddedSinceUpdate >= UPDATE_BATCH_SIZE) {
-            QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-            m_itemsAddedSinceUpdate = 0;
+    }
+    
+    if (!newParameters.isEmpty()) {
+        for (const EmberData::ParameterInfo &param : std::as_const(newParameters)) {
+            qCDebug(lcElements).noquote() << QString("Parameter: %1 = %2 [%3] (Type: %4, Access: %5)")
+                .arg(param.identifier).arg(param.value).arg(param.path).arg(param.type).arg(param.access);
         }
+        m_model->applyParameters(newParameters);
+    }
+    
+    PerformanceCounters::set(PerformanceCounters::PendingTreeUpdates, m_pendingParameterUpdates.size());
+    if (!m_pendingParameterUpdates.isEmpty() && !m_parameterUpdateTimer->isActive()) {
+        m_parameterUpdateTimer->start();
+    }
+}
+
+void TreeViewController::onParameterUpdateTimer()
+{
+    flushPendingParameterUpdates();
+}
+
+void TreeViewController::flushPendingParameterUpdates()
+{
+    m_parameterUpdateTimer->stop();
+    if (m_pendingParameterUpdates.isEmpty()) {
+        return;
+    }
+    
+    // Swap out first so updates arriving during the flush wait for the next frame
+    QHash<EmberPath, EmberData::ParameterInfo> updates;
+    updates.swap(m_pendingParameterUpdates);
+    PerformanceCounters::set(PerformanceCounters::PendingTreeUpdates, 0);
+    PerformanceCounters::add(PerformanceCounters::TreeUpdatesApplied, quint64(updates.size()));
+    PerformanceCounters::ScopedTimer timer(PerformanceCounters::ApplyTree);
+    
+    QVector<EmberData::ParameterInfo> parameters;
+    parameters.reserve(updates.size());
+    for (const EmberData::ParameterInfo &param : std::as_const(updates)) {
+        parameters.append(param);
     }
+    m_model->applyParameters(parameters);
 }
 
-void TreeViewController::onMatrixReceived(const QString &path, int , const QString &identifier, 
+void TreeViewController::onMatrixReceived(const QString &path, int number, const QString &identifier, 
                                    const QString &description, int type, int targetCount, int sourceCount)
 {
-    QTreeWidgetItem *item = findOrCreateTreeItem(path);
-    if (item) {
-        bool isNew = item->text(1).isEmpty();
-        
-        
+    EmberPath oid = EmberPath::fromString(path);
+    if (oid.isEmpty()) {
+        return;
+    }
+    
+    bool isNew = isNewElement(oid);
+    
+    EmberData::MatrixInfo matrix;
+    matrix.path = path;
+    matrix.oid = oid;
+    matrix.number = number;
+    matrix.identifier = identifier;
+    matrix.description = description;
+    matrix.type = type;
+    matrix.targetCount = targetCount;
+    matrix.sourceCount = sourceCount;
+    m_model->applyMatrix(matrix);
+    
+    if (isNew) {
         QString displayName = !description.isEmpty() ? description : identifier;
+        qInfo().noquote() << QString("Matrix discovered: %1 (%2×%3)").arg(displayName).arg(sourceCount).arg(targetCount);
         
-        setItemDisplayName(item, displayName);
-        item->setText(1, "Matrix");
-        item->setText(2, QString("%1×%2").arg(sourceCount).arg(targetCount));
-        item->setIcon(0, m_treeWidget->style()->standardIcon(QStyle::SP_FileDialogDetailedView));
-        
-        
-        item->setData(0, Qt::UserRole, path);
-        item->setData(0, Qt::UserRole + 7, "Matrix");  
-        
-        
-        if (item->parent()) {
-            QTreeWidgetItem *parent = item->parent();
-            
-            for (int i = 0; i < parent->childCount(); i++) {
-                QTreeWidgetItem *child = parent->child(i);
-                if (child->text(0) == "Loading..." && child->text(1).isEmpty()) {
-                    delete child;
-                    break;  
-                }
-            }
-        }
+        emit matrixItemCreated(path);
+    }
+    
+    
+    if ((targetCount == 0 || sourceCount == 0) && !m_fetchedPaths.contains(oid)) {
+        qInfo().noquote() << QString("Matrix has no dimensions, batching detail request for: %1").arg(path);
+        m_fetchedPaths.insert(oid);
         
-        if (isNew) {
-            qInfo().noquote() << QString("Matrix discovered: %1 (%2×%3)").arg(displayName).arg(sourceCount).arg(targetCount);
-            
-            
-            item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
-            
-            
-            emit matrixItemCreated(path, item);
+        // Add to pending batch instead of sending immediately
+        if (!m_pendingMatrixDetailPaths.contains(path)) {
+            m_pendingMatrixDetailPaths.append(path);
         }
         
-        
-        if ((targetCount == 0 || sourceCount == 0) && !m_fetchedPaths.contains(path)) {
-            qInfo().noquote() << QString("Matrix has no dimensions, batching detail request for: %1").arg(path);
-            m_fetchedPaths.insert(path);
-            
-            // Add to pending batch instead of sending immediately
-            if (!m_pendingMatrixDetailPaths.contains(path)) {
-                m_pendingMatrixDetailPaths.append(path);
-            }
-            
-            // Start/restart the timer - will fire after 50ms of no new matrices
-            if (m_matrixDetailBatchTimer && !m_matrixDetailBatchTimer->isActive()) {
-                m_matrixDetailBatchTimer->start();
-            }
+        // Start/restart the timer - will fire after 50ms of no new matrices
+        if (m_matrixDetailBatchTimer && !m_matrixDetailBatchTimer->isActive()) {
+            m_matrixDetailBatchTimer->start();
         }
     }
 }
@@ -320,152 +281,128 @@ void TreeViewController::onFunctionReceived(const QString &path, const QString &
                                    const QStringList &argNames, const QList<int> &argTypes,
                                    const QStringList &resultNames, const QList<int> &resultTypes)
 {
-    QTreeWidgetItem *item = findOrCreateTreeItem(path);
-    if (item) {
-        bool isNew = item->text(1).isEmpty();
-        
-        QString displayName = !description.isEmpty() ? description : identifier;
-        
-        setItemDisplayName(item, displayName);
-        item->setText(1, "Function");
-        item->setText(2, "");
-        item->setIcon(0, QIcon::fromTheme("system-run", m_treeWidget->style()->standardIcon(QStyle::SP_CommandLink)));
+    EmberPath oid = EmberPath::fromString(path);
+    if (oid.isEmpty()) {
+        return;
+    }
+    
+    bool isNew = isNewElement(oid);
+    
+    EmberData::FunctionInfo function;
+    function.path = path;
+    function.oid = oid;
+    function.identifier = identifier;
+    function.description = description;
+    function.argNames = argNames;
+    function.argTypes = argTypes;
+    function.resultNames = resultNames;
+    function.resultTypes = resultTypes;
+    m_model->applyFunction(function);
+    
+    if (isNew) {
+        qCDebug(lcElements).noquote() << QString("Function: %1 [%2] (%3 args)")
+            .arg(!description.isEmpty() ? description : identifier).arg(path).arg(argNames.size());
         
-        if (isNew) {
-            qDebug().noquote() << QString("Function: %1 [%2] (%3 args)")
-                .arg(displayName).arg(path).arg(argNames.size());
-            
-            
-            
-            
-            
-            emit functionItemCreated(path, item);
-        }
+        emit functionItemCreated(path);
     }
 }
 
-void TreeViewController::onItemExpanded(QTreeWidgetItem *item)
+void TreeViewController::onFetchRequested(const QString &path)
 {
-    QString path = item->data(0, Qt::UserRole).toString();
-    QString type = item->text(1);
+    // Queued, so the tree may have been cleared since
+    EmberPath oid = EmberPath::find(path);
+    ElementStore::Kind kind = kindOf(oid);
+    if ((kind != ElementStore::Node && kind != ElementStore::Matrix) || m_fetchedPaths.contains(oid)) {
+        return;
+    }
+    m_fetchedPaths.insert(oid);
     
-    if (path.isEmpty()) {
+    if (kind == ElementStore::Matrix) {
+        qDebug().noquote() << QString("Lazy loading: Requesting matrix details for %1").arg(path);
+        m_connection->sendGetDirectoryForPath(path);
         return;
     }
     
+    const ElementStore &store = m_model->store();
+    int element = store.find(oid);
+    if (store.childCount(element) > 0) {
+        return;
+    }
     
     
-    if (type == "Node" && !m_fetchedPaths.contains(path)) {
-        m_fetchedPaths.insert(path);  
-        
-        
-        
-        
-        bool needsToFetch = (item->childCount() == 0);
-        
-        if (needsToFetch) {
-            
-            QTreeWidgetItem *loadingItem = new QTreeWidgetItem(item);
-            loadingItem->setText(0, "Loading...");
-            loadingItem->setText(1, "");  
-            loadingItem->setForeground(0, QBrush(QColor("#888888")));
-            loadingItem->setFlags(Qt::ItemIsEnabled);  
-            
-            
-            
-            
-            QStringList pathsToPrefetch;
-            pathsToPrefetch << path;  
-            
-            
-            if (QTreeWidgetItem* parent = item->parent()) {
-                for (int i = 0; i < parent->childCount(); i++) {
-                    QTreeWidgetItem* sibling = parent->child(i);
-                    if (sibling != item) {  
-                        QString siblingPath = sibling->data(0, Qt::UserRole).toString();
-                        QString siblingType = sibling->text(1);
-                        
-                        if (siblingType == "Node" && !siblingPath.isEmpty() && 
-                            !m_fetchedPaths.contains(siblingPath)) {
-                            pathsToPrefetch << siblingPath;
-                            m_fetchedPaths.insert(siblingPath);  
-                        }
-                    }
-                }
-            }
-            
-            
-            if (pathsToPrefetch.size() == 1) {
-                qDebug().noquote() << QString("Lazy loading: Requesting children for %1").arg(path);
-                m_connection->sendGetDirectoryForPath(path);
-            } else {
-                qDebug().noquote() << QString("Lazy loading: Batch requesting %1 paths (expanded: %2 + %3 siblings)")
-                    .arg(pathsToPrefetch.size()).arg(path).arg(pathsToPrefetch.size() - 1);
-                m_connection->sendBatchGetDirectory(pathsToPrefetch);
+    // Siblings are likely to be expanded next, ask for them in the same batch
+    QStringList pathsToPrefetch;
+    pathsToPrefetch << path;
+    
+    int parent = store.parent(element);
+    if (parent != ElementStore::NoElement) {
+        for (int row = 0; row < store.childCount(parent); ++row) {
+            int sibling = store.child(parent, row);
+            EmberPath siblingPath = store.path(sibling);
+            if (sibling != element && store.kind(sibling) == ElementStore::Node &&
+                !m_fetchedPaths.contains(siblingPath)) {
+                pathsToPrefetch << siblingPath.toString();
+                m_fetchedPaths.insert(siblingPath);
             }
         }
     }
-    else if (type == "Matrix" && !m_fetchedPaths.contains(path)) {
-        
-        
-        
-        m_fetchedPaths.insert(path);
-        
-        qDebug().noquote() << QString("Lazy loading: Requesting matrix details for %1").arg(path);
+    
+    
+    if (pathsToPrefetch.size() == 1) {
+        qDebug().noquote() << QString("Lazy loading: Requesting children for %1").arg(path);
         m_connection->sendGetDirectoryForPath(path);
+    } else {
+        qDebug().noquote() << QString("Lazy loading: Batch requesting %1 paths (expanded: %2 + %3 siblings)")
+            .arg(pathsToPrefetch.size()).arg(path).arg(pathsToPrefetch.size() - 1);
+        m_connection->sendBatchGetDirectory(pathsToPrefetch);
     }
 }
 
-QTreeWidgetItem* TreeViewController::findOrCreateTreeItem(const QString &path)
+void TreeViewController::onElementsRemoved(const QStringList &paths)
 {
-    if (path.isEmpty()) {
-        return nullptr;
-    }
-    
-    
-    if (m_pathToItem.contains(path)) {
-        return m_pathToItem[path];
+    if (paths.isEmpty()) {
+        return;
     }
     
-    
-    QStringList pathSegments = path.split('.', Qt::SkipEmptyParts);
-    
-    QTreeWidgetItem *parent = nullptr;
-    QString currentPath;
-    
-    
-    for (int i = 0; i < pathSegments.size(); ++i) {
-        if (!currentPath.isEmpty()) {
-            currentPath += ".";
+    QVector<EmberPath> removed;
+    removed.reserve(paths.size());
+    for (const QString &path : paths) {
+        // Never interned means nothing of it is pending or fetched
+        EmberPath root = EmberPath::find(path);
+        if (!root.isEmpty()) {
+            removed.append(root);
         }
-        currentPath += pathSegments[i];
-        
-        
-        QTreeWidgetItem *found = m_pathToItem.value(currentPath, nullptr);
-        
-        
-        if (!found) {
-            QStringList columns;
-            columns << pathSegments[i] << "" << "";
-            
-            if (parent == nullptr) {
-                found = new QTreeWidgetItem(m_treeWidget, columns);
-            } else {
-                found = new QTreeWidgetItem(parent, columns);
+    }
+    auto isRemoved = [&removed](EmberPath path) {
+        for (EmberPath root : removed) {
+            if (root == path || root.isAncestorOf(path)) {
+                return true;
             }
-            found->setData(0, Qt::UserRole, currentPath);
-            
-            
-            m_pathToItem[currentPath] = found;
         }
-        
-        parent = found;
+        return false;
+    };
+    
+    // A pending update would bring a removed parameter back on the next flush
+    for (auto it = m_pendingParameterUpdates.begin(); it != m_pendingParameterUpdates.end();) {
+        it = isRemoved(it.key()) ? m_pendingParameterUpdates.erase(it) : std::next(it);
+    }
+    PerformanceCounters::set(PerformanceCounters::PendingTreeUpdates, m_pendingParameterUpdates.size());
+    for (auto it = m_fetchedPaths.begin(); it != m_fetchedPaths.end();) {
+        it = isRemoved(*it) ? m_fetchedPaths.erase(it) : std::next(it);
     }
     
-    return parent;
+    qDebug().noquote() << QString("Removing %1 elements no longer present on the device").arg(paths.size());
+    m_model->removePaths(paths);
+}
+
+bool TreeViewController::isNewElement(EmberPath path) const
+{
+    return kindOf(path) == ElementStore::Placeholder;
 }
 
-void TreeViewController::setItemDisplayName(QTreeWidgetItem *item, const QString &baseName)
+ElementStore::Kind TreeViewController::kindOf(EmberPath path) const
 {
-    item->setText(0, baseName);
+    const ElementStore &store = m_model->store();
+    int element = store.find(path);
+    return element == ElementStore::NoElement ? ElementStore::Placeholder : store.kind(element);
 }
@@ -38,6 +38,9 @@ void VirtualizedHeaderView::setModel(MatrixModel *model)
         connect(m_model, &MatrixModel::dataChanged, this, [this]() {
             update();
         });
+        connect(m_model, &MatrixModel::labelsChanged, this, [this]() {
+            update();
+        });
     }
     
     update();
@@ -12,11 +12,17 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QDebug>
+#include <limits>
 
 
 static int s_preferredHeaderHeight = 80;
 static int s_preferredSidebarWidth = 80;
 
+static quint64 tileKey(int tileColumn, int tileRow)
+{
+    return (quint64(quint32(tileColumn)) << 32) | quint32(tileRow);
+}
+
 VirtualizedMatrixWidget::VirtualizedMatrixWidget(QWidget *parent)
     : QAbstractScrollArea(parent)
     , m_model(nullptr)
@@ -24,9 +30,11 @@ VirtualizedMatrixWidget::VirtualizedMatrixWidget(QWidget *parent)
     , m_headerHeight(s_preferredHeaderHeight)
     , m_sidebarWidth(s_preferredSidebarWidth)
     , m_selectedCell(-1, -1)
+    , m_selectionAnchor(-1, -1)
     , m_hoveredCell(-1, -1)
     , m_isDragging(false)
     , m_crosspointsEnabled(true)
+    , m_cellIndexDirty(true)
 {
     
     setMouseTracking(true);
@@ -142,6 +150,7 @@ void VirtualizedMatrixWidget::setModel(MatrixModel *model)
         setHeaderHeight(newHeight);
     });
 
+    invalidateTiles();
     updateScrollBars();
     viewport()->update();
 }
@@ -151,6 +160,7 @@ void VirtualizedMatrixWidget::setCellSize(const QSize &size)
     m_cellSize = size;
     m_headerView->setCellWidth(size.width());
     m_sidebarView->setCellHeight(size.height());
+    invalidateTiles();
     updateScrollBars();
     viewport()->update();
 }
@@ -184,6 +194,7 @@ void VirtualizedMatrixWidget::setSelectedCell(int targetIndex, int sourceIndex)
 
     if (row >= 0 && col >= 0) {
         m_selectedCell = QPoint(col, row);
+        m_selectionAnchor = m_selectedCell;
         viewport()->update();
     }
 }
@@ -191,9 +202,21 @@ void VirtualizedMatrixWidget::setSelectedCell(int targetIndex, int sourceIndex)
 void VirtualizedMatrixWidget::clearSelection()
 {
     m_selectedCell = QPoint(-1, -1);
+    m_selectionAnchor = QPoint(-1, -1);
     viewport()->update();
 }
 
+QRect VirtualizedMatrixWidget::selectedRange() const
+{
+    if (m_selectedCell.x() < 0 || m_selectedCell.y() < 0) {
+        return QRect();
+    }
+    if (m_selectionAnchor.x() < 0 || m_selectionAnchor.y() < 0) {
+        return QRect(m_selectedCell, QSize(1, 1));
+    }
+    return QRect(m_selectionAnchor, m_selectedCell).normalized();
+}
+
 void VirtualizedMatrixWidget::refresh()
 {
     viewport()->update();
@@ -243,17 +266,17 @@ void VirtualizedMatrixWidget::setMatrixPath(const QString &path)
     }
 }
 
-void VirtualizedMatrixWidget::setTargetLabel(int targetNumber, const QString &label)
+void VirtualizedMatrixWidget::setTargetLabel(int targetNumber, const QString &label, bool isLabel)
 {
     if (m_model) {
-        m_model->setTargetLabel(targetNumber, label);
+        m_model->setTargetLabel(targetNumber, label, isLabel);
     }
 }
 
-void VirtualizedMatrixWidget::setSourceLabel(int sourceNumber, const QString &label)
+void VirtualizedMatrixWidget::setSourceLabel(int sourceNumber, const QString &label, bool isLabel)
 {
     if (m_model) {
-        m_model->setSourceLabel(sourceNumber, label);
+        m_model->setSourceLabel(sourceNumber, label, isLabel);
     }
 }
 
@@ -295,6 +318,7 @@ void VirtualizedMatrixWidget::endBatchUpdate()
 void VirtualizedMatrixWidget::rebuild()
 {
     
+    invalidateTiles();
     updateScrollBars();
     viewport()->update();
     m_headerView->update();
@@ -426,10 +450,29 @@ void VirtualizedMatrixWidget::paintEvent(QPaintEvent *event)
     QRect visibleCells = visibleCellsRect();
 
     
-    drawConnections(painter, visibleCells);
-    drawGrid(painter, visibleCells);
+    drawTiles(painter, visibleCells);
     drawHover(painter);
     drawSelection(painter);
+    
+    reportVisibleRange(visibleCells);
+}
+
+void VirtualizedMatrixWidget::reportVisibleRange(const QRect &visibleCells)
+{
+    // Painting is the one place that sees every scroll, resize and model change
+    if (visibleCells == m_reportedVisibleCells || visibleCells.isEmpty() || m_matrixPath.isEmpty()) {
+        return;
+    }
+    m_reportedVisibleCells = visibleCells;
+    
+    // The scheduler maps list indices to numbers, so the range stays valid for sparse matrices
+    if (visibleCells.right() >= m_model->targetNumbers().size() ||
+        visibleCells.bottom() >= m_model->sourceNumbers().size()) {
+        return;
+    }
+    
+    emit visibleRangeChanged(m_matrixPath, visibleCells.left(), visibleCells.right(),
+                             visibleCells.top(), visibleCells.bottom());
 }
 
 void VirtualizedMatrixWidget::resizeEvent(QResizeEvent *event)
@@ -445,19 +488,14 @@ void VirtualizedMatrixWidget::mousePressEvent(QMouseEvent *event)
     if (event->button() == Qt::LeftButton) {
         QPoint cell = cellAt(event->pos());
         if (cell.x() >= 0 && cell.y() >= 0) {
+            bool extend = (event->modifiers() & Qt::ShiftModifier) && m_selectedCell.x() >= 0 && m_selectedCell.y() >= 0;
+            if (!extend) {
+                m_selectionAnchor = cell;
+            }
             m_selectedCell = cell;
+            m_isDragging = true;
             
-            
-            
-            const QList<int> &targets = m_model->targetNumbers();
-            const QList<int> &sources = m_model->sourceNumbers();
-            
-            int targetNumber = targets[cell.x()];
-            int sourceNumber = sources[cell.y()];
-            
-            
-            emit crosspointClicked(targetNumber, sourceNumber);
-            emit crosspointClicked(m_matrixPath, targetNumber, sourceNumber);
+            // Crosspoints are emitted on release so a drag becomes one salvo
             viewport()->update();
         }
     }
@@ -470,6 +508,11 @@ void VirtualizedMatrixWidget::mouseMoveEvent(QMouseEvent *event)
     if (!m_model) return;
 
     QPoint cell = cellAt(event->pos());
+    if (m_isDragging && cell.x() >= 0 && cell.y() >= 0 && cell != m_selectedCell) {
+        m_selectedCell = cell;
+        viewport()->update();
+    }
+    
     if (cell != m_hoveredCell) {
         m_hoveredCell = cell;
         
@@ -510,6 +553,13 @@ void VirtualizedMatrixWidget::mouseMoveEvent(QMouseEvent *event)
 
 void VirtualizedMatrixWidget::mouseReleaseEvent(QMouseEvent *event)
 {
+    if (m_isDragging && event->button() == Qt::LeftButton) {
+        m_isDragging = false;
+        if (m_model && m_crosspointsEnabled) {
+            emitSelectionClicked();
+        }
+    }
+
     QAbstractScrollArea::mouseReleaseEvent(event);
 }
 
@@ -535,8 +585,8 @@ void VirtualizedMatrixWidget::keyPressEvent(QKeyEvent *event)
         return;
     }
 
-    int maxCol = m_model->sourceNumbers().size() - 1;
-    int maxRow = m_model->targetNumbers().size() - 1;
+    int maxCol = m_model->targetNumbers().size() - 1;
+    int maxRow = m_model->sourceNumbers().size() - 1;
     QPoint newCell = m_selectedCell;
 
     switch (event->key()) {
@@ -573,6 +623,7 @@ void VirtualizedMatrixWidget::keyPressEvent(QKeyEvent *event)
 
     if (newCell != m_selectedCell) {
         m_selectedCell = newCell;
+        m_selectionAnchor = newCell;
         
         
         QRect cellRect = this->cellRect(newCell.y(), newCell.x());
@@ -601,12 +652,22 @@ void VirtualizedMatrixWidget::keyPressEvent(QKeyEvent *event)
         
         const QList<int> &targets = m_model->targetNumbers();
         const QList<int> &sources = m_model->sourceNumbers();
-        emit crosspointClicked(targets[newCell.y()], sources[newCell.x()]);
+        emit crosspointClicked(targets[newCell.x()], sources[newCell.y()]);
+    }
+}
+
+void VirtualizedMatrixWidget::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::PaletteChange || event->type() == QEvent::StyleChange) {
+        invalidateTiles();
     }
+    QAbstractScrollArea::changeEvent(event);
 }
 
 void VirtualizedMatrixWidget::onModelDataChanged()
 {
+    // Numbers, dimensions or bulk connection state changed, every tile may be stale
+    invalidateTiles();
     updateScrollBars();
     viewport()->update();
 }
@@ -627,8 +688,8 @@ void VirtualizedMatrixWidget::updateScrollBars()
         return;
     }
 
-    int totalWidth = m_model->sourceNumbers().size() * m_cellSize.width();
-    int totalHeight = m_model->targetNumbers().size() * m_cellSize.height();
+    int totalWidth = m_model->targetNumbers().size() * m_cellSize.width();
+    int totalHeight = m_model->sourceNumbers().size() * m_cellSize.height();
 
     int maxScrollX = qMax(0, totalWidth - viewport()->width());
     int maxScrollY = qMax(0, totalHeight - viewport()->height());
@@ -677,58 +738,153 @@ QRect VirtualizedMatrixWidget::visibleCellsRect() const
     int lastRow = (scrollY + viewport()->height() - 1) / m_cellSize.height();
 
     
-    lastCol = qMin(lastCol, m_model->sourceNumbers().size() - 1);
-    lastRow = qMin(lastRow, m_model->targetNumbers().size() - 1);
+    lastCol = qMin(lastCol, m_model->targetNumbers().size() - 1);
+    lastRow = qMin(lastRow, m_model->sourceNumbers().size() - 1);
 
     return QRect(firstCol, firstRow, lastCol - firstCol + 1, lastRow - firstRow + 1);
 }
 
-void VirtualizedMatrixWidget::drawGrid(QPainter &painter, const QRect &visibleCells)
+void VirtualizedMatrixWidget::drawTiles(QPainter &painter, const QRect &visibleCells)
 {
-    painter.setPen(QPen(palette().mid().color(), 1));
+    if (visibleCells.isEmpty()) {
+        return;
+    }
+    ensureCellIndex();
 
-    
-    for (int col = visibleCells.left(); col <= visibleCells.right() + 1; ++col) {
-        int x = col * m_cellSize.width() - horizontalScrollBar()->value();
-        painter.drawLine(x, 0, x, viewport()->height());
+    int tileWidth = TILE_CELLS * m_cellSize.width();
+    int tileHeight = TILE_CELLS * m_cellSize.height();
+    int scrollX = horizontalScrollBar()->value();
+    int scrollY = verticalScrollBar()->value();
+
+    int firstTileColumn = visibleCells.left() / TILE_CELLS;
+    int lastTileColumn = visibleCells.right() / TILE_CELLS;
+    int firstTileRow = visibleCells.top() / TILE_CELLS;
+    int lastTileRow = visibleCells.bottom() / TILE_CELLS;
+
+    for (int tileRow = firstTileRow; tileRow <= lastTileRow; ++tileRow) {
+        for (int tileColumn = firstTileColumn; tileColumn <= lastTileColumn; ++tileColumn) {
+            quint64 key = tileKey(tileColumn, tileRow);
+            auto it = m_tileCache.find(key);
+            if (it == m_tileCache.end()) {
+                it = m_tileCache.insert(key, renderTile(tileColumn, tileRow));
+            }
+            painter.drawPixmap(tileColumn * tileWidth - scrollX, tileRow * tileHeight - scrollY, it.value());
+        }
     }
 
-    
-    for (int row = visibleCells.top(); row <= visibleCells.bottom() + 1; ++row) {
-        int y = row * m_cellSize.height() - verticalScrollBar()->value();
-        painter.drawLine(0, y, viewport()->width(), y);
+    // Only keep what is on screen once the cache grows past its budget
+    if (m_tileCache.size() > MAX_CACHED_TILES) {
+        for (auto it = m_tileCache.begin(); it != m_tileCache.end();) {
+            int tileColumn = int(it.key() >> 32);
+            int tileRow = int(it.key() & 0xffffffff);
+            if (tileColumn < firstTileColumn || tileColumn > lastTileColumn ||
+                tileRow < firstTileRow || tileRow > lastTileRow) {
+                it = m_tileCache.erase(it);
+            } else {
+                ++it;
+            }
+        }
     }
 }
 
-void VirtualizedMatrixWidget::drawConnections(QPainter &painter, const QRect &visibleCells)
+QPixmap VirtualizedMatrixWidget::renderTile(int tileColumn, int tileRow) const
 {
-    if (!m_model) return;
-
-    
     const QList<int> &targets = m_model->targetNumbers();
     const QList<int> &sources = m_model->sourceNumbers();
 
-    
-    painter.setPen(Qt::NoPen);
-    painter.setBrush(QColor(120, 255, 120, 130)); 
-
-    for (int row = visibleCells.top(); row <= visibleCells.bottom(); ++row) {
-        for (int col = visibleCells.left(); col <= visibleCells.right(); ++col) {
-            int targetNumber = targets[col];
-            int sourceNumber = sources[row];
+    int firstCol = tileColumn * TILE_CELLS;
+    int firstRow = tileRow * TILE_CELLS;
+    int lastCol = qMin(firstCol + TILE_CELLS, int(targets.size())) - 1;
+    int lastRow = qMin(firstRow + TILE_CELLS, int(sources.size())) - 1;
+    int cellWidth = m_cellSize.width();
+    int cellHeight = m_cellSize.height();
+
+    // The last tile of a row or column also carries the closing grid line
+    int width = (lastCol - firstCol + 1) * cellWidth + (lastCol == targets.size() - 1 ? 1 : 0);
+    int height = (lastRow - firstRow + 1) * cellHeight + (lastRow == sources.size() - 1 ? 1 : 0);
+
+    qreal ratio = devicePixelRatioF();
+    QPixmap pixmap(QSize(width, height) * ratio);
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(palette().base().color());
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    // Only connected sources between the smallest and largest source number of the tile are visited
+    int minSource = std::numeric_limits<int>::max();
+    int maxSource = std::numeric_limits<int>::min();
+    for (int row = firstRow; row <= lastRow; ++row) {
+        minSource = qMin(minSource, sources[row]);
+        maxSource = qMax(maxSource, sources[row]);
+    }
 
-            if (m_model->isConnected(targetNumber, sourceNumber)) {
-                QRect rect = cellRect(row, col);
-                painter.fillRect(rect, painter.brush());
+    QColor connectedColor(120, 255, 120, 130);
+    const ConnectionStore &store = m_model->connectionStore();
+    for (int col = firstCol; col <= lastCol; ++col) {
+        int x = (col - firstCol) * cellWidth;
+        store.forEachSource(targets[col], minSource, maxSource, [&](int sourceNumber) {
+            int row = m_sourceRows.value(sourceNumber, -1);
+            if (row >= firstRow && row <= lastRow) {
+                painter.fillRect(x, (row - firstRow) * cellHeight, cellWidth, cellHeight, connectedColor);
             }
-        }
+        });
+    }
+
+    painter.setPen(QPen(palette().mid().color(), 1));
+    for (int col = firstCol; col <= lastCol + 1; ++col) {
+        int x = (col - firstCol) * cellWidth;
+        painter.drawLine(x, 0, x, height);
+    }
+    for (int row = firstRow; row <= lastRow + 1; ++row) {
+        int y = (row - firstRow) * cellHeight;
+        painter.drawLine(0, y, width, y);
     }
+
+    return pixmap;
+}
+
+void VirtualizedMatrixWidget::invalidateTiles()
+{
+    m_tileCache.clear();
+    m_cellIndexDirty = true;
+}
+
+void VirtualizedMatrixWidget::ensureCellIndex()
+{
+    if (!m_cellIndexDirty || !m_model) {
+        return;
+    }
+
+    const QList<int> &targets = m_model->targetNumbers();
+    const QList<int> &sources = m_model->sourceNumbers();
+    m_targetColumns.clear();
+    m_sourceRows.clear();
+    m_targetColumns.reserve(targets.size());
+    m_sourceRows.reserve(sources.size());
+    for (int col = 0; col < targets.size(); ++col) {
+        m_targetColumns.insert(targets[col], col);
+    }
+    for (int row = 0; row < sources.size(); ++row) {
+        m_sourceRows.insert(sources[row], row);
+    }
+    m_cellIndexDirty = false;
 }
 
 void VirtualizedMatrixWidget::drawSelection(QPainter &painter)
 {
     if (m_selectedCell.x() < 0 || m_selectedCell.y() < 0) return;
 
+    QRect range = selectedRange();
+    if (range.width() > 1 || range.height() > 1) {
+        QRect rangeRect = cellRect(range.top(), range.left()).united(cellRect(range.bottom(), range.right()));
+        QColor rangeColor = palette().highlight().color();
+        rangeColor.setAlpha(50);
+        painter.setPen(QPen(palette().highlight().color(), 1));
+        painter.setBrush(rangeColor);
+        painter.drawRect(rangeRect.adjusted(1, 1, -1, -1));
+    }
+
     QRect rect = cellRect(m_selectedCell.y(), m_selectedCell.x());
     
     painter.setPen(QPen(palette().highlight().color(), 2));
@@ -767,13 +923,12 @@ void VirtualizedMatrixWidget::invalidateCell(int targetNumber, int sourceNumber)
     if (!m_model) return;
 
     
-    const QList<int> &targets = m_model->targetNumbers();
-    const QList<int> &sources = m_model->sourceNumbers();
-
-    int col = targets.indexOf(targetNumber);
-    int row = sources.indexOf(sourceNumber);
+    ensureCellIndex();
+    int col = m_targetColumns.value(targetNumber, -1);
+    int row = m_sourceRows.value(sourceNumber, -1);
     
     if (row >= 0 && col >= 0) {
+        m_tileCache.remove(tileKey(col / TILE_CELLS, row / TILE_CELLS));
         invalidateCellRegion(row, col);
     }
 }
@@ -799,3 +954,35 @@ int VirtualizedMatrixWidget::preferredSidebarWidth()
     return s_preferredSidebarWidth;
 }
 
+void VirtualizedMatrixWidget::emitSelectionClicked()
+{
+    QRect range = selectedRange();
+    if (range.isEmpty()) return;
+
+    const QList<int> &targets = m_model->targetNumbers();
+    const QList<int> &sources = m_model->sourceNumbers();
+    if (range.right() >= targets.size() || range.bottom() >= sources.size()) return;
+
+    if (range.width() == 1 && range.height() == 1) {
+        int targetNumber = targets[range.left()];
+        int sourceNumber = sources[range.top()];
+        emit crosspointClicked(targetNumber, sourceNumber);
+        emit crosspointClicked(m_matrixPath, targetNumber, sourceNumber);
+        return;
+    }
+
+    if (qint64(range.width()) * range.height() > MAX_SELECTED_CROSSPOINTS) {
+        qWarning().noquote() << QString("Selection of %1 x %2 crosspoints exceeds the limit of %3, ignored")
+                                    .arg(range.width()).arg(range.height()).arg(MAX_SELECTED_CROSSPOINTS);
+        return;
+    }
+
+    QList<QPair<int, int>> crosspoints;
+    crosspoints.reserve(range.width() * range.height());
+    for (int col = range.left(); col <= range.right(); ++col) {
+        for (int row = range.top(); row <= range.bottom(); ++row) {
+            crosspoints.append(qMakePair(targets[col], sources[row]));
+        }
+    }
+    emit crosspointsClicked(m_matrixPath, crosspoints);
+}
@@ -0,0 +1,172 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "../include/DeviceSnapshot.h"
+#include "../include/MappedDeviceSnapshot.h"
+
+
+class TestDeviceSnapshot : public QObject
+{
+    Q_OBJECT
+
+private:
+    static DeviceSnapshot sampleSnapshot()
+    {
+        DeviceSnapshot snapshot;
+        snapshot.deviceName = "Router";
+        snapshot.hostAddress = "10.0.0.5";
+        snapshot.port = 9000;
+        snapshot.captureTime = QDateTime::fromMSecsSinceEpoch(1700000000123);
+        snapshot.rootPaths = {"1"};
+
+        NodeData root;
+        root.path = "1";
+        root.identifier = "router";
+        root.description = "Router";
+        root.isOnline = true;
+        root.childPaths = {"1.1", "1.2", "1.3"};
+        snapshot.nodes.insert(root.path, root);
+
+        ParameterData gain;
+        gain.path = "1.1";
+        gain.identifier = "gain";
+        gain.value = "-6.5";
+        gain.type = 2;
+        gain.access = 3;
+        gain.minimum = -64.5;
+        gain.maximum = 6;
+        gain.isOnline = true;
+        gain.streamIdentifier = 17;
+        gain.streamOffset = 8;
+        snapshot.parameters.insert(gain.path, gain);
+
+        ParameterData mode;
+        mode.path = "1.3";
+        mode.identifier = "mode";
+        mode.value = "1";
+        mode.type = 4;
+        mode.access = 1;
+        mode.enumOptions = {"Off", "On"};
+        mode.enumValues = {0, 1};
+        mode.isOnline = false;
+        snapshot.parameters.insert(mode.path, mode);
+
+        MatrixData matrix;
+        matrix.path = "1.2";
+        matrix.identifier = "matrix";
+        matrix.description = "Video";
+        matrix.type = 1;
+        matrix.targetCount = 4;
+        matrix.sourceCount = 20;
+        matrix.targetNumbers = {0, 1, 2, 3};
+        matrix.targetLabels = {{0, "MON 1"}, {3, "MON 4"}};
+        matrix.sourceLabels = {{19, "CAM 20"}};
+        matrix.connections[{0, 19}] = true;
+        matrix.connections[{3, 0}] = true;
+        matrix.connections[{3, 9}] = true;
+        snapshot.matrices.insert(matrix.path, matrix);
+
+        FunctionData function;
+        function.path = "1.4";
+        function.identifier = "reset";
+        function.argNames = {"hard"};
+        function.argTypes = {4};
+        function.resultNames = {"ok"};
+        function.resultTypes = {4};
+        snapshot.functions.insert(function.path, function);
+
+        return snapshot;
+    }
+
+private slots:
+    void testBinaryRoundTrip()
+    {
+        QTemporaryDir dir;
+        QString filePath = dir.filePath("device.evsnap");
+        DeviceSnapshot original = sampleSnapshot();
+        QVERIFY(original.saveToFile(filePath, DeviceSnapshot::Binary));
+        QVERIFY(MappedDeviceSnapshot::isBinarySnapshot(filePath));
+
+        DeviceSnapshot loaded = DeviceSnapshot::loadFromFile(filePath);
+        QCOMPARE(loaded.deviceName, QString("Router"));
+        QCOMPARE(loaded.hostAddress, QString("10.0.0.5"));
+        QCOMPARE(loaded.port, 9000);
+        QCOMPARE(loaded.captureTime, original.captureTime);
+        QCOMPARE(loaded.rootPaths, QStringList{"1"});
+        QCOMPARE(loaded.nodes["1"].childPaths, original.nodes["1"].childPaths);
+
+        const ParameterData &gain = loaded.parameters["1.1"];
+        QCOMPARE(gain.value, QString("-6.5"));
+        QCOMPARE(gain.minimum.toDouble(), -64.5);
+        QCOMPARE(gain.maximum.typeId(), int(QMetaType::Int));
+        QCOMPARE(gain.maximum.toInt(), 6);
+        QCOMPARE(gain.streamIdentifier, 17);
+        QCOMPARE(gain.streamOffset, 8);
+
+        const ParameterData &mode = loaded.parameters["1.3"];
+        QVERIFY(!mode.minimum.isValid());
+        QVERIFY(!mode.isOnline);
+        QCOMPARE(mode.streamIdentifier, -1);
+        QCOMPARE(mode.streamOffset, 0);
+        QCOMPARE(mode.enumOptions, original.parameters["1.3"].enumOptions);
+        QCOMPARE(mode.enumValues, original.parameters["1.3"].enumValues);
+
+        const MatrixData &matrix = loaded.matrices["1.2"];
+        QCOMPARE(matrix.targetNumbers, original.matrices["1.2"].targetNumbers);
+        QVERIFY(matrix.sourceNumbers.isEmpty());
+        QCOMPARE(matrix.targetLabels, original.matrices["1.2"].targetLabels);
+        QCOMPARE(matrix.sourceLabels, original.matrices["1.2"].sourceLabels);
+        QCOMPARE(matrix.connections, original.matrices["1.2"].connections);
+
+        QCOMPARE(loaded.functions["1.4"].argNames, QStringList{"hard"});
+        QCOMPARE(loaded.functions["1.4"].resultTypes, QList<int>{4});
+    }
+
+    void testLazyMatrixAccess()
+    {
+        QTemporaryDir dir;
+        QString filePath = dir.filePath("device.evsnap");
+        QVERIFY(sampleSnapshot().saveToFile(filePath));
+
+        MappedDeviceSnapshot mapped;
+        QVERIFY(mapped.open(filePath));
+        QCOMPARE(mapped.matrixCount(), 1);
+        QCOMPARE(mapped.findMatrix("1.1"), -1);
+
+        int index = mapped.findMatrix("1.2");
+        QCOMPARE(index, 0);
+        MatrixData header = mapped.matrix(index, false);
+        QCOMPARE(header.targetCount, 4);
+        QVERIFY(header.connections.isEmpty());
+        QCOMPARE(mapped.matrix(index).connections.size(), 3);
+    }
+
+    void testJsonExportStillLoads()
+    {
+        QTemporaryDir dir;
+        QString filePath = dir.filePath("device.json");
+        QVERIFY(sampleSnapshot().saveToFile(filePath, DeviceSnapshot::Json));
+        QVERIFY(!MappedDeviceSnapshot::isBinarySnapshot(filePath));
+
+        DeviceSnapshot loaded = DeviceSnapshot::loadFromFile(filePath);
+        QCOMPARE(loaded.parameterCount(), 2);
+        QCOMPARE(loaded.parameters["1.1"].streamOffset, 8);
+        QCOMPARE(loaded.matrices["1.2"].connections.size(), 3);
+    }
+
+    void testTruncatedFileIsRejected()
+    {
+        QTemporaryDir dir;
+        QString filePath = dir.filePath("device.evsnap");
+        QVERIFY(sampleSnapshot().saveToFile(filePath));
+
+        QFile file(filePath);
+        QVERIFY(file.resize(file.size() - 16));
+
+        MappedDeviceSnapshot mapped;
+        QVERIFY(!mapped.open(filePath));
+        QVERIFY(!mapped.errorString().isEmpty());
+    }
+};
+
+QTEST_MAIN(TestDeviceSnapshot)
+#include "test_device_snapshot.moc"
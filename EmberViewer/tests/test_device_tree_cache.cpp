@@ -0,0 +1,164 @@
+#include <QtTest/QtTest>
+#include <QStandardPaths>
+#include "../include/DeviceTreeCache.h"
+#include "../include/TreeFetchService.h"
+
+
+class TestDeviceTreeCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr const char *HOST_PORT = "192.0.2.1:9000";
+    // Silent requests are retried once after at least two seconds each
+    static constexpr int TIMEOUT_MS = 20000;
+
+    static EmberData::NodeInfo node(const QString &path, const QString &identifier)
+    {
+        EmberData::NodeInfo info;
+        info.path = path;
+        info.identifier = identifier;
+        info.isOnline = true;
+        info.hasIdentifier = true;
+        info.hasDescription = false;
+        return info;
+    }
+
+    static EmberData::ParameterInfo parameter(const QString &path, const QString &identifier, const QString &value)
+    {
+        EmberData::ParameterInfo info;
+        info.path = path;
+        info.number = path.section('.', -1).toInt();
+        info.identifier = identifier;
+        info.value = value;
+        info.access = 3;
+        info.type = 1;
+        info.minimum = -64;
+        info.maximum = 6;
+        info.isOnline = true;
+        info.streamIdentifier = 7;
+        info.streamOffset = 4;
+        info.factor = 1;
+        return info;
+    }
+
+    static EmberData::MatrixInfo matrix(const QString &path)
+    {
+        EmberData::MatrixInfo info;
+        info.path = path;
+        info.number = path.section('.', -1).toInt();
+        info.identifier = "router";
+        info.type = 2;
+        info.targetCount = 16;
+        info.sourceCount = 8;
+        return info;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+    void cleanup()
+    {
+        QFile::remove(DeviceTreeCache(HOST_PORT).filePath());
+    }
+
+    void testSaveAndLoad()
+    {
+        DeviceTreeCache cache(HOST_PORT);
+        QCOMPARE(cache.update(node("1", "device")), DeviceTreeCache::Added);
+        QCOMPARE(cache.update(node("1.1", "inputs")), DeviceTreeCache::Added);
+        QCOMPARE(cache.update(parameter("1.1.1", "gain", "-6")), DeviceTreeCache::Added);
+        QCOMPARE(cache.update(matrix("1.2")), DeviceTreeCache::Added);
+        QVERIFY(cache.isDirty());
+        QVERIFY(cache.save());
+        QVERIFY(!cache.isDirty());
+
+        DeviceTreeCache loaded(HOST_PORT);
+        QVERIFY(loaded.load());
+        QCOMPARE(loaded.nodes().size(), 2);
+        QCOMPARE(loaded.nodes().first().path, QString("1"));
+        QCOMPARE(loaded.parameters().size(), 1);
+        QCOMPARE(loaded.parameters().first().streamOffset, 4);
+        QCOMPARE(loaded.matrices().first().targetCount, 16);
+
+        QCOMPARE(loaded.update(parameter("1.1.1", "gain", "-6")), DeviceTreeCache::Unchanged);
+        QCOMPARE(loaded.update(parameter("1.1.1", "gain", "-3")), DeviceTreeCache::Modified);
+
+        DeviceTreeCache otherDevice("192.0.2.2:9000");
+        QVERIFY(!otherDevice.load());
+    }
+
+    void testRevalidationDropsUnseenElements()
+    {
+        DeviceTreeCache cache(HOST_PORT);
+        cache.update(node("1", "device"));
+        cache.update(node("1.1", "inputs"));
+        cache.update(parameter("1.1.1", "gain", "-6"));
+        cache.update(parameter("1.1.2", "mute", "0"));
+        cache.update(matrix("1.2"));
+        QVERIFY(cache.save());
+
+        // The device answered a walk of the cached tree without 1.1.2 and the matrix
+        DeviceTreeCache revalidated(HOST_PORT);
+        QVERIFY(revalidated.load());
+        QStringList removed = revalidated.retainOnly({"1", "1.1", "1.1.1"});
+        removed.sort();
+        QCOMPARE(removed, QStringList({"1.1.2", "1.2"}));
+        QVERIFY(revalidated.isDirty());
+        QVERIFY(revalidated.save());
+
+        DeviceTreeCache reloaded(HOST_PORT);
+        QVERIFY(reloaded.load());
+        QCOMPARE(reloaded.nodePaths().size(), 2);
+        QCOMPARE(reloaded.parameters().size(), 1);
+        QVERIFY(reloaded.matrices().isEmpty());
+        QVERIFY(reloaded.retainOnly({"1", "1.1", "1.1.1"}).isEmpty());
+        QVERIFY(!reloaded.isDirty());
+    }
+
+    void testRevalidationDropsRemovedNode()
+    {
+        DeviceTreeCache cache(HOST_PORT);
+        cache.update(node("1", "device"));
+        cache.update(node("1.1", "inputs"));
+        cache.update(parameter("1.1.1", "gain", "-6"));
+        cache.update(node("1.2", "outputs"));
+        cache.update(parameter("1.2.1", "level", "0"));
+        cache.update(node("2", "backup"));
+        cache.update(parameter("2.1", "gain", "0"));
+
+        QStringList walk;
+        for (const QString &path : cache.nodePaths()) {
+            walk.append(path + "|Node");
+        }
+        walk.prepend("|Node");
+
+        TreeFetchService service;
+        service.setSendGetDirectoryCallback([](const QStringList &) {});
+        QSignalSpy completed(&service, &TreeFetchService::fetchCompleted);
+        service.startFetch(walk);
+
+        // 1 answers without its deleted child 1.2, whose own request stays silent like the
+        // root and node 2 do
+        QSet<QString> seen;
+        for (const QString &path : {QString("1.1"), QString("1.1.1")}) {
+            seen.insert(path);
+            service.onElementReceived(path, path == "1.1");
+        }
+        QTRY_COMPARE_WITH_TIMEOUT(completed.count(), 1, TIMEOUT_MS);
+        QCOMPARE(completed.first().at(0).toBool(), true);
+        QCOMPARE(service.silentPaths(), QSet<QString>({"", "1.2", "2"}));
+
+        QStringList removed = cache.retainOnly(seen, service.silentPaths());
+        removed.sort();
+        QCOMPARE(removed, QStringList({"1.2", "1.2.1"}));
+        QCOMPARE(cache.nodePaths().size(), 3);
+        QCOMPARE(cache.parameters().size(), 2);
+    }
+};
+
+QTEST_MAIN(TestDeviceTreeCache)
+#include "test_device_tree_cache.moc"
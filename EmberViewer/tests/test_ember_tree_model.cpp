@@ -0,0 +1,213 @@
+#include <QtTest/QtTest>
+#include <QAbstractItemModelTester>
+#include <QSpinBox>
+#include "../include/EmberTreeModel.h"
+#include "../include/ParameterDelegate.h"
+
+
+class TestEmberTreeModel : public QObject
+{
+    Q_OBJECT
+
+private:
+    static EmberData::NodeInfo node(const QString &path, const QString &identifier, bool isOnline = true)
+    {
+        EmberData::NodeInfo info;
+        info.path = path;
+        info.identifier = identifier;
+        info.isOnline = isOnline;
+        info.hasIdentifier = true;
+        info.hasDescription = false;
+        return info;
+    }
+
+    static EmberData::ParameterInfo parameter(const QString &path, const QString &identifier, const QString &value,
+                                              int access = 3, int streamIdentifier = 0)
+    {
+        EmberData::ParameterInfo info;
+        info.path = path;
+        info.number = path.section('.', -1).toInt();
+        info.identifier = identifier;
+        info.value = value;
+        info.access = access;
+        info.type = 1;
+        info.minimum = -64;
+        info.maximum = 6;
+        info.isOnline = true;
+        info.streamIdentifier = streamIdentifier;
+        info.format = "%.1f dB";
+        info.factor = 1;
+        return info;
+    }
+
+private slots:
+    void testStructureAndLayout()
+    {
+        EmberTreeModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+
+
+        model.applyParameters({parameter("1.2.3", "gain", "-6")});
+        QCOMPARE(model.rowCount(), 1);
+
+        QModelIndex root = model.indexForPath("1");
+        QModelIndex placeholder = model.indexForPath("1.2");
+        QModelIndex gain = model.indexForPath("1.2.3");
+        QVERIFY(root.isValid() && placeholder.isValid() && gain.isValid());
+        QCOMPARE(gain.parent(), placeholder);
+        QCOMPARE(placeholder.parent(), root);
+
+
+        QCOMPARE(placeholder.data().toString(), QString("2"));
+        QCOMPARE(model.index(0, EmberTreeModel::TypeColumn, root).data().toString(), QString());
+
+
+        model.applyNodes({node("1", "device"), node("1.2", "audio")});
+        QCOMPARE(model.rowCount(), 1);
+        QCOMPARE(placeholder.data().toString(), QString("audio"));
+        QCOMPARE(model.index(0, EmberTreeModel::TypeColumn, root).data().toString(), QString("Node"));
+        QCOMPARE(model.store().size(), 3);
+    }
+
+    void testBatchedSignals()
+    {
+        EmberTreeModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+        QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+        model.applyParameters({parameter("1.1.1", "gain", "-6"), parameter("1.2.1", "level", "-20"),
+                               parameter("1.1.2", "mute", "0")});
+
+        // One insertion each under the root, 1, 1.1 and 1.2
+        QCOMPARE(inserted.count(), 4);
+        QModelIndex root = model.indexForPath("1");
+        for (const QList<QVariant> &arguments : std::as_const(inserted)) {
+            if (arguments.at(0).value<QModelIndex>() == root) {
+                QCOMPARE(arguments.at(1).toInt(), 0);
+                QCOMPARE(arguments.at(2).toInt(), 1);
+            }
+        }
+        QCOMPARE(model.rowCount(model.indexForPath("1.1")), 2);
+
+        // One range per parent of the applied parameters
+        QCOMPARE(changed.count(), 2);
+    }
+
+    void testParameterRoles()
+    {
+        EmberTreeModel model;
+        model.applyParameters({parameter("1.1", "gain", "-6"), parameter("1.2", "level", "-20", 1, 42)});
+
+        QModelIndex gain = model.indexForPath("1.1");
+        QCOMPARE(gain.data(Qt::UserRole).toString(), QString("1.1"));
+        QCOMPARE(gain.data(Qt::UserRole + 1).toInt(), 1);
+        QCOMPARE(gain.data(Qt::UserRole + 2).toInt(), 3);
+        QCOMPARE(gain.data(Qt::UserRole + 3).toInt(), -64);
+        QCOMPARE(gain.data(Qt::UserRole + 4).toInt(), 6);
+        QCOMPARE(gain.data(Qt::UserRole + 10).toString(), QString("%.1f dB"));
+
+        QModelIndex gainValue = model.indexForPath("1.1", EmberTreeModel::ValueColumn);
+        QCOMPARE(gainValue.data().toString(), QString("-6"));
+        QVERIFY(model.flags(gainValue) & Qt::ItemIsEditable);
+
+
+        QModelIndex meterValue = model.indexForPath("1.2", EmberTreeModel::ValueColumn);
+        QCOMPARE(meterValue.data().toString(), QString());
+        QVERIFY(!(model.flags(meterValue) & Qt::ItemIsEditable));
+    }
+
+    void testValueUpdates()
+    {
+        EmberTreeModel model;
+        model.applyParameters({parameter("1.1", "gain", "-6")});
+        QSignalSpy spy(&model, &QAbstractItemModel::dataChanged);
+
+        model.setParameterValue("1.1", "-3");
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(model.indexForPath("1.1", EmberTreeModel::ValueColumn).data().toString(), QString("-3"));
+
+
+        model.setParameterValue("1.1", "-3");
+        QCOMPARE(spy.count(), 1);
+    }
+
+    void testParameterDelegateEditsThroughModel()
+    {
+        EmberTreeModel model;
+        model.applyParameters({parameter("1.1", "gain", "-6")});
+        ParameterDelegate delegate;
+        QSignalSpy spy(&delegate, &ParameterDelegate::valueChanged);
+
+        QWidget parent;
+        QModelIndex gainValue = model.indexForPath("1.1", EmberTreeModel::ValueColumn);
+        QScopedPointer<QWidget> editor(delegate.createEditor(&parent, QStyleOptionViewItem(), gainValue));
+        QSpinBox *spinBox = qobject_cast<QSpinBox*>(editor.data());
+        QVERIFY(spinBox);
+        QCOMPARE(spinBox->minimum(), -64);
+        QCOMPARE(spinBox->maximum(), 6);
+
+        delegate.setEditorData(spinBox, gainValue);
+        QCOMPARE(spinBox->value(), -6);
+
+
+        spinBox->setValue(-12);
+        delegate.setModelData(spinBox, &model, gainValue);
+        QCOMPARE(gainValue.data().toString(), QString("-12"));
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.first().at(0).toString(), QString("1.1"));
+        QCOMPARE(spy.first().at(1).toString(), QString("-12"));
+    }
+
+    void testLazyFetch()
+    {
+        EmberTreeModel model;
+        model.applyNodes({node("1", "device")});
+        QSignalSpy spy(&model, &EmberTreeModel::fetchRequested);
+
+        QModelIndex root = model.indexForPath("1");
+        QVERIFY(model.hasChildren(root));
+        QVERIFY(model.canFetchMore(root));
+
+        model.fetchMore(root);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.first().first().toString(), QString("1"));
+        QVERIFY(!model.canFetchMore(root));
+        QVERIFY(!model.hasChildren(root));
+    }
+
+    void testRemovePaths()
+    {
+        EmberTreeModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        model.applyNodes({node("1", "device"), node("1.1", "inputs"), node("1.2", "outputs"), node("1.3", "meters")});
+        model.applyParameters({parameter("1.1.1", "gain", "-6"), parameter("1.3.1", "level", "-20")});
+
+        QModelIndex root = model.indexForPath("1");
+        QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+        model.removePaths({"1.1.1", "1.1", "1.4"});
+
+        QCOMPARE(removed.count(), 2);
+        QCOMPARE(model.rowCount(root), 2);
+        QVERIFY(!model.indexForPath("1.1").isValid());
+        QVERIFY(!model.indexForPath("1.1.1").isValid());
+
+        // Later siblings move up a row
+        QModelIndex meters = model.indexForPath("1.3");
+        QCOMPARE(meters.row(), 1);
+        QCOMPARE(model.index(1, EmberTreeModel::NameColumn, root), meters);
+        QCOMPARE(model.indexForPath("1.3.1").parent(), meters);
+
+        // A removed path can arrive again as a new element, in a freed slot
+        int slots = model.store().size();
+        model.applyNodes({node("1.1", "inputs")});
+        model.applyParameters({parameter("1.1.1", "gain", "-6")});
+        QCOMPARE(model.rowCount(root), 3);
+        QCOMPARE(model.indexForPath("1.1").row(), 2);
+        QCOMPARE(model.store().size(), slots);
+        QCOMPARE(model.indexForPath("1.1.1", EmberTreeModel::ValueColumn).data().toString(), QString("-6"));
+    }
+};
+
+QTEST_MAIN(TestEmberTreeModel)
+#include "test_ember_tree_model.moc"
@@ -0,0 +1,144 @@
+#include <QtTest/QtTest>
+#include "../include/GlowParser.h"
+#include <ember/glow/GlowRootElementCollection.hpp>
+#include <ember/glow/GlowQualifiedNode.hpp>
+#include <ember/glow/GlowNode.hpp>
+#include <ember/glow/GlowParameter.hpp>
+#include <ember/glow/GlowQualifiedParameter.hpp>
+#include <ember/glow/GlowStreamCollection.hpp>
+#include <ember/glow/StreamFormat.hpp>
+#include <ember/util/OctetStream.hpp>
+#include <cstring>
+
+
+class TestGlowParser : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray encode(libember::dom::Node *root)
+    {
+        libember::util::OctetStream stream;
+        root->encode(stream);
+        delete root;
+
+        QByteArray bytes;
+        for (auto it = stream.begin(); it != stream.end(); ++it) {
+            bytes.append(static_cast<char>(*it));
+        }
+        return bytes;
+    }
+
+    static libember::glow::GlowQualifiedParameter* streamParameter(int number, int offset,
+                                                                    libember::glow::StreamFormat::_Domain format, int factor)
+    {
+        libember::ber::ObjectIdentifier path;
+        path.push_back(1);
+        path.push_back(number);
+
+        auto parameter = new libember::glow::GlowQualifiedParameter(path);
+        parameter->setIdentifier(QString("channel%1").arg(number).toStdString());
+        parameter->setStreamIdentifier(7);
+        parameter->setStreamDescriptor(format, offset);
+        parameter->setFactor(factor);
+        return parameter;
+    }
+
+private slots:
+    void testPackedStreamIsDecodedInOneUpdate()
+    {
+        GlowParser parser;
+        QList<QVector<EmberData::StreamValue>> updates;
+        connect(&parser, &GlowParser::streamValuesReceived, this,
+                [&](const QVector<EmberData::StreamValue> &values) { updates.append(values); });
+
+        QList<int> offsets;
+        connect(&parser, &GlowParser::parameterReceived, this,
+                [&](const EmberData::ParameterInfo &param) { offsets.append(param.streamOffset); });
+
+        auto root = new libember::glow::GlowRootElementCollection();
+        root->insert(root->end(), streamParameter(1, 0, libember::glow::StreamFormat::SignedInt16BigEndian, 32));
+        root->insert(root->end(), streamParameter(2, 2, libember::glow::StreamFormat::IeeeFloat32LittleEndian, 1));
+        parser.parseEmberData(encode(root));
+        QVERIFY(offsets.contains(0));
+        QVERIFY(offsets.contains(2));
+
+        // -256 big endian, followed by -6.5f little endian
+        std::vector<unsigned char> packed = {0xFF, 0x00, 0, 0, 0, 0};
+        float level = -6.5f;
+        std::memcpy(&packed[2], &level, sizeof(level));
+
+        auto streams = libember::glow::GlowStreamCollection::create();
+        streams->insert(7, packed.begin(), packed.end());
+        streams->insert(9, 42);
+        parser.parseEmberData(encode(streams));
+
+        QCOMPARE(updates.size(), 1);
+        const QVector<EmberData::StreamValue> &values = updates.first();
+        QCOMPARE(values.size(), 3);
+        QCOMPARE(values[0].streamIdentifier, 7);
+        QCOMPARE(values[0].offset, 0);
+        QCOMPARE(values[0].value, -8.0);
+        QCOMPARE(values[1].offset, 2);
+        QCOMPARE(values[1].value, -6.5);
+        QCOMPARE(values[2].streamIdentifier, 9);
+        QCOMPARE(values[2].value, 42.0);
+    }
+
+    void testUnknownAndShortPackedStreamsAreSkipped()
+    {
+        GlowParser parser;
+        int updateCount = 0;
+        connect(&parser, &GlowParser::streamValuesReceived, this,
+                [&](const QVector<EmberData::StreamValue> &) { ++updateCount; });
+
+        auto root = new libember::glow::GlowRootElementCollection();
+        root->insert(root->end(), streamParameter(1, 4, libember::glow::StreamFormat::UnsignedInt32BigEndian, 1));
+        parser.parseEmberData(encode(root));
+
+        std::vector<unsigned char> shortBuffer = {1, 2, 3, 4, 5};
+        auto streams = libember::glow::GlowStreamCollection::create();
+        streams->insert(7, shortBuffer.begin(), shortBuffer.end());
+        streams->insert(8, shortBuffer.begin(), shortBuffer.end());
+        parser.parseEmberData(encode(streams));
+
+        QCOMPARE(updateCount, 0);
+    }
+
+    void testElementsCarryInternedPath()
+    {
+        GlowParser parser;
+        QList<EmberData::NodeInfo> nodes;
+        QList<EmberData::ParameterInfo> parameters;
+        connect(&parser, &GlowParser::nodeReceived, this,
+                [&](const EmberData::NodeInfo &node) { nodes.append(node); });
+        connect(&parser, &GlowParser::parameterReceived, this,
+                [&](const EmberData::ParameterInfo &param) { parameters.append(param); });
+
+        libember::ber::ObjectIdentifier path;
+        path.push_back(1);
+        path.push_back(2);
+        auto qualified = new libember::glow::GlowQualifiedNode(path);
+        qualified->setIdentifier("device");
+        auto node = new libember::glow::GlowNode(qualified, 3);
+        node->setIdentifier("channel");
+        auto parameter = new libember::glow::GlowParameter(node, 4);
+        parameter->setIdentifier("gain");
+
+        auto root = new libember::glow::GlowRootElementCollection();
+        root->insert(root->end(), qualified);
+        parser.parseEmberData(encode(root));
+
+        QCOMPARE(nodes.size(), 2);
+        QCOMPARE(nodes[0].path, QString("1.2"));
+        QCOMPARE(nodes[0].oid, EmberPath::fromString(u"1.2"));
+        QCOMPARE(nodes[1].path, QString("1.2.3"));
+        QCOMPARE(nodes[1].oid, nodes[0].oid.child(3));
+        QCOMPARE(parameters.size(), 1);
+        QCOMPARE(parameters[0].path, QString("1.2.3.4"));
+        QCOMPARE(parameters[0].oid.toString(), QString("1.2.3.4"));
+    }
+};
+
+QTEST_MAIN(TestGlowParser)
+#include "test_glow_parser.moc"
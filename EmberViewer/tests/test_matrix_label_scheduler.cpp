@@ -0,0 +1,116 @@
+#include <QtTest/QtTest>
+#include "../include/MatrixLabelScheduler.h"
+
+
+class TestMatrixLabelScheduler : public QObject
+{
+    Q_OBJECT
+
+private:
+    static void receiveAll(MatrixLabelScheduler &scheduler, const QVector<MatrixLabelScheduler::Request> &requests)
+    {
+        for (const MatrixLabelScheduler::Request &request : requests) {
+            scheduler.markReceived(request.matrixPath, request.type, request.number);
+        }
+    }
+
+private slots:
+    void testVisibleRangeComesFirst()
+    {
+        MatrixLabelScheduler scheduler(8);
+        scheduler.addMatrix("1.2", 4096, 4096);
+        scheduler.setVisibleRange("1.2", 2000, 2003, 100, 101);
+
+        QVector<MatrixLabelScheduler::Request> requests = scheduler.takeRequests(0);
+        QCOMPARE(requests.size(), 8);
+        for (int i = 0; i < 4; ++i) {
+            QCOMPARE(requests[i].type, MatrixLabelScheduler::Target);
+            QCOMPARE(requests[i].number, 2000 + i);
+        }
+        QCOMPARE(requests[4].type, MatrixLabelScheduler::Source);
+        QCOMPARE(requests[4].number, 100);
+        QCOMPARE(requests[5].number, 101);
+
+        // Next page after the visible targets
+        QCOMPARE(requests[6].type, MatrixLabelScheduler::Target);
+        QCOMPARE(requests[6].number, 2004);
+    }
+
+    void testWindowIsBounded()
+    {
+        MatrixLabelScheduler scheduler(16);
+        scheduler.addMatrix("1", 100, 100);
+        scheduler.addMatrix("2", 10, 10);
+
+        QCOMPARE(scheduler.takeRequests(0).size(), 16);
+        QVERIFY(scheduler.takeRequests(0).isEmpty());
+
+        int total = 16;
+        receiveAll(scheduler, scheduler.takeExpired(0, 0));
+        while (!scheduler.isIdle()) {
+            QVector<MatrixLabelScheduler::Request> requests = scheduler.takeRequests(0);
+            QVERIFY(!requests.isEmpty());
+            QVERIFY(scheduler.inFlightCount() <= 16);
+            total += requests.size();
+            receiveAll(scheduler, requests);
+        }
+        QCOMPARE(total, 220);
+        QVERIFY(scheduler.hasAnswers("2"));
+    }
+
+    void testLabelsArrivingUnrequestedAreSkipped()
+    {
+        MatrixLabelScheduler scheduler(4);
+        scheduler.addMatrix("1", 4, 0);
+        scheduler.markReceived("1", MatrixLabelScheduler::Target, 0);
+        scheduler.markReceived("1", MatrixLabelScheduler::Target, 1);
+
+        QVector<MatrixLabelScheduler::Request> requests = scheduler.takeRequests(0);
+        QCOMPARE(requests.size(), 2);
+        QCOMPARE(requests[0].number, 2);
+        QVERIFY(!scheduler.hasAnswers("1"));
+    }
+
+    void testExpiredRequestsAreGivenUp()
+    {
+        MatrixLabelScheduler scheduler(4);
+        scheduler.addMatrix("1", 3, 0);
+        QCOMPARE(scheduler.takeRequests(0).size(), 3);
+
+        QVERIFY(scheduler.takeExpired(1000, 3000).isEmpty());
+        QCOMPARE(scheduler.takeExpired(5000, 3000).size(), 3);
+        QCOMPARE(scheduler.inFlightCount(), 0);
+        QVERIFY(scheduler.isIdle());
+        QVERIFY(!scheduler.hasAnswers("1"));
+    }
+
+    void testSparseNumbersAreMappedFromIndices()
+    {
+        MatrixLabelScheduler scheduler(2);
+        scheduler.addMatrix("1", 4, 0);
+        QCOMPARE(scheduler.takeRequests(0).size(), 2);
+
+        // The target list arrives after the fetch started; in-flight guesses are asked again
+        scheduler.setNumbers("1", MatrixLabelScheduler::Target, {10, 20, 30, 40});
+        QCOMPARE(scheduler.inFlightCount(), 0);
+        scheduler.setVisibleRange("1", 2, 3, 0, -1);
+
+        QVector<MatrixLabelScheduler::Request> requests = scheduler.takeRequests(0);
+        QCOMPARE(requests.size(), 2);
+        QCOMPARE(requests[0].number, 30);
+        QCOMPARE(requests[1].number, 40);
+
+        receiveAll(scheduler, requests);
+        scheduler.markReceived("1", MatrixLabelScheduler::Target, 10);
+        scheduler.markReceived("1", MatrixLabelScheduler::Target, 3);
+
+        requests = scheduler.takeRequests(0);
+        QCOMPARE(requests.size(), 1);
+        QCOMPARE(requests[0].number, 20);
+        receiveAll(scheduler, requests);
+        QVERIFY(scheduler.isIdle());
+    }
+};
+
+QTEST_MAIN(TestMatrixLabelScheduler)
+#include "test_matrix_label_scheduler.moc"
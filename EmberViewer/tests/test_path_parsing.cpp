@@ -1,6 +1,7 @@
 #include <QtTest/QtTest>
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
+#include "EmberPath.h"
 
 
 class TestPathParsing : public QObject
@@ -99,6 +100,59 @@ private slots:
         QCOMPARE(getDepth("1.2.3"), 3);
         QCOMPARE(getDepth(""), 0);
     }
+    
+    void testEmberPathInterning()
+    {
+        EmberPath path = EmberPath::fromString(QStringLiteral("1.3.7.12"));
+        
+        QCOMPARE(path, EmberPath::fromString(QStringLiteral("1.3.7.12")));
+        QCOMPARE(path, EmberPath::fromNumbers({1, 3, 7, 12}));
+        QCOMPARE(path, EmberPath::fromString(QStringLiteral("1.3.7")).child(12));
+        QVERIFY(path != EmberPath::fromString(QStringLiteral("1.3.7.13")));
+        
+        QCOMPARE(path.toString(), QString("1.3.7.12"));
+        QCOMPARE(path.depth(), 4);
+        QCOMPARE(path.number(), 12);
+        QCOMPARE(path.numbers(), QVector<int>({1, 3, 7, 12}));
+    }
+    
+    void testEmberPathSegmentation()
+    {
+        QVERIFY(EmberPath::fromString(QString()).isEmpty());
+        QCOMPARE(EmberPath::fromString(QString()).depth(), 0);
+        QCOMPARE(EmberPath::fromString(QStringLiteral("1.2.3.")), EmberPath::fromString(QStringLiteral("1.2.3")));
+        QCOMPARE(EmberPath::fromString(QStringLiteral("1.2.666999666.1.5")).ancestor(2).toString(), QString("1.2"));
+    }
+    
+    void testEmberPathAncestry()
+    {
+        EmberPath root = EmberPath::fromString(QStringLiteral("1"));
+        EmberPath identity = EmberPath::fromString(QStringLiteral("1.2"));
+        EmberPath name = EmberPath::fromString(QStringLiteral("1.2.3"));
+        
+        QCOMPARE(name.parent(), identity);
+        QCOMPARE(identity.parent(), root);
+        QVERIFY(root.parent().isEmpty());
+        
+        QVERIFY(identity.isAncestorOf(name));
+        QVERIFY(root.isAncestorOf(name));
+        QVERIFY(!name.isAncestorOf(identity));
+        QVERIFY(!identity.isAncestorOf(identity));
+        QVERIFY(!EmberPath::fromString(QStringLiteral("1.3")).isAncestorOf(name));
+    }
+    
+    void testEmberPathFindDoesNotIntern()
+    {
+        EmberPath known = EmberPath::fromString(QStringLiteral("4.5.6"));
+        int interned = EmberPath::internedCount();
+        
+        QCOMPARE(EmberPath::find(QStringLiteral("4.5.6")), known);
+        QCOMPARE(EmberPath::find(QStringLiteral("4.5")), known.parent());
+        QVERIFY(EmberPath::find(QStringLiteral("4.5.7")).isEmpty());
+        QVERIFY(EmberPath::find(QStringLiteral("4.5.6.1")).isEmpty());
+        QVERIFY(EmberPath::find(QString()).isEmpty());
+        QCOMPARE(EmberPath::internedCount(), interned);
+    }
 
 private:
     QTreeWidget *m_treeWidget;
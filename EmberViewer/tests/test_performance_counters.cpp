@@ -0,0 +1,77 @@
+#include <QtTest/QtTest>
+#include "../include/PerformanceCounters.h"
+
+
+class TestPerformanceCounters : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        PerformanceCounters::reset();
+        PerformanceCounters::snapshot();
+    }
+
+    void testCountersAccumulate()
+    {
+        PerformanceCounters::add(PerformanceCounters::BytesIn, 1000);
+        PerformanceCounters::add(PerformanceCounters::BytesIn, 24);
+        PerformanceCounters::add(PerformanceCounters::FramesIn);
+
+        PerformanceCounters::Snapshot snapshot = PerformanceCounters::snapshot();
+        QCOMPARE(snapshot.counters[PerformanceCounters::BytesIn], quint64(1024));
+        QCOMPARE(snapshot.counters[PerformanceCounters::FramesIn], quint64(1));
+        QCOMPARE(snapshot.counters[PerformanceCounters::BytesOut], quint64(0));
+    }
+
+    void testTimerMaxIsPerSnapshot()
+    {
+        PerformanceCounters::record(PerformanceCounters::DecodeMessage, 3000);
+        PerformanceCounters::record(PerformanceCounters::DecodeMessage, 9000);
+        PerformanceCounters::record(PerformanceCounters::DecodeMessage, -5);
+
+        PerformanceCounters::Snapshot first = PerformanceCounters::snapshot();
+        QCOMPARE(first.timers[PerformanceCounters::DecodeMessage].count, quint64(3));
+        QCOMPARE(first.timers[PerformanceCounters::DecodeMessage].totalNs, quint64(12000));
+        QCOMPARE(first.timers[PerformanceCounters::DecodeMessage].maxNs, quint64(9000));
+
+        PerformanceCounters::record(PerformanceCounters::DecodeMessage, 1000);
+        PerformanceCounters::Snapshot second = PerformanceCounters::snapshot();
+        QCOMPARE(second.timers[PerformanceCounters::DecodeMessage].count, quint64(4));
+        QCOMPARE(second.timers[PerformanceCounters::DecodeMessage].maxNs, quint64(1000));
+    }
+
+    void testGaugesKeepLatestValue()
+    {
+        PerformanceCounters::set(PerformanceCounters::PendingBatches, 3);
+        PerformanceCounters::set(PerformanceCounters::PendingBatches, 1);
+        QCOMPARE(PerformanceCounters::snapshot().gauges[PerformanceCounters::PendingBatches], qint64(1));
+    }
+
+    void testConcurrentRecording()
+    {
+        auto work = []() {
+            for (int i = 0; i < 10000; ++i) {
+                PerformanceCounters::add(PerformanceCounters::ElementsDecoded);
+                PerformanceCounters::record(PerformanceCounters::ApplyTree, i);
+            }
+        };
+        std::unique_ptr<QThread> threads[4];
+        for (auto &thread : threads) {
+            thread.reset(QThread::create(work));
+            thread->start();
+        }
+        for (auto &thread : threads) {
+            thread->wait();
+        }
+
+        PerformanceCounters::Snapshot snapshot = PerformanceCounters::snapshot();
+        QCOMPARE(snapshot.counters[PerformanceCounters::ElementsDecoded], quint64(40000));
+        QCOMPARE(snapshot.timers[PerformanceCounters::ApplyTree].count, quint64(40000));
+        QCOMPARE(snapshot.timers[PerformanceCounters::ApplyTree].maxNs, quint64(9999));
+    }
+};
+
+QTEST_MAIN(TestPerformanceCounters)
+#include "test_performance_counters.moc"
@@ -0,0 +1,178 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "../include/S101Capture.h"
+#include "../include/S101Replayer.h"
+#include "../include/S101Protocol.h"
+#include <ember/glow/GlowRootElementCollection.hpp>
+#include <ember/glow/GlowQualifiedParameter.hpp>
+#include <ember/util/OctetStream.hpp>
+
+
+class TestS101Capture : public QObject
+{
+    Q_OBJECT
+
+private:
+    // One S101 frame carrying a root with the given number of parameters
+    static QByteArray parameterFrame(int parameterCount)
+    {
+        auto root = new libember::glow::GlowRootElementCollection();
+        for (int i = 1; i <= parameterCount; ++i) {
+            libember::ber::ObjectIdentifier path;
+            path.push_back(1);
+            path.push_back(i);
+
+            auto parameter = new libember::glow::GlowQualifiedParameter(path);
+            parameter->setIdentifier(QString("gain%1").arg(i).toStdString());
+            parameter->setValue(long(i));
+            root->insert(root->end(), parameter);
+        }
+
+        libember::util::OctetStream stream;
+        root->encode(stream);
+        delete root;
+
+        S101Protocol protocol;
+        return protocol.encodeEmberData(stream);
+    }
+
+    static S101CaptureRecord record(S101CaptureRecord::Direction direction, qint64 timestampUs, const QByteArray &data)
+    {
+        S101CaptureRecord result;
+        result.direction = direction;
+        result.timestampUs = timestampUs;
+        result.data = data;
+        return result;
+    }
+
+private slots:
+    void testWriteAndReadBack()
+    {
+        QTemporaryDir dir;
+        QString path = dir.filePath("session.evcap");
+
+        S101CaptureWriter writer;
+        QVERIFY(writer.open(path));
+        writer.append(S101CaptureRecord::Outbound, QByteArray("request"));
+        writer.append(S101CaptureRecord::Inbound, QByteArray("response"));
+        writer.append(S101CaptureRecord::Inbound, QByteArray());
+        writer.append(S101CaptureRecord::Inbound, QByteArray(100000, 'x'));
+        QCOMPARE(writer.recordCount(), qint64(3));
+        writer.close();
+
+        QString error;
+        QVector<S101CaptureRecord> records = S101CaptureReader::readAll(path, &error);
+        QVERIFY(error.isEmpty());
+        QCOMPARE(records.size(), 3);
+        QCOMPARE(records[0].direction, S101CaptureRecord::Outbound);
+        QCOMPARE(records[0].data, QByteArray("request"));
+        QCOMPARE(records[1].direction, S101CaptureRecord::Inbound);
+        QCOMPARE(records[1].data, QByteArray("response"));
+        QCOMPARE(records[2].data.size(), 100000);
+        QVERIFY(records[0].timestampUs <= records[1].timestampUs);
+        QVERIFY(records[1].timestampUs <= records[2].timestampUs);
+    }
+
+    void testTruncatedCaptureKeepsCompleteRecords()
+    {
+        QTemporaryDir dir;
+        QString path = dir.filePath("crashed.evcap");
+
+        S101CaptureWriter writer;
+        QVERIFY(writer.open(path));
+        writer.append(S101CaptureRecord::Inbound, QByteArray("complete"));
+        writer.append(S101CaptureRecord::Inbound, QByteArray("cut short"));
+        writer.close();
+
+        QFile file(path);
+        QVERIFY(file.resize(file.size() - 3));
+
+        QString error;
+        QVector<S101CaptureRecord> records = S101CaptureReader::readAll(path, &error);
+        QCOMPARE(records.size(), 1);
+        QCOMPARE(records[0].data, QByteArray("complete"));
+        QCOMPARE(error, QString("Capture is truncated"));
+    }
+
+    void testRejectsOtherFiles()
+    {
+        QTemporaryDir dir;
+        QString path = dir.filePath("snapshot.json");
+
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("{\"nodes\": []}");
+        file.close();
+
+        QString error;
+        QVERIFY(S101CaptureReader::readAll(path, &error).isEmpty());
+        QCOMPARE(error, QString("Not an S101 capture"));
+    }
+
+    void testDecodeSkipsOutboundAndReassemblesFrames()
+    {
+        QByteArray frame = parameterFrame(3);
+        int split = frame.size() / 2;
+
+        S101Replayer replayer;
+        replayer.setRecords({
+            record(S101CaptureRecord::Outbound, 0, parameterFrame(1)),
+            record(S101CaptureRecord::Inbound, 1000, frame.left(split)),
+            record(S101CaptureRecord::Inbound, 2000, frame.mid(split)),
+        });
+        QCOMPARE(replayer.chunkCount(), 2);
+        QCOMPARE(replayer.durationUs(), qint64(1000));
+
+        S101Replayer::DecodeStats stats = replayer.decode();
+        QCOMPARE(stats.bytes, qint64(frame.size()));
+        QCOMPARE(stats.messages, qint64(1));
+        QCOMPARE(stats.elements, qint64(3));
+        QCOMPARE(stats.errors, 0);
+    }
+
+    void testPlaybackPreservesOrder()
+    {
+        QVector<S101CaptureRecord> records;
+        for (int i = 0; i < 200; ++i) {
+            records.append(record(S101CaptureRecord::Inbound, i, QByteArray::number(i)));
+        }
+
+        S101Replayer replayer;
+        replayer.setRecords(records);
+
+        QList<QByteArray> received;
+        bool finished = false;
+        connect(&replayer, &S101Replayer::dataReady, this, [&](const QByteArray &data) { received.append(data); });
+        connect(&replayer, &S101Replayer::finished, this, [&]() { finished = true; });
+
+        replayer.start(S101Replayer::AsFastAsPossible);
+        QTRY_VERIFY(finished);
+        QCOMPARE(received.size(), 200);
+        QCOMPARE(received.first(), QByteArray("0"));
+        QCOMPARE(received.last(), QByteArray("199"));
+    }
+
+    void testOriginalTimingWaitsForTimestamps()
+    {
+        S101Replayer replayer;
+        replayer.setRecords({
+            record(S101CaptureRecord::Inbound, 0, QByteArray("first")),
+            record(S101CaptureRecord::Inbound, 40000, QByteArray("second")),
+        });
+
+        int received = 0;
+        bool finished = false;
+        connect(&replayer, &S101Replayer::dataReady, this, [&]() { ++received; });
+        connect(&replayer, &S101Replayer::finished, this, [&]() { finished = true; });
+
+        QElapsedTimer clock;
+        clock.start();
+        replayer.start(S101Replayer::OriginalTiming);
+        QTRY_VERIFY(finished);
+        QCOMPARE(received, 2);
+        QVERIFY(clock.elapsed() >= 35);
+    }
+};
+
+QTEST_MAIN(TestS101Capture)
+#include "test_s101_capture.moc"
@@ -0,0 +1,145 @@
+#include <QtTest/QtTest>
+#include "../include/SyntheticDeviceGenerator.h"
+
+
+class TestSyntheticDevice : public QObject
+{
+    Q_OBJECT
+
+private:
+    static qint64 elementsOf(const DeviceSnapshot &snapshot)
+    {
+        return qint64(snapshot.nodeCount()) + snapshot.parameterCount() + snapshot.matrixCount();
+    }
+
+private slots:
+    void testElementCountMatchesShape()
+    {
+        SyntheticDeviceGenerator::Options options;
+        options.depth = 2;
+        options.fanOut = 3;
+        options.parametersPerNode = 5;
+        options.matrixCount = 2;
+        options.streamCount = 4;
+
+        DeviceSnapshot snapshot = SyntheticDeviceGenerator::generate(options);
+
+        // Root, 3 + 9 tree nodes, routing and meters
+        QCOMPARE(snapshot.nodeCount(), 1 + 3 + 9 + 2);
+        QCOMPARE(snapshot.parameterCount(), 9 * 5 + 4);
+        QCOMPARE(snapshot.matrixCount(), 2);
+        QCOMPARE(elementsOf(snapshot), SyntheticDeviceGenerator::elementCount(options));
+        QCOMPARE(snapshot.rootPaths, QStringList{"1"});
+    }
+
+    void testEveryElementIsReachableFromTheRoot()
+    {
+        SyntheticDeviceGenerator::Options options;
+        options.depth = 3;
+        options.fanOut = 4;
+        options.parametersPerNode = 3;
+        options.matrixCount = 1;
+        options.streamCount = 2;
+        DeviceSnapshot snapshot = SyntheticDeviceGenerator::generate(options);
+
+        qint64 reached = 0;
+        QStringList pending = snapshot.rootPaths;
+        while (!pending.isEmpty()) {
+            QString path = pending.takeLast();
+            ++reached;
+            if (snapshot.nodes.contains(path)) {
+                pending.append(snapshot.nodes.value(path).childPaths);
+            }
+        }
+        QCOMPARE(reached, elementsOf(snapshot));
+    }
+
+    void testParameterTypesAreCycled()
+    {
+        SyntheticDeviceGenerator::Options options;
+        options.depth = 0;
+        options.parametersPerNode = 6;
+        options.parameterTypes = {1, 6};
+        options.enumSize = 12;
+        DeviceSnapshot snapshot = SyntheticDeviceGenerator::generate(options);
+
+        QCOMPARE(snapshot.parameters.value("1.1").type, 1);
+        QCOMPARE(snapshot.parameters.value("1.2").type, 6);
+        QCOMPARE(snapshot.parameters.value("1.2").enumOptions.size(), 12);
+        QCOMPARE(snapshot.parameters.value("1.5").type, 1);
+        QCOMPARE(snapshot.parameters.value("1.6").type, 6);
+
+        int enumValue = snapshot.parameters.value("1.6").value.toInt();
+        QVERIFY(enumValue >= 0 && enumValue < 12);
+    }
+
+    void testSameSeedGivesSameDevice()
+    {
+        SyntheticDeviceGenerator::Options options;
+        options.depth = 1;
+        options.parametersPerNode = 20;
+        options.matrixCount = 1;
+        options.matrixType = 2;
+        options.connectionDensity = 0.3;
+
+        DeviceSnapshot first = SyntheticDeviceGenerator::generate(options);
+        DeviceSnapshot second = SyntheticDeviceGenerator::generate(options);
+        QCOMPARE(first.parameters.value("1.3.7").value, second.parameters.value("1.3.7").value);
+        QCOMPARE(first.matrices.first().connections, second.matrices.first().connections);
+
+        options.seed = 2;
+        DeviceSnapshot reseeded = SyntheticDeviceGenerator::generate(options);
+        QVERIFY(reseeded.matrices.first().connections != first.matrices.first().connections);
+    }
+
+    void testConnectionDensity()
+    {
+        SyntheticDeviceGenerator::Options options;
+        options.depth = 0;
+        options.parametersPerNode = 0;
+        options.matrixCount = 1;
+        options.matrixTargets = 200;
+        options.matrixSources = 100;
+
+        options.matrixType = 2;
+        options.connectionDensity = 0.25;
+        int crosspoints = SyntheticDeviceGenerator::generate(options).matrices.first().connections.size();
+        QVERIFY(crosspoints > 200 * 100 / 8 && crosspoints < 200 * 100 / 2);
+
+        // oneToOne never connects a source twice, so 100 sources cap the connections
+        options.matrixType = 1;
+        options.connectionDensity = 1.0;
+        MatrixData oneToOne = SyntheticDeviceGenerator::generate(options).matrices.first();
+        QCOMPARE(oneToOne.connections.size(), 100);
+        QSet<int> sources;
+        for (auto it = oneToOne.connections.cbegin(); it != oneToOne.connections.cend(); ++it) {
+            sources.insert(it.key().second);
+        }
+        QCOMPARE(sources.size(), 100);
+
+        options.matrixType = 0;
+        options.connectionDensity = 0.0;
+        QVERIFY(SyntheticDeviceGenerator::generate(options).matrices.first().connections.isEmpty());
+    }
+
+    void testStreamsGetRatesInTurn()
+    {
+        SyntheticDeviceGenerator::Options options;
+        options.depth = 0;
+        options.parametersPerNode = 0;
+        options.streamCount = 3;
+        options.streamRatesHz = {100, 10};
+
+        DeviceSnapshot snapshot = SyntheticDeviceGenerator::generate(options);
+        QCOMPARE(snapshot.parameters.value("1.10.2").streamIdentifier, 2);
+
+        QMap<int, int> rates = SyntheticDeviceGenerator::streamRates(options);
+        QCOMPARE(rates.size(), 3);
+        QCOMPARE(rates.value(1), 100);
+        QCOMPARE(rates.value(2), 10);
+        QCOMPARE(rates.value(3), 100);
+    }
+};
+
+QTEST_MAIN(TestSyntheticDevice)
+#include "test_synthetic_device.moc"
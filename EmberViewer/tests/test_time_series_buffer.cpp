@@ -0,0 +1,108 @@
+#include <QtTest/QtTest>
+#include <QRandomGenerator>
+#include <deque>
+#include "../include/TimeSeriesBuffer.h"
+
+
+class TestTimeSeriesBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testStatisticsMatchRescan()
+    {
+        TimeSeriesBuffer buffer(64);
+        std::deque<QPair<qint64, double>> reference;
+        QRandomGenerator random(42);
+        qint64 timestamp = 0;
+
+        for (int i = 0; i < 5000; ++i) {
+            timestamp += random.bounded(3);
+            double value = random.bounded(1000) - 500;
+            buffer.append(timestamp, value);
+            reference.push_back(qMakePair(timestamp, value));
+            if (reference.size() > 64) {
+                reference.pop_front();
+            }
+
+            if (random.bounded(5) == 0) {
+                qint64 cutoff = timestamp - random.bounded(40);
+                buffer.removeOlderThan(cutoff);
+                while (!reference.empty() && reference.front().first < cutoff) {
+                    reference.pop_front();
+                }
+            }
+
+            QCOMPARE(buffer.size(), static_cast<int>(reference.size()));
+            if (reference.empty()) {
+                continue;
+            }
+
+            double min = reference.front().second;
+            double max = min;
+            double sum = 0.0;
+            for (const auto &sample : reference) {
+                min = qMin(min, sample.second);
+                max = qMax(max, sample.second);
+                sum += sample.second;
+            }
+            QCOMPARE(buffer.minimum(), min);
+            QCOMPARE(buffer.maximum(), max);
+            QVERIFY(qAbs(buffer.average() - sum / reference.size()) < 1e-9);
+        }
+    }
+
+    void testCapacityDropsOldest()
+    {
+        TimeSeriesBuffer buffer(4);
+        for (int i = 0; i < 6; ++i) {
+            buffer.append(i, i * 10.0);
+        }
+
+        QCOMPARE(buffer.size(), 4);
+        QCOMPARE(buffer.timestampAt(0), qint64(2));
+        QCOMPARE(buffer.valueAt(3), 50.0);
+        QCOMPARE(buffer.minimum(), 20.0);
+
+        buffer.clear();
+        QVERIFY(buffer.isEmpty());
+        buffer.append(10, 1.0);
+        QCOMPARE(buffer.maximum(), 1.0);
+    }
+
+    void testLowerBound()
+    {
+        TimeSeriesBuffer buffer(8);
+        for (int i = 0; i < 12; ++i) {
+            buffer.append(i * 10, i);
+        }
+
+        QCOMPARE(buffer.lowerBound(0), 0);
+        QCOMPARE(buffer.lowerBound(45), 1);
+        QCOMPARE(buffer.lowerBound(50), 1);
+        QCOMPARE(buffer.lowerBound(1000), buffer.size());
+    }
+
+    void testDecimationKeepsSpikes()
+    {
+        TimeSeriesBuffer buffer(2000);
+        for (int i = 0; i < 2000; ++i) {
+            buffer.append(i, i == 1234 ? 99.0 : (i % 2));
+        }
+
+        QVector<QPointF> points = buffer.decimate(0, 2000, 20);
+        QVERIFY(points.size() <= 20 * 4);
+
+        double max = 0.0;
+        for (const QPointF &point : points) {
+            QVERIFY(point.x() >= 0 && point.x() < 20);
+            max = qMax(max, point.y());
+        }
+        QCOMPARE(max, 99.0);
+
+        QVERIFY(buffer.decimate(5000, 1000, 20).isEmpty());
+    }
+};
+
+QTEST_MAIN(TestTimeSeriesBuffer)
+#include "test_time_series_buffer.moc"
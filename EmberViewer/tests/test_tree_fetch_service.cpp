@@ -0,0 +1,85 @@
+#include <QtTest/QtTest>
+#include "../include/TreeFetchService.h"
+
+
+class TestTreeFetchService : public QObject
+{
+    Q_OBJECT
+
+private:
+    // Requests time out after at least two seconds, two rounds need more than four
+    static constexpr int TIMEOUT_MS = 10000;
+
+private slots:
+    void testAnsweredFetchSucceeds()
+    {
+        TreeFetchService service;
+        QStringList sent;
+        service.setSendGetDirectoryCallback([&](const QStringList &paths) { sent.append(paths); });
+        QSignalSpy completed(&service, &TreeFetchService::fetchCompleted);
+
+        service.startFetch({"1|Node"});
+        QCOMPARE(sent, QStringList{"1"});
+
+        service.onElementReceived("1.1", false);
+        QTRY_COMPARE(completed.count(), 1);
+        QCOMPARE(completed.first().at(0).toBool(), true);
+        QCOMPARE(service.silentCount(), 0);
+    }
+
+    void testTimedOutRequestIsRetriedOnce()
+    {
+        TreeFetchService service;
+        QStringList sent;
+        service.setSendGetDirectoryCallback([&](const QStringList &paths) { sent.append(paths); });
+        QSignalSpy completed(&service, &TreeFetchService::fetchCompleted);
+
+        service.startFetch({"1|Node"});
+        QTRY_COMPARE_WITH_TIMEOUT(sent.count("1"), 2, TIMEOUT_MS);
+        QCOMPARE(completed.count(), 0);
+
+        service.onElementReceived("1.1", false);
+        QTRY_COMPARE(completed.count(), 1);
+        QCOMPARE(completed.first().at(0).toBool(), true);
+    }
+
+    void testSilentPathCountsAsAnswered()
+    {
+        TreeFetchService service;
+        QStringList sent;
+        service.setSendGetDirectoryCallback([&](const QStringList &paths) { sent.append(paths); });
+        QSignalSpy completed(&service, &TreeFetchService::fetchCompleted);
+
+        service.startFetch({"1|Node", "2|Node"});
+        service.onElementReceived("1.1", false);
+
+        QTRY_COMPARE_WITH_TIMEOUT(completed.count(), 1, 2 * TIMEOUT_MS);
+        QCOMPARE(sent.count("1"), 1);
+        QCOMPARE(sent.count("2"), 2);
+        QCOMPARE(completed.first().at(0).toBool(), true);
+        QVERIFY(completed.first().at(1).toString().contains("1 without a reply"));
+        QCOMPARE(service.silentCount(), 1);
+    }
+
+    void testEmptyNodeCompletesFetch()
+    {
+        TreeFetchService service;
+        QStringList sent;
+        service.setSendGetDirectoryCallback([&](const QStringList &paths) { sent.append(paths); });
+        QSignalSpy completed(&service, &TreeFetchService::fetchCompleted);
+
+        // 1.1 is a node without children, the provider never answers its GetDirectory
+        service.startFetch({"1|Node"});
+        service.onElementReceived("1.1", true);
+        int window = service.windowSize();
+
+        QTRY_COMPARE_WITH_TIMEOUT(completed.count(), 1, 2 * TIMEOUT_MS);
+        QCOMPARE(sent.count("1.1"), 2);
+        QCOMPARE(completed.first().at(0).toBool(), true);
+        QCOMPARE(service.silentCount(), 1);
+        QCOMPARE(service.windowSize(), window);
+    }
+};
+
+QTEST_MAIN(TestTreeFetchService)
+#include "test_tree_fetch_service.moc"
@@ -207,6 +207,109 @@ private slots:
         QVERIFY(widget.isConnected(0, 0));
         QCOMPARE(widget.getMatrixType(), 2);
     }
+
+    void testDragSelectionEmitsSalvo()
+    {
+        VirtualizedMatrixWidget widget;
+        widget.setMatrixInfo("TestMatrix", "Test Description", 2, 4, 4);
+        widget.setMatrixPath("1.2");
+        widget.setCrosspointsEnabled(true);
+        widget.resize(400, 400);
+
+        QSignalSpy singleSpy(&widget, static_cast<void(VirtualizedMatrixWidget::*)(const QString&, int, int)>(
+                                          &VirtualizedMatrixWidget::crosspointClicked));
+        QSignalSpy rangeSpy(&widget, &VirtualizedMatrixWidget::crosspointsClicked);
+
+        QSize cell = widget.cellSize();
+        auto cellCenter = [&](int col, int row) {
+            return QPoint(col * cell.width() + cell.width() / 2, row * cell.height() + cell.height() / 2);
+        };
+
+        QTest::mousePress(widget.viewport(), Qt::LeftButton, Qt::NoModifier, cellCenter(1, 0));
+        QTest::mouseMove(widget.viewport(), cellCenter(2, 1));
+        QTest::mouseRelease(widget.viewport(), Qt::LeftButton, Qt::NoModifier, cellCenter(2, 1));
+
+        QCOMPARE(widget.selectedRange(), QRect(1, 0, 2, 2));
+        QCOMPARE(singleSpy.count(), 0);
+        QCOMPARE(rangeSpy.count(), 1);
+        QCOMPARE(rangeSpy.at(0).at(0).toString(), QString("1.2"));
+        auto crosspoints = rangeSpy.at(0).at(1).value<QList<QPair<int, int>>>();
+        QList<QPair<int, int>> expected = {{1, 0}, {1, 1}, {2, 0}, {2, 1}};
+        QCOMPARE(crosspoints, expected);
+
+        QTest::mouseClick(widget.viewport(), Qt::LeftButton, Qt::NoModifier, cellCenter(3, 3));
+        QCOMPARE(singleSpy.count(), 1);
+        QCOMPARE(widget.selectedRange(), QRect(3, 3, 1, 1));
+    }
+
+    void testConnectionStoreDense()
+    {
+        MatrixModel model;
+        model.setMatrixInfo("TestMatrix", "Test Description", 2, 4, 130);
+
+        model.setConnection(3, 129, true, 2);
+        model.setConnection(3, 64, true, 0);
+        model.setConnection(1, 0, true, 0);
+        QCOMPARE(model.connectionDisposition(3, 129), 2);
+        QCOMPARE(model.connectionDisposition(3, 64), 0);
+
+        QList<QPair<int, int>> expected = {{1, 0}, {3, 64}, {3, 129}};
+        QCOMPARE(model.getAllConnections(), expected);
+
+        model.clearTargetConnections(3);
+        QVERIFY(!model.isConnected(3, 129));
+        QCOMPARE(model.connectionDisposition(3, 129), 0);
+        QCOMPARE(model.getAllConnections().size(), 1);
+    }
+
+    void testConnectionStoreSparseFallback()
+    {
+        MatrixModel model;
+        model.setMatrixInfo("TestMatrix", "Test Description", 0, 4, 4);
+        model.setConnection(0, 1, true, 0);
+
+        // Nonlinear numbering outside the advertised dimensions
+        model.setConnection(1000, 7, true, 1);
+        model.setConnection(0, 3, true, 0);
+
+        QVERIFY(model.isConnected(0, 1));
+        QVERIFY(model.isConnected(1000, 7));
+        QVERIFY(!model.isConnected(1000, 6));
+        QCOMPARE(model.connectionDisposition(1000, 7), 1);
+
+        QList<QPair<int, int>> expected = {{0, 1}, {0, 3}, {1000, 7}};
+        QCOMPARE(model.getAllConnections(), expected);
+
+        model.clearTargetConnections(0);
+        QCOMPARE(model.getAllConnections(), QList<QPair<int, int>>{qMakePair(1000, 7)});
+    }
+
+    void testForEachSourceInRange()
+    {
+        MatrixModel model;
+        model.setMatrixInfo("TestMatrix", "Test Description", 2, 2, 200);
+        for (int source : {0, 63, 64, 127, 128, 199}) {
+            model.setConnection(1, source, true, 0);
+        }
+
+        QList<int> visited;
+        model.connectionStore().forEachSource(1, 63, 128, [&](int source) { visited.append(source); });
+        QCOMPARE(visited, QList<int>({63, 64, 127, 128}));
+
+        visited.clear();
+        model.connectionStore().forEachSource(0, 0, 199, [&](int source) { visited.append(source); });
+        QVERIFY(visited.isEmpty());
+    }
+
+    void testConnectionsSurviveResize()
+    {
+        MatrixModel model;
+        model.setConnection(2, 5, true, 0);
+        model.setMatrixInfo("TestMatrix", "Test Description", 2, 8, 8);
+
+        QVERIFY(model.isConnected(2, 5));
+        QCOMPARE(model.getAllConnections().size(), 1);
+    }
 };
 
 QTEST_MAIN(TestVirtualizedMatrixWidget)
@@ -0,0 +1,290 @@
+#include "EmberWalker.h"
+#include "EmberConnection.h"
+#include <QDebug>
+#include <algorithm>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+qint64 percentile(const QVector<qint64> &sorted, double fraction)
+{
+    if (sorted.isEmpty()) {
+        return 0;
+    }
+    int rank = qBound(0, int(fraction * sorted.size() + 0.5) - 1, int(sorted.size()) - 1);
+    return sorted[rank];
+}
+
+// Kilobytes, -1 where the platform does not report it
+qint64 peakResidentKb()
+{
+#if defined(Q_OS_MACOS)
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? qint64(usage.ru_maxrss) / 1024 : -1;
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? qint64(usage.ru_maxrss) : -1;
+#else
+    return -1;
+#endif
+}
+
+double perSecond(quint64 count, qint64 elapsedMs)
+{
+    return elapsedMs > 0 ? count * 1000.0 / elapsedMs : 0.0;
+}
+
+}
+
+EmberWalker::EmberWalker(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_connection(new EmberConnection(this))
+    , m_timeoutTimer(new QTimer(this))
+    , m_phase(Connecting)
+    , m_connectedAtMs(-1)
+    , m_firstDataAtMs(-1)
+    , m_walkStartedAtMs(-1)
+    , m_walkFinishedAtMs(-1)
+    , m_observeStartedAtMs(-1)
+    , m_subscribedCount(0)
+    , m_parameterUpdates(0)
+    , m_streamValues(0)
+{
+    // A benchmark measures the device, not what an earlier session left on disk
+    m_connection->setDeviceTreeCacheEnabled(false);
+
+    m_timeoutTimer->setSingleShot(true);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &EmberWalker::onTimeout);
+
+    connect(m_connection, &EmberConnection::connected, this, &EmberWalker::onConnected);
+    connect(m_connection, &EmberConnection::disconnected, this, &EmberWalker::onDisconnected);
+    connect(m_connection, &EmberConnection::treePopulated, this, &EmberWalker::onTreePopulated);
+    connect(m_connection, &EmberConnection::treeFetchCompleted, this, &EmberWalker::onTreeFetchCompleted);
+    connect(m_connection, &EmberConnection::treeFetchResponseTime, this, [this](qint64 responseTimeUs) {
+        m_responseTimesUs.append(responseTimeUs);
+    });
+
+    connect(m_connection, &EmberConnection::nodesReceived, this, [this](const QVector<EmberData::NodeInfo> &nodes) {
+        for (const EmberData::NodeInfo &node : nodes) {
+            m_nodes.insert(node.path);
+        }
+    });
+    connect(m_connection, &EmberConnection::parametersReceived, this,
+            [this](const QVector<EmberData::ParameterInfo> &parameters) {
+        if (m_phase == Observing) {
+            m_parameterUpdates += parameters.size();
+        }
+        for (const EmberData::ParameterInfo &parameter : parameters) {
+            m_parameters.insert(parameter.path);
+        }
+    });
+    connect(m_connection, &EmberConnection::matrixReceived, this, [this](const QString &path) {
+        m_matrices.insert(path);
+    });
+    connect(m_connection, &EmberConnection::functionReceived, this, [this](const QString &path) {
+        m_functions.insert(path);
+    });
+    connect(m_connection, &EmberConnection::streamValuesReceived, this,
+            [this](const QVector<EmberData::StreamValue> &values) {
+        if (m_phase == Observing) {
+            m_streamValues += values.size();
+        }
+    });
+}
+
+void EmberWalker::start()
+{
+    m_clock.start();
+    m_timeoutTimer->start(m_options.timeoutSeconds * 1000);
+    if (!m_options.capturePath.isEmpty()) {
+        m_connection->startCapture(m_options.capturePath);
+    }
+    m_connection->connectToHost(m_options.host, m_options.port);
+}
+
+void EmberWalker::onConnected()
+{
+    m_connectedAtMs = m_clock.elapsed();
+}
+
+void EmberWalker::onDisconnected()
+{
+    if (m_phase == Done) {
+        return;
+    }
+    if (m_phase == Connecting) {
+        finish(ConnectionFailed, m_connectedAtMs < 0 ? "Could not connect" : "No Ember+ response");
+    } else {
+        finish(WalkIncomplete, "Connection lost");
+    }
+}
+
+void EmberWalker::onTreePopulated()
+{
+    if (m_phase != Connecting) {
+        return;
+    }
+
+    m_firstDataAtMs = m_clock.elapsed();
+    m_phase = Walking;
+
+    // Everything seen so far is fetched again, the walk discovers the rest
+    QStringList paths{"|Node"};
+    for (const QString &path : std::as_const(m_nodes)) {
+        paths.append(path + "|Node");
+    }
+
+    m_walkStart = PerformanceCounters::snapshot();
+    m_walkStartedAtMs = m_clock.elapsed();
+    m_connection->fetchCompleteTree(paths);
+}
+
+void EmberWalker::onTreeFetchCompleted(bool success, const QString &message)
+{
+    if (m_phase != Walking) {
+        return;
+    }
+
+    m_walkFinishedAtMs = m_clock.elapsed();
+    m_walkEnd = PerformanceCounters::snapshot();
+    m_timeoutTimer->stop();
+
+    if (!success) {
+        finish(WalkIncomplete, message);
+        return;
+    }
+
+    if (!m_options.subscribe) {
+        finish(Success, message);
+        return;
+    }
+
+    m_phase = Observing;
+    subscribeAll();
+    QTimer::singleShot(m_options.observeSeconds * 1000, this, &EmberWalker::finishObservation);
+}
+
+void EmberWalker::onTimeout()
+{
+    if (m_phase == Connecting) {
+        finish(ConnectionFailed, QString("No Ember+ data after %1 s").arg(m_options.timeoutSeconds));
+        return;
+    }
+
+    m_walkFinishedAtMs = m_clock.elapsed();
+    m_walkEnd = PerformanceCounters::snapshot();
+    m_connection->cancelTreeFetch();
+    finish(WalkIncomplete, QString("Walk timed out after %1 s").arg(m_options.timeoutSeconds));
+}
+
+void EmberWalker::finishObservation()
+{
+    if (m_phase == Observing) {
+        finish(Success, "Walk and observation complete");
+    }
+}
+
+void EmberWalker::subscribeAll()
+{
+    QList<EmberConnection::SubscriptionRequest> requests;
+    for (const QString &path : std::as_const(m_parameters)) {
+        requests.append({path, "Parameter"});
+    }
+    for (const QString &path : std::as_const(m_matrices)) {
+        requests.append({path, "Matrix"});
+    }
+
+    for (int i = 0; i < requests.size(); i += SUBSCRIBE_CHUNK_SIZE) {
+        m_connection->sendBatchSubscribe(requests.mid(i, SUBSCRIBE_CHUNK_SIZE));
+    }
+    m_subscribedCount = requests.size();
+
+    m_observeStart = PerformanceCounters::snapshot();
+    m_observeStartedAtMs = m_clock.elapsed();
+}
+
+void EmberWalker::finish(ExitCode exitCode, const QString &message)
+{
+    Phase phase = m_phase;
+    m_phase = Done;
+    m_timeoutTimer->stop();
+
+    if (phase == Walking && m_walkFinishedAtMs < 0) {
+        m_walkFinishedAtMs = m_clock.elapsed();
+        m_walkEnd = PerformanceCounters::snapshot();
+    }
+
+    buildReport(message);
+    m_report.insert("exitCode", exitCode);
+
+    m_connection->stopCapture();
+    m_connection->disconnect();
+    emit finished(exitCode);
+}
+
+void EmberWalker::buildReport(const QString &message)
+{
+    m_reportKeys.clear();
+    m_report = QJsonObject();
+
+    addResult("host", QString("%1:%2").arg(m_options.host).arg(m_options.port));
+    addResult("result", message);
+    addResult("connectMs", m_connectedAtMs);
+    addResult("firstDataMs", m_firstDataAtMs);
+
+    qint64 walkMs = m_walkStartedAtMs >= 0 ? m_walkFinishedAtMs - m_walkStartedAtMs : -1;
+    addResult("walkMs", walkMs);
+    addResult("nodes", m_nodes.size());
+    addResult("parameters", m_parameters.size());
+    addResult("matrices", m_matrices.size());
+    addResult("functions", m_functions.size());
+
+    if (walkMs >= 0) {
+        auto delta = [this](PerformanceCounters::Counter counter) {
+            return m_walkEnd.counters[counter] - m_walkStart.counters[counter];
+        };
+        addResult("walkElementsPerSecond", qRound(perSecond(delta(PerformanceCounters::ElementsDecoded), walkMs)));
+        addResult("walkBytesIn", qint64(delta(PerformanceCounters::BytesIn)));
+        addResult("walkBytesOut", qint64(delta(PerformanceCounters::BytesOut)));
+        addResult("walkFramesIn", qint64(delta(PerformanceCounters::FramesIn)));
+        addResult("walkFramesOut", qint64(delta(PerformanceCounters::FramesOut)));
+
+        quint64 decodeCount = m_walkEnd.timers[PerformanceCounters::DecodeMessage].count
+                            - m_walkStart.timers[PerformanceCounters::DecodeMessage].count;
+        quint64 decodeNs = m_walkEnd.timers[PerformanceCounters::DecodeMessage].totalNs
+                         - m_walkStart.timers[PerformanceCounters::DecodeMessage].totalNs;
+        addResult("decodeAvgUs", decodeCount > 0 ? qRound(decodeNs / 1000.0 / decodeCount) : 0);
+    }
+
+    QVector<qint64> sorted = m_responseTimesUs;
+    std::sort(sorted.begin(), sorted.end());
+    addResult("responseSamples", sorted.size());
+    addResult("responseP50Us", percentile(sorted, 0.50));
+    addResult("responseP90Us", percentile(sorted, 0.90));
+    addResult("responseP99Us", percentile(sorted, 0.99));
+    addResult("responseMaxUs", sorted.isEmpty() ? 0 : sorted.last());
+
+    if (m_observeStartedAtMs >= 0) {
+        qint64 observeMs = m_clock.elapsed() - m_observeStartedAtMs;
+        PerformanceCounters::Snapshot observeEnd = PerformanceCounters::snapshot();
+        addResult("subscribed", m_subscribedCount);
+        addResult("observeMs", observeMs);
+        addResult("parameterUpdatesPerSecond", qRound(perSecond(m_parameterUpdates, observeMs)));
+        addResult("streamValuesPerSecond", qRound(perSecond(m_streamValues, observeMs)));
+        addResult("observeBytesInPerSecond",
+                  qRound64(perSecond(observeEnd.counters[PerformanceCounters::BytesIn]
+                                     - m_observeStart.counters[PerformanceCounters::BytesIn], observeMs)));
+    }
+
+    addResult("peakResidentKb", peakResidentKb());
+}
+
+void EmberWalker::addResult(const QString &key, const QJsonValue &value)
+{
+    m_reportKeys.append(key);
+    m_report.insert(key, value);
+}
@@ -0,0 +1,103 @@
+#ifndef EMBERWALKER_H
+#define EMBERWALKER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "EmberDataTypes.h"
+#include "PerformanceCounters.h"
+
+class EmberConnection;
+
+// Drives an EmberConnection without a GUI: connects, walks the complete tree,
+// optionally subscribes to every parameter and matrix for a while, then
+// reports timings, throughput, response time percentiles and peak memory.
+class EmberWalker : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        QString host;
+        int port = 9000;
+        bool subscribe = false;
+        int observeSeconds = 10;
+        int timeoutSeconds = 120;
+        QString capturePath;        // Records the session for later replay when set
+    };
+
+    enum ExitCode {
+        Success = 0,
+        ConnectionFailed = 1,
+        WalkIncomplete = 2
+    };
+
+    explicit EmberWalker(const Options &options, QObject *parent = nullptr);
+
+    void start();
+
+    // Keys in report order
+    QStringList reportKeys() const { return m_reportKeys; }
+    QJsonObject report() const { return m_report; }
+
+signals:
+    void finished(int exitCode);
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onTreePopulated();
+    void onTreeFetchCompleted(bool success, const QString &message);
+    void onTimeout();
+    void finishObservation();
+
+private:
+    enum Phase {
+        Connecting,
+        Walking,
+        Observing,
+        Done
+    };
+
+    void subscribeAll();
+    void finish(ExitCode exitCode, const QString &message);
+    void buildReport(const QString &message);
+    void addResult(const QString &key, const QJsonValue &value);
+
+    Options m_options;
+    EmberConnection *m_connection;
+    QTimer *m_timeoutTimer;
+    Phase m_phase;
+
+    QElapsedTimer m_clock;
+    qint64 m_connectedAtMs;
+    qint64 m_firstDataAtMs;
+    qint64 m_walkStartedAtMs;
+    qint64 m_walkFinishedAtMs;
+    qint64 m_observeStartedAtMs;
+
+    QSet<QString> m_nodes;
+    QSet<QString> m_parameters;
+    QSet<QString> m_matrices;
+    QSet<QString> m_functions;
+    QVector<qint64> m_responseTimesUs;
+    int m_subscribedCount;
+    quint64 m_parameterUpdates;
+    quint64 m_streamValues;
+
+    PerformanceCounters::Snapshot m_walkStart;
+    PerformanceCounters::Snapshot m_walkEnd;
+    PerformanceCounters::Snapshot m_observeStart;
+
+    QStringList m_reportKeys;
+    QJsonObject m_report;
+
+    static constexpr int SUBSCRIBE_CHUNK_SIZE = 256;
+};
+
+#endif
@@ -0,0 +1,155 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include "EmberWalker.h"
+#include "S101Capture.h"
+#include "S101Replayer.h"
+#include "S101ReplayServer.h"
+#include "version.h"
+
+namespace {
+
+void printReport(const QStringList &keys, const QJsonObject &report, bool json)
+{
+    QTextStream out(stdout);
+    if (json) {
+        out << QJsonDocument(report).toJson(QJsonDocument::Indented);
+    } else {
+        for (const QString &key : keys) {
+            out << QString("%1 %2\n").arg(key, -28).arg(report.value(key).toVariant().toString());
+        }
+    }
+    out.flush();
+}
+
+// Decodes a capture as fast as possible, without a socket or a GUI in the way
+int runDecodeBenchmark(const QString &filePath, bool json)
+{
+    QString error;
+    QVector<S101CaptureRecord> records = S101CaptureReader::readAll(filePath, &error);
+    if (records.isEmpty()) {
+        qCritical().noquote() << QString("Cannot replay %1: %2").arg(filePath, error.isEmpty() ? "capture is empty" : error);
+        return EmberWalker::ConnectionFailed;
+    }
+
+    S101Replayer replayer;
+    replayer.setRecords(records);
+    S101Replayer::DecodeStats stats = replayer.decode();
+
+    double seconds = stats.elapsedNs / 1e9;
+    QStringList keys;
+    QJsonObject report;
+    auto addResult = [&](const QString &key, const QJsonValue &value) {
+        keys.append(key);
+        report.insert(key, value);
+    };
+    addResult("capture", filePath);
+    addResult("result", error.isEmpty() ? "Decode complete" : error);
+    addResult("chunks", replayer.chunkCount());
+    addResult("recordedMs", replayer.durationUs() / 1000);
+    addResult("bytes", stats.bytes);
+    addResult("messages", stats.messages);
+    addResult("elements", stats.elements);
+    addResult("streamValues", stats.streamValues);
+    addResult("errors", stats.errors);
+    addResult("decodeMs", stats.elapsedNs / 1000000);
+    addResult("megabytesPerSecond", seconds > 0 ? qRound(stats.bytes / seconds / 1e4) / 100.0 : 0.0);
+    addResult("elementsPerSecond", seconds > 0 ? qRound64(stats.elements / seconds) : 0);
+    addResult("messagesPerSecond", seconds > 0 ? qRound64(stats.messages / seconds) : 0);
+    printReport(keys, report, json);
+
+    return stats.errors > 0 ? EmberWalker::WalkIncomplete : EmberWalker::Success;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ember-walk");
+    QCoreApplication::setApplicationVersion(EMBERVIEWER_VERSION_STRING);
+    QCoreApplication::setOrganizationName("Magnus Overli");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Connects to an Ember+ provider, walks its complete tree and reports "
+                                     "timings, throughput, response times and memory use.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("host", "Provider host name or address, not used with --replay or --serve");
+    
+    QCommandLineOption portOption({"p", "port"}, "Provider port (default 9000).", "port", "9000");
+    QCommandLineOption subscribeOption({"s", "subscribe"}, "Subscribe to every parameter and matrix after the walk.");
+    QCommandLineOption observeOption("observe", "Seconds to count updates while subscribed (default 10).", "seconds", "10");
+    QCommandLineOption timeoutOption("timeout", "Seconds allowed for connecting and walking (default 120).", "seconds", "120");
+    QCommandLineOption jsonOption("json", "Print the report as JSON.");
+    QCommandLineOption verboseOption({"v", "verbose"}, "Show debug logging.");
+    QCommandLineOption recordOption("record", "Record the raw S101 traffic of the walk to a capture file.", "file");
+    QCommandLineOption replayOption("replay", "Decode a capture as fast as possible and report decode throughput.", "file");
+    QCommandLineOption serveOption("serve", "Serve a capture to every client that connects.", "file");
+    QCommandLineOption listenOption("listen", "Port for --serve (default 9000).", "port", "9000");
+    QCommandLineOption realtimeOption("realtime", "With --serve, replay at the recorded pace instead of as fast as possible.");
+    QCommandLineOption speedOption("speed", "Playback speed factor for --realtime (default 1).", "factor", "1");
+    parser.addOptions({portOption, subscribeOption, observeOption, timeoutOption, jsonOption, verboseOption,
+                       recordOption, replayOption, serveOption, listenOption, realtimeOption, speedOption});
+    parser.process(app);
+    
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("*.debug=false\n*.info=false");
+    }
+    
+    if (parser.isSet(replayOption)) {
+        return runDecodeBenchmark(parser.value(replayOption), parser.isSet(jsonOption));
+    }
+    
+    if (parser.isSet(serveOption)) {
+        S101ReplayServer server;
+        QString error;
+        if (!server.load(parser.value(serveOption), &error)) {
+            qCritical().noquote() << QString("Cannot serve %1: %2").arg(parser.value(serveOption), error);
+            return EmberWalker::ConnectionFailed;
+        }
+        
+        S101Replayer::Timing timing = parser.isSet(realtimeOption) ? S101Replayer::OriginalTiming
+                                                                  : S101Replayer::AsFastAsPossible;
+        if (!server.listen(parser.value(listenOption).toUShort(), timing, parser.value(speedOption).toDouble())) {
+            qCritical().noquote() << QString("Cannot listen: %1").arg(server.errorString());
+            return EmberWalker::ConnectionFailed;
+        }
+        
+        QTextStream out(stdout);
+        out << QString("Serving %1 chunks on port %2\n").arg(server.chunkCount()).arg(server.serverPort());
+        out.flush();
+        QObject::connect(&server, &S101ReplayServer::clientConnected, &app, [](const QString &address) {
+            QTextStream(stdout) << QString("%1 connected\n").arg(address);
+        });
+        QObject::connect(&server, &S101ReplayServer::clientFinished, &app, [](const QString &address) {
+            QTextStream(stdout) << QString("%1 replay complete\n").arg(address);
+        });
+        return app.exec();
+    }
+    
+    const QStringList positional = parser.positionalArguments();
+    if (positional.size() != 1) {
+        parser.showHelp(EmberWalker::ConnectionFailed);
+    }
+    
+    EmberWalker::Options options;
+    options.host = positional.first();
+    options.port = parser.value(portOption).toInt();
+    options.subscribe = parser.isSet(subscribeOption);
+    options.observeSeconds = qMax(1, parser.value(observeOption).toInt());
+    options.timeoutSeconds = qMax(1, parser.value(timeoutOption).toInt());
+    options.capturePath = parser.value(recordOption);
+    
+    EmberWalker walker(options);
+    QObject::connect(&walker, &EmberWalker::finished, &app, [&](int exitCode) {
+        printReport(walker.reportKeys(), walker.report(), parser.isSet(jsonOption));
+        app.exit(exitCode);
+    }, Qt::QueuedConnection);
+    
+    walker.start();
+    return app.exec();
+}
@@ -50,6 +50,33 @@ namespace libember { namespace ber
              */
             explicit ObjectIdentifier(value_type value);
 
+#if __cplusplus >= 201103L
+            /**
+             * Copy constructor.
+             * @param other The object identifier to copy.
+             */
+            ObjectIdentifier(ObjectIdentifier const& other) = default;
+
+            /**
+             * Move constructor. Takes over the elements of @p other, which is
+             * left empty.
+             * @param other The object identifier to take the elements from.
+             */
+            ObjectIdentifier(ObjectIdentifier&& other) = default;
+
+            /**
+             * Copy assignment operator.
+             * @param other The object identifier to copy.
+             */
+            ObjectIdentifier& operator=(ObjectIdentifier const& other) = default;
+
+            /**
+             * Move assignment operator. Takes over the elements of @p other.
+             * @param other The object identifier to take the elements from.
+             */
+            ObjectIdentifier& operator=(ObjectIdentifier&& other) = default;
+#endif
+
             /**
              * Returns true if the ObjectIdentifier does not contain any elements.
              * @return True if the ObjectIdentifier does not contain any elements.
@@ -10,6 +10,9 @@
 #define __LIBEMBER_BER_OCTETS_HPP
 
 #include <vector>
+#if __cplusplus >= 201103L
+#  include <utility>
+#endif
 
 namespace libember { namespace ber 
 {
@@ -33,6 +36,23 @@ namespace libember { namespace ber
              */
             Octets(Octets const& other);
 
+#if __cplusplus >= 201103L
+            /** Move constructor
+             * @param other The instance to take the data from. It is left empty.
+             */
+            Octets(Octets&& other) noexcept;
+
+            /** Copy assignment operator
+             * @param other The instance to copy the data from
+             */
+            Octets& operator=(Octets const& other);
+
+            /** Move assignment operator
+             * @param other The instance to take the data from. It is left empty.
+             */
+            Octets& operator=(Octets&& other) noexcept;
+#endif
+
             /**
              * Initializes a new instance of Octets with the provided buffer
              * @param first First item to copy
@@ -87,6 +107,25 @@ namespace libember { namespace ber
     {
     }
 
+#if __cplusplus >= 201103L
+    inline Octets::Octets(Octets&& other) noexcept
+        : m_data(std::move(other.m_data))
+    {
+    }
+
+    inline Octets& Octets::operator=(Octets const& other)
+    {
+        m_data = other.m_data;
+        return *this;
+    }
+
+    inline Octets& Octets::operator=(Octets&& other) noexcept
+    {
+        m_data = std::move(other.m_data);
+        return *this;
+    }
+#endif
+
     template<typename InputIterator>
     inline Octets::Octets(InputIterator first, InputIterator last)
         : m_data(first, last)
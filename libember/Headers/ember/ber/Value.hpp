@@ -10,6 +10,9 @@
 #define __LIBEMBER_BER_VALUE_HPP
 
 #include <typeinfo>
+#if __cplusplus >= 201103L
+#  include <utility>
+#endif
 #include "../util/Api.hpp"
 #include "traits/CodecTraits.hpp"
 
@@ -35,6 +38,17 @@ namespace libember { namespace ber
              */
             Value(Value const& other);
 
+#if __cplusplus >= 201103L
+            /**
+             * Move constructor. Takes over the payload of @p other without
+             * touching its reference count and leaves @p other in a singular
+             * state.
+             * @param other a reference to the value whose contents should be
+             *      moved into the newly created instance.
+             */
+            Value(Value&& other) noexcept;
+#endif
+
             /**
              * Constructor that initializes this instance by wrapping the value
              * passed in @p value.
@@ -282,10 +296,23 @@ namespace libember { namespace ber
     /* Mandatory inline implementation                                        */
     /**************************************************************************/
 
+#if __cplusplus >= 201103L
+    inline Value::Value(Value&& other) noexcept
+        : m_payload(other.m_payload)
+    {
+        other.m_payload = 0;
+    }
+
+    template<typename ValueType>
+    inline Value::Value(ValueType value)
+        : m_payload(new PayloadImpl<ValueType>(std::move(value)))
+    {}
+#else
     template<typename ValueType>
     inline Value::Value(ValueType value)
         : m_payload(new PayloadImpl<ValueType>(value))
     {}
+#endif
 
     template<typename DestType>
     inline DestType Value::as() const
@@ -304,7 +331,11 @@ namespace libember { namespace ber
 
     template<typename ValueType>
     inline Value::PayloadImpl<ValueType>::PayloadImpl(ValueType value)
+#if __cplusplus >= 201103L
+        : Payload(), m_value(std::move(value))
+#else
         : Payload(), m_value(value)
+#endif
     {}
 
     template<typename ValueType>
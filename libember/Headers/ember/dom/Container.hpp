@@ -10,6 +10,9 @@
 #define __LIBEMBER_DOM_CONTAINER_HPP
 
 #include <list>
+#if __cplusplus >= 201103L
+#  include <memory>
+#endif
 #include "Node.hpp"
 #include "../util/TypeErasedIterator.hpp"
 
@@ -100,6 +103,24 @@ namespace libember { namespace dom
              */
             iterator insert(iterator const& where, Node* child);
 
+#if __cplusplus >= 201103L
+            /**
+             * Overload of insert() that takes ownership of @p child from a
+             * std::unique_ptr. Ownership is only released once the node has
+             * been inserted successfully, so the node is destroyed if
+             * inserting it fails.
+             * @param where an iterator referring to a position where the child
+             *      should be inserted.
+             * @param child the node that should be inserted.
+             * @return An iterator referring to the child node.
+             * @throw An exception derived from std::runtime_error if the
+             *      container policy does not allow inserting elements or
+             *      inserting the specific element failed for some reason.
+             */
+            template<typename NodeType>
+            iterator insert(iterator const& where, std::unique_ptr<NodeType> child);
+#endif
+
             /**
              * Clear this container node by removing all child nodes contained
              * within this node.
@@ -218,6 +239,20 @@ namespace libember { namespace dom
              */
             Container& operator=(Container const&);
    };
+
+#if __cplusplus >= 201103L
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    template<typename NodeType>
+    inline Container::iterator Container::insert(iterator const& where, std::unique_ptr<NodeType> child)
+    {
+        iterator const result = insert(where, static_cast<Node*>(child.get()));
+        child.release();
+        return result;
+    }
+#endif
 }
 }
 
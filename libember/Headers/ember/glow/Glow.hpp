@@ -39,6 +39,7 @@
 #include "GlowQualifiedFunction.hpp"
 #include "GlowTemplate.hpp"
 #include "GlowQualifiedTemplate.hpp"
+#include "GlowVisitor.hpp"
 
 #endif  // __LIBEMBER_GLOW_GLOW_HPP
 
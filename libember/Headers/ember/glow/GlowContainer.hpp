@@ -17,11 +17,33 @@
 
 namespace libember { namespace glow
 {
+    /** Forward declaration */
+    class GlowVisitor;
+
     /**
      * Base class for all glow object types.
      */
     class LIBEMBER_API GlowContainer : public dom::Sequence
     {
+        public:
+            /**
+             * Returns the glow type of this container. Unlike typeTag(), this
+             * does not require a virtual call and may be used to switch on
+             * the concrete type of an object instead of trying several
+             * dynamic_casts.
+             * @return The glow type of this container.
+             */
+            GlowType glowType() const;
+
+            /**
+             * Passes all children of this container to the dispatch method of
+             * @p visitor, in order.
+             * @param visitor The visitor to notify.
+             * @note The implementation of this method is provided by GlowVisitor.hpp,
+             *      which must be included when calling it.
+             */
+            void visitChildren(GlowVisitor& visitor) const;
+
         protected:
             /**
              * Initializes a new container with a glow type and application tag.
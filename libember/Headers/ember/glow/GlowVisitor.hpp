@@ -0,0 +1,240 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+
+    Copyright (C) 2012-2016 Lawo GmbH (http://www.lawo.com).
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWVISITOR_HPP
+#define __LIBEMBER_GLOW_GLOWVISITOR_HPP
+
+#include "../dom/Container.hpp"
+#include "../util/Api.hpp"
+#include "GlowType.hpp"
+
+namespace libember { namespace glow
+{
+    class GlowCommand;
+    class GlowConnection;
+    class GlowElementCollection;
+    class GlowFunction;
+    class GlowInvocation;
+    class GlowInvocationResult;
+    class GlowLabel;
+    class GlowMatrix;
+    class GlowNode;
+    class GlowParameter;
+    class GlowQualifiedFunction;
+    class GlowQualifiedMatrix;
+    class GlowQualifiedNode;
+    class GlowQualifiedParameter;
+    class GlowQualifiedTemplate;
+    class GlowRootElementCollection;
+    class GlowSource;
+    class GlowStreamCollection;
+    class GlowStreamDescriptor;
+    class GlowStreamEntry;
+    class GlowStringIntegerCollection;
+    class GlowStringIntegerPair;
+    class GlowTarget;
+    class GlowTemplate;
+    class GlowTupleItemDescription;
+
+    /**
+     * Base class for visitors of decoded glow trees. The dispatch() method
+     * determines the concrete type of a node with a single switch over the
+     * glow type stored in its type tag and forwards the node to the
+     * corresponding visit method. This avoids cascades of dynamic_casts when
+     * processing the elements of a container. All visit methods do nothing
+     * by default, so derived classes only override the ones they are
+     * interested in.
+     */
+    class LIBEMBER_API GlowVisitor
+    {
+        public:
+            /** Destructor */
+            virtual ~GlowVisitor();
+
+            /**
+             * Forwards @p node to the visit method matching its glow type.
+             * Nodes that are not glow objects, like the leaves of a contents
+             * set, are forwarded to visitUnknown().
+             * @note Nodes with an application type tag are expected to have
+             *      been created by the GlowNodeFactory, which maps each glow
+             *      type to exactly one class.
+             * @param node The node to dispatch.
+             */
+            void dispatch(dom::Node const& node);
+
+            /**
+             * Dispatches all children of @p container, in order.
+             * @param container The container whose children shall be dispatched.
+             */
+            void dispatchChildren(dom::Container const& container);
+
+        protected:
+            /**
+             * Called by dispatch() for GlowParameter instances.
+             * @param parameter The visited object.
+             */
+            virtual void visitParameter(GlowParameter const& parameter);
+
+            /**
+             * Called by dispatch() for GlowCommand instances.
+             * @param command The visited object.
+             */
+            virtual void visitCommand(GlowCommand const& command);
+
+            /**
+             * Called by dispatch() for GlowNode instances.
+             * @param node The visited object.
+             */
+            virtual void visitNode(GlowNode const& node);
+
+            /**
+             * Called by dispatch() for GlowElementCollection instances.
+             * @param elementCollection The visited object.
+             */
+            virtual void visitElementCollection(GlowElementCollection const& elementCollection);
+
+            /**
+             * Called by dispatch() for GlowStreamEntry instances.
+             * @param streamEntry The visited object.
+             */
+            virtual void visitStreamEntry(GlowStreamEntry const& streamEntry);
+
+            /**
+             * Called by dispatch() for GlowStreamCollection instances.
+             * @param streamCollection The visited object.
+             */
+            virtual void visitStreamCollection(GlowStreamCollection const& streamCollection);
+
+            /**
+             * Called by dispatch() for GlowStringIntegerPair instances.
+             * @param stringIntegerPair The visited object.
+             */
+            virtual void visitStringIntegerPair(GlowStringIntegerPair const& stringIntegerPair);
+
+            /**
+             * Called by dispatch() for GlowStringIntegerCollection instances.
+             * @param stringIntegerCollection The visited object.
+             */
+            virtual void visitStringIntegerCollection(GlowStringIntegerCollection const& stringIntegerCollection);
+
+            /**
+             * Called by dispatch() for GlowQualifiedParameter instances.
+             * @param qualifiedParameter The visited object.
+             */
+            virtual void visitQualifiedParameter(GlowQualifiedParameter const& qualifiedParameter);
+
+            /**
+             * Called by dispatch() for GlowQualifiedNode instances.
+             * @param qualifiedNode The visited object.
+             */
+            virtual void visitQualifiedNode(GlowQualifiedNode const& qualifiedNode);
+
+            /**
+             * Called by dispatch() for GlowRootElementCollection instances.
+             * @param rootElementCollection The visited object.
+             */
+            virtual void visitRootElementCollection(GlowRootElementCollection const& rootElementCollection);
+
+            /**
+             * Called by dispatch() for GlowStreamDescriptor instances.
+             * @param streamDescriptor The visited object.
+             */
+            virtual void visitStreamDescriptor(GlowStreamDescriptor const& streamDescriptor);
+
+            /**
+             * Called by dispatch() for GlowMatrix instances.
+             * @param matrix The visited object.
+             */
+            virtual void visitMatrix(GlowMatrix const& matrix);
+
+            /**
+             * Called by dispatch() for GlowTarget instances.
+             * @param target The visited object.
+             */
+            virtual void visitTarget(GlowTarget const& target);
+
+            /**
+             * Called by dispatch() for GlowSource instances.
+             * @param source The visited object.
+             */
+            virtual void visitSource(GlowSource const& source);
+
+            /**
+             * Called by dispatch() for GlowConnection instances.
+             * @param connection The visited object.
+             */
+            virtual void visitConnection(GlowConnection const& connection);
+
+            /**
+             * Called by dispatch() for GlowQualifiedMatrix instances.
+             * @param qualifiedMatrix The visited object.
+             */
+            virtual void visitQualifiedMatrix(GlowQualifiedMatrix const& qualifiedMatrix);
+
+            /**
+             * Called by dispatch() for GlowLabel instances.
+             * @param label The visited object.
+             */
+            virtual void visitLabel(GlowLabel const& label);
+
+            /**
+             * Called by dispatch() for GlowFunction instances.
+             * @param function The visited object.
+             */
+            virtual void visitFunction(GlowFunction const& function);
+
+            /**
+             * Called by dispatch() for GlowQualifiedFunction instances.
+             * @param qualifiedFunction The visited object.
+             */
+            virtual void visitQualifiedFunction(GlowQualifiedFunction const& qualifiedFunction);
+
+            /**
+             * Called by dispatch() for GlowTupleItemDescription instances.
+             * @param tupleItemDescription The visited object.
+             */
+            virtual void visitTupleItemDescription(GlowTupleItemDescription const& tupleItemDescription);
+
+            /**
+             * Called by dispatch() for GlowInvocation instances.
+             * @param invocation The visited object.
+             */
+            virtual void visitInvocation(GlowInvocation const& invocation);
+
+            /**
+             * Called by dispatch() for GlowInvocationResult instances.
+             * @param invocationResult The visited object.
+             */
+            virtual void visitInvocationResult(GlowInvocationResult const& invocationResult);
+
+            /**
+             * Called by dispatch() for GlowTemplate instances.
+             * @param glowTemplate The visited object.
+             */
+            virtual void visitTemplate(GlowTemplate const& glowTemplate);
+
+            /**
+             * Called by dispatch() for GlowQualifiedTemplate instances.
+             * @param qualifiedTemplate The visited object.
+             */
+            virtual void visitQualifiedTemplate(GlowQualifiedTemplate const& qualifiedTemplate);
+
+            /**
+             * Called by dispatch() for all nodes that are not glow objects.
+             * @param node The visited object.
+             */
+            virtual void visitUnknown(dom::Node const& node);
+    };
+}
+}
+
+#ifdef LIBEMBER_HEADER_ONLY
+#  include "impl/GlowVisitor.ipp"
+#endif
+
+#endif  // __LIBEMBER_GLOW_GLOWVISITOR_HPP
@@ -32,6 +32,12 @@ namespace libember { namespace glow
         , m_universalTag(type.toTypeTag())
     {}
 
+    LIBEMBER_INLINE
+    GlowType GlowContainer::glowType() const
+    {
+        return GlowType(static_cast<GlowType::value_type>(m_universalTag.number()));
+    }
+
     LIBEMBER_INLINE
     GlowContainer::iterator GlowContainer::insertImpl(iterator const&, Node* child)
     {
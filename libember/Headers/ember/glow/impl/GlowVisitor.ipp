@@ -0,0 +1,287 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+
+    Copyright (C) 2012-2016 Lawo GmbH (http://www.lawo.com).
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef __LIBEMBER_GLOW_GLOWVISITOR_IPP
+#define __LIBEMBER_GLOW_GLOWVISITOR_IPP
+
+#include "../../util/Inline.hpp"
+#include "../GlowCommand.hpp"
+#include "../GlowConnection.hpp"
+#include "../GlowElementCollection.hpp"
+#include "../GlowFunction.hpp"
+#include "../GlowInvocation.hpp"
+#include "../GlowInvocationResult.hpp"
+#include "../GlowLabel.hpp"
+#include "../GlowMatrix.hpp"
+#include "../GlowNode.hpp"
+#include "../GlowParameter.hpp"
+#include "../GlowQualifiedFunction.hpp"
+#include "../GlowQualifiedMatrix.hpp"
+#include "../GlowQualifiedNode.hpp"
+#include "../GlowQualifiedParameter.hpp"
+#include "../GlowQualifiedTemplate.hpp"
+#include "../GlowRootElementCollection.hpp"
+#include "../GlowSource.hpp"
+#include "../GlowStreamCollection.hpp"
+#include "../GlowStreamDescriptor.hpp"
+#include "../GlowStreamEntry.hpp"
+#include "../GlowStringIntegerCollection.hpp"
+#include "../GlowStringIntegerPair.hpp"
+#include "../GlowTarget.hpp"
+#include "../GlowTemplate.hpp"
+#include "../GlowTupleItemDescription.hpp"
+
+namespace libember { namespace glow
+{
+    LIBEMBER_INLINE
+    GlowVisitor::~GlowVisitor()
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::dispatch(dom::Node const& node)
+    {
+        ber::Tag const typeTag = node.typeTag();
+        if (typeTag.getClass() != ber::Class::Application)
+        {
+            visitUnknown(node);
+            return;
+        }
+
+        // All glow types derive from dom::Node through single, non-virtual
+        // inheritance, so the type tag is sufficient to safely downcast.
+        switch (typeTag.number())
+        {
+            case GlowType::Parameter:
+                visitParameter(static_cast<GlowParameter const&>(node));
+                break;
+
+            case GlowType::Command:
+                visitCommand(static_cast<GlowCommand const&>(node));
+                break;
+
+            case GlowType::Node:
+                visitNode(static_cast<GlowNode const&>(node));
+                break;
+
+            case GlowType::ElementCollection:
+                visitElementCollection(static_cast<GlowElementCollection const&>(node));
+                break;
+
+            case GlowType::StreamEntry:
+                visitStreamEntry(static_cast<GlowStreamEntry const&>(node));
+                break;
+
+            case GlowType::StreamCollection:
+                visitStreamCollection(static_cast<GlowStreamCollection const&>(node));
+                break;
+
+            case GlowType::StringIntegerPair:
+                visitStringIntegerPair(static_cast<GlowStringIntegerPair const&>(node));
+                break;
+
+            case GlowType::StringIntegerCollection:
+                visitStringIntegerCollection(static_cast<GlowStringIntegerCollection const&>(node));
+                break;
+
+            case GlowType::QualifiedParameter:
+                visitQualifiedParameter(static_cast<GlowQualifiedParameter const&>(node));
+                break;
+
+            case GlowType::QualifiedNode:
+                visitQualifiedNode(static_cast<GlowQualifiedNode const&>(node));
+                break;
+
+            case GlowType::RootElementCollection:
+                visitRootElementCollection(static_cast<GlowRootElementCollection const&>(node));
+                break;
+
+            case GlowType::StreamDescriptor:
+                visitStreamDescriptor(static_cast<GlowStreamDescriptor const&>(node));
+                break;
+
+            case GlowType::Matrix:
+                visitMatrix(static_cast<GlowMatrix const&>(node));
+                break;
+
+            case GlowType::Target:
+                visitTarget(static_cast<GlowTarget const&>(node));
+                break;
+
+            case GlowType::Source:
+                visitSource(static_cast<GlowSource const&>(node));
+                break;
+
+            case GlowType::Connection:
+                visitConnection(static_cast<GlowConnection const&>(node));
+                break;
+
+            case GlowType::QualifiedMatrix:
+                visitQualifiedMatrix(static_cast<GlowQualifiedMatrix const&>(node));
+                break;
+
+            case GlowType::Label:
+                visitLabel(static_cast<GlowLabel const&>(node));
+                break;
+
+            case GlowType::Function:
+                visitFunction(static_cast<GlowFunction const&>(node));
+                break;
+
+            case GlowType::QualifiedFunction:
+                visitQualifiedFunction(static_cast<GlowQualifiedFunction const&>(node));
+                break;
+
+            case GlowType::TupleItemDescription:
+                visitTupleItemDescription(static_cast<GlowTupleItemDescription const&>(node));
+                break;
+
+            case GlowType::Invocation:
+                visitInvocation(static_cast<GlowInvocation const&>(node));
+                break;
+
+            case GlowType::InvocationResult:
+                visitInvocationResult(static_cast<GlowInvocationResult const&>(node));
+                break;
+
+            case GlowType::Template:
+                visitTemplate(static_cast<GlowTemplate const&>(node));
+                break;
+
+            case GlowType::QualifiedTemplate:
+                visitQualifiedTemplate(static_cast<GlowQualifiedTemplate const&>(node));
+                break;
+
+            default:
+                visitUnknown(node);
+                break;
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowVisitor::dispatchChildren(dom::Container const& container)
+    {
+        dom::Container::const_iterator const last = container.end();
+        for (dom::Container::const_iterator it = container.begin(); it != last; ++it)
+        {
+            dispatch(*it);
+        }
+    }
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitParameter(GlowParameter const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitCommand(GlowCommand const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitNode(GlowNode const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitElementCollection(GlowElementCollection const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitStreamEntry(GlowStreamEntry const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitStreamCollection(GlowStreamCollection const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitStringIntegerPair(GlowStringIntegerPair const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitStringIntegerCollection(GlowStringIntegerCollection const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitQualifiedParameter(GlowQualifiedParameter const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitQualifiedNode(GlowQualifiedNode const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitRootElementCollection(GlowRootElementCollection const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitStreamDescriptor(GlowStreamDescriptor const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitMatrix(GlowMatrix const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitTarget(GlowTarget const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitSource(GlowSource const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitConnection(GlowConnection const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitQualifiedMatrix(GlowQualifiedMatrix const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitLabel(GlowLabel const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitFunction(GlowFunction const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitQualifiedFunction(GlowQualifiedFunction const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitTupleItemDescription(GlowTupleItemDescription const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitInvocation(GlowInvocation const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitInvocationResult(GlowInvocationResult const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitTemplate(GlowTemplate const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitQualifiedTemplate(GlowQualifiedTemplate const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowVisitor::visitUnknown(dom::Node const&)
+    {}
+
+    LIBEMBER_INLINE
+    void GlowContainer::visitChildren(GlowVisitor& visitor) const
+    {
+        visitor.dispatchChildren(*this);
+    }
+}
+}
+
+#endif  // __LIBEMBER_GLOW_GLOWVISITOR_IPP
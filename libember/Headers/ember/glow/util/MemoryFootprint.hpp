@@ -0,0 +1,418 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+
+    Copyright (C) 2012-2016 Lawo GmbH (http://www.lawo.com).
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef __LIBEMBER_GLOW_UTIL_MEMORYFOOTPRINT_HPP
+#define __LIBEMBER_GLOW_UTIL_MEMORYFOOTPRINT_HPP
+
+#include <string>
+#include <typeinfo>
+#include "../../ber/ObjectIdentifier.hpp"
+#include "../../ber/Octets.hpp"
+#include "../../dom/Container.hpp"
+#include "../../dom/Sequence.hpp"
+#include "../../dom/Set.hpp"
+#include "../../dom/VariantLeaf.hpp"
+#include "../Glow.hpp"
+#include "../GlowStreamDescriptor.hpp"
+#include "../GlowTupleItemDescription.hpp"
+
+namespace libember { namespace glow { namespace util
+{
+    /**
+     * Estimates the amount of heap memory occupied by a dom tree, broken down
+     * by the kind of object the memory is spent on. The numbers are computed
+     * from the sizes of the node classes and the sizes of the values they
+     * hold. They do not include the bookkeeping overhead of the heap
+     * allocator, so they are a lower bound of the actual memory usage.
+     */
+    class MemoryFootprint
+    {
+        public:
+            /**
+             * The kinds of objects the memory of a tree is attributed to.
+             */
+            enum Category
+            {
+                GlowNodes,              /**< GlowNode and GlowQualifiedNode instances. */
+                GlowParameters,         /**< GlowParameter and GlowQualifiedParameter instances. */
+                GlowMatrices,           /**< Matrices and their targets, sources, connections and labels. */
+                GlowFunctions,          /**< Functions, invocations and tuple item descriptions. */
+                OtherGlowContainers,    /**< All other glow types, e.g. collections and stream entries. */
+                DomContainers,          /**< Plain sets and sequences, e.g. the contents set of an element. */
+                VariantLeaves,          /**< Leaf nodes, including the payload object of their value. */
+                Strings,                /**< Heap storage of string values. */
+                ObjectIdentifiers,      /**< Heap storage of object identifier values. */
+                OctetStrings,           /**< Heap storage of octet string values. */
+                ListNodes,              /**< The list nodes linking the children of a container. */
+                OtherNodes,             /**< Nodes of a type unknown to this utility. */
+
+                CategoryCount
+            };
+
+        public:
+            /**
+             * Walks the tree starting at @p root and returns its footprint.
+             * @param root The root node of the tree to measure.
+             * @return The memory footprint of the tree.
+             */
+            static MemoryFootprint measure(dom::Node const& root);
+
+            /**
+             * Returns a human readable name of the passed category.
+             * @param category The category to return the name of.
+             * @return The name of the category.
+             */
+            static char const* categoryName(Category category);
+
+            /** Initializes an empty footprint. */
+            MemoryFootprint();
+
+            /**
+             * Returns the number of bytes attributed to the passed category.
+             * @param category The category to query.
+             * @return The number of bytes attributed to @p category.
+             */
+            std::size_t bytes(Category category) const;
+
+            /**
+             * Returns the number of objects attributed to the passed category.
+             * For the value categories this is the number of values that
+             * required heap storage.
+             * @param category The category to query.
+             * @return The number of objects attributed to @p category.
+             */
+            std::size_t count(Category category) const;
+
+            /**
+             * Returns the sum of all categories, in bytes.
+             * @return The total estimated footprint of the tree.
+             */
+            std::size_t totalBytes() const;
+
+            /**
+             * Returns the number of dom nodes contained in the tree, including
+             * the root node.
+             * @return The number of dom nodes contained in the tree.
+             */
+            std::size_t nodeCount() const;
+
+            /**
+             * Returns the depth of the tree. A tree consisting of a single
+             * node has a depth of one.
+             * @return The depth of the tree.
+             */
+            std::size_t maxDepth() const;
+
+        private:
+            /**
+             * Estimated size of a single node of a std::list, which stores two
+             * links and the node pointer.
+             */
+            static std::size_t const ListNodeSize = 3 * sizeof(void*);
+
+            /**
+             * Estimated size of the reference counted payload object a
+             * ber::Value allocates, excluding the wrapped value itself.
+             */
+            static std::size_t const PayloadOverhead = sizeof(void*) + sizeof(unsigned long);
+
+            /**
+             * The longest string that typically fits into the small string
+             * buffer of std::string and therefore requires no heap storage.
+             */
+            static std::size_t const SmallStringCapacity = 15;
+
+            /**
+             * Typical size of the blocks a std::deque allocates, which is
+             * the container used by ber::ObjectIdentifier.
+             */
+            static std::size_t const DequeBlockSize = 512;
+
+            /**
+             * Typical minimum number of block pointers in the map of a
+             * std::deque.
+             */
+            static std::size_t const DequeMapSize = 8;
+
+            void add(Category category, std::size_t bytes);
+
+            void visit(dom::Node const& node, std::size_t depth);
+
+            void visitValue(ber::Value const& value);
+
+            static std::size_t payloadSize(ber::Value const& value);
+
+            static Category categoryOf(GlowType::_Domain type);
+
+            static std::size_t sizeOf(GlowType::_Domain type);
+
+        private:
+            std::size_t m_bytes[CategoryCount];
+            std::size_t m_counts[CategoryCount];
+            std::size_t m_nodeCount;
+            std::size_t m_maxDepth;
+    };
+
+    /**************************************************************************/
+    /* Mandatory inline implementation                                        */
+    /**************************************************************************/
+
+    inline MemoryFootprint MemoryFootprint::measure(dom::Node const& root)
+    {
+        MemoryFootprint result;
+        result.visit(root, 1);
+        return result;
+    }
+
+    inline char const* MemoryFootprint::categoryName(Category category)
+    {
+        switch (category)
+        {
+            case GlowNodes:             return "GlowNode";
+            case GlowParameters:        return "GlowParameter";
+            case GlowMatrices:          return "GlowMatrix";
+            case GlowFunctions:         return "GlowFunction";
+            case OtherGlowContainers:   return "OtherGlowContainer";
+            case DomContainers:         return "DomContainer";
+            case VariantLeaves:         return "VariantLeaf";
+            case Strings:               return "String";
+            case ObjectIdentifiers:     return "ObjectIdentifier";
+            case OctetStrings:          return "Octets";
+            case ListNodes:             return "ListNode";
+            case OtherNodes:            return "OtherNode";
+            default:                    return "Unknown";
+        }
+    }
+
+    inline MemoryFootprint::MemoryFootprint()
+        : m_nodeCount(0), m_maxDepth(0)
+    {
+        for (int i = 0; i < CategoryCount; ++i)
+        {
+            m_bytes[i] = 0;
+            m_counts[i] = 0;
+        }
+    }
+
+    inline std::size_t MemoryFootprint::bytes(Category category) const
+    {
+        return m_bytes[category];
+    }
+
+    inline std::size_t MemoryFootprint::count(Category category) const
+    {
+        return m_counts[category];
+    }
+
+    inline std::size_t MemoryFootprint::totalBytes() const
+    {
+        std::size_t total = 0;
+        for (int i = 0; i < CategoryCount; ++i)
+        {
+            total += m_bytes[i];
+        }
+        return total;
+    }
+
+    inline std::size_t MemoryFootprint::nodeCount() const
+    {
+        return m_nodeCount;
+    }
+
+    inline std::size_t MemoryFootprint::maxDepth() const
+    {
+        return m_maxDepth;
+    }
+
+    inline void MemoryFootprint::add(Category category, std::size_t bytes)
+    {
+        m_bytes[category] += bytes;
+        m_counts[category] += 1;
+    }
+
+    inline void MemoryFootprint::visit(dom::Node const& node, std::size_t depth)
+    {
+        m_nodeCount += 1;
+        if (depth > m_maxDepth)
+        {
+            m_maxDepth = depth;
+        }
+
+        dom::Container const* const container = dynamic_cast<dom::Container const*>(&node);
+        if (container != 0)
+        {
+            ber::Tag const typeTag = node.typeTag();
+            if (typeTag.getClass() == ber::Class::Application)
+            {
+                GlowType::_Domain const type = static_cast<GlowType::_Domain>(typeTag.number());
+                add(categoryOf(type), sizeOf(type));
+            }
+            else if (dynamic_cast<dom::Set const*>(container) != 0)
+            {
+                add(DomContainers, sizeof(dom::Set));
+            }
+            else if (dynamic_cast<dom::Sequence const*>(container) != 0)
+            {
+                add(DomContainers, sizeof(dom::Sequence));
+            }
+            else
+            {
+                add(OtherNodes, sizeof(dom::Container));
+            }
+
+            dom::Container::const_iterator const last = container->end();
+            for (dom::Container::const_iterator it = container->begin(); it != last; ++it)
+            {
+                add(ListNodes, ListNodeSize);
+                visit(*it, depth + 1);
+            }
+        }
+        else
+        {
+            dom::VariantLeaf const* const leaf = dynamic_cast<dom::VariantLeaf const*>(&node);
+            if (leaf != 0)
+            {
+                ber::Value const value = leaf->value();
+                add(VariantLeaves, sizeof(dom::VariantLeaf) + payloadSize(value));
+                visitValue(value);
+            }
+            else
+            {
+                add(OtherNodes, sizeof(dom::Node));
+            }
+        }
+    }
+
+    inline void MemoryFootprint::visitValue(ber::Value const& value)
+    {
+        if (!value)
+        {
+            return;
+        }
+
+        std::type_info const& type = value.typeId();
+        if (type == typeid(std::string))
+        {
+            std::string const string = value.as<std::string>();
+            if (string.size() > SmallStringCapacity)
+            {
+                add(Strings, string.size() + 1);
+            }
+        }
+        else if (type == typeid(ber::ObjectIdentifier))
+        {
+            std::size_t const elementsPerBlock = DequeBlockSize / sizeof(ber::ObjectIdentifier::value_type);
+            std::size_t const blocks = value.as<ber::ObjectIdentifier>().size() / elementsPerBlock + 1;
+            add(ObjectIdentifiers, DequeMapSize * sizeof(void*) + blocks * DequeBlockSize);
+        }
+        else if (type == typeid(ber::Octets))
+        {
+            std::size_t const size = value.as<ber::Octets>().size();
+            if (size > 0)
+            {
+                add(OctetStrings, size);
+            }
+        }
+    }
+
+    inline std::size_t MemoryFootprint::payloadSize(ber::Value const& value)
+    {
+        if (!value)
+        {
+            return 0;
+        }
+
+        std::type_info const& type = value.typeId();
+        if (type == typeid(std::string))
+        {
+            return PayloadOverhead + sizeof(std::string);
+        }
+        else if (type == typeid(ber::ObjectIdentifier))
+        {
+            return PayloadOverhead + sizeof(ber::ObjectIdentifier);
+        }
+        else if (type == typeid(ber::Octets))
+        {
+            return PayloadOverhead + sizeof(ber::Octets);
+        }
+        else
+        {
+            // All remaining value types are scalars of at most eight bytes.
+            return PayloadOverhead + sizeof(double);
+        }
+    }
+
+    inline MemoryFootprint::Category MemoryFootprint::categoryOf(GlowType::_Domain type)
+    {
+        switch (type)
+        {
+            case GlowType::Node:
+            case GlowType::QualifiedNode:
+                return GlowNodes;
+
+            case GlowType::Parameter:
+            case GlowType::QualifiedParameter:
+                return GlowParameters;
+
+            case GlowType::Matrix:
+            case GlowType::QualifiedMatrix:
+            case GlowType::Target:
+            case GlowType::Source:
+            case GlowType::Connection:
+            case GlowType::Label:
+                return GlowMatrices;
+
+            case GlowType::Function:
+            case GlowType::QualifiedFunction:
+            case GlowType::TupleItemDescription:
+            case GlowType::Invocation:
+            case GlowType::InvocationResult:
+                return GlowFunctions;
+
+            default:
+                return OtherGlowContainers;
+        }
+    }
+
+    inline std::size_t MemoryFootprint::sizeOf(GlowType::_Domain type)
+    {
+        switch (type)
+        {
+            case GlowType::Parameter:               return sizeof(GlowParameter);
+            case GlowType::Command:                 return sizeof(GlowCommand);
+            case GlowType::Node:                    return sizeof(GlowNode);
+            case GlowType::ElementCollection:       return sizeof(GlowElementCollection);
+            case GlowType::StreamEntry:             return sizeof(GlowStreamEntry);
+            case GlowType::StreamCollection:        return sizeof(GlowStreamCollection);
+            case GlowType::StringIntegerPair:       return sizeof(GlowStringIntegerPair);
+            case GlowType::StringIntegerCollection: return sizeof(GlowStringIntegerCollection);
+            case GlowType::QualifiedParameter:      return sizeof(GlowQualifiedParameter);
+            case GlowType::QualifiedNode:           return sizeof(GlowQualifiedNode);
+            case GlowType::RootElementCollection:   return sizeof(GlowRootElementCollection);
+            case GlowType::StreamDescriptor:        return sizeof(GlowStreamDescriptor);
+            case GlowType::Matrix:                  return sizeof(GlowMatrix);
+            case GlowType::Target:                  return sizeof(GlowTarget);
+            case GlowType::Source:                  return sizeof(GlowSource);
+            case GlowType::Connection:              return sizeof(GlowConnection);
+            case GlowType::QualifiedMatrix:         return sizeof(GlowQualifiedMatrix);
+            case GlowType::Label:                   return sizeof(GlowLabel);
+            case GlowType::Function:                return sizeof(GlowFunction);
+            case GlowType::QualifiedFunction:       return sizeof(GlowQualifiedFunction);
+            case GlowType::TupleItemDescription:    return sizeof(GlowTupleItemDescription);
+            case GlowType::Invocation:              return sizeof(GlowInvocation);
+            case GlowType::InvocationResult:        return sizeof(GlowInvocationResult);
+            case GlowType::Template:                return sizeof(GlowTemplate);
+            case GlowType::QualifiedTemplate:       return sizeof(GlowQualifiedTemplate);
+            default:                                return sizeof(GlowContainer);
+        }
+    }
+}
+}
+}
+
+#endif  // __LIBEMBER_GLOW_UTIL_MEMORYFOOTPRINT_HPP
@@ -0,0 +1,413 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+
+    Copyright (C) 2012-2016 Lawo GmbH (http://www.lawo.com).
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef __LIBEMBER_GLOW_UTIL_STATICENCODER_HPP
+#define __LIBEMBER_GLOW_UTIL_STATICENCODER_HPP
+
+#include <string>
+#include <utility>
+#include "../../ber/Encoding.hpp"
+#include "../../ber/Class.hpp"
+#include "../../ber/Type.hpp"
+#include "../../util/OctetStream.hpp"
+#include "../ConnectionDisposition.hpp"
+#include "../ConnectionOperation.hpp"
+#include "../GlowType.hpp"
+#include "../ParameterProperty.hpp"
+
+//SimianIgnore
+
+namespace libember { namespace glow { namespace util
+{
+    /**
+     * Contains the compile time building blocks of the static encoders.
+     */
+    namespace detail
+    {
+        /**
+         * Provides the single encoded byte of a tag whose class and number are
+         * known at compile time. Only tag numbers below 31 can be encoded in
+         * a single byte, which holds true for all tags used by the Glow DTD.
+         * @param TagClass The class of the tag.
+         * @param TagNumber The number of the tag, must be less than 31.
+         * @param IsContainer Specifies whether the constructed bit is set.
+         */
+        template<ber::Class::_Domain TagClass, unsigned int TagNumber, bool IsContainer>
+        struct StaticTag
+        {
+            typedef char tag_number_must_fit_into_a_single_byte[(TagNumber < 0x1FU) ? 1 : -1];
+
+            enum
+            {
+                value = static_cast<unsigned int>(TagClass) | (IsContainer ? 0x20U : 0x00U) | TagNumber
+            };
+        };
+
+        /** The constructed context-specific tag with the specified number. */
+        template<unsigned int TagNumber>
+        struct ContextTag : StaticTag<ber::Class::ContextSpecific, TagNumber, true>
+        {};
+
+        /** The constructed application tag of the specified Glow type. */
+        template<unsigned int TypeNumber>
+        struct ApplicationTag : StaticTag<ber::Class::Application, TypeNumber, true>
+        {};
+
+        /** The primitive universal tag of the specified BER type. */
+        template<ber::Type::_Domain UniversalType>
+        struct UniversalTag : StaticTag<ber::Class::Universal, UniversalType, false>
+        {};
+
+        /**
+         * Maps a value type to the universal tag used to encode it. Only the
+         * types that may be stored in a Glow Value are supported.
+         */
+        template<typename ValueType>
+        struct ValueTag;
+
+        template<>
+        struct ValueTag<bool> : UniversalTag<ber::Type::Boolean>
+        {};
+
+        template<>
+        struct ValueTag<int> : UniversalTag<ber::Type::Integer>
+        {};
+
+        template<>
+        struct ValueTag<long> : UniversalTag<ber::Type::Integer>
+        {};
+
+        template<>
+        struct ValueTag<double> : UniversalTag<ber::Type::Real>
+        {};
+
+        template<>
+        struct ValueTag<std::string> : UniversalTag<ber::Type::UTF8String>
+        {};
+
+        template<>
+        struct ValueTag<ber::Octets> : UniversalTag<ber::Type::OctetString>
+        {};
+
+        /**
+         * Returns the size of a frame with a single byte tag, including the
+         * tag, the encoded length and the payload.
+         * @param payloadLength The number of bytes contained in the frame.
+         * @return The total number of bytes occupied by the frame.
+         */
+        inline std::size_t frameLength(std::size_t payloadLength)
+        {
+            return 1U + ber::encodedLength(ber::make_length(payloadLength)) + payloadLength;
+        }
+
+        /**
+         * Writes the header of a frame, i.e. its single byte tag and the
+         * definite length of its payload.
+         * @param output The stream to write the header to.
+         * @param tag The precomputed tag byte.
+         * @param payloadLength The number of bytes contained in the frame.
+         */
+        inline void encodeFrameHeader(libember::util::OctetStream& output, unsigned int tag, std::size_t payloadLength)
+        {
+            output.append(static_cast<libember::util::OctetStream::value_type>(tag));
+            ber::encode(output, ber::make_length(payloadLength));
+        }
+
+        /**
+         * Returns the length of a universally tagged value, excluding the
+         * context specific tag it is wrapped into.
+         * @param value The value to compute the encoded length of.
+         * @return The number of bytes required to encode @p value.
+         */
+        template<typename ValueType>
+        inline std::size_t universalLength(ValueType const& value)
+        {
+            return frameLength(ber::EncodingTraits<ValueType>::encodedLength(value));
+        }
+
+        /**
+         * Encodes a universally tagged value wrapped into a context specific
+         * frame, which is how all leaves of the Glow DTD are represented.
+         * @param output The stream to write the leaf to.
+         * @param value The value to encode.
+         */
+        template<unsigned int ContextNumber, typename ValueType>
+        inline void encodeLeaf(libember::util::OctetStream& output, ValueType const& value)
+        {
+            std::size_t const payloadLength = ber::EncodingTraits<ValueType>::encodedLength(value);
+            encodeFrameHeader(output, ContextTag<ContextNumber>::value, frameLength(payloadLength));
+            encodeFrameHeader(output, ValueTag<ValueType>::value, payloadLength);
+            ber::EncodingTraits<ValueType>::encode(output, value);
+        }
+
+        /**
+         * Encodes a relative object identifier wrapped into a context
+         * specific frame, as used for paths and connection sources.
+         * @param output The stream to write the leaf to.
+         * @param oid The object identifier to encode.
+         */
+        template<unsigned int ContextNumber>
+        inline void encodeOidLeaf(libember::util::OctetStream& output, ber::ObjectIdentifier const& oid)
+        {
+            std::size_t const payloadLength = ber::EncodingTraits<ber::ObjectIdentifier>::encodedLength(oid);
+            encodeFrameHeader(output, ContextTag<ContextNumber>::value, frameLength(payloadLength));
+            encodeFrameHeader(output, UniversalTag<ber::Type::RelativeObject>::value, payloadLength);
+            ber::EncodingTraits<ber::ObjectIdentifier>::encode(output, oid);
+        }
+
+        /** Returns the length of a leaf created with encodeOidLeaf. */
+        inline std::size_t oidLeafLength(ber::ObjectIdentifier const& oid)
+        {
+            return frameLength(frameLength(ber::EncodingTraits<ber::ObjectIdentifier>::encodedLength(oid)));
+        }
+
+        /**
+         * Returns the length of a Glow root frame containing a root element
+         * collection with a single element of the specified length.
+         * @param elementLength The length of the element, including its frame.
+         * @return The total number of bytes required for the message.
+         */
+        inline std::size_t rootCollectionLength(std::size_t elementLength)
+        {
+            return frameLength(frameLength(frameLength(elementLength)));
+        }
+
+        /**
+         * Writes the headers of a Glow root frame and a root element collection
+         * that contains a single element of the specified length.
+         * @param output The stream to write the headers to.
+         * @param elementLength The length of the element, including its frame.
+         */
+        inline void encodeRootCollectionHeader(libember::util::OctetStream& output, std::size_t elementLength)
+        {
+            std::size_t const itemLength = frameLength(elementLength);
+            std::size_t const collectionLength = frameLength(itemLength);
+            encodeFrameHeader(output, StaticTag<ber::Class::Application, 0, true>::value, collectionLength);
+            encodeFrameHeader(output, ApplicationTag<GlowType::RootElementCollection>::value, itemLength);
+            encodeFrameHeader(output, ContextTag<0>::value, elementLength);
+        }
+    }
+
+
+    /**
+     * Encodes a complete Glow message that reports the value of a single
+     * qualified parameter, i.e. a root element collection containing a
+     * QualifiedParameter with only its path and the value content set.
+     * The tag bytes are known at compile time and the message is written
+     * directly to the output stream without building a DOM tree. The
+     * result is byte-for-byte identical to encoding the equivalent
+     * GlowQualifiedParameter.
+     * @param ValueType The type of the value to encode. Supported types are
+     *      bool, int, long, double, std::string and ber::Octets.
+     */
+    template<typename ValueType>
+    struct QualifiedParameterValueEncoder
+    {
+        public:
+            typedef ValueType value_type;
+
+            /**
+             * Returns the number of bytes the encoded message will occupy.
+             * @param path The path of the parameter.
+             * @param value The value of the parameter.
+             * @return The total encoded length of the message.
+             */
+            static std::size_t encodedLength(ber::ObjectIdentifier const& path, value_type const& value)
+            {
+                return detail::rootCollectionLength(elementLength(path, value));
+            }
+
+            /**
+             * Encodes the message to @p output.
+             * @param output The stream to append the encoded message to.
+             * @param path The path of the parameter.
+             * @param value The value of the parameter.
+             */
+            static void encode(libember::util::OctetStream& output, ber::ObjectIdentifier const& path, value_type const& value)
+            {
+                std::size_t const valueLength = detail::frameLength(detail::universalLength(value));
+                std::size_t const setLength = detail::frameLength(valueLength);
+                std::size_t const contentsLength = detail::frameLength(setLength);
+                std::size_t const payloadLength = detail::oidLeafLength(path) + contentsLength;
+
+                detail::encodeRootCollectionHeader(output, detail::frameLength(payloadLength));
+                detail::encodeFrameHeader(output, detail::ApplicationTag<GlowType::QualifiedParameter>::value, payloadLength);
+                detail::encodeOidLeaf<0>(output, path);
+                detail::encodeFrameHeader(output, detail::ContextTag<1>::value, setLength);
+                detail::encodeFrameHeader(output, detail::StaticTag<ber::Class::Universal, ber::Type::Set, true>::value, valueLength);
+                detail::encodeLeaf<ParameterProperty::Value>(output, value);
+            }
+
+        private:
+            static std::size_t elementLength(ber::ObjectIdentifier const& path, value_type const& value)
+            {
+                std::size_t const valueLength = detail::frameLength(detail::universalLength(value));
+                std::size_t const contentsLength = detail::frameLength(detail::frameLength(valueLength));
+                return detail::frameLength(detail::oidLeafLength(path) + contentsLength);
+            }
+    };
+
+
+    /**
+     * Encodes a complete Glow message that reports the state of a single
+     * crosspoint, i.e. a root element collection containing a QualifiedMatrix
+     * with only its path and a connections sequence holding one Connection.
+     * The connection always carries its target, sources, operation and
+     * disposition.
+     */
+    struct ConnectionEncoder
+    {
+        public:
+            /**
+             * Returns the number of bytes the encoded message will occupy.
+             * @param matrixPath The path of the matrix.
+             * @param target The number of the target.
+             * @param sources The sources connected to the target.
+             * @return The total encoded length of the message.
+             */
+            static std::size_t encodedLength(ber::ObjectIdentifier const& matrixPath, int target, ber::ObjectIdentifier const& sources)
+            {
+                std::size_t const connectionLength = detail::frameLength(connectionPayloadLength(target, sources));
+                std::size_t const connectionsLength = detail::frameLength(detail::frameLength(detail::frameLength(connectionLength)));
+                return detail::rootCollectionLength(detail::frameLength(detail::oidLeafLength(matrixPath) + connectionsLength));
+            }
+
+            /**
+             * Encodes the message to @p output.
+             * @param output The stream to append the encoded message to.
+             * @param matrixPath The path of the matrix.
+             * @param target The number of the target.
+             * @param sources The sources connected to the target.
+             * @param operation The connection operation.
+             * @param disposition The connection disposition.
+             */
+            static void encode(
+                libember::util::OctetStream& output,
+                ber::ObjectIdentifier const& matrixPath,
+                int target,
+                ber::ObjectIdentifier const& sources,
+                ConnectionOperation const& operation,
+                ConnectionDisposition const& disposition)
+            {
+                std::size_t const payloadLength = connectionPayloadLength(target, sources);
+                std::size_t const connectionLength = detail::frameLength(payloadLength);
+                std::size_t const itemLength = detail::frameLength(connectionLength);
+                std::size_t const sequenceLength = detail::frameLength(itemLength);
+                std::size_t const matrixLength = detail::oidLeafLength(matrixPath) + detail::frameLength(sequenceLength);
+
+                detail::encodeRootCollectionHeader(output, detail::frameLength(matrixLength));
+                detail::encodeFrameHeader(output, detail::ApplicationTag<GlowType::QualifiedMatrix>::value, matrixLength);
+                detail::encodeOidLeaf<0>(output, matrixPath);
+                detail::encodeFrameHeader(output, detail::ContextTag<5>::value, sequenceLength);
+                detail::encodeFrameHeader(output, detail::StaticTag<ber::Class::Universal, ber::Type::Sequence, true>::value, itemLength);
+                detail::encodeFrameHeader(output, detail::ContextTag<0>::value, connectionLength);
+                detail::encodeFrameHeader(output, detail::ApplicationTag<GlowType::Connection>::value, payloadLength);
+                detail::encodeLeaf<0>(output, target);
+                detail::encodeOidLeaf<1>(output, sources);
+                detail::encodeLeaf<2>(output, static_cast<int>(operation.value()));
+                detail::encodeLeaf<3>(output, static_cast<int>(disposition.value()));
+            }
+
+        private:
+            static std::size_t connectionPayloadLength(int target, ber::ObjectIdentifier const& sources)
+            {
+                // Operation and disposition values are always in the range of
+                // a single byte integer.
+                std::size_t const enumLeafLength = detail::frameLength(detail::universalLength(0));
+                return detail::frameLength(detail::universalLength(target))
+                    + detail::oidLeafLength(sources)
+                    + 2U * enumLeafLength;
+            }
+    };
+
+
+    /**
+     * Encodes a complete Glow message containing a stream collection, without
+     * building the intermediate GlowStreamEntry nodes.
+     * @param ValueType The type of the stream values. Supported types are
+     *      int, long, double and ber::Octets.
+     */
+    template<typename ValueType>
+    struct StreamEntryEncoder
+    {
+        public:
+            typedef ValueType value_type;
+            typedef std::pair<int, value_type> entry_type;
+
+            /**
+             * Returns the number of bytes a message containing a single
+             * stream entry will occupy.
+             * @param streamIdentifier The identifier of the stream.
+             * @param value The current value of the stream.
+             * @return The total encoded length of the message.
+             */
+            static std::size_t encodedLength(int streamIdentifier, value_type const& value)
+            {
+                return detail::frameLength(detail::frameLength(itemLength(streamIdentifier, value)));
+            }
+
+            /**
+             * Encodes a message containing a single stream entry to @p output.
+             * @param output The stream to append the encoded message to.
+             * @param streamIdentifier The identifier of the stream.
+             * @param value The current value of the stream.
+             */
+            static void encode(libember::util::OctetStream& output, int streamIdentifier, value_type const& value)
+            {
+                entry_type const entry(streamIdentifier, value);
+                encode(output, &entry, &entry + 1);
+            }
+
+            /**
+             * Encodes a message containing all stream entries of the range
+             * [first, last) to @p output. The value type of the iterator must
+             * be convertible to entry_type.
+             * @param output The stream to append the encoded message to.
+             * @param first An iterator pointing to the first entry to encode.
+             * @param last An iterator pointing one past the last entry to encode.
+             */
+            template<typename InputIterator>
+            static void encode(libember::util::OctetStream& output, InputIterator first, InputIterator last)
+            {
+                std::size_t collectionLength = 0U;
+                for (InputIterator it = first; it != last; ++it)
+                {
+                    collectionLength += itemLength(it->first, it->second);
+                }
+
+                detail::encodeFrameHeader(output, detail::StaticTag<ber::Class::Application, 0, true>::value, detail::frameLength(collectionLength));
+                detail::encodeFrameHeader(output, detail::ApplicationTag<GlowType::StreamCollection>::value, collectionLength);
+                for (/* Nothing */; first != last; ++first)
+                {
+                    std::size_t const payloadLength = entryPayloadLength(first->first, first->second);
+                    detail::encodeFrameHeader(output, detail::ContextTag<0>::value, detail::frameLength(payloadLength));
+                    detail::encodeFrameHeader(output, detail::ApplicationTag<GlowType::StreamEntry>::value, payloadLength);
+                    detail::encodeLeaf<0>(output, first->first);
+                    detail::encodeLeaf<1>(output, first->second);
+                }
+            }
+
+        private:
+            static std::size_t entryPayloadLength(int streamIdentifier, value_type const& value)
+            {
+                return detail::frameLength(detail::universalLength(streamIdentifier))
+                    + detail::frameLength(detail::universalLength(value));
+            }
+
+            static std::size_t itemLength(int streamIdentifier, value_type const& value)
+            {
+                return detail::frameLength(detail::frameLength(entryPayloadLength(streamIdentifier, value)));
+            }
+    };
+}
+}
+}
+
+//EndSimianIgnore
+
+#endif  // __LIBEMBER_GLOW_UTIL_STATICENCODER_HPP
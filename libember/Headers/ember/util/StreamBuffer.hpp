@@ -54,6 +54,16 @@ namespace libember { namespace util
              */
             StreamBuffer(StreamBuffer const& other);
 
+#if __cplusplus >= 201103L
+            /**
+             * Move constructor that takes over the chunks of @p other without
+             * copying them. @p other is left empty.
+             * @param other a reference to the StreamBuffer instance whose
+             *      buffer contents should be taken over.
+             */
+            StreamBuffer(StreamBuffer&& other) noexcept;
+#endif
+
             /** Destructor. Releases memory allocated to the controlled sequence. */
             virtual ~StreamBuffer();
 
@@ -171,6 +181,8 @@ namespace libember { namespace util
              * @p other into this instance.
              * @param other the Stream buffer whose contents to copy.
              * @return A reference referring to this instance.
+             * @note When move semantics are available, assigning an rvalue
+             *      moves its contents instead of copying them.
              */
             StreamBuffer& operator=(StreamBuffer other);
 
@@ -245,6 +257,15 @@ namespace libember { namespace util
         : m_head(0), m_tail(0), m_size(0), m_maxsize(maxSize ? maxSize : 0xFFFFFFFF)
     {}
 
+#if __cplusplus >= 201103L
+    template<typename ValueType, unsigned short ChunkSize>
+    inline StreamBuffer<ValueType, ChunkSize>::StreamBuffer(StreamBuffer&& other) noexcept
+        : m_head(0), m_tail(0), m_size(0), m_maxsize(other.m_maxsize)
+    {
+        swap(other);
+    }
+#endif
+
     template<typename ValueType, unsigned short ChunkSize>
     inline StreamBuffer<ValueType, ChunkSize>::StreamBuffer(StreamBuffer const& other)
         : m_head(0), m_tail(0), m_size(other.m_size), m_maxsize(other.m_maxsize)
@@ -253,9 +274,9 @@ namespace libember { namespace util
         while (currentSource != 0)
         {
             node_type* const newNode = new node_type(*currentSource);
-            if (m_head != 0)
+            if (m_tail != 0)
             {
-                m_head->next() = newNode;
+                m_tail->next() = newNode;
             }
             else
             {
@@ -0,0 +1,753 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+
+    Copyright (C) 2012-2016 Lawo GmbH (http://www.lawo.com).
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ember/Ember.hpp"
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <windows.h>
+#  include <psapi.h>
+#  if defined(_MSC_VER)
+#    pragma comment(lib, "psapi.lib")
+#  endif
+#else
+#  include <sys/resource.h>
+#  include <sys/time.h>
+#endif
+
+//SimianIgnore
+
+/*
+ * Replacement global allocation functions used to count the number of heap
+ * allocations performed while building, encoding and decoding a tree.
+ * The benchmark is strictly single threaded, so plain counters suffice.
+ */
+namespace
+{
+    unsigned long long g_allocationCount = 0;
+}
+
+#if __cplusplus >= 201103L
+#  define BENCHMARK_NEW_THROW
+#  define BENCHMARK_DELETE_THROW noexcept
+#else
+#  define BENCHMARK_NEW_THROW throw(std::bad_alloc)
+#  define BENCHMARK_DELETE_THROW throw()
+#endif
+
+void* operator new(std::size_t size) BENCHMARK_NEW_THROW
+{
+    ++g_allocationCount;
+
+    void* const memory = std::malloc(size > 0 ? size : 1);
+    if (memory == 0)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](std::size_t size) BENCHMARK_NEW_THROW
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) BENCHMARK_DELETE_THROW
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) BENCHMARK_DELETE_THROW
+{
+    std::free(memory);
+}
+
+#if defined(__cpp_sized_deallocation)
+void operator delete(void* memory, std::size_t) BENCHMARK_DELETE_THROW
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) BENCHMARK_DELETE_THROW
+{
+    std::free(memory);
+}
+#endif
+
+namespace
+{
+    /**
+     * The command line configurable dimensions of the synthetic device.
+     */
+    struct Options
+    {
+        Options()
+            : nodes(100)
+            , parameters(50)
+            , targets(64)
+            , sources(64)
+            , connections(64)
+            , streamEntries(1024)
+            , iterations(10)
+            , chunkSize(1024)
+        {}
+
+        unsigned int nodes;
+        unsigned int parameters;
+        unsigned int targets;
+        unsigned int sources;
+        unsigned int connections;
+        unsigned int streamEntries;
+        unsigned int iterations;
+        unsigned int chunkSize;
+    };
+
+    /**
+     * Aggregated measurements of a single benchmark scenario.
+     */
+    struct Result
+    {
+        Result()
+            : elements(0)
+            , encodedBytes(0)
+            , buildSeconds(0.0)
+            , encodeSeconds(0.0)
+            , decodeSeconds(0.0)
+            , buildAllocations(0)
+            , encodeAllocations(0)
+            , decodeAllocations(0)
+            , peakRssKiB(0)
+        {}
+
+        std::string name;
+        unsigned long elements;
+        unsigned long encodedBytes;
+        double buildSeconds;
+        double encodeSeconds;
+        double decodeSeconds;
+        unsigned long long buildAllocations;
+        unsigned long long encodeAllocations;
+        unsigned long long decodeAllocations;
+        unsigned long peakRssKiB;
+    };
+
+    /**
+     * Returns a high resolution timestamp in seconds.
+     * @return The current wall clock time, in seconds.
+     */
+    double now()
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER counter;
+        ::QueryPerformanceFrequency(&frequency);
+        ::QueryPerformanceCounter(&counter);
+        return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+#else
+        struct timeval tv;
+        ::gettimeofday(&tv, 0);
+        return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1e-6;
+#endif
+    }
+
+    /**
+     * Returns the peak resident set size of this process, in KiB.
+     * @return The peak resident set size, or 0 if it cannot be determined.
+     */
+    unsigned long peakRssKiB()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return static_cast<unsigned long>(counters.PeakWorkingSetSize / 1024);
+        }
+        return 0;
+#else
+        struct rusage usage;
+        if (::getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#  if defined(__APPLE__)
+        return static_cast<unsigned long>(usage.ru_maxrss / 1024);
+#  else
+        return static_cast<unsigned long>(usage.ru_maxrss);
+#  endif
+#endif
+    }
+
+    /**
+     * Returns the number of nodes contained in the DOM subtree rooted at
+     * @p node, including @p node itself.
+     */
+    unsigned long countNodes(libember::dom::Node const* node)
+    {
+        unsigned long count = 1;
+        libember::dom::Container const* const container = dynamic_cast<libember::dom::Container const*>(node);
+        if (container != 0)
+        {
+            libember::dom::Container::const_iterator const last = container->end();
+            for (libember::dom::Container::const_iterator it = container->begin(); it != last; ++it)
+            {
+                count += countNodes(&*it);
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Builds a root collection containing @p nodes nodes, each of which
+     * holds @p parameters parameters of alternating value types.
+     */
+    libember::dom::Node* buildParameterTree(Options const& options)
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        for (unsigned int n = 0; n < options.nodes; ++n)
+        {
+            GlowNode* const node = new GlowNode(root, static_cast<int>(n + 1));
+            std::ostringstream identifier;
+            identifier << "node" << n;
+            node->setIdentifier(identifier.str());
+            node->setDescription("Synthetic node");
+            node->setIsOnline(true);
+
+            for (unsigned int p = 0; p < options.parameters; ++p)
+            {
+                GlowParameter* const parameter = new GlowParameter(node, static_cast<int>(p + 1));
+                std::ostringstream parameterIdentifier;
+                parameterIdentifier << "param" << p;
+                parameter->setIdentifier(parameterIdentifier.str());
+                parameter->setAccess(Access::ReadWrite);
+
+                switch (p % 4)
+                {
+                    case 0:
+                        parameter->setType(ParameterType::Integer);
+                        parameter->setValue(static_cast<long>(n * options.parameters + p));
+                        parameter->setMinimum(0L);
+                        parameter->setMaximum(65535L);
+                        break;
+
+                    case 1:
+                        parameter->setType(ParameterType::Real);
+                        parameter->setValue(static_cast<double>(p) * 0.5 - 64.0);
+                        parameter->setMinimum(-128.0);
+                        parameter->setMaximum(12.0);
+                        parameter->setFormat("%.1f dB");
+                        break;
+
+                    case 2:
+                        parameter->setType(ParameterType::String);
+                        parameter->setValue(std::string("Synthetic string value"));
+                        break;
+
+                    default:
+                        parameter->setType(ParameterType::Boolean);
+                        parameter->setValue((p & 1) != 0);
+                        break;
+                }
+            }
+        }
+        return root;
+    }
+
+    /**
+     * Builds a root collection containing a single linear matrix with the
+     * configured number of targets, sources and connections.
+     */
+    libember::dom::Node* buildMatrixTree(Options const& options)
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowMatrix* const matrix = new GlowMatrix(root, 1);
+        matrix->setIdentifier("router");
+        matrix->setDescription("Synthetic router");
+        matrix->setType(MatrixType::OneToN);
+        matrix->setAddressingMode(MatrixAddressingMode::Linear);
+        matrix->setTargetCount(static_cast<int>(options.targets));
+        matrix->setSourceCount(static_cast<int>(options.sources));
+
+        libember::dom::Sequence* const targets = matrix->targets();
+        for (unsigned int t = 0; t < options.targets; ++t)
+        {
+            targets->insert(targets->end(), new GlowTarget(static_cast<int>(t)));
+        }
+
+        libember::dom::Sequence* const sources = matrix->sources();
+        for (unsigned int s = 0; s < options.sources; ++s)
+        {
+            sources->insert(sources->end(), new GlowSource(static_cast<int>(s)));
+        }
+
+        if (options.targets > 0 && options.sources > 0)
+        {
+            libember::dom::Sequence* const connections = matrix->connections();
+            for (unsigned int c = 0; c < options.connections; ++c)
+            {
+                GlowConnection* const connection = new GlowConnection(static_cast<int>(c % options.targets));
+                libember::ber::ObjectIdentifier connected;
+                connected.push_back(static_cast<libember::ber::ObjectIdentifier::value_type>((c * 7) % options.sources));
+                connection->setSources(connected);
+                connection->setDisposition(ConnectionDisposition::Tally);
+                connections->insert(connections->end(), connection);
+            }
+        }
+        return root;
+    }
+
+    /**
+     * Builds a stream collection with the configured number of entries,
+     * alternating between integer and real values.
+     */
+    libember::dom::Node* buildStreamTree(Options const& options)
+    {
+        using namespace libember::glow;
+
+        GlowStreamCollection* const streams = GlowStreamCollection::create();
+        for (unsigned int e = 0; e < options.streamEntries; ++e)
+        {
+            if ((e & 1) == 0)
+            {
+                streams->insert(static_cast<int>(e + 1), static_cast<int>(e % 256) - 128);
+            }
+            else
+            {
+                streams->insert(static_cast<int>(e + 1), static_cast<double>(e % 256) * -0.25);
+            }
+        }
+        return streams;
+    }
+
+    typedef libember::dom::Node* (*TreeBuilder)(Options const&);
+
+    /**
+     * Runs a single benchmark scenario. Every iteration builds a fresh tree,
+     * encodes it and decodes the encoded bytes again through the
+     * AsyncDomReader, feeding the input in chunks of the configured size.
+     * @throw std::runtime_error if a decoded tree does not match the
+     *      encoded one.
+     */
+    Result runScenario(std::string const& name, TreeBuilder builder, Options const& options)
+    {
+        using libember::glow::GlowNodeFactory;
+
+        Result result;
+        result.name = name;
+
+        for (unsigned int i = 0; i < options.iterations; ++i)
+        {
+            unsigned long long allocations = g_allocationCount;
+            double start = now();
+            libember::dom::Node* const tree = builder(options);
+            result.buildSeconds += now() - start;
+            result.buildAllocations += g_allocationCount - allocations;
+
+            unsigned long const elements = countNodes(tree);
+
+            libember::util::OctetStream stream;
+            allocations = g_allocationCount;
+            start = now();
+            tree->encode(stream);
+            result.encodeSeconds += now() - start;
+            result.encodeAllocations += g_allocationCount - allocations;
+            delete tree;
+
+            std::vector<unsigned char> const bytes(stream.begin(), stream.end());
+            std::size_t const chunkSize = options.chunkSize > 0 ? options.chunkSize : bytes.size();
+
+            libember::dom::AsyncDomReader reader(GlowNodeFactory::getFactory());
+            allocations = g_allocationCount;
+            start = now();
+            for (std::size_t offset = 0; offset < bytes.size(); offset += chunkSize)
+            {
+                std::size_t const length = std::min(chunkSize, bytes.size() - offset);
+                reader.read(bytes.begin() + offset, bytes.begin() + offset + length);
+            }
+            libember::dom::Node* const decoded = reader.detachRoot();
+            result.decodeSeconds += now() - start;
+            result.decodeAllocations += g_allocationCount - allocations;
+
+            if (decoded == 0)
+            {
+                throw std::runtime_error("Decoding did not yield a root node in scenario " + name + ".");
+            }
+
+            unsigned long const decodedElements = countNodes(decoded);
+            delete decoded;
+
+            if (decodedElements != elements)
+            {
+                std::ostringstream msgStream;
+                msgStream << "Decoded element count mismatch in scenario " << name
+                          << ". Expected " << elements << ", found " << decodedElements;
+                throw std::runtime_error(msgStream.str());
+            }
+
+            result.elements += elements;
+            result.encodedBytes += static_cast<unsigned long>(bytes.size());
+        }
+
+        result.peakRssKiB = peakRssKiB();
+        return result;
+    }
+
+    /**
+     * Builds the parameter tree and adds a matrix and a function to every
+     * node, so that element dispatch has to distinguish several types.
+     */
+    libember::dom::Node* buildMixedTree(Options const& options)
+    {
+        using namespace libember::glow;
+
+        libember::dom::Node* const root = buildParameterTree(options);
+        GlowRootElementCollection* const collection = static_cast<GlowRootElementCollection*>(root);
+        for (libember::dom::Container::iterator it = collection->begin(); it != collection->end(); ++it)
+        {
+            GlowNode* const node = static_cast<GlowNode*>(&*it);
+            GlowMatrix* const matrix = new GlowMatrix(node, static_cast<int>(options.parameters + 1));
+            matrix->setIdentifier("matrix");
+            GlowFunction* const function = new GlowFunction(node, static_cast<int>(options.parameters + 2));
+            function->setIdentifier("function");
+        }
+        return root;
+    }
+
+    /**
+     * Dispatches the elements of @p container the way a consumer without
+     * type information has to, by trying one dynamic_cast after another.
+     * Returns the number of dispatched elements and accumulates a checksum
+     * of the detected types.
+     */
+    unsigned long dispatchByCast(libember::dom::Container const& container, unsigned long& checksum)
+    {
+        using namespace libember::glow;
+
+        unsigned long dispatched = 0;
+        libember::dom::Container::const_iterator const last = container.end();
+        for (libember::dom::Container::const_iterator it = container.begin(); it != last; ++it)
+        {
+            libember::dom::Node const* const element = &*it;
+            ++dispatched;
+
+            if (dynamic_cast<GlowQualifiedNode const*>(element) != 0)
+                checksum += GlowType::QualifiedNode;
+            else if (GlowNode const* const node = dynamic_cast<GlowNode const*>(element))
+            {
+                checksum += GlowType::Node;
+                if (node->children() != 0)
+                    dispatched += dispatchByCast(*node->children(), checksum);
+            }
+            else if (dynamic_cast<GlowQualifiedParameter const*>(element) != 0)
+                checksum += GlowType::QualifiedParameter;
+            else if (dynamic_cast<GlowParameter const*>(element) != 0)
+                checksum += GlowType::Parameter;
+            else if (dynamic_cast<GlowQualifiedMatrix const*>(element) != 0)
+                checksum += GlowType::QualifiedMatrix;
+            else if (dynamic_cast<GlowMatrix const*>(element) != 0)
+                checksum += GlowType::Matrix;
+            else if (dynamic_cast<GlowQualifiedFunction const*>(element) != 0)
+                checksum += GlowType::QualifiedFunction;
+            else if (dynamic_cast<GlowFunction const*>(element) != 0)
+                checksum += GlowType::Function;
+        }
+        return dispatched;
+    }
+
+    /**
+     * Dispatches the elements of a tree through the GlowVisitor and computes
+     * the same checksum as dispatchByCast.
+     */
+    class ChecksumVisitor : public libember::glow::GlowVisitor
+    {
+        public:
+            ChecksumVisitor()
+                : checksum(0)
+                , dispatched(0)
+            {}
+
+            unsigned long checksum;
+            unsigned long dispatched;
+
+        protected:
+            virtual void visitQualifiedNode(libember::glow::GlowQualifiedNode const&)
+            {
+                add(libember::glow::GlowType::QualifiedNode);
+            }
+
+            virtual void visitNode(libember::glow::GlowNode const& node)
+            {
+                add(libember::glow::GlowType::Node);
+                if (node.children() != 0)
+                    node.children()->visitChildren(*this);
+            }
+
+            virtual void visitQualifiedParameter(libember::glow::GlowQualifiedParameter const&)
+            {
+                add(libember::glow::GlowType::QualifiedParameter);
+            }
+
+            virtual void visitParameter(libember::glow::GlowParameter const&)
+            {
+                add(libember::glow::GlowType::Parameter);
+            }
+
+            virtual void visitQualifiedMatrix(libember::glow::GlowQualifiedMatrix const&)
+            {
+                add(libember::glow::GlowType::QualifiedMatrix);
+            }
+
+            virtual void visitMatrix(libember::glow::GlowMatrix const&)
+            {
+                add(libember::glow::GlowType::Matrix);
+            }
+
+            virtual void visitQualifiedFunction(libember::glow::GlowQualifiedFunction const&)
+            {
+                add(libember::glow::GlowType::QualifiedFunction);
+            }
+
+            virtual void visitFunction(libember::glow::GlowFunction const&)
+            {
+                add(libember::glow::GlowType::Function);
+            }
+
+        private:
+            void add(unsigned long type)
+            {
+                checksum += type;
+                ++dispatched;
+            }
+    };
+
+    /**
+     * Timing of the two element dispatch strategies on the mixed tree.
+     */
+    struct DispatchResult
+    {
+        DispatchResult()
+            : elements(0)
+            , castSeconds(0.0)
+            , visitorSeconds(0.0)
+        {}
+
+        unsigned long elements;
+        double castSeconds;
+        double visitorSeconds;
+    };
+
+    /**
+     * Walks the mixed tree repeatedly, once with dynamic_cast chains and
+     * once with the GlowVisitor.
+     * @throw std::runtime_error if both strategies disagree.
+     */
+    DispatchResult runDispatch(Options const& options)
+    {
+        libember::dom::Node* const tree = buildMixedTree(options);
+        libember::dom::Container const& root = *static_cast<libember::glow::GlowRootElementCollection const*>(tree);
+        unsigned int const walks = options.iterations * 10;
+
+        DispatchResult result;
+        unsigned long castChecksum = 0;
+        double start = now();
+        for (unsigned int i = 0; i < walks; ++i)
+        {
+            result.elements += dispatchByCast(root, castChecksum);
+        }
+        result.castSeconds = now() - start;
+
+        ChecksumVisitor visitor;
+        start = now();
+        for (unsigned int i = 0; i < walks; ++i)
+        {
+            visitor.dispatchChildren(root);
+        }
+        result.visitorSeconds = now() - start;
+        delete tree;
+
+        if (visitor.checksum != castChecksum || visitor.dispatched != result.elements)
+        {
+            throw std::runtime_error("Visitor and dynamic_cast dispatch disagree.");
+        }
+        return result;
+    }
+
+    double nanosecondsPer(double seconds, unsigned long count)
+    {
+        return count > 0 ? seconds * 1.0e9 / static_cast<double>(count) : 0.0;
+    }
+
+    double megabytesPerSecond(unsigned long bytes, double seconds)
+    {
+        return seconds > 0.0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / seconds : 0.0;
+    }
+
+    double ratio(unsigned long long numerator, unsigned long denominator)
+    {
+        return denominator > 0 ? static_cast<double>(numerator) / static_cast<double>(denominator) : 0.0;
+    }
+
+    /**
+     * Writes the result of a single scenario as a JSON object. The key order
+     * and number formatting are fixed so that outputs of different runs can
+     * be compared textually.
+     */
+    void writeResult(std::ostream& out, Result const& result, Options const& options)
+    {
+        unsigned long const iterations = options.iterations > 0 ? options.iterations : 1;
+
+        out << "    {\n"
+            << "      \"name\": \"" << result.name << "\",\n"
+            << "      \"elementsPerTree\": " << (result.elements / iterations) << ",\n"
+            << "      \"encodedBytesPerTree\": " << (result.encodedBytes / iterations) << ",\n"
+            << "      \"buildMs\": " << (result.buildSeconds * 1000.0 / iterations) << ",\n"
+            << "      \"encodeMs\": " << (result.encodeSeconds * 1000.0 / iterations) << ",\n"
+            << "      \"decodeMs\": " << (result.decodeSeconds * 1000.0 / iterations) << ",\n"
+            << "      \"encodeMBps\": " << megabytesPerSecond(result.encodedBytes, result.encodeSeconds) << ",\n"
+            << "      \"decodeMBps\": " << megabytesPerSecond(result.encodedBytes, result.decodeSeconds) << ",\n"
+            << "      \"buildAllocationsPerElement\": " << ratio(result.buildAllocations, result.elements) << ",\n"
+            << "      \"encodeAllocationsPerElement\": " << ratio(result.encodeAllocations, result.elements) << ",\n"
+            << "      \"decodeAllocationsPerElement\": " << ratio(result.decodeAllocations, result.elements) << ",\n"
+            << "      \"peakRssKiB\": " << result.peakRssKiB << "\n"
+            << "    }";
+    }
+
+    /**
+     * Parses an unsigned numeric command line argument.
+     * @throw std::runtime_error if the value is missing or not a number.
+     */
+    unsigned int parseCount(int argc, char const* const* argv, int& index)
+    {
+        if (index + 1 >= argc)
+        {
+            throw std::runtime_error(std::string("Missing value for option ") + argv[index]);
+        }
+
+        char const* const text = argv[++index];
+        char* end = 0;
+        unsigned long const value = std::strtoul(text, &end, 10);
+        if (end == text || *end != '\0')
+        {
+            throw std::runtime_error(std::string("Invalid numeric value: ") + text);
+        }
+        return static_cast<unsigned int>(value);
+    }
+
+    void printUsage(char const* program)
+    {
+        std::cerr
+            << "Usage: " << program << " [options]\n"
+            << "  --nodes N          number of nodes in the parameter tree (default 100)\n"
+            << "  --parameters M     parameters per node (default 50)\n"
+            << "  --targets T        matrix targets (default 64)\n"
+            << "  --sources S        matrix sources (default 64)\n"
+            << "  --connections K    matrix connections (default 64)\n"
+            << "  --streams E        stream collection entries (default 1024)\n"
+            << "  --iterations I     iterations per scenario (default 10)\n"
+            << "  --chunk C          decoder input chunk size in bytes, 0 = whole buffer (default 1024)\n";
+    }
+}
+
+int main(int argc, char const* const* argv)
+{
+    try
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--nodes") == 0)
+                options.nodes = parseCount(argc, argv, i);
+            else if (std::strcmp(argv[i], "--parameters") == 0)
+                options.parameters = parseCount(argc, argv, i);
+            else if (std::strcmp(argv[i], "--targets") == 0)
+                options.targets = parseCount(argc, argv, i);
+            else if (std::strcmp(argv[i], "--sources") == 0)
+                options.sources = parseCount(argc, argv, i);
+            else if (std::strcmp(argv[i], "--connections") == 0)
+                options.connections = parseCount(argc, argv, i);
+            else if (std::strcmp(argv[i], "--streams") == 0)
+                options.streamEntries = parseCount(argc, argv, i);
+            else if (std::strcmp(argv[i], "--iterations") == 0)
+                options.iterations = parseCount(argc, argv, i);
+            else if (std::strcmp(argv[i], "--chunk") == 0)
+                options.chunkSize = parseCount(argc, argv, i);
+            else
+            {
+                printUsage(argv[0]);
+                return 2;
+            }
+        }
+
+        std::vector<Result> results;
+        results.push_back(runScenario("parameters", &buildParameterTree, options));
+        results.push_back(runScenario("matrix", &buildMatrixTree, options));
+        results.push_back(runScenario("streams", &buildStreamTree, options));
+        DispatchResult const dispatch = runDispatch(options);
+
+        std::cout << std::fixed << std::setprecision(3)
+            << "{\n"
+            << "  \"benchmark\": \"libember-glow-tree\",\n"
+            << "  \"version\": 2,\n"
+            << "  \"config\": {\n"
+            << "    \"nodes\": " << options.nodes << ",\n"
+            << "    \"parameters\": " << options.parameters << ",\n"
+            << "    \"targets\": " << options.targets << ",\n"
+            << "    \"sources\": " << options.sources << ",\n"
+            << "    \"connections\": " << options.connections << ",\n"
+            << "    \"streams\": " << options.streamEntries << ",\n"
+            << "    \"iterations\": " << options.iterations << ",\n"
+            << "    \"chunk\": " << options.chunkSize << "\n"
+            << "  },\n"
+            << "  \"results\": [\n";
+
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            writeResult(std::cout, results[i], options);
+            std::cout << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+
+        unsigned long const walks = options.iterations > 0 ? options.iterations * 10UL : 1;
+        std::cout
+            << "  ],\n"
+            << "  \"dispatch\": {\n"
+            << "    \"elementsPerWalk\": " << (dispatch.elements / walks) << ",\n"
+            << "    \"dynamicCastNsPerElement\": " << nanosecondsPer(dispatch.castSeconds, dispatch.elements) << ",\n"
+            << "    \"visitorNsPerElement\": " << nanosecondsPer(dispatch.visitorSeconds, dispatch.elements) << "\n"
+            << "  },\n"
+            << "  \"peakRssKiB\": " << peakRssKiB() << "\n"
+            << "}" << std::endl;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "ERROR: " << "An unknown error occurred." << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+//EndSimianIgnore
@@ -0,0 +1,108 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+
+    Copyright (C) 2012-2016 Lawo GmbH (http://www.lawo.com).
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "ember/Ember.hpp"
+#include "ember/glow/util/MemoryFootprint.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    typedef libember::glow::util::MemoryFootprint MemoryFootprint;
+
+    /**
+     * Throws if the number of objects attributed to @p category differs from
+     * @p expected.
+     */
+    void expectCount(MemoryFootprint const& footprint, MemoryFootprint::Category category, std::size_t expected)
+    {
+        std::size_t const actual = footprint.count(category);
+        if (actual != expected)
+        {
+            THROW_TEST_EXCEPTION("Unexpected count for " << MemoryFootprint::categoryName(category)
+                << ". Expected " << expected << ", found " << actual);
+        }
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowNode* const node = new GlowNode(root, 1);
+        node->setIdentifier("device");
+
+        GlowParameter* const gain = new GlowParameter(node, 1);
+        gain->setIdentifier("gain");
+        gain->setValue(-6.0);
+
+        GlowParameter* const name = new GlowParameter(node, 2);
+        name->setIdentifier("name");
+        name->setValue(std::string("A string that does not fit into the small string buffer"));
+
+        libember::ber::ObjectIdentifier path;
+        path.push_back(1);
+        path.push_back(3);
+        root->insert(root->end(), new GlowQualifiedParameter(path));
+
+        MemoryFootprint const footprint = MemoryFootprint::measure(*root);
+
+        expectCount(footprint, MemoryFootprint::GlowNodes, 1);
+        expectCount(footprint, MemoryFootprint::GlowParameters, 3);
+        expectCount(footprint, MemoryFootprint::Strings, 1);
+        expectCount(footprint, MemoryFootprint::ObjectIdentifiers, 1);
+        expectCount(footprint, MemoryFootprint::OtherNodes, 0);
+
+        // root > node > children > parameter > contents > value
+        if (footprint.maxDepth() != 6)
+        {
+            THROW_TEST_EXCEPTION("Unexpected depth " << footprint.maxDepth());
+        }
+
+        std::size_t const nodes = footprint.count(MemoryFootprint::GlowNodes)
+            + footprint.count(MemoryFootprint::GlowParameters)
+            + footprint.count(MemoryFootprint::GlowMatrices)
+            + footprint.count(MemoryFootprint::GlowFunctions)
+            + footprint.count(MemoryFootprint::OtherGlowContainers)
+            + footprint.count(MemoryFootprint::DomContainers)
+            + footprint.count(MemoryFootprint::VariantLeaves)
+            + footprint.count(MemoryFootprint::OtherNodes);
+        if (nodes != footprint.nodeCount())
+        {
+            THROW_TEST_EXCEPTION("Node categories add up to " << nodes << " instead of " << footprint.nodeCount());
+        }
+        if (footprint.count(MemoryFootprint::ListNodes) + 1 != footprint.nodeCount())
+        {
+            THROW_TEST_EXCEPTION("Every node except the root should be linked by exactly one list node.");
+        }
+        if (footprint.totalBytes() < footprint.nodeCount() * sizeof(libember::dom::Node))
+        {
+            THROW_TEST_EXCEPTION("Total footprint is smaller than the nodes it contains.");
+        }
+
+        delete root;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
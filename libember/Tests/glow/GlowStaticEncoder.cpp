@@ -0,0 +1,173 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+
+    Copyright (C) 2012-2016 Lawo GmbH (http://www.lawo.com).
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ember/Ember.hpp"
+#include "ember/glow/util/StaticEncoder.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    /**
+     * Encodes @p node, deletes it and returns the encoded bytes.
+     */
+    std::vector<unsigned char> encodeAndDelete(libember::dom::Node* node)
+    {
+        libember::util::OctetStream stream;
+        node->encode(stream);
+        delete node;
+        return std::vector<unsigned char>(stream.begin(), stream.end());
+    }
+
+    /**
+     * Throws if the bytes produced by the static encoder differ from the
+     * bytes produced by the DOM, or if the predicted length is wrong.
+     */
+    void compare(std::string const& name, libember::util::OctetStream& actual, std::size_t predictedLength, std::vector<unsigned char> const& expected)
+    {
+        std::vector<unsigned char> const bytes(actual.begin(), actual.end());
+        if (bytes.size() != predictedLength)
+        {
+            THROW_TEST_EXCEPTION(name << ": predicted length " << predictedLength << " differs from actual length " << bytes.size());
+        }
+        if (bytes != expected)
+        {
+            THROW_TEST_EXCEPTION(name << ": encoding differs from the DOM encoding");
+        }
+    }
+
+    libember::ber::ObjectIdentifier makePath(int a, int b, int c)
+    {
+        libember::ber::ObjectIdentifier path;
+        path.push_back(a);
+        path.push_back(b);
+        path.push_back(c);
+        return path;
+    }
+
+    /**
+     * Encodes a qualified parameter with the static encoder and via the DOM
+     * and compares the results.
+     */
+    template<typename ValueType>
+    void testQualifiedParameter(std::string const& name, libember::ber::ObjectIdentifier const& path, ValueType const& value)
+    {
+        typedef libember::glow::util::QualifiedParameterValueEncoder<ValueType> Encoder;
+
+        libember::glow::GlowRootElementCollection* const root = libember::glow::GlowRootElementCollection::create();
+        libember::glow::GlowQualifiedParameter* const parameter = new libember::glow::GlowQualifiedParameter(path);
+        parameter->setValue(value);
+        root->insert(root->end(), parameter);
+        std::vector<unsigned char> const expected = encodeAndDelete(root);
+
+        libember::util::OctetStream stream;
+        Encoder::encode(stream, path, value);
+        compare(name, stream, Encoder::encodedLength(path, value), expected);
+    }
+
+    void testConnection(std::string const& name, libember::ber::ObjectIdentifier const& path, int target, libember::ber::ObjectIdentifier const& sources)
+    {
+        using libember::glow::ConnectionOperation;
+        using libember::glow::ConnectionDisposition;
+
+        libember::glow::GlowRootElementCollection* const root = libember::glow::GlowRootElementCollection::create();
+        libember::glow::GlowQualifiedMatrix* const matrix = new libember::glow::GlowQualifiedMatrix(path);
+        root->insert(root->end(), matrix);
+        libember::glow::GlowConnection* const connection = new libember::glow::GlowConnection(target);
+        connection->setSources(sources);
+        connection->setOperation(ConnectionOperation::Connect);
+        connection->setDisposition(ConnectionDisposition::Modified);
+        matrix->connections()->insert(matrix->connections()->end(), connection);
+        std::vector<unsigned char> const expected = encodeAndDelete(root);
+
+        libember::util::OctetStream stream;
+        libember::glow::util::ConnectionEncoder::encode(stream, path, target, sources, ConnectionOperation::Connect, ConnectionDisposition::Modified);
+        compare(name, stream, libember::glow::util::ConnectionEncoder::encodedLength(path, target, sources), expected);
+    }
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        libember::ber::ObjectIdentifier const shortPath = makePath(1, 2, 3);
+        libember::ber::ObjectIdentifier const longPath = makePath(1, 300, 70000);
+
+        testQualifiedParameter("parameter-long", shortPath, 42L);
+        testQualifiedParameter("parameter-negative", longPath, -123456789L);
+        testQualifiedParameter("parameter-real", shortPath, -12.75);
+        testQualifiedParameter("parameter-bool", longPath, true);
+        testQualifiedParameter("parameter-string", shortPath, std::string("Hello World"));
+        testQualifiedParameter("parameter-long-string", longPath, std::string(300, 'x'));
+
+        {
+            libember::ber::ObjectIdentifier sources;
+            sources.push_back(7);
+            testConnection("connection-single", shortPath, 5, sources);
+        }
+        {
+            libember::ber::ObjectIdentifier sources;
+            for (int i = 0; i < 100; ++i)
+            {
+                sources.push_back(i * 3);
+            }
+            testConnection("connection-many", longPath, 1000, sources);
+        }
+
+        {
+            typedef libember::glow::util::StreamEntryEncoder<double> Encoder;
+
+            std::vector<Encoder::entry_type> entries;
+            libember::glow::GlowStreamCollection* const collection = libember::glow::GlowStreamCollection::create();
+            for (int i = 0; i < 50; ++i)
+            {
+                double const value = -0.5 * i;
+                entries.push_back(Encoder::entry_type(i + 1, value));
+                collection->insert(i + 1, value);
+            }
+            std::vector<unsigned char> const expected = encodeAndDelete(collection);
+
+            libember::util::OctetStream stream;
+            Encoder::encode(stream, entries.begin(), entries.end());
+            std::vector<unsigned char> const bytes(stream.begin(), stream.end());
+            if (bytes != expected)
+            {
+                THROW_TEST_EXCEPTION("stream-collection: encoding differs from the DOM encoding");
+            }
+        }
+
+        {
+            typedef libember::glow::util::StreamEntryEncoder<int> Encoder;
+
+            libember::glow::GlowStreamCollection* const collection = libember::glow::GlowStreamCollection::create();
+            collection->insert(3, -1024);
+            std::vector<unsigned char> const expected = encodeAndDelete(collection);
+
+            libember::util::OctetStream stream;
+            Encoder::encode(stream, 3, -1024);
+            compare("stream-single", stream, Encoder::encodedLength(3, -1024), expected);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+
+    Copyright (C) 2012-2016 Lawo GmbH (http://www.lawo.com).
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "ember/Ember.hpp"
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+namespace
+{
+    /**
+     * Records the sequence of visited types as a string, so that both the
+     * dispatched method and the visiting order can be verified.
+     */
+    class RecordingVisitor : public libember::glow::GlowVisitor
+    {
+        public:
+            std::string const& trace() const
+            {
+                return m_trace;
+            }
+
+        protected:
+            virtual void visitNode(libember::glow::GlowNode const& node)
+            {
+                m_trace += "N";
+                node.children()->visitChildren(*this);
+            }
+
+            virtual void visitParameter(libember::glow::GlowParameter const&)
+            {
+                m_trace += "P";
+            }
+
+            virtual void visitQualifiedParameter(libember::glow::GlowQualifiedParameter const&)
+            {
+                m_trace += "Q";
+            }
+
+            virtual void visitMatrix(libember::glow::GlowMatrix const&)
+            {
+                m_trace += "M";
+            }
+
+            virtual void visitFunction(libember::glow::GlowFunction const&)
+            {
+                m_trace += "F";
+            }
+
+            virtual void visitStreamEntry(libember::glow::GlowStreamEntry const&)
+            {
+                m_trace += "S";
+            }
+
+            virtual void visitUnknown(libember::dom::Node const&)
+            {
+                m_trace += "?";
+            }
+
+        private:
+            std::string m_trace;
+    };
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        using namespace libember::glow;
+
+        GlowRootElementCollection* const root = GlowRootElementCollection::create();
+        GlowNode* const node = new GlowNode(root, 1);
+        new GlowParameter(node, 1);
+        new GlowMatrix(node, 2);
+        new GlowFunction(node, 3);
+
+        libember::ber::ObjectIdentifier path;
+        path.push_back(2);
+        root->insert(root->end(), new GlowQualifiedParameter(path));
+        root->insert(root->end(), new GlowCommand(CommandType::GetDirectory));
+
+        if (node->glowType().value() != GlowType::Node || root->glowType().value() != GlowType::RootElementCollection)
+        {
+            THROW_TEST_EXCEPTION("GlowContainer::glowType does not match the type tag.");
+        }
+
+        RecordingVisitor visitor;
+        root->visitChildren(visitor);
+        if (visitor.trace() != "NPMFQ")
+        {
+            THROW_TEST_EXCEPTION("Unexpected visiting sequence " << visitor.trace());
+        }
+
+        // The number and the contents set of a parameter are not glow objects.
+        GlowParameter* const parameter = new GlowParameter(0);
+        parameter->setValue(42L);
+        RecordingVisitor leafVisitor;
+        leafVisitor.dispatch(*parameter);
+        leafVisitor.dispatchChildren(*parameter);
+        if (leafVisitor.trace() != "P??")
+        {
+            THROW_TEST_EXCEPTION("Unexpected visiting sequence " << leafVisitor.trace());
+        }
+        delete parameter;
+
+        GlowStreamCollection* const streams = GlowStreamCollection::create();
+        streams->insert(1, 0.5);
+        streams->insert(2, 1);
+        RecordingVisitor streamVisitor;
+        streams->visitChildren(streamVisitor);
+        if (streamVisitor.trace() != "SS")
+        {
+            THROW_TEST_EXCEPTION("Unexpected visiting sequence " << streamVisitor.trace());
+        }
+        delete streams;
+
+        delete root;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+/*
+    libember -- C++ 03 implementation of the Ember+ Protocol
+
+    Copyright (C) 2012-2016 Lawo GmbH (http://www.lawo.com).
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "ember/Ember.hpp"
+
+#if __cplusplus >= 201103L
+#  include <memory>
+#  include <utility>
+#endif
+
+#define THROW_TEST_EXCEPTION(message)                       \
+            {                                               \
+                std::ostringstream msgStream;               \
+                msgStream << message ;                      \
+                throw std::runtime_error(msgStream.str());  \
+            }
+
+/*
+ * This test is built both in C++98 and in C++17 mode. The copy based checks
+ * run in both modes, the move based checks only when move semantics are
+ * available.
+ */
+namespace
+{
+    libember::ber::Octets makeOctets(std::size_t size)
+    {
+        std::string const data(size, 'x');
+        return libember::ber::Octets(data.begin(), data.end());
+    }
+
+    libember::util::OctetStream makeStream(std::size_t size)
+    {
+        libember::util::OctetStream stream;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            stream.append(static_cast<unsigned char>(i));
+        }
+        return stream;
+    }
+
+    void testCopies()
+    {
+        libember::ber::Octets const octets = makeOctets(100);
+        libember::ber::Octets copy(octets);
+        if (copy.size() != 100 || octets.size() != 100)
+        {
+            THROW_TEST_EXCEPTION("Copying Octets changed their size.");
+        }
+
+        libember::util::OctetStream const stream = makeStream(1000);
+        libember::util::OctetStream streamCopy;
+        streamCopy = stream;
+        if (streamCopy.size() != 1000 || stream.size() != 1000)
+        {
+            THROW_TEST_EXCEPTION("Copying a StreamBuffer changed its size.");
+        }
+
+        libember::ber::Value const value(std::string("Hello World"));
+        libember::ber::Value const valueCopy(value);
+        if (valueCopy.as<std::string>() != "Hello World")
+        {
+            THROW_TEST_EXCEPTION("Copying a Value changed its contents.");
+        }
+    }
+
+#if __cplusplus >= 201103L
+    void testMoves()
+    {
+        libember::ber::Octets octets = makeOctets(100);
+        libember::ber::Octets moved(std::move(octets));
+        if (moved.size() != 100 || octets.size() != 0)
+        {
+            THROW_TEST_EXCEPTION("Moving Octets did not transfer their contents.");
+        }
+        octets = std::move(moved);
+        if (octets.size() != 100 || moved.size() != 0)
+        {
+            THROW_TEST_EXCEPTION("Move assigning Octets did not transfer their contents.");
+        }
+
+        libember::ber::ObjectIdentifier path;
+        path.push_back(1);
+        path.push_back(2);
+        libember::ber::ObjectIdentifier movedPath(std::move(path));
+        if (movedPath.size() != 2)
+        {
+            THROW_TEST_EXCEPTION("Moving an ObjectIdentifier lost its elements.");
+        }
+
+        libember::util::OctetStream stream = makeStream(1000);
+        libember::util::OctetStream movedStream(std::move(stream));
+        if (movedStream.size() != 1000 || !stream.empty())
+        {
+            THROW_TEST_EXCEPTION("Moving a StreamBuffer did not transfer its contents.");
+        }
+        stream = std::move(movedStream);
+        if (stream.size() != 1000)
+        {
+            THROW_TEST_EXCEPTION("Move assigning a StreamBuffer did not transfer its contents.");
+        }
+
+        libember::ber::Value value(std::string("Hello World"));
+        libember::ber::Value movedValue(std::move(value));
+        if (value || movedValue.as<std::string>() != "Hello World")
+        {
+            THROW_TEST_EXCEPTION("Moving a Value did not transfer its payload.");
+        }
+
+        libember::glow::GlowRootElementCollection* const root = libember::glow::GlowRootElementCollection::create();
+        std::unique_ptr<libember::glow::GlowNode> node(new libember::glow::GlowNode(1));
+        libember::glow::GlowNode* const raw = node.get();
+        libember::dom::Container::iterator const where = root->insert(root->end(), std::move(node));
+        if (node || &*where != raw || root->size() != 1)
+        {
+            THROW_TEST_EXCEPTION("Inserting a unique_ptr did not transfer ownership.");
+        }
+
+        delete root;
+    }
+#endif
+}
+
+int main(int, char const* const*)
+{
+    try
+    {
+        testCopies();
+#if __cplusplus >= 201103L
+        testMoves();
+#endif
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
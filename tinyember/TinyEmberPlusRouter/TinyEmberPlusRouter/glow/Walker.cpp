@@ -12,7 +12,7 @@ namespace glow
    {
       using libember::glow::GlowType;
 
-      switch(glow->typeTag().number())
+      switch(glow->glowType().value())
       {
          case GlowType::Command:
             handleCommand(static_cast<libember::glow::GlowCommand const*>(glow), pathToOid());
@@ -200,10 +200,8 @@ namespace glow
    {
       for(libember::dom::Node const& ember : *glow)
       {
-         auto streamEntry = dynamic_cast<libember::glow::GlowStreamEntry const*>(&ember);
-
-         if(streamEntry != nullptr)
-            handleStreamEntry(streamEntry);
+         if(ember.typeTag() == libember::glow::GlowType(libember::glow::GlowType::StreamEntry).toTypeTag())
+            handleStreamEntry(static_cast<libember::glow::GlowStreamEntry const*>(&ember));
       }
    }
 }
@@ -111,10 +111,11 @@ namespace glow
    {
       for( ; first != last; first++)
       {
-         auto glow = dynamic_cast<libember::glow::GlowContainer const*>(std::addressof(*first));
+         // Only glow objects carry an application type tag
+         libember::dom::Node const* node = std::addressof(*first);
 
-         if(glow != nullptr)
-            walk(glow);
+         if(node->typeTag().getClass() == libember::ber::Class::Application)
+            walk(static_cast<libember::glow::GlowContainer const*>(node));
       }
    }
 }